@@ -35,4 +35,8 @@
 umba-enum-gen %GEN_OPTS% %HEX2% %TPL_OVERRIDE% %SNIPPETOPTIONS_GEN_FLAGS%              ^
     %FLAGS%                                                                            ^
     %UINT32% %HEX4% -E=RoundRectFlags                -F=@RoundRectFlags.txt            ^
+    --enum-flags=0 --enum-flags=type-decl,serialize,deserialize,lowercase,enum-class,fmt-hex ^
+    %UINT32% %HEX4% -E=LineJoin                      -F=@LineJoin.txt                  ^
+    %UINT32% %HEX4% -E=DominantBaseline              -F=@DominantBaseline.txt          ^
+    %UINT32% %HEX4% -E=TextAnchor                    -F=@TextAnchor.txt                ^
 ..\enums.h
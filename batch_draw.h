@@ -0,0 +1,323 @@
+/*! \file
+    \brief Пакетный вывод примитивов: много прямоугольников/линий/ломаных одним элементом <path>
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include "marty_svg.h"
+//
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/batch_draw.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+struct SvgPoint
+{
+    int x = 0;
+    int y = 0;
+};
+
+struct SvgRect
+{
+    int posX  = 0;
+    int posY  = 0;
+    int sizeX = 0;
+    int sizeY = 0;
+};
+
+struct SvgLine
+{
+    int startX = 0;
+    int startY = 0;
+    int endX   = 0;
+    int endY   = 0;
+};
+
+//----------------------------------------------------------------------------
+//! Стиль элемента <path>: класс, или inline-атрибуты, как у стилевого pathStart
+struct SvgPathStyle
+{
+    std::string_view    pathClass;
+
+    int                 strokeWidth = 0;
+    std::string_view    strokeColor;
+    std::string_view    fillColor;   // no fill if empty
+    std::string_view    linejoin;    // miter if empty
+
+    SvgPathStyle() = default;
+
+    SvgPathStyle(std::string_view pathClass_) : pathClass(pathClass_) {}
+    SvgPathStyle(const char *pathClass_)      : pathClass(pathClass_) {}
+
+    SvgPathStyle( int strokeWidth_, std::string_view strokeColor_
+                , std::string_view fillColor_=std::string_view()
+                , std::string_view linejoin_=std::string_view()
+                )
+    : strokeWidth(strokeWidth_)
+    , strokeColor(strokeColor_)
+    , fillColor(fillColor_)
+    , linejoin(linejoin_)
+    {}
+
+    bool isClass() const { return strokeColor.empty(); }
+
+    //! Толщина линии для хуков учёта габаритов; -1 - задана классом
+    int boundsStrokeWidth() const { return isClass() ? -1 : strokeWidth; }
+};
+
+//----------------------------------------------------------------------------
+//! Открывает <path> и атрибут d
+template<typename StreamType>
+void pathStartBatch(StreamType &oss, const SvgPathStyle &style)
+{
+    oss << "<path ";
+    elementTagOpened(oss);
+    if (style.isClass())
+    {
+        if (!style.pathClass.empty())
+            oss << "class=\"" << style.pathClass << "\" ";
+    }
+    else
+    {
+        writePathStyleAttributes(oss, style.strokeWidth, style.strokeColor, style.fillColor, style.linejoin);
+    }
+    oss << "d=\"";
+}
+
+//----------------------------------------------------------------------------
+template<typename StreamType>
+void pathEndBatch(StreamType &oss)
+{
+    oss << "\" />\n";
+}
+
+//----------------------------------------------------------------------------
+//! Пара координат; разделитель перед вторым числом нужен, только если оно неотрицательное
+template<typename StreamType> inline
+void writePathCoordPair(StreamType &oss, int a, int b)
+{
+    oss << a;
+    if (b>=0)
+        oss << ' ';
+    oss << b;
+}
+
+//----------------------------------------------------------------------------
+//! Подпуть прямоугольника: M x y h w v h h -w z
+template<typename StreamType> inline
+void writeRectSubpath(StreamType &oss, const SvgRect &rc)
+{
+    oss << 'M'; writePathCoordPair(oss, rc.posX, rc.posY);
+    oss << 'h' << rc.sizeX << 'v' << rc.sizeY << 'h' << -rc.sizeX << 'z';
+}
+
+//----------------------------------------------------------------------------
+//! Подпуть отрезка: M x y, затем H, V или L
+/*! Каждый отрезок начинается своим moveto, даже если продолжает предыдущий: отрезки не должны
+    сливаться в ломаную, иначе на стыках появятся соединения (linejoin) вместо концов линий,
+    как у отдельных drawLine.
+ */
+template<typename StreamType> inline
+void writeLineSubpath(StreamType &oss, const SvgLine &ln)
+{
+    oss << 'M'; writePathCoordPair(oss, ln.startX, ln.startY);
+
+    if (ln.startY==ln.endY)
+        oss << 'H' << ln.endX;
+    else if (ln.startX==ln.endX)
+        oss << 'V' << ln.endY;
+    else
+    {
+        oss << 'L'; writePathCoordPair(oss, ln.endX, ln.endY);
+    }
+}
+
+//----------------------------------------------------------------------------
+//! Все прямоугольники одним элементом <path>, каждый - отдельный подпуть
+template<typename StreamType>
+void drawRects(StreamType &oss, const SvgRect *pRects, std::size_t count, const SvgPathStyle &style)
+{
+    if (!count)
+        return;
+
+    pathStartBatch(oss, style);
+    for(const SvgRect *pEnd=pRects+count; pRects!=pEnd; ++pRects)
+    {
+        boundsRect(oss, pRects->posX, pRects->posY, pRects->sizeX, pRects->sizeY, 0, style.boundsStrokeWidth());
+        writeRectSubpath(oss, *pRects);
+    }
+    pathEndBatch(oss);
+}
+
+//----------------------------------------------------------------------------
+//! Все отрезки одним элементом <path>, каждый - отдельный подпуть
+template<typename StreamType>
+void drawLines(StreamType &oss, const SvgLine *pLines, std::size_t count, const SvgPathStyle &style)
+{
+    if (!count)
+        return;
+
+    pathStartBatch(oss, style);
+    for(const SvgLine *pEnd=pLines+count; pLines!=pEnd; ++pLines)
+    {
+        boundsLine(oss, pLines->startX, pLines->startY, pLines->endX, pLines->endY, style.boundsStrokeWidth());
+        writeLineSubpath(oss, *pLines);
+    }
+    pathEndBatch(oss);
+}
+
+//----------------------------------------------------------------------------
+//! Ломаные одним элементом <path>
+/*! Точки всех ломаных лежат подряд в pPoints, pPointCounts[i] - число точек i-й ломаной.
+    Ломаные из одной точки пропускаются.
+ */
+template<typename StreamType>
+void drawPolylines( StreamType &oss
+                  , const SvgPoint *pPoints, const std::size_t *pPointCounts, std::size_t nPolylines
+                  , const SvgPathStyle &style
+                  , bool closePath=false
+                  )
+{
+    bool started = false;
+
+    for(std::size_t i=0; i!=nPolylines; ++i)
+    {
+        const std::size_t nPoints = pPointCounts[i];
+        const SvgPoint   *p       = pPoints;
+        pPoints += nPoints;
+
+        if (nPoints<2)
+            continue;
+
+        if (!started)
+        {
+            pathStartBatch(oss, style);
+            started = true;
+        }
+
+        boundsPathStart(oss, p[0].x, p[0].y, true, style.boundsStrokeWidth(), style.linejoin);
+        for(std::size_t k=1; k!=nPoints; ++k)
+            boundsPathLineTo(oss, p[k].x, p[k].y, true);
+        boundsPathEnd(oss, closePath);
+
+        oss << 'M'; writePathCoordPair(oss, p[0].x, p[0].y);
+        oss << 'L'; writePathCoordPair(oss, p[1].x, p[1].y);
+        for(std::size_t k=2; k!=nPoints; ++k)
+        {
+            // Неявный повтор L
+            if (p[k].x>=0)
+                oss << ' ';
+            writePathCoordPair(oss, p[k].x, p[k].y);
+        }
+
+        if (closePath)
+            oss << 'z';
+    }
+
+    if (started)
+        pathEndBatch(oss);
+}
+
+//----------------------------------------------------------------------------
+//! Элементы с разными стилями: по одному <path> на каждую группу стиля, в порядке стилей
+/*! subpathWriter(item, firstInGroup) пишет подпуть одного элемента. Индекс стиля, не меньший
+    nStyles, - std::out_of_range; индексы проверяются до вывода, поток при этом не меняется.
+ */
+template<typename StreamType, typename ItemType, typename SubpathWriter>
+void drawGroupedImpl( StreamType &oss
+                    , const ItemType *pItems, const std::uint32_t *pStyleIndices, std::size_t count
+                    , const SvgPathStyle *pStyles, std::size_t nStyles
+                    , SubpathWriter subpathWriter
+                    )
+{
+    for(std::size_t i=0; i!=count; ++i)
+    {
+        if (pStyleIndices[i]>=nStyles)
+            throw std::out_of_range("marty::svg::drawRects/drawLines: style index is out of range");
+    }
+
+    // Сортировка подсчётом по индексу стиля, порядок внутри группы сохраняется
+    std::vector<std::uint32_t> groupStart(nStyles+1u, 0u);
+    for(std::size_t i=0; i!=count; ++i)
+        ++groupStart[pStyleIndices[i]+1u];
+    for(std::size_t s=0; s!=nStyles; ++s)
+        groupStart[s+1u] += groupStart[s];
+
+    std::vector<std::uint32_t> order(count);
+    {
+        std::vector<std::uint32_t> pos(groupStart.begin(), groupStart.end()-1);
+        for(std::size_t i=0; i!=count; ++i)
+            order[pos[pStyleIndices[i]]++] = std::uint32_t(i);
+    }
+
+    for(std::size_t s=0; s!=nStyles; ++s)
+    {
+        if (groupStart[s]==groupStart[s+1u])
+            continue;
+
+        pathStartBatch(oss, pStyles[s]);
+        for(std::uint32_t k=groupStart[s]; k!=groupStart[s+1u]; ++k)
+            subpathWriter(pItems[order[k]], k==groupStart[s]);
+        pathEndBatch(oss);
+    }
+}
+
+//----------------------------------------------------------------------------
+//! Прямоугольники с разными стилями; pStyleIndices[i] - индекс стиля в pStyles, меньше nStyles
+template<typename StreamType>
+void drawRects( StreamType &oss
+              , const SvgRect *pRects, const std::uint32_t *pStyleIndices, std::size_t count
+              , const SvgPathStyle *pStyles, std::size_t nStyles
+              )
+{
+    drawGroupedImpl( oss, pRects, pStyleIndices, count, pStyles, nStyles
+                   , [&](const SvgRect &rc, bool /* firstInGroup */)
+                     {
+                         boundsRect(oss, rc.posX, rc.posY, rc.sizeX, rc.sizeY, 0, pStyles[pStyleIndices[&rc-pRects]].boundsStrokeWidth());
+                         writeRectSubpath(oss, rc);
+                     }
+                   );
+}
+
+//----------------------------------------------------------------------------
+//! Отрезки с разными стилями
+template<typename StreamType>
+void drawLines( StreamType &oss
+              , const SvgLine *pLines, const std::uint32_t *pStyleIndices, std::size_t count
+              , const SvgPathStyle *pStyles, std::size_t nStyles
+              )
+{
+    drawGroupedImpl( oss, pLines, pStyleIndices, count, pStyles, nStyles
+                   , [&](const SvgLine &ln, bool /* firstInGroup */)
+                     {
+                         boundsLine(oss, ln.startX, ln.startY, ln.endX, ln.endY, pStyles[pStyleIndices[&ln-pLines]].boundsStrokeWidth());
+                         writeLineSubpath(oss, ln);
+                     }
+                   );
+}
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/batch_draw.h"
+
@@ -0,0 +1,774 @@
+/*! \file
+    \brief Бенчмарк примитивов marty_svg
+
+    Прогоняет каждый примитив на масштабах от 1k до 10M элементов и выводит
+    ns/element, bytes/element и allocations/element. Результаты дополнительно пишутся в JSON.
+
+    marty_svg_bench [--max-elements N] [--filter substr] [--json file.json]
+
+    При сборке с MARTY_SVG_INSTRUMENTATION (опция CMake MARTY_SVG_BENCH_INSTRUMENTATION) в конце
+    печатается отчёт инструментирования по примитивам.
+ */
+
+#include "marty_svg/marty_svg.h"
+#include "marty_svg/batch_draw.h"
+#include "marty_svg/bounds_tracker.h"
+#include "marty_svg/font_metrics.h"
+#include "marty_svg/frame_diff.h"
+#include "marty_svg/parallel_writer.h"
+#include "marty_svg/path_encoder.h"
+#include "marty_svg/polyline_simplify.h"
+#include "marty_svg/shape_instancer.h"
+#include "marty_svg/stream_producer.h"
+#include "marty_svg/style_registry.h"
+#include "marty_svg/svg_pull_parser.h"
+#include "marty_svg/svg_raster.h"
+#include "marty_svg/svgz_writer.h"
+#include "marty_svg/tile_writer.h"
+
+// Подсчёт аллокаций - глобальные operator new/delete подменены счётчиком
+#include "marty_svg/tests/marty_svg_counting_allocator.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+//----------------------------------------------------------------------------
+namespace {
+
+using namespace marty::svg;
+
+//! Сколько элементов пишем в один буфер перед его сбросом - чтобы 10M элементов не держать в памяти
+constexpr std::size_t flushEveryElements = 4096;
+
+struct BenchResult
+{
+    std::string     name;
+    std::string     sink;
+    std::size_t     elements = 0;
+    double          nsPerElement     = 0;
+    double          bytesPerElement  = 0;
+    double          allocsPerElement = 0;
+};
+
+//----------------------------------------------------------------------------
+//! Обёртка над приёмником, считающая выведенные байты при сбросе
+struct OstreamSink
+{
+    static const char* name() { return "ostringstream"; }
+
+    std::ostringstream  oss;
+    std::uint64_t       bytes = 0;
+
+    std::ostringstream& stream() { return oss; }
+
+    void flush()
+    {
+        bytes += std::uint64_t(oss.tellp());
+        oss.seekp(0); // Память потока остаётся, как и у SvgWriter::clear()
+    }
+};
+
+struct SvgWriterSink
+{
+    static const char* name() { return "SvgWriter"; }
+
+    SvgWriter           w;
+    std::uint64_t       bytes = 0;
+
+    SvgWriter& stream() { return w; }
+
+    void flush()
+    {
+        bytes += w.size();
+        w.clear();
+    }
+};
+
+//! SvgWriter с подсчётом габаритов
+struct SvgBoundsSink
+{
+    static const char* name() { return "SvgBoundsStream"; }
+
+    SvgWriter                   w;
+    SvgBoundsStream<SvgWriter>  bs{w};
+    std::uint64_t               bytes = 0;
+
+    SvgBoundsStream<SvgWriter>& stream() { return bs; }
+
+    void flush()
+    {
+        bytes += w.size();
+        w.clear();
+    }
+};
+
+//----------------------------------------------------------------------------
+template<typename SinkType, typename DrawFn>
+BenchResult runBench(const std::string &name, std::size_t nElements, DrawFn drawFn)
+{
+    SinkType sink;
+
+    // Прогрев - чтобы буферы приёмника уже были выделены
+    for(std::size_t i=0; i!=std::min(nElements, flushEveryElements); ++i)
+        drawFn(sink.stream(), i);
+    sink.flush();
+    sink.bytes = 0;
+
+    const std::uint64_t allocsBefore = g_allocationCounter.load();
+    const auto startTime = std::chrono::steady_clock::now();
+
+    for(std::size_t i=0; i!=nElements; ++i)
+    {
+        drawFn(sink.stream(), i);
+        if ((i+1)%flushEveryElements==0)
+            sink.flush();
+    }
+    sink.flush();
+
+    const auto endTime = std::chrono::steady_clock::now();
+    const std::uint64_t allocsAfter = g_allocationCounter.load();
+
+    const double ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(endTime-startTime).count());
+
+    BenchResult res;
+    res.name             = name;
+    res.sink             = SinkType::name();
+    res.elements         = nElements;
+    res.nsPerElement     = ns/double(nElements);
+    res.bytesPerElement  = double(sink.bytes)/double(nElements);
+    res.allocsPerElement = double(allocsAfter-allocsBefore)/double(nElements);
+    return res;
+}
+
+//----------------------------------------------------------------------------
+struct BenchCase
+{
+    std::string     name;
+    // Запускает кейс на обоих приёмниках
+    std::function<void(std::size_t, std::vector<BenchResult>&)> run;
+};
+
+template<typename DrawFn>
+BenchCase makeCase(const std::string &name, DrawFn drawFn)
+{
+    return BenchCase{ name
+                    , [name, drawFn](std::size_t nElements, std::vector<BenchResult> &results)
+                      {
+                          results.emplace_back(runBench<OstreamSink  >(name, nElements, drawFn));
+                          results.emplace_back(runBench<SvgWriterSink>(name, nElements, drawFn));
+                      }
+                    };
+}
+
+//----------------------------------------------------------------------------
+const std::string& labelText(std::size_t i)
+{
+    static const std::vector<std::string> labels = { "Control register"
+                                                   , "STATUS[31:16] - reserved"
+                                                   , "Q & A <draft>"
+                                                   , "\"quoted\" 'label'"
+                                                   , "A reasonably long label without any special characters at all"
+                                                   };
+    return labels[i%labels.size()];
+}
+
+int coord(std::size_t i, int mod)
+{
+    return int(i%std::size_t(mod));
+}
+
+std::vector<BenchCase> makeCases()
+{
+    std::vector<BenchCase> cases;
+
+    cases.emplace_back(makeCase("escapeText", [](auto &oss, std::size_t i)
+    {
+        oss << escapeText(labelText(i));
+    }));
+
+    cases.emplace_back(makeCase("escapeText/view", [](auto &oss, std::size_t i)
+    {
+        thread_local std::string buf;
+        oss << escapeText(std::string_view(labelText(i)), buf);
+    }));
+
+    cases.emplace_back(makeCase("writeEscapedText", [](auto &oss, std::size_t i)
+    {
+        writeEscapedText(oss, labelText(i));
+    }));
+
+    for(unsigned f=0; f!=16; ++f)
+    {
+        const RoundRectFlags flags = RoundRectFlags(f);
+        cases.emplace_back(makeCase("drawRectEx/flags=" + std::to_string(f), [flags](auto &oss, std::size_t i)
+        {
+            drawRectEx(oss, coord(i, 1000), coord(i, 700), 120, 40, 8, 2, "#1f77b4", (i&1) ? "#aec7e8" : "", flags);
+        }));
+    }
+
+    cases.emplace_back(makeCase("drawRect/round", [](auto &oss, std::size_t i)
+    {
+        drawRect(oss, coord(i, 1000), coord(i, 700), 120, 40, "cell", true, true, 6);
+    }));
+
+    cases.emplace_back(makeCase("drawRect/square", [](auto &oss, std::size_t i)
+    {
+        drawRect(oss, coord(i, 1000), coord(i, 700), 120, 40, "cell", false, false, 6);
+    }));
+
+    cases.emplace_back(makeCase("drawRect/roundLeft", [](auto &oss, std::size_t i)
+    {
+        drawRect(oss, coord(i, 1000), coord(i, 700), 120, 40, "cell", true, false, 6);
+    }));
+
+    cases.emplace_back(makeCase("drawRect/roundRight", [](auto &oss, std::size_t i)
+    {
+        drawRect(oss, coord(i, 1000), coord(i, 700), 120, 40, "cell", false, true, 6);
+    }));
+
+    cases.emplace_back(makeCase("drawLine/class", [](auto &oss, std::size_t i)
+    {
+        drawLine(oss, coord(i, 1000), coord(i, 700), coord(i+7, 1000), coord(i+3, 700), "wire");
+    }));
+
+    cases.emplace_back(makeCase("drawLine/styled", [](auto &oss, std::size_t i)
+    {
+        drawLine(oss, coord(i, 1000), coord(i, 700), coord(i+7, 1000), coord(i+3, 700), 1, "black");
+    }));
+
+    cases.emplace_back(makeCase("drawLine/styled/enum", [](auto &oss, std::size_t i)
+    {
+        drawLine(oss, coord(i, 1000), coord(i, 700), coord(i+7, 1000), coord(i+3, 700), 1, "black", LineJoin::round);
+    }));
+
+    cases.emplace_back(makeCase("drawLine/double", [](auto &oss, std::size_t i)
+    {
+        drawLine(oss, coord(i, 1000)*0.25, coord(i, 700)*0.5, coord(i+7, 1000)/3.0, coord(i+3, 700)+0.125, "wire");
+    }));
+
+    cases.emplace_back(makeCase("drawRectEx/double", [](auto &oss, std::size_t i)
+    {
+        drawRectEx(oss, coord(i, 1000)*0.25, coord(i, 700)*0.5, 120.5, 40.25, 8.0, 2, "#1f77b4", "", RoundRectFlags::round);
+    }));
+
+    cases.emplace_back(makeCase("drawRectEx/fixed16", [](auto &oss, std::size_t i)
+    {
+        drawRectEx(oss, SvgFixed16::fromRaw(int(i%65536000)), SvgFixed16(coord(i, 700)), SvgFixed16(120.5), SvgFixed16(40.25), SvgFixed16(8), 2, "#1f77b4", "", RoundRectFlags::round);
+    }));
+
+    cases.emplace_back(makeCase("drawText", [](auto &oss, std::size_t i)
+    {
+        drawText(oss, coord(i, 1000), coord(i, 700), labelText(i), "label");
+    }));
+
+    cases.emplace_back(makeCase("drawText/enum", [](auto &oss, std::size_t i)
+    {
+        drawText(oss, coord(i, 1000), coord(i, 700), labelText(i), "label", DominantBaseline::middle, TextAnchor::middle);
+    }));
+
+    cases.emplace_back(makeCase("path/class", [](auto &oss, std::size_t i)
+    {
+        pathStart(oss, coord(i, 1000), coord(i, 700), "trace", true);
+        pathLineTo(oss, 10, 5);
+        pathHorzLineTo(oss, 20);
+        pathVertLineTo(oss, -5);
+        pathQuadraticBezier(oss, 5, 0, 5, 5);
+        pathEnd(oss, false);
+    }));
+
+    cases.emplace_back(makeCase("path/styled", [](auto &oss, std::size_t i)
+    {
+        pathStart(oss, coord(i, 1000), coord(i, 700), 2, "red", "yellow", "round", true);
+        pathLineTo(oss, 10, 5);
+        pathHorzLineTo(oss, 20);
+        pathVertLineTo(oss, -5);
+        pathQuadraticBezier(oss, 5, 0, 5, 5);
+        pathEnd(oss, true);
+    }));
+
+    cases.emplace_back(makeCase("drawRectEx/styleRegistry", [](auto &oss, std::size_t i)
+    {
+        static SvgStyleRegistry styles;
+        drawRectEx(oss, coord(i, 1000), coord(i, 700), 120, 40, 8, styles, 2, "#1f77b4", (i&1) ? "#aec7e8" : "", RoundRectFlags::round);
+    }));
+
+    cases.emplace_back(makeCase("drawRectEx/compact", [](auto &oss, std::size_t i)
+    {
+        CompactPathStream<std::decay_t<decltype(oss)>> cps(oss);
+        drawRectEx(cps, coord(i, 1000), coord(i, 700), 120, 40, 8, 2, "#1f77b4", "", RoundRectFlags::round);
+    }));
+
+    cases.emplace_back(makeCase("drawRectEx/instanced", [](auto &oss, std::size_t i)
+    {
+        static SvgShapeInstancer shapes;
+        drawRectEx(oss, coord(i, 1000), coord(i, 700), 120, 40, 8, shapes, 2, "#1f77b4", (i&1) ? "#aec7e8" : "", RoundRectFlags::round);
+    }));
+
+    cases.emplace_back(makeCase("path/compact", [](auto &oss, std::size_t i)
+    {
+        CompactPathStream<std::decay_t<decltype(oss)>> cps(oss);
+        pathStart(cps, coord(i, 1000), coord(i, 700), "trace", true);
+        pathLineTo(cps, 10, 5);
+        pathHorzLineTo(cps, 20);
+        pathVertLineTo(cps, -5);
+        pathQuadraticBezier(cps, 5, 0, 5, 5);
+        pathEnd(cps, false);
+    }));
+
+    // Пакетные варианты: элементы копятся и выводятся по batchSize штук одним <path>
+    constexpr std::size_t batchSize = 64;
+
+    cases.emplace_back(makeCase("drawRects/batch", [](auto &oss, std::size_t i)
+    {
+        static SvgRect rects[batchSize];
+        rects[i%batchSize] = SvgRect{ coord(i, 1000), coord(i, 700), 120, 40 };
+        if (i%batchSize==batchSize-1)
+            drawRects(oss, rects, batchSize, "cell");
+    }));
+
+    cases.emplace_back(makeCase("drawLines/batch", [](auto &oss, std::size_t i)
+    {
+        static SvgLine lines[batchSize];
+        lines[i%batchSize] = SvgLine{ coord(i, 1000), coord(i, 700), coord(i+7, 1000), coord(i+3, 700) };
+        if (i%batchSize==batchSize-1)
+            drawLines(oss, lines, batchSize, "wire");
+    }));
+
+    // Параллельная генерация: весь результат держится в памяти, поэтому не больше maxParallelElements
+    constexpr std::size_t maxParallelElements = 1000000;
+
+    const unsigned hwThreads = std::max(1u, std::thread::hardware_concurrency());
+    for(unsigned nThreads=1; nThreads<=hwThreads; nThreads*=2)
+    {
+        const std::string name = "parallel/drawRectEx/t=" + std::to_string(nThreads);
+        cases.emplace_back(BenchCase{ name
+                                    , [name, nThreads](std::size_t nElements, std::vector<BenchResult> &results)
+                                      {
+                                          if (nElements>maxParallelElements)
+                                              return;
+
+                                          auto drawFn = [](SvgWriter &oss, std::size_t i)
+                                          {
+                                              drawRectEx(oss, coord(i, 1000), coord(i, 700), 120, 40, 8, 2, "#1f77b4", (i&1) ? "#aec7e8" : "", RoundRectFlags::round);
+                                              drawText(oss, coord(i, 1000)+4, coord(i, 700)+20, labelText(i), "label");
+                                          };
+
+                                          SvgParallelWriter pw(nThreads);
+                                          pw.generate(nElements, drawFn); // Прогрев - буферы кусков уже выделены
+
+                                          const std::uint64_t allocsBefore = g_allocationCounter.load();
+                                          const auto startTime = std::chrono::steady_clock::now();
+                                          pw.generate(nElements, drawFn);
+                                          const auto endTime = std::chrono::steady_clock::now();
+                                          const std::uint64_t allocsAfter = g_allocationCounter.load();
+
+                                          BenchResult res;
+                                          res.name             = name;
+                                          res.sink             = "SvgParallelWriter";
+                                          res.elements         = nElements;
+                                          res.nsPerElement     = double(std::chrono::duration_cast<std::chrono::nanoseconds>(endTime-startTime).count())/double(nElements);
+                                          res.bytesPerElement  = double(pw.size())/double(nElements);
+                                          res.allocsPerElement = double(allocsAfter-allocsBefore)/double(nElements);
+                                          results.emplace_back(res);
+                                      }
+                                    });
+    }
+
+    // Потоковое сжатие: bytes/element - размер сжатого вывода
+    const std::string svgzName = "svgz/drawRectEx/level=" + std::to_string(MARTY_SVG_SVGZ_DEFAULT_LEVEL);
+    cases.emplace_back(BenchCase{ svgzName
+                                , [name=svgzName](std::size_t nElements, std::vector<BenchResult> &results)
+                                  {
+                                      std::uint64_t compressedBytes = 0;
+                                      SvgzWriter<> z([&](const char*, std::size_t size) { compressedBytes += size; });
+
+                                      const std::uint64_t allocsBefore = g_allocationCounter.load();
+                                      const auto startTime = std::chrono::steady_clock::now();
+                                      for(std::size_t i=0; i!=nElements; ++i)
+                                          drawRectEx(z.writer(), coord(i, 1000), coord(i, 700), 120, 40, 8, 2, "#1f77b4", (i&1) ? "#aec7e8" : "", RoundRectFlags::round);
+                                      z.finish();
+                                      const auto endTime = std::chrono::steady_clock::now();
+                                      const std::uint64_t allocsAfter = g_allocationCounter.load();
+
+                                      BenchResult res;
+                                      res.name             = name;
+                                      res.sink             = "SvgzWriter";
+                                      res.elements         = nElements;
+                                      res.nsPerElement     = double(std::chrono::duration_cast<std::chrono::nanoseconds>(endTime-startTime).count())/double(nElements);
+                                      res.bytesPerElement  = double(compressedBytes)/double(nElements);
+                                      res.allocsPerElement = double(allocsAfter-allocsBefore)/double(nElements);
+                                      results.emplace_back(res);
+                                  }
+                                });
+
+    // Стоимость подсчёта габаритов - сравнивать с drawRectEx/flags=15 на SvgWriter
+    cases.emplace_back(BenchCase{ "bounds/drawRectEx"
+                                , [](std::size_t nElements, std::vector<BenchResult> &results)
+                                  {
+                                      results.emplace_back(runBench<SvgBoundsSink>( "bounds/drawRectEx", nElements
+                                                                                  , [](auto &oss, std::size_t i)
+                                                                                    {
+                                                                                        drawRectEx(oss, coord(i, 1000), coord(i, 700), 120, 40, 8, 2, "#1f77b4", (i&1) ? "#aec7e8" : "", RoundRectFlags::round);
+                                                                                    }
+                                                                                  ));
+                                  }
+                                });
+
+    // Покадровый diff: второй кадр, изменён каждый сотый элемент; bytes/element - размер патча
+    cases.emplace_back(BenchCase{ "diff/drawRectEx/1%"
+                                , [](std::size_t nElements, std::vector<BenchResult> &results)
+                                  {
+                                      std::vector<std::string> ids(nElements);
+                                      for(std::size_t i=0; i!=nElements; ++i)
+                                          ids[i] = "e" + std::to_string(i);
+
+                                      SvgFrameDiff diff;
+                                      SvgWriter    patch;
+                                      auto frame = [&](bool changes)
+                                      {
+                                          diff.beginFrame();
+                                          for(std::size_t i=0; i!=nElements; ++i)
+                                          {
+                                              const bool changed = changes && i%100==0;
+                                              diff.element(patch, ids[i], [&](auto &oss)
+                                                                          {
+                                                                              drawRectEx(oss, coord(i, 1000), coord(i, 700), 120, 40, 8, 2, changed ? "#d62728" : "#1f77b4", "", RoundRectFlags::round);
+                                                                          });
+                                          }
+                                          diff.endFrame(patch);
+                                      };
+
+                                      frame(false);
+                                      patch.clear();
+
+                                      const std::uint64_t allocsBefore = g_allocationCounter.load();
+                                      const auto startTime = std::chrono::steady_clock::now();
+                                      frame(true);
+                                      const auto endTime = std::chrono::steady_clock::now();
+                                      const std::uint64_t allocsAfter = g_allocationCounter.load();
+
+                                      BenchResult res;
+                                      res.name             = "diff/drawRectEx/1%";
+                                      res.sink             = "SvgFrameDiff";
+                                      res.elements         = nElements;
+                                      res.nsPerElement     = double(std::chrono::duration_cast<std::chrono::nanoseconds>(endTime-startTime).count())/double(nElements);
+                                      res.bytesPerElement  = double(patch.size())/double(nElements);
+                                      res.allocsPerElement = double(allocsAfter-allocsBefore)/double(nElements);
+                                      results.emplace_back(res);
+                                  }
+                                });
+
+    // Выдача по запросу в буфер фиксированного размера
+    cases.emplace_back(BenchCase{ "stream/drawRectEx"
+                                , [](std::size_t nElements, std::vector<BenchResult> &results)
+                                  {
+                                      SvgStreamProducer producer( 10000, 10000, "<style></style>", nElements
+                                                                , [](SvgWriter &oss, std::size_t i)
+                                                                  {
+                                                                      drawRectEx(oss, coord(i, 1000), coord(i, 700), 120, 40, 8, 2, "#1f77b4", (i&1) ? "#aec7e8" : "", RoundRectFlags::round);
+                                                                  }
+                                                                );
+                                      char buf[16384];
+                                      std::uint64_t bytes = 0;
+
+                                      const std::uint64_t allocsBefore = g_allocationCounter.load();
+                                      const auto startTime = std::chrono::steady_clock::now();
+                                      while(std::size_t n = producer.read(&buf[0], sizeof(buf)))
+                                          bytes += n;
+                                      const auto endTime = std::chrono::steady_clock::now();
+                                      const std::uint64_t allocsAfter = g_allocationCounter.load();
+
+                                      BenchResult res;
+                                      res.name             = "stream/drawRectEx";
+                                      res.sink             = "SvgStreamProducer";
+                                      res.elements         = nElements;
+                                      res.nsPerElement     = double(std::chrono::duration_cast<std::chrono::nanoseconds>(endTime-startTime).count())/double(nElements);
+                                      res.bytesPerElement  = double(bytes)/double(nElements);
+                                      res.allocsPerElement = double(allocsAfter-allocsBefore)/double(nElements);
+                                      results.emplace_back(res);
+                                  }
+                                });
+
+    // Превью: растеризация документа в 560x370 и PNG; bytes/element - размер PNG
+    cases.emplace_back(BenchCase{ "raster/drawRectEx/png"
+                                , [](std::size_t nElements, std::vector<BenchResult> &results)
+                                  {
+                                      SvgDocument doc;
+                                      for(std::size_t i=0; i!=nElements; ++i)
+                                          doc.drawRectEx(coord(i, 1000), coord(i, 700), 120, 40, 8, 2, "#1f77b4", (i&1) ? "#aec7e8" : "", RoundRectFlags::round);
+
+                                      const std::uint64_t allocsBefore = g_allocationCounter.load();
+                                      const auto startTime = std::chrono::steady_clock::now();
+                                      const SvgRasterImage img = rasterizeDocument(doc, 0, 0, 1120, 740, 560, 370);
+                                      SvgWriter png;
+                                      writePng(png, img);
+                                      const auto endTime = std::chrono::steady_clock::now();
+                                      const std::uint64_t allocsAfter = g_allocationCounter.load();
+
+                                      BenchResult res;
+                                      res.name             = "raster/drawRectEx/png";
+                                      res.sink             = "SvgRasterizer";
+                                      res.elements         = nElements;
+                                      res.nsPerElement     = double(std::chrono::duration_cast<std::chrono::nanoseconds>(endTime-startTime).count())/double(nElements);
+                                      res.bytesPerElement  = double(png.size())/double(nElements);
+                                      res.allocsPerElement = double(allocsAfter-allocsBefore)/double(nElements);
+                                      results.emplace_back(res);
+                                  }
+                                });
+
+    // Повторное чтение: разбор документа и данных путей; bytes/element - размер входа
+    cases.emplace_back(BenchCase{ "parse/drawRectEx"
+                                , [](std::size_t nElements, std::vector<BenchResult> &results)
+                                  {
+                                      SvgWriter doc;
+                                      writeSvgHeader(doc, 0, 0, 1120, 740, "");
+                                      for(std::size_t i=0; i!=nElements; ++i)
+                                          drawRectEx(doc, coord(i, 1000), coord(i, 700), 120, 40, 8, 2, "#1f77b4", (i&1) ? "#aec7e8" : "", RoundRectFlags::round);
+                                      writeSvgFooter(doc);
+
+                                      std::size_t        segments = 0;
+                                      SvgPathDataSegment seg;
+
+                                      const std::uint64_t allocsBefore = g_allocationCounter.load();
+                                      const auto startTime = std::chrono::steady_clock::now();
+                                      SvgPullParser parser(doc.view());
+                                      for(auto ev=parser.next(); ev!=SvgXmlEvent::end && ev!=SvgXmlEvent::error; ev=parser.next())
+                                      {
+                                          if (ev==SvgXmlEvent::startElement && parser.name()=="path")
+                                          {
+                                              SvgPathDataParser pdp(parser.attribute("d"));
+                                              while(pdp.next(seg))
+                                                  ++segments;
+                                          }
+                                      }
+                                      const auto endTime = std::chrono::steady_clock::now();
+                                      const std::uint64_t allocsAfter = g_allocationCounter.load();
+
+                                      if (segments<nElements)
+                                          std::cerr << "parse/drawRectEx: unexpected segment count\n";
+
+                                      BenchResult res;
+                                      res.name             = "parse/drawRectEx";
+                                      res.sink             = "SvgPullParser";
+                                      res.elements         = nElements;
+                                      res.nsPerElement     = double(std::chrono::duration_cast<std::chrono::nanoseconds>(endTime-startTime).count())/double(nElements);
+                                      res.bytesPerElement  = double(doc.size())/double(nElements);
+                                      res.allocsPerElement = double(allocsAfter-allocsBefore)/double(nElements);
+                                      results.emplace_back(res);
+                                  }
+                                });
+
+    // Ряд отсчётов на 1000 колонок: время и объём вывода на отсчёт, после прореживания
+    cases.emplace_back(BenchCase{ "series/drawSeries/1000px"
+                                , [](std::size_t nElements, std::vector<BenchResult> &results)
+                                  {
+                                      std::vector<float> samples(nElements);
+                                      for(std::size_t i=0; i!=nElements; ++i)
+                                          samples[i] = float(std::sin(double(i)*0.001)*200.0 + double(i%17));
+
+                                      SvgSeriesTransform transform;
+                                      transform.scaleX  = 1000.0/double(nElements);
+                                      transform.scaleY  = -1.0;
+                                      transform.offsetY = 300.0;
+
+                                      SvgPolylineSimplifier simplifier;
+                                      SvgWriter             oss;
+
+                                      const std::uint64_t allocsBefore = g_allocationCounter.load();
+                                      const auto startTime = std::chrono::steady_clock::now();
+                                      drawSeries(oss, simplifier, (const float*)nullptr, samples.data(), nElements, transform, SvgPathStyle(1, "#1f77b4"));
+                                      const auto endTime = std::chrono::steady_clock::now();
+                                      const std::uint64_t allocsAfter = g_allocationCounter.load();
+
+                                      BenchResult res;
+                                      res.name             = "series/drawSeries/1000px";
+                                      res.sink             = "SvgWriter";
+                                      res.elements         = nElements;
+                                      res.nsPerElement     = double(std::chrono::duration_cast<std::chrono::nanoseconds>(endTime-startTime).count())/double(nElements);
+                                      res.bytesPerElement  = double(oss.size())/double(nElements);
+                                      res.allocsPerElement = double(allocsAfter-allocsBefore)/double(nElements);
+                                      results.emplace_back(res);
+                                  }
+                                });
+
+    // Измерение подписей: 1000 разных строк по кругу, без кэша и с кэшем (в том числе для коротких строк)
+    cases.emplace_back(BenchCase{ "text/measureText"
+                                , [](std::size_t nElements, std::vector<BenchResult> &results)
+                                  {
+                                      std::vector<std::string> labels;
+                                      for(std::size_t i=0; i!=1000; ++i)
+                                          labels.emplace_back("Label number " + std::to_string(i));
+
+                                      const SvgFontRegistry fonts;
+                                      const std::size_t     fontIdx = fonts.findFont("Arial, sans-serif");
+
+                                      for(std::size_t cacheMinLength : { std::size_t(-1), SvgTextMeasurer::defaultCacheMinLength, std::size_t(0) })
+                                      {
+                                          SvgTextMeasurer measurer(fonts, 4096, cacheMinLength);
+                                          double widthSum = 0.0;
+
+                                          const std::uint64_t allocsBefore = g_allocationCounter.load();
+                                          const auto startTime = std::chrono::steady_clock::now();
+                                          for(std::size_t i=0; i!=nElements; ++i)
+                                              widthSum += measurer.measureText(labels[i%labels.size()], fontIdx, 12.0).width;
+                                          const auto endTime = std::chrono::steady_clock::now();
+                                          const std::uint64_t allocsAfter = g_allocationCounter.load();
+
+                                          if (widthSum<=0.0)
+                                              std::cerr << "text/measureText: unexpected width\n";
+
+                                          BenchResult res;
+                                          res.name             = "text/measureText";
+                                          res.sink             = cacheMinLength==std::size_t(-1) ? "nocache" : (cacheMinLength ? "cache/len>=32" : "cache/all");
+                                          res.elements         = nElements;
+                                          res.nsPerElement     = double(std::chrono::duration_cast<std::chrono::nanoseconds>(endTime-startTime).count())/double(nElements);
+                                          res.bytesPerElement  = 0.0;
+                                          res.allocsPerElement = double(allocsAfter-allocsBefore)/double(nElements);
+                                          results.emplace_back(res);
+                                      }
+                                  }
+                                });
+
+    // Тайлы 1000x1000 с буфером 1 МБ; bytes/element - суммарный объём всех тайлов
+    cases.emplace_back(BenchCase{ "tiles/drawRectEx/1000px"
+                                , [](std::size_t nElements, std::vector<BenchResult> &results)
+                                  {
+                                      std::size_t tileBytes = 0;
+                                      SvgTileWriter tiles( 1000, 1000, ""
+                                                         , [&](const SvgTileInfo&, std::string_view data) { tileBytes += data.size(); }
+                                                         , 1024u*1024u
+                                                         );
+
+                                      const std::uint64_t allocsBefore = g_allocationCounter.load();
+                                      const auto startTime = std::chrono::steady_clock::now();
+                                      for(std::size_t i=0; i!=nElements; ++i)
+                                          tiles.element([&](auto &oss) { drawRectEx(oss, coord(i, 10000), coord(i, 7000), 120, 40, 8, 2, "#1f77b4", "", RoundRectFlags::round); });
+                                      tiles.finish();
+                                      const auto endTime = std::chrono::steady_clock::now();
+                                      const std::uint64_t allocsAfter = g_allocationCounter.load();
+
+                                      BenchResult res;
+                                      res.name             = "tiles/drawRectEx/1000px";
+                                      res.sink             = "SvgTileWriter";
+                                      res.elements         = nElements;
+                                      res.nsPerElement     = double(std::chrono::duration_cast<std::chrono::nanoseconds>(endTime-startTime).count())/double(nElements);
+                                      res.bytesPerElement  = double(tileBytes)/double(nElements);
+                                      res.allocsPerElement = double(allocsAfter-allocsBefore)/double(nElements);
+                                      results.emplace_back(res);
+                                  }
+                                });
+
+    return cases;
+}
+
+//----------------------------------------------------------------------------
+std::string jsonEscape(const std::string &str)
+{
+    std::string res;
+    for(char ch : str)
+    {
+        if (ch=='\"' || ch=='\\')
+            res.append(1, '\\');
+        res.append(1, ch);
+    }
+    return res;
+}
+
+void writeJson(std::ostream &os, const std::vector<BenchResult> &results)
+{
+    os << "{\n  \"benchmarks\": [\n";
+    for(std::size_t i=0; i!=results.size(); ++i)
+    {
+        const auto &r = results[i];
+        os << "    { \"name\": \"" << jsonEscape(r.name) << "\""
+           << ", \"sink\": \"" << r.sink << "\""
+           << ", \"elements\": " << r.elements
+           << ", \"ns_per_element\": " << r.nsPerElement
+           << ", \"bytes_per_element\": " << r.bytesPerElement
+           << ", \"allocs_per_element\": " << r.allocsPerElement
+           << " }" << (i+1!=results.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n}\n";
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    std::size_t maxElements = 10000000;
+    std::string filter;
+    std::string jsonName    = "marty_svg_bench.json";
+
+    for(int i=1; i<argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg=="--max-elements" && i+1<argc)
+            maxElements = std::size_t(std::strtoull(argv[++i], nullptr, 10));
+        else if (arg=="--filter" && i+1<argc)
+            filter = argv[++i];
+        else if (arg=="--json" && i+1<argc)
+            jsonName = argv[++i];
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--max-elements N] [--filter substr] [--json file.json]\n";
+            return 1;
+        }
+    }
+
+    std::vector<BenchResult> results;
+
+    std::printf("%-28s %-18s %10s %12s %12s %12s\n", "case", "sink", "elements", "ns/elem", "bytes/elem", "allocs/elem");
+
+    for(const auto &benchCase : makeCases())
+    {
+        if (!filter.empty() && benchCase.name.find(filter)==benchCase.name.npos)
+            continue;
+
+        for(std::size_t nElements=1000; nElements<=maxElements; nElements*=10)
+        {
+            const std::size_t firstIdx = results.size();
+            benchCase.run(nElements, results);
+
+            for(std::size_t i=firstIdx; i!=results.size(); ++i)
+            {
+                const auto &r = results[i];
+                std::printf( "%-28s %-18s %10zu %12.2f %12.2f %12.4f\n"
+                           , r.name.c_str(), r.sink.c_str(), r.elements
+                           , r.nsPerElement, r.bytesPerElement, r.allocsPerElement
+                           );
+            }
+        }
+    }
+
+    std::ofstream jsonFile(jsonName);
+    if (!jsonFile)
+    {
+        std::cerr << "Failed to open " << jsonName << "\n";
+        return 2;
+    }
+
+    writeJson(jsonFile, results);
+    std::cout << "Results written to " << jsonName << "\n";
+
+    const auto instrReport = marty::svg::instrumentationReport();
+    if (instrReport.enabled)
+    {
+        std::cout << "\n";
+        marty::svg::writeInstrumentationReport(std::cout, instrReport);
+    }
+
+    return 0;
+}
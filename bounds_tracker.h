@@ -0,0 +1,391 @@
+/*! \file
+    \brief Подсчёт габаритов выводимого за один проход - для viewBox без предварительного обмера диаграммы
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include "marty_svg.h"
+#include "svg_box.h"
+//
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <string_view>
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/bounds_tracker.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+//! Накопитель габаритов выведенных элементов, с учётом толщины линии
+/*! Оценка для фигур точная:
+    - обводка расширяет фигуру на половину толщины линии;
+    - у путей с linejoin miter, у которых есть не параллельные осям участки, углы могут выступать
+      на величину miter-limit (4 по умолчанию), поэтому запас - две толщины линии; пути из
+      участков вдоль осей (в том числе скруглённые углы drawRectEx) выступают только на половину;
+    - квадратичные кривые учитываются по их экстремумам.
+
+    Текст оценивается сверху: ширина - SvgBoundsOptions::textCharWidth на символ UTF-8, высота -
+    textHeight, с учётом text-anchor и dominant-baseline.
+ */
+class SvgBoundsTracker
+{
+
+public:
+
+    explicit SvgBoundsTracker(const SvgBoundsOptions &opts=SvgBoundsOptions())
+    : m_opts(opts)
+    {}
+
+    const SvgBoundsOptions& options() const { return m_opts; }
+
+    bool empty() const { return m_minX>m_maxX; }
+
+    //! Габариты в целых координатах, с округлением наружу
+    SvgBox box() const
+    {
+        SvgBox res;
+        if (empty())
+            return res;
+        res.minX = int(std::floor(m_minX));
+        res.minY = int(std::floor(m_minY));
+        res.maxX = int(std::ceil (m_maxX));
+        res.maxY = int(std::ceil (m_maxY));
+        return res;
+    }
+
+    void clear()
+    {
+        *this = SvgBoundsTracker(m_opts);
+    }
+
+    //! Область, расширенная на pad во все стороны
+    void addBox(double x0, double y0, double x1, double y1, double pad)
+    {
+        m_minX = std::min(m_minX, std::min(x0, x1)-pad);
+        m_minY = std::min(m_minY, std::min(y0, y1)-pad);
+        m_maxX = std::max(m_maxX, std::max(x0, x1)+pad);
+        m_maxY = std::max(m_maxY, std::max(y0, y1)+pad);
+    }
+
+    void addRect(double posX, double posY, double sizeX, double sizeY, int strokeWidth)
+    {
+        addBox(posX, posY, posX+sizeX, posY+sizeY, strokeHalf(strokeWidth));
+    }
+
+    void addLine(double startX, double startY, double endX, double endY, int strokeWidth)
+    {
+        addBox(startX, startY, endX, endY, strokeHalf(strokeWidth));
+    }
+
+    void addText(double posX, double posY, std::string_view text, std::string_view baseLine, std::string_view hAlign)
+    {
+        std::size_t nChars = 0;
+        for(char ch : text)
+        {
+            if ((static_cast<unsigned char>(ch)&0xC0u)!=0x80u) // Продолжения UTF-8 не считаем
+                ++nChars;
+        }
+
+        const double w = double(nChars)*double(m_opts.textCharWidth);
+        const double h = double(m_opts.textHeight);
+
+        double x0 = posX;
+        if (hAlign=="middle")
+            x0 -= w/2;
+        else if (hAlign=="end")
+            x0 -= w;
+
+        double y0 = posY-h*0.8; // auto/alphabetic - под базовой линией остаётся место на нижние выносные
+        if (baseLine=="hanging" || baseLine=="text-top")
+            y0 = posY;
+        else if (baseLine=="middle" || baseLine=="central" || baseLine=="mathematical")
+            y0 = posY-h/2;
+        else if (baseLine=="text-bottom" || baseLine=="ideographic")
+            y0 = posY-h;
+
+        addBox(x0, y0, x0+w, y0+h, 0);
+    }
+
+    //------------------------------
+    void pathStart(double posX, double posY, bool /* bAbs */, int strokeWidth, std::string_view linejoin)
+    {
+        // Первый moveto пути отсчитывается от начала координат в обоих вариантах
+        m_curX  = m_startX = posX;
+        m_curY  = m_startY = posY;
+
+        m_pathMinX = m_pathMaxX = posX;
+        m_pathMinY = m_pathMaxY = posY;
+
+        m_pathStrokeHalf  = strokeHalf(strokeWidth);
+        m_pathMiter       = linejoin.empty() || linejoin=="miter" || linejoin=="miter-clip" || linejoin=="arcs";
+        m_pathRectilinear = true;
+    }
+
+    void pathLineTo(double posX, double posY, bool bAbs)
+    {
+        const double x = bAbs ? posX : m_curX+posX;
+        const double y = bAbs ? posY : m_curY+posY;
+        checkAxisAligned(x-m_curX, y-m_curY);
+        pathPoint(x, y);
+    }
+
+    void pathHorzLineTo(double posX, bool bAbs)
+    {
+        pathPoint(bAbs ? posX : m_curX+posX, m_curY);
+    }
+
+    void pathVertLineTo(double posY, bool bAbs)
+    {
+        pathPoint(m_curX, bAbs ? posY : m_curY+posY);
+    }
+
+    void pathQuadraticBezier(double cpX, double cpY, double endX, double endY, bool bAbs)
+    {
+        const double x0 = m_curX, y0 = m_curY;
+        const double x1 = bAbs ? cpX  : x0+cpX;
+        const double y1 = bAbs ? cpY  : y0+cpY;
+        const double x2 = bAbs ? endX : x0+endX;
+        const double y2 = bAbs ? endY : y0+endY;
+
+        // Стыки определяются касательными на концах кривой
+        checkAxisAligned(x1-x0, y1-y0);
+        checkAxisAligned(x2-x1, y2-y1);
+
+        double t = 0;
+        if (quadExtremum(x0, x1, x2, t))
+            pathExtend(quadValue(x0, x1, x2, t), quadValue(y0, y1, y2, t));
+        if (quadExtremum(y0, y1, y2, t))
+            pathExtend(quadValue(x0, x1, x2, t), quadValue(y0, y1, y2, t));
+
+        pathPoint(x2, y2);
+    }
+
+    void pathEnd(bool closePath)
+    {
+        if (closePath)
+            checkAxisAligned(m_startX-m_curX, m_startY-m_curY);
+
+        const double pad = (m_pathMiter && !m_pathRectilinear) ? 4*m_pathStrokeHalf : m_pathStrokeHalf;
+        addBox(m_pathMinX, m_pathMinY, m_pathMaxX, m_pathMaxY, pad);
+    }
+
+
+protected:
+
+    double strokeHalf(int strokeWidth) const
+    {
+        return double(strokeWidth<0 ? m_opts.classStrokeWidth : strokeWidth)/2;
+    }
+
+    void checkAxisAligned(double dx, double dy)
+    {
+        if (dx!=0 && dy!=0)
+            m_pathRectilinear = false;
+    }
+
+    void pathExtend(double x, double y)
+    {
+        m_pathMinX = std::min(m_pathMinX, x); m_pathMaxX = std::max(m_pathMaxX, x);
+        m_pathMinY = std::min(m_pathMinY, y); m_pathMaxY = std::max(m_pathMaxY, y);
+    }
+
+    void pathPoint(double x, double y)
+    {
+        pathExtend(x, y);
+        m_curX = x;
+        m_curY = y;
+    }
+
+    //! Параметр t экстремума квадратичной кривой по одной оси, если он внутри (0, 1)
+    static bool quadExtremum(double p0, double p1, double p2, double &t)
+    {
+        const double denom = p0-2*p1+p2;
+        if (denom==0)
+            return false;
+        t = (p0-p1)/denom;
+        return t>0 && t<1;
+    }
+
+    static double quadValue(double p0, double p1, double p2, double t)
+    {
+        const double mt = 1-t;
+        return mt*mt*p0 + 2*mt*t*p1 + t*t*p2;
+    }
+
+
+    SvgBoundsOptions    m_opts;
+
+    double              m_minX = HUGE_VAL;
+    double              m_minY = HUGE_VAL;
+    double              m_maxX = -HUGE_VAL;
+    double              m_maxY = -HUGE_VAL;
+
+    // Текущий путь
+    double              m_curX   = 0;
+    double              m_curY   = 0;
+    double              m_startX = 0;
+    double              m_startY = 0;
+    double              m_pathMinX = 0;
+    double              m_pathMinY = 0;
+    double              m_pathMaxX = 0;
+    double              m_pathMaxY = 0;
+    double              m_pathStrokeHalf  = 0;
+    bool                m_pathMiter       = true;
+    bool                m_pathRectilinear = true;
+
+}; // class SvgBoundsTracker
+
+//----------------------------------------------------------------------------
+//! Обёртка над потоком: вывод передаётся в исходный поток, геометрия примитивов - в SvgBoundsTracker
+/*! Примитивы marty_svg.h, batch_draw.h и shape_instancer.h сообщают свою геометрию через хуки
+    bounds*, для этой обёртки они перегружены; для остальных потоков хуки пустые и ничего не стоят.
+    Перегрузки передают хуки дальше во вложенный поток, остальные хуки передаются по умолчанию
+    (см. SvgStreamWrapper) - поэтому, например, SvgBoundsStream<CompactPathStream<SvgWriter>>
+    выводит компактные пути, а SvgBoundsStream<SvgIdStream<SvgWriter>> - id элементов.
+
+    \code
+    marty::svg::SvgWriter body;
+    marty::svg::SvgBoundsStream<marty::svg::SvgWriter> bs(body);
+    marty::svg::drawRectEx(bs, 10, 10, 120, 40, 8, 2, "black");
+    marty::svg::drawText(bs, 70, 30, "label", "lbl", "middle", "middle");
+    marty::svg::writeSvg(out, bs.box(), style, body.view(), 4);
+    \endcode
+ */
+template<typename StreamType>
+class SvgBoundsStream : public SvgStreamWrapper<SvgBoundsStream<StreamType>, StreamType>
+{
+
+public:
+
+    explicit SvgBoundsStream(StreamType &oss, const SvgBoundsOptions &opts=SvgBoundsOptions())
+    : SvgStreamWrapper<SvgBoundsStream<StreamType>, StreamType>(oss)
+    , m_tracker(opts)
+    {}
+
+    SvgBoundsTracker&       tracker()       { return m_tracker; }
+    const SvgBoundsTracker& tracker() const { return m_tracker; }
+
+    SvgBox box() const { return m_tracker.box(); }
+
+
+protected:
+
+    SvgBoundsTracker    m_tracker;
+
+}; // class SvgBoundsStream
+
+//----------------------------------------------------------------------------
+// Хуки учёта габаритов для SvgBoundsStream; после учёта хук передаётся во вложенный поток
+
+template<typename StreamType, typename CoordType> inline
+void boundsPathStart(SvgBoundsStream<StreamType> &oss, CoordType posX, CoordType posY, bool bAbs, int strokeWidth, std::string_view linejoin)
+{
+    oss.tracker().pathStart(coordToDouble(posX), coordToDouble(posY), bAbs, strokeWidth, linejoin);
+    boundsPathStart(oss.stream(), posX, posY, bAbs, strokeWidth, linejoin);
+}
+
+template<typename StreamType, typename CoordType> inline
+void boundsPathLineTo(SvgBoundsStream<StreamType> &oss, CoordType posX, CoordType posY, bool bAbs)
+{
+    oss.tracker().pathLineTo(coordToDouble(posX), coordToDouble(posY), bAbs);
+    boundsPathLineTo(oss.stream(), posX, posY, bAbs);
+}
+
+template<typename StreamType, typename CoordType> inline
+void boundsPathHorzLineTo(SvgBoundsStream<StreamType> &oss, CoordType posX, bool bAbs)
+{
+    oss.tracker().pathHorzLineTo(coordToDouble(posX), bAbs);
+    boundsPathHorzLineTo(oss.stream(), posX, bAbs);
+}
+
+template<typename StreamType, typename CoordType> inline
+void boundsPathVertLineTo(SvgBoundsStream<StreamType> &oss, CoordType posY, bool bAbs)
+{
+    oss.tracker().pathVertLineTo(coordToDouble(posY), bAbs);
+    boundsPathVertLineTo(oss.stream(), posY, bAbs);
+}
+
+template<typename StreamType, typename CoordType> inline
+void boundsPathQuadraticBezier(SvgBoundsStream<StreamType> &oss, CoordType cpX, CoordType cpY, CoordType endX, CoordType endY, bool bAbs)
+{
+    oss.tracker().pathQuadraticBezier(coordToDouble(cpX), coordToDouble(cpY), coordToDouble(endX), coordToDouble(endY), bAbs);
+    boundsPathQuadraticBezier(oss.stream(), cpX, cpY, endX, endY, bAbs);
+}
+
+template<typename StreamType> inline
+void boundsPathEnd(SvgBoundsStream<StreamType> &oss, bool closePath)
+{
+    oss.tracker().pathEnd(closePath);
+    boundsPathEnd(oss.stream(), closePath);
+}
+
+template<typename StreamType, typename CoordType> inline
+void boundsRect(SvgBoundsStream<StreamType> &oss, CoordType posX, CoordType posY, CoordType sizeX, CoordType sizeY, CoordType r, int strokeWidth)
+{
+    // Скругление углов габаритов не меняет
+    oss.tracker().addRect(coordToDouble(posX), coordToDouble(posY), coordToDouble(sizeX), coordToDouble(sizeY), strokeWidth);
+    boundsRect(oss.stream(), posX, posY, sizeX, sizeY, r, strokeWidth);
+}
+
+template<typename StreamType, typename CoordType> inline
+void boundsLine(SvgBoundsStream<StreamType> &oss, CoordType startX, CoordType startY, CoordType endX, CoordType endY, int strokeWidth)
+{
+    oss.tracker().addLine(coordToDouble(startX), coordToDouble(startY), coordToDouble(endX), coordToDouble(endY), strokeWidth);
+    boundsLine(oss.stream(), startX, startY, endX, endY, strokeWidth);
+}
+
+template<typename StreamType, typename CoordType> inline
+void boundsText(SvgBoundsStream<StreamType> &oss, CoordType posX, CoordType posY, std::string_view text, std::string_view baseLine, std::string_view hAlign)
+{
+    oss.tracker().addText(coordToDouble(posX), coordToDouble(posY), text, baseLine, hAlign);
+    boundsText(oss.stream(), posX, posY, text, baseLine, hAlign);
+}
+
+//----------------------------------------------------------------------------
+//! writeSvg с viewBox по габаритам, расширенным на margin со всех сторон
+template<typename StreamType>
+void writeSvg( StreamType &oss
+             , SvgBox viewBox
+             , std::string_view style
+             , std::string_view text
+             , int margin=0
+             )
+{
+    if (viewBox.empty())
+        viewBox = SvgBox::fromRect(0, 0, 0, 0);
+    viewBox.inflate(margin);
+    writeSvg(oss, viewBox.minX, viewBox.minY, viewBox.sizeX(), viewBox.sizeY(), style, text);
+}
+
+//----------------------------------------------------------------------------
+//! Документ за один проход: тело выводится drawFn(SvgBoundsStream<SvgWriter>&), заголовок - после, по габаритам тела
+template<typename StreamType, typename DrawFn>
+void writeSvgAutoView( StreamType &oss
+                     , std::string_view style
+                     , DrawFn drawFn
+                     , int margin=0
+                     , const SvgBoundsOptions &opts=SvgBoundsOptions()
+                     )
+{
+    SvgWriter body;
+    SvgBoundsStream<SvgWriter> bs(body, opts);
+    drawFn(bs);
+    writeSvg(oss, bs.box(), style, body.view(), margin);
+}
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/bounds_tracker.h"
+
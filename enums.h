@@ -94,6 +94,125 @@ MARTY_CPP_ENUM_FLAGS_DESERIALIZE_BEGIN( RoundRectFlags, std::map, 1 )
     MARTY_CPP_ENUM_FLAGS_DESERIALIZE_ITEM( RoundRectFlags::round              , "round"              );
 MARTY_CPP_ENUM_FLAGS_DESERIALIZE_END( RoundRectFlags, std::map, 1 )
 
+//#!LineJoin
+enum class LineJoin : std::uint32_t
+{
+    invalid            = (std::uint32_t)(-1) /*!<  */,
+    unknown            = (std::uint32_t)(-1) /*!<  */,
+    miter              = 0x0000 /*!< Sharp corner, SVG default */,
+    round              = 0x0001 /*!< Round corner */,
+    bevel              = 0x0002 /*!< Bevelled corner */,
+    arcs               = 0x0003 /*!< Arcs corner (SVG 2) */,
+    miterClip          = 0x0004 /*!< Clipped miter corner (SVG 2) */
+
+}; // enum 
+//#!
+
+MARTY_CPP_MAKE_ENUM_IS_FLAGS_FOR_NON_FLAGS_ENUM(LineJoin)
+
+MARTY_CPP_ENUM_CLASS_SERIALIZE_BEGIN( LineJoin, std::map, 1 )
+    MARTY_CPP_ENUM_CLASS_SERIALIZE_ITEM( LineJoin::invalid            , "Invalid"   );
+    MARTY_CPP_ENUM_CLASS_SERIALIZE_ITEM( LineJoin::miter              , "Miter"     );
+    MARTY_CPP_ENUM_CLASS_SERIALIZE_ITEM( LineJoin::round              , "Round"     );
+    MARTY_CPP_ENUM_CLASS_SERIALIZE_ITEM( LineJoin::bevel              , "Bevel"     );
+    MARTY_CPP_ENUM_CLASS_SERIALIZE_ITEM( LineJoin::arcs               , "Arcs"      );
+    MARTY_CPP_ENUM_CLASS_SERIALIZE_ITEM( LineJoin::miterClip          , "MiterClip" );
+MARTY_CPP_ENUM_CLASS_SERIALIZE_END( LineJoin, std::map, 1 )
+
+MARTY_CPP_ENUM_CLASS_DESERIALIZE_BEGIN( LineJoin, std::map, 1 )
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( LineJoin::invalid            , "invalid"    );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( LineJoin::invalid            , "unknown"    );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( LineJoin::miter              , "miter"      );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( LineJoin::round              , "round"      );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( LineJoin::bevel              , "bevel"      );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( LineJoin::arcs               , "arcs"       );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( LineJoin::miterClip          , "miter-clip" );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( LineJoin::miterClip          , "miterclip"  );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( LineJoin::miterClip          , "miter_clip" );
+MARTY_CPP_ENUM_CLASS_DESERIALIZE_END( LineJoin, std::map, 1 )
+
+//#!DominantBaseline
+enum class DominantBaseline : std::uint32_t
+{
+    invalid            = (std::uint32_t)(-1) /*!<  */,
+    unknown            = (std::uint32_t)(-1) /*!<  */,
+    autoBaseline       = 0x0000 /*!< Baseline is taken from the parent, SVG default */,
+    textBottom         = 0x0001 /*!< Bottom of the em box */,
+    alphabetic         = 0x0002 /*!< Alphabetic baseline */,
+    ideographic        = 0x0003 /*!< Ideographic baseline */,
+    middle             = 0x0004 /*!< Middle of the x-height */,
+    central            = 0x0005 /*!< Center of the em box */,
+    mathematical       = 0x0006 /*!< Mathematical baseline */,
+    hanging            = 0x0007 /*!< Hanging baseline */,
+    textTop            = 0x0008 /*!< Top of the em box */
+
+}; // enum 
+//#!
+
+MARTY_CPP_MAKE_ENUM_IS_FLAGS_FOR_NON_FLAGS_ENUM(DominantBaseline)
+
+MARTY_CPP_ENUM_CLASS_SERIALIZE_BEGIN( DominantBaseline, std::map, 1 )
+    MARTY_CPP_ENUM_CLASS_SERIALIZE_ITEM( DominantBaseline::invalid            , "Invalid"      );
+    MARTY_CPP_ENUM_CLASS_SERIALIZE_ITEM( DominantBaseline::autoBaseline       , "AutoBaseline" );
+    MARTY_CPP_ENUM_CLASS_SERIALIZE_ITEM( DominantBaseline::textBottom         , "TextBottom"   );
+    MARTY_CPP_ENUM_CLASS_SERIALIZE_ITEM( DominantBaseline::alphabetic         , "Alphabetic"   );
+    MARTY_CPP_ENUM_CLASS_SERIALIZE_ITEM( DominantBaseline::ideographic        , "Ideographic"  );
+    MARTY_CPP_ENUM_CLASS_SERIALIZE_ITEM( DominantBaseline::middle             , "Middle"       );
+    MARTY_CPP_ENUM_CLASS_SERIALIZE_ITEM( DominantBaseline::central            , "Central"      );
+    MARTY_CPP_ENUM_CLASS_SERIALIZE_ITEM( DominantBaseline::mathematical       , "Mathematical" );
+    MARTY_CPP_ENUM_CLASS_SERIALIZE_ITEM( DominantBaseline::hanging            , "Hanging"      );
+    MARTY_CPP_ENUM_CLASS_SERIALIZE_ITEM( DominantBaseline::textTop            , "TextTop"      );
+MARTY_CPP_ENUM_CLASS_SERIALIZE_END( DominantBaseline, std::map, 1 )
+
+MARTY_CPP_ENUM_CLASS_DESERIALIZE_BEGIN( DominantBaseline, std::map, 1 )
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( DominantBaseline::invalid            , "invalid"       );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( DominantBaseline::invalid            , "unknown"       );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( DominantBaseline::autoBaseline       , "auto-baseline" );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( DominantBaseline::autoBaseline       , "autobaseline"  );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( DominantBaseline::autoBaseline       , "auto_baseline" );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( DominantBaseline::textBottom         , "text-bottom"   );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( DominantBaseline::textBottom         , "textbottom"    );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( DominantBaseline::textBottom         , "text_bottom"   );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( DominantBaseline::alphabetic         , "alphabetic"    );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( DominantBaseline::ideographic        , "ideographic"   );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( DominantBaseline::middle             , "middle"        );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( DominantBaseline::central            , "central"       );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( DominantBaseline::mathematical       , "mathematical"  );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( DominantBaseline::hanging            , "hanging"       );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( DominantBaseline::textTop            , "text-top"      );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( DominantBaseline::textTop            , "texttop"       );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( DominantBaseline::textTop            , "text_top"      );
+MARTY_CPP_ENUM_CLASS_DESERIALIZE_END( DominantBaseline, std::map, 1 )
+
+//#!TextAnchor
+enum class TextAnchor : std::uint32_t
+{
+    invalid            = (std::uint32_t)(-1) /*!<  */,
+    unknown            = (std::uint32_t)(-1) /*!<  */,
+    start              = 0x0000 /*!< Text starts at the anchor point, SVG default */,
+    middle             = 0x0001 /*!< Text is centered at the anchor point */,
+    end                = 0x0002 /*!< Text ends at the anchor point */
+
+}; // enum 
+//#!
+
+MARTY_CPP_MAKE_ENUM_IS_FLAGS_FOR_NON_FLAGS_ENUM(TextAnchor)
+
+MARTY_CPP_ENUM_CLASS_SERIALIZE_BEGIN( TextAnchor, std::map, 1 )
+    MARTY_CPP_ENUM_CLASS_SERIALIZE_ITEM( TextAnchor::invalid            , "Invalid" );
+    MARTY_CPP_ENUM_CLASS_SERIALIZE_ITEM( TextAnchor::start              , "Start"   );
+    MARTY_CPP_ENUM_CLASS_SERIALIZE_ITEM( TextAnchor::middle             , "Middle"  );
+    MARTY_CPP_ENUM_CLASS_SERIALIZE_ITEM( TextAnchor::end                , "End"     );
+MARTY_CPP_ENUM_CLASS_SERIALIZE_END( TextAnchor, std::map, 1 )
+
+MARTY_CPP_ENUM_CLASS_DESERIALIZE_BEGIN( TextAnchor, std::map, 1 )
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( TextAnchor::invalid            , "invalid" );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( TextAnchor::invalid            , "unknown" );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( TextAnchor::start              , "start"   );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( TextAnchor::middle             , "middle"  );
+    MARTY_CPP_ENUM_CLASS_DESERIALIZE_ITEM( TextAnchor::end                , "end"     );
+MARTY_CPP_ENUM_CLASS_DESERIALIZE_END( TextAnchor, std::map, 1 )
+
 } // namespace svg
 } // namespace marty
 
@@ -0,0 +1,806 @@
+/*! \file
+    \brief Метрики шрифтов (ширины символов) и измерение текста - для раскладки подписей без внешнего движка шрифтов
+
+    Встроены ширины стандартных шрифтов PostScript (Helvetica, Times-Roman, Courier, по AFM Adobe Core14)
+    для печатных символов ASCII; остальные шрифты и символы загружаются из AFM-файлов.
+    Кернинг и лигатуры не учитываются.
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include "svg_checksum.h"
+//
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/font_metrics.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+//! Размеры текста в единицах вывода
+struct SvgTextMetrics
+{
+    double  width   = 0.0;
+    double  ascent  = 0.0;  //!< Над базовой линией
+    double  descent = 0.0;  //!< Под базовой линией, положительное
+
+    double  height() const { return ascent+descent; }
+};
+
+//----------------------------------------------------------------------------
+//! Метрики одного шрифта, в единицах AFM (1000 на кегль)
+class SvgFontMetrics
+{
+
+public:
+
+    static constexpr int unitsPerEm = 1000;
+
+    SvgFontMetrics() = default;
+
+    SvgFontMetrics(std::string name, int ascent, int descent, int defaultWidth)
+    : m_name(std::move(name))
+    , m_ascent(ascent)
+    , m_descent(descent)
+    , m_defaultWidth(defaultWidth)
+    {}
+
+    const std::string& name() const { return m_name; }
+    int  ascent()       const { return m_ascent; }
+    int  descent()      const { return m_descent; }
+    int  defaultWidth() const { return m_defaultWidth; }
+
+    void setName(std::string name)      { m_name = std::move(name); }
+    void setAscent(int v)               { m_ascent = v; }
+    void setDescent(int v)              { m_descent = v < 0 ? -v : v; }
+    void setDefaultWidth(int v)         { m_defaultWidth = v; }
+
+    //! Ширина символа с кодом Unicode cp
+    void setAdvance(char32_t cp, int width)
+    {
+        if (cp<latinSize)
+        {
+            m_latin[cp] = std::uint16_t(width);
+            m_latinKnown[cp] = 1;
+        }
+        else
+        {
+            m_extra[cp] = width;
+        }
+    }
+
+    bool hasAdvance(char32_t cp) const
+    {
+        return cp<latinSize ? m_latinKnown[cp]!=0 : m_extra.find(cp)!=m_extra.end();
+    }
+
+    //! Ширина символа; неизвестные символы - defaultWidth, управляющие - 0
+    int advance(char32_t cp) const
+    {
+        if (cp<latinSize)
+            return m_latinKnown[cp] ? int(m_latin[cp]) : (cp<0x20u ? 0 : m_defaultWidth);
+
+        const auto it = m_extra.find(cp);
+        return it!=m_extra.end() ? it->second : m_defaultWidth;
+    }
+
+    //! Сумма ширин символов строки UTF-8 (некорректные байты считаются символами Latin-1)
+    std::int64_t textAdvance(std::string_view text) const
+    {
+        std::int64_t sum = 0;
+
+        const unsigned char *p    = reinterpret_cast<const unsigned char*>(text.data());
+        const unsigned char *pEnd = p+text.size();
+
+        while(p!=pEnd)
+        {
+            // ASCII - без декодирования
+            if (*p<0x80u)
+            {
+                sum += m_latinKnown[*p] ? int(m_latin[*p]) : (*p<0x20u ? 0 : m_defaultWidth);
+                ++p;
+                continue;
+            }
+
+            sum += advance(decodeUtf8(p, pEnd));
+        }
+
+        return sum;
+    }
+
+    //! Размеры строки для кегля fontSize
+    SvgTextMetrics measure(std::string_view text, double fontSize) const
+    {
+        return metricsFromAdvance(textAdvance(text), fontSize);
+    }
+
+    SvgTextMetrics metricsFromAdvance(std::int64_t advanceSum, double fontSize) const
+    {
+        const double scale = fontSize/double(unitsPerEm);
+
+        SvgTextMetrics res;
+        res.width   = double(advanceSum)*scale;
+        res.ascent  = double(m_ascent)*scale;
+        res.descent = double(m_descent)*scale;
+        return res;
+    }
+
+    //! Один символ UTF-8; p сдвигается за него
+    static char32_t decodeUtf8(const unsigned char *&p, const unsigned char *pEnd)
+    {
+        const unsigned char b0 = *p++;
+        if (b0<0x80u)
+            return b0;
+
+        std::size_t nCont = 0;
+        char32_t    cp    = 0;
+        if ((b0&0xE0u)==0xC0u)      { nCont = 1; cp = b0&0x1Fu; }
+        else if ((b0&0xF0u)==0xE0u) { nCont = 2; cp = b0&0x0Fu; }
+        else if ((b0&0xF8u)==0xF0u) { nCont = 3; cp = b0&0x07u; }
+        else
+            return b0;
+
+        if (std::size_t(pEnd-p)<nCont)
+            return b0;
+
+        for(std::size_t i=0; i!=nCont; ++i)
+        {
+            if ((p[i]&0xC0u)!=0x80u)
+                return b0;
+            cp = (cp<<6) | (p[i]&0x3Fu);
+        }
+
+        p += nCont;
+        return cp;
+    }
+
+
+protected:
+
+    static constexpr char32_t latinSize = 256;
+
+    std::string                             m_name;
+    int                                     m_ascent       = 750;
+    int                                     m_descent      = 250;
+    int                                     m_defaultWidth = 500;
+
+    std::uint16_t                           m_latin[latinSize]      = {};
+    unsigned char                           m_latinKnown[latinSize] = {};
+    std::unordered_map<char32_t, int>       m_extra;
+
+}; // class SvgFontMetrics
+
+//----------------------------------------------------------------------------
+//! Код Unicode по имени глифа PostScript; 0 - имя неизвестно
+/*! Подмножество Adobe Glyph List: ASCII, Latin-1 и символы AdobeStandardEncoding/WinAnsi вне Latin-1
+    (кавычки, тире, лигатуры fi/fl и т.п.), а также имена вида uniXXXX и uXXXX..uXXXXXX.
+ */
+inline
+char32_t glyphNameToUnicode(std::string_view name)
+{
+    struct Entry
+    {
+        std::string_view    name;
+        char32_t            codePoint;
+    };
+
+    // Отсортировано по имени (побайтно)
+    static constexpr Entry entries[] =
+    {
+    { "A", 0x0041 }, { "AE", 0x00C6 }, { "Aacute", 0x00C1 }, { "Acircumflex", 0x00C2 }, { "Adieresis", 0x00C4 },
+    { "Agrave", 0x00C0 }, { "Aring", 0x00C5 }, { "Atilde", 0x00C3 }, { "B", 0x0042 }, { "C", 0x0043 },
+    { "Ccedilla", 0x00C7 }, { "D", 0x0044 }, { "E", 0x0045 }, { "Eacute", 0x00C9 }, { "Ecircumflex", 0x00CA },
+    { "Edieresis", 0x00CB }, { "Egrave", 0x00C8 }, { "Eth", 0x00D0 }, { "Euro", 0x20AC }, { "F", 0x0046 },
+    { "G", 0x0047 }, { "H", 0x0048 }, { "I", 0x0049 }, { "Iacute", 0x00CD }, { "Icircumflex", 0x00CE },
+    { "Idieresis", 0x00CF }, { "Igrave", 0x00CC }, { "J", 0x004A }, { "K", 0x004B }, { "L", 0x004C },
+    { "Lslash", 0x0141 }, { "M", 0x004D }, { "N", 0x004E }, { "Ntilde", 0x00D1 }, { "O", 0x004F }, { "OE", 0x0152 },
+    { "Oacute", 0x00D3 }, { "Ocircumflex", 0x00D4 }, { "Odieresis", 0x00D6 }, { "Ograve", 0x00D2 },
+    { "Oslash", 0x00D8 }, { "Otilde", 0x00D5 }, { "P", 0x0050 }, { "Q", 0x0051 }, { "R", 0x0052 }, { "S", 0x0053 },
+    { "Scaron", 0x0160 }, { "T", 0x0054 }, { "Thorn", 0x00DE }, { "U", 0x0055 }, { "Uacute", 0x00DA },
+    { "Ucircumflex", 0x00DB }, { "Udieresis", 0x00DC }, { "Ugrave", 0x00D9 }, { "V", 0x0056 }, { "W", 0x0057 },
+    { "X", 0x0058 }, { "Y", 0x0059 }, { "Yacute", 0x00DD }, { "Ydieresis", 0x0178 }, { "Z", 0x005A },
+    { "Zcaron", 0x017D }, { "a", 0x0061 }, { "aacute", 0x00E1 }, { "acircumflex", 0x00E2 }, { "acute", 0x00B4 },
+    { "adieresis", 0x00E4 }, { "ae", 0x00E6 }, { "agrave", 0x00E0 }, { "ampersand", 0x0026 }, { "aring", 0x00E5 },
+    { "asciicircum", 0x005E }, { "asciitilde", 0x007E }, { "asterisk", 0x002A }, { "at", 0x0040 },
+    { "atilde", 0x00E3 }, { "b", 0x0062 }, { "backslash", 0x005C }, { "bar", 0x007C }, { "braceleft", 0x007B },
+    { "braceright", 0x007D }, { "bracketleft", 0x005B }, { "bracketright", 0x005D }, { "breve", 0x02D8 },
+    { "brokenbar", 0x00A6 }, { "bullet", 0x2022 }, { "c", 0x0063 }, { "caron", 0x02C7 }, { "ccedilla", 0x00E7 },
+    { "cedilla", 0x00B8 }, { "cent", 0x00A2 }, { "circumflex", 0x02C6 }, { "colon", 0x003A }, { "comma", 0x002C },
+    { "copyright", 0x00A9 }, { "currency", 0x00A4 }, { "d", 0x0064 }, { "dagger", 0x2020 }, { "daggerdbl", 0x2021 },
+    { "degree", 0x00B0 }, { "dieresis", 0x00A8 }, { "divide", 0x00F7 }, { "dollar", 0x0024 },
+    { "dotaccent", 0x02D9 }, { "dotlessi", 0x0131 }, { "e", 0x0065 }, { "eacute", 0x00E9 },
+    { "ecircumflex", 0x00EA }, { "edieresis", 0x00EB }, { "egrave", 0x00E8 }, { "eight", 0x0038 },
+    { "ellipsis", 0x2026 }, { "emdash", 0x2014 }, { "endash", 0x2013 }, { "equal", 0x003D }, { "eth", 0x00F0 },
+    { "exclam", 0x0021 }, { "exclamdown", 0x00A1 }, { "f", 0x0066 }, { "fi", 0xFB01 }, { "five", 0x0035 },
+    { "fl", 0xFB02 }, { "florin", 0x0192 }, { "four", 0x0034 }, { "fraction", 0x2044 }, { "g", 0x0067 },
+    { "germandbls", 0x00DF }, { "grave", 0x0060 }, { "greater", 0x003E }, { "guillemotleft", 0x00AB },
+    { "guillemotright", 0x00BB }, { "guilsinglleft", 0x2039 }, { "guilsinglright", 0x203A }, { "h", 0x0068 },
+    { "hungarumlaut", 0x02DD }, { "hyphen", 0x002D }, { "i", 0x0069 }, { "iacute", 0x00ED },
+    { "icircumflex", 0x00EE }, { "idieresis", 0x00EF }, { "igrave", 0x00EC }, { "j", 0x006A }, { "k", 0x006B },
+    { "l", 0x006C }, { "less", 0x003C }, { "logicalnot", 0x00AC }, { "lslash", 0x0142 }, { "m", 0x006D },
+    { "macron", 0x00AF }, { "middot", 0x00B7 }, { "minus", 0x2212 }, { "mu", 0x00B5 }, { "multiply", 0x00D7 },
+    { "n", 0x006E }, { "nbspace", 0x00A0 }, { "nine", 0x0039 }, { "nonbreakingspace", 0x00A0 }, { "ntilde", 0x00F1 },
+    { "numbersign", 0x0023 }, { "o", 0x006F }, { "oacute", 0x00F3 }, { "ocircumflex", 0x00F4 },
+    { "odieresis", 0x00F6 }, { "oe", 0x0153 }, { "ogonek", 0x02DB }, { "ograve", 0x00F2 }, { "one", 0x0031 },
+    { "onehalf", 0x00BD }, { "onequarter", 0x00BC }, { "onesuperior", 0x00B9 }, { "ordfeminine", 0x00AA },
+    { "ordmasculine", 0x00BA }, { "oslash", 0x00F8 }, { "otilde", 0x00F5 }, { "overscore", 0x00AF }, { "p", 0x0070 },
+    { "paragraph", 0x00B6 }, { "parenleft", 0x0028 }, { "parenright", 0x0029 }, { "percent", 0x0025 },
+    { "period", 0x002E }, { "periodcentered", 0x00B7 }, { "perthousand", 0x2030 }, { "plus", 0x002B },
+    { "plusminus", 0x00B1 }, { "q", 0x0071 }, { "question", 0x003F }, { "questiondown", 0x00BF },
+    { "quotedbl", 0x0022 }, { "quotedblbase", 0x201E }, { "quotedblleft", 0x201C }, { "quotedblright", 0x201D },
+    { "quoteleft", 0x2018 }, { "quoteright", 0x2019 }, { "quotesinglbase", 0x201A }, { "quotesingle", 0x0027 },
+    { "r", 0x0072 }, { "registered", 0x00AE }, { "ring", 0x02DA }, { "s", 0x0073 }, { "scaron", 0x0161 },
+    { "section", 0x00A7 }, { "semicolon", 0x003B }, { "seven", 0x0037 }, { "sfthyphen", 0x00AD }, { "six", 0x0036 },
+    { "slash", 0x002F }, { "space", 0x0020 }, { "sterling", 0x00A3 }, { "t", 0x0074 }, { "thorn", 0x00FE },
+    { "three", 0x0033 }, { "threequarters", 0x00BE }, { "threesuperior", 0x00B3 }, { "tilde", 0x02DC },
+    { "trademark", 0x2122 }, { "two", 0x0032 }, { "twosuperior", 0x00B2 }, { "u", 0x0075 }, { "uacute", 0x00FA },
+    { "ucircumflex", 0x00FB }, { "udieresis", 0x00FC }, { "ugrave", 0x00F9 }, { "underscore", 0x005F },
+    { "v", 0x0076 }, { "w", 0x0077 }, { "x", 0x0078 }, { "y", 0x0079 }, { "yacute", 0x00FD },
+    { "ydieresis", 0x00FF }, { "yen", 0x00A5 }, { "z", 0x007A }, { "zcaron", 0x017E }, { "zero", 0x0030 }
+    };
+
+    const auto it = std::lower_bound( std::begin(entries), std::end(entries), name
+                                    , [](const Entry &e, std::string_view n) { return e.name<n; }
+                                    );
+    if (it!=std::end(entries) && it->name==name)
+        return it->codePoint;
+
+    // uniXXXX - ровно 4 шестнадцатеричные цифры, uXXXX..uXXXXXX - от 4 до 6
+    std::string_view hex;
+    if (name.size()==7 && name.substr(0, 3)=="uni")
+        hex = name.substr(3);
+    else if (name.size()>=5 && name.size()<=7 && name.front()=='u')
+        hex = name.substr(1);
+    else
+        return 0;
+
+    std::uint32_t cp = 0;
+    for(char ch : hex)
+    {
+        std::uint32_t d;
+        if (ch>='0' && ch<='9')      d = std::uint32_t(ch-'0');
+        else if (ch>='A' && ch<='F') d = std::uint32_t(ch-'A'+10);
+        else return 0; // AGL требует заглавных шестнадцатеричных цифр
+        cp = cp*16u + d;
+    }
+
+    if (cp>0x10FFFFu || (cp>=0xD800u && cp<=0xDFFFu))
+        return 0;
+    return char32_t(cp);
+}
+
+//----------------------------------------------------------------------------
+//! Разбор AFM (Adobe Font Metrics) из текста
+/*! Используются FontName, EncodingScheme, Ascender, Descender и строки метрик символов
+    "C code ; WX width ; N name ; ...".
+
+    Символ определяется по имени глифа N (см. glyphNameToUnicode): коды C в AFM - коды кодировки
+    шрифта, обычно AdobeStandardEncoding, где, например, 39 - quoteright, а не апостроф. Код C (или
+    CH <hex>) используется как код Unicode, только если имени нет или оно неизвестно, а кодировка -
+    ISOLatin1Encoding; у шрифтов с EncodingScheme FontSpecific (Symbol, Dingbats) - всегда код C.
+    Строка может вместо C задавать U <hex> - код Unicode явно (расширение, для символов без имени
+    в таблице). Глифы, для которых символ определить не удалось, и остальные строки пропускаются.
+
+    Символы без ширины получают ширину символа 'n' или, если её нет, среднюю ширину.
+ */
+inline
+SvgFontMetrics parseAfmMetrics(std::string_view afmText)
+{
+    SvgFontMetrics res;
+    bool hasAscent = false, hasDescent = false;
+
+    std::int64_t widthSum = 0;
+    std::size_t  nWidths  = 0;
+
+    bool bFontSpecific = false;
+    bool bLatin1Codes  = false;
+
+    auto trim = [](std::string_view sv)
+    {
+        while(!sv.empty() && (sv.front()==' ' || sv.front()=='\t'))
+            sv.remove_prefix(1);
+        while(!sv.empty() && (sv.back()==' ' || sv.back()=='\t' || sv.back()=='\r'))
+            sv.remove_suffix(1);
+        return sv;
+    };
+
+    auto splitKey = [&](std::string_view sv, std::string_view &value)
+    {
+        const std::size_t pos = sv.find_first_of(" \t");
+        value = pos==sv.npos ? std::string_view() : trim(sv.substr(pos));
+        return sv.substr(0, pos);
+    };
+
+    auto toLong = [](std::string_view sv, int base, long &v)
+    {
+        const std::string str(sv);
+        char *pEnd = nullptr;
+        v = std::strtol(str.c_str(), &pEnd, base);
+        return !str.empty() && pEnd && *pEnd==0;
+    };
+
+    while(!afmText.empty())
+    {
+        std::size_t eol = afmText.find('\n');
+        std::string_view line = trim(afmText.substr(0, eol));
+        afmText.remove_prefix(eol==afmText.npos ? afmText.size() : eol+1);
+
+        std::string_view value;
+        const std::string_view key = splitKey(line, value);
+
+        long v = 0;
+        if (key=="FontName")
+        {
+            res.setName(std::string(value));
+        }
+        else if (key=="EncodingScheme")
+        {
+            bFontSpecific = value=="FontSpecific";
+            bLatin1Codes  = value=="ISOLatin1Encoding";
+        }
+        else if (key=="Ascender")
+        {
+            if (toLong(value, 10, v)) { res.setAscent(int(v)); hasAscent = true; }
+        }
+        else if (key=="Descender")
+        {
+            if (toLong(value, 10, v)) { res.setDescent(int(v)); hasDescent = true; }
+        }
+        else if (key=="C" || key=="CH" || key=="U")
+        {
+            long             code     = -1;
+            long             width    = -1;
+            std::string_view glyphName;
+            std::size_t      fieldIdx = 0;
+
+            // Поля разделены ';'
+            while(!line.empty())
+            {
+                const std::size_t sep = line.find(';');
+                const std::string_view field = trim(line.substr(0, sep));
+                line.remove_prefix(sep==line.npos ? line.size() : sep+1);
+
+                std::string_view fieldValue;
+                const std::string_view fieldKey = splitKey(field, fieldValue);
+
+                if (fieldIdx++==0)
+                {
+                    if (fieldKey=="C")
+                        toLong(fieldValue, 10, code);
+                    else
+                    {
+                        if (fieldValue.size()>=2 && fieldValue.front()=='<' && fieldValue.back()=='>')
+                            fieldValue = fieldValue.substr(1, fieldValue.size()-2);
+                        toLong(fieldValue, 16, code);
+                    }
+                }
+                else if (fieldKey=="WX" || fieldKey=="W0X")
+                {
+                    toLong(fieldValue, 10, width);
+                }
+                else if (fieldKey=="N")
+                {
+                    glyphName = fieldValue;
+                }
+            }
+
+            char32_t cp = 0;
+            if (key=="U")
+                cp = code>0 ? char32_t(code) : 0;
+            else if (bFontSpecific)
+                cp = code>0 && code<=0xFF ? char32_t(code) : 0;
+            else
+            {
+                cp = glyphNameToUnicode(glyphName);
+                if (!cp && bLatin1Codes && code>0 && code<=0xFF)
+                    cp = char32_t(code);
+            }
+
+            if (cp && width>=0 && width<=0xFFFF)
+            {
+                res.setAdvance(cp, int(width));
+                widthSum += width;
+                ++nWidths;
+            }
+        }
+    }
+
+    if (!hasAscent)
+        res.setAscent(750);
+    if (!hasDescent)
+        res.setDescent(250);
+
+    if (res.hasAdvance(U'n'))
+        res.setDefaultWidth(res.advance(U'n'));
+    else if (nWidths)
+        res.setDefaultWidth(int(widthSum/std::int64_t(nWidths)));
+
+    return res;
+}
+
+//----------------------------------------------------------------------------
+//! Загрузка AFM-файла; ошибки чтения - std::runtime_error
+inline
+SvgFontMetrics loadAfmMetrics(const std::string &fileName)
+{
+    std::ifstream ifs(fileName, std::ios::binary);
+    if (!ifs)
+        throw std::runtime_error("marty::svg::loadAfmMetrics: failed to open file: " + fileName);
+
+    const std::string text((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    return parseAfmMetrics(text);
+}
+
+//----------------------------------------------------------------------------
+//! Встроенные шрифты: ширины символов 32-126 (WinAnsi: 39 - quotesingle, 96 - grave)
+inline
+SvgFontMetrics makeBuiltinFontMetrics(std::string name, int ascent, int descent, int defaultWidth, const std::uint16_t (&widths)[95])
+{
+    SvgFontMetrics res(std::move(name), ascent, descent, defaultWidth);
+    for(char32_t cp=32; cp!=127; ++cp)
+        res.setAdvance(cp, widths[cp-32]);
+    res.setAdvance(U'\u00A0', widths[0]); // nbsp - как пробел
+    return res;
+}
+
+inline
+SvgFontMetrics makeHelveticaMetrics()
+{
+    static constexpr std::uint16_t widths[95] =
+    { 278, 278, 355, 556, 556, 889, 667, 191, 333, 333, 389, 584, 278, 333, 278, 278  //  !"#$%&'()*+,-./
+    , 556, 556, 556, 556, 556, 556, 556, 556, 556, 556                                // 0-9
+    , 278, 278, 584, 584, 584, 556, 1015                                              // :;<=>?@
+    , 667, 667, 722, 722, 667, 611, 778, 722, 278, 500, 667, 556, 833                 // A-M
+    , 722, 778, 667, 778, 722, 667, 611, 722, 667, 944, 667, 667, 611                 // N-Z
+    , 278, 278, 278, 469, 556, 333                                                    // [\]^_`
+    , 556, 556, 500, 556, 556, 278, 556, 556, 222, 222, 500, 222, 833                 // a-m
+    , 556, 556, 556, 556, 333, 500, 278, 556, 500, 722, 500, 500, 500                 // n-z
+    , 334, 260, 334, 584                                                              // {|}~
+    };
+    return makeBuiltinFontMetrics("Helvetica", 718, 207, 556, widths);
+}
+
+inline
+SvgFontMetrics makeTimesMetrics()
+{
+    static constexpr std::uint16_t widths[95] =
+    { 250, 333, 408, 500, 500, 833, 778, 180, 333, 333, 500, 564, 250, 333, 250, 278
+    , 500, 500, 500, 500, 500, 500, 500, 500, 500, 500
+    , 278, 278, 564, 564, 564, 444, 921
+    , 722, 667, 667, 722, 611, 556, 722, 722, 333, 389, 722, 611, 889
+    , 722, 722, 556, 722, 667, 556, 611, 722, 722, 944, 722, 722, 611
+    , 333, 278, 333, 469, 500, 333
+    , 444, 500, 444, 500, 444, 333, 500, 500, 278, 278, 500, 278, 778
+    , 500, 500, 500, 500, 333, 389, 278, 500, 500, 722, 500, 500, 444
+    , 480, 200, 480, 541
+    };
+    return makeBuiltinFontMetrics("Times-Roman", 683, 217, 500, widths);
+}
+
+inline
+SvgFontMetrics makeCourierMetrics()
+{
+    SvgFontMetrics res("Courier", 629, 157, 600);
+    for(char32_t cp=32; cp!=127; ++cp)
+        res.setAdvance(cp, 600);
+    res.setAdvance(U'\u00A0', 600);
+    return res;
+}
+
+//----------------------------------------------------------------------------
+//! Набор шрифтов с поиском по имени семейства (без учёта регистра) и псевдонимам
+/*! Изначально содержит встроенные Helvetica, Times-Roman и Courier, с псевдонимами CSS
+    (sans-serif, serif, monospace) и метрически совместимых шрифтов (Arial, Times New Roman, Courier New).
+ */
+class SvgFontRegistry
+{
+
+public:
+
+    static constexpr std::size_t npos = std::size_t(-1);
+
+    SvgFontRegistry()
+    {
+        const std::size_t helvetica = addFont(makeHelveticaMetrics());
+        const std::size_t times     = addFont(makeTimesMetrics());
+        const std::size_t courier   = addFont(makeCourierMetrics());
+
+        addAlias("sans-serif"     , helvetica);
+        addAlias("Arial"          , helvetica);
+        addAlias("serif"          , times);
+        addAlias("Times"          , times);
+        addAlias("Times New Roman", times);
+        addAlias("monospace"      , courier);
+        addAlias("Courier New"    , courier);
+    }
+
+    //! Добавляет шрифт (или заменяет шрифт с тем же именем), возвращает индекс
+    std::size_t addFont(SvgFontMetrics metrics)
+    {
+        const std::size_t existing = findExact(metrics.name());
+        if (existing!=npos)
+        {
+            m_fonts[existing] = std::move(metrics);
+            return existing;
+        }
+
+        m_fonts.emplace_back(std::move(metrics));
+        m_names.emplace_back(m_fonts.back().name(), m_fonts.size()-1);
+        return m_fonts.size()-1;
+    }
+
+    //! Загружает AFM-файл
+    std::size_t loadAfm(const std::string &fileName)
+    {
+        return addFont(loadAfmMetrics(fileName));
+    }
+
+    void addAlias(std::string alias, std::size_t fontIdx)
+    {
+        m_names.emplace_back(std::move(alias), fontIdx);
+    }
+
+    //! Первое известное семейство из списка CSS font-family ("Arial, sans-serif"); npos, если нет ни одного
+    std::size_t findFont(std::string_view familyList) const
+    {
+        while(!familyList.empty())
+        {
+            const std::size_t comma = familyList.find(',');
+            std::string_view family = familyList.substr(0, comma);
+            familyList.remove_prefix(comma==familyList.npos ? familyList.size() : comma+1);
+
+            while(!family.empty() && (family.front()==' ' || family.front()=='\'' || family.front()=='\"'))
+                family.remove_prefix(1);
+            while(!family.empty() && (family.back()==' ' || family.back()=='\'' || family.back()=='\"'))
+                family.remove_suffix(1);
+
+            const std::size_t idx = findExact(family);
+            if (idx!=npos)
+                return idx;
+        }
+
+        return npos;
+    }
+
+    std::size_t size() const { return m_fonts.size(); }
+
+    const SvgFontMetrics& font(std::size_t idx) const { return m_fonts[idx]; }
+
+
+protected:
+
+    static bool equalNoCase(std::string_view a, std::string_view b)
+    {
+        if (a.size()!=b.size())
+            return false;
+
+        for(std::size_t i=0; i!=a.size(); ++i)
+        {
+            char ca = a[i], cb = b[i];
+            if (ca>='A' && ca<='Z') ca = char(ca-'A'+'a');
+            if (cb>='A' && cb<='Z') cb = char(cb-'A'+'a');
+            if (ca!=cb)
+                return false;
+        }
+
+        return true;
+    }
+
+    std::size_t findExact(std::string_view name) const
+    {
+        for(const auto &n : m_names)
+        {
+            if (equalNoCase(n.first, name))
+                return n.second;
+        }
+        return npos;
+    }
+
+
+    std::vector<SvgFontMetrics>                         m_fonts;
+    std::vector<std::pair<std::string, std::size_t>>    m_names;
+
+}; // class SvgFontRegistry
+
+//----------------------------------------------------------------------------
+//! Измерение текста с LRU-кэшем сумм ширин
+/*! Кэш хранит сумму ширин строки в единицах шрифта, поэтому не зависит от кегля. Узлы кэша
+    выделяются один раз, при вытеснении строка узла перезаписывается на месте; при совпадении
+    хэшей разных строк старая запись просто вытесняется. capacity==0 - без кэша.
+
+    Строки короче cacheMinLength байт в кэш не попадают: сложить ширины по таблице дешевле,
+    чем посчитать хэш и найти запись.
+
+    Неизвестное семейство измеряется первым шрифтом реестра (Helvetica).
+
+    \code
+    marty::svg::SvgFontRegistry  fonts;
+    marty::svg::SvgTextMeasurer  measurer(fonts);
+    auto m = measurer.measureText("Label", "Arial, sans-serif", 12.0);
+    marty::svg::drawRectEx(oss, x, y, int(m.width)+8, int(m.height())+4, 3, 1, "black");
+    \endcode
+ */
+class SvgTextMeasurer
+{
+
+public:
+
+    static constexpr std::size_t defaultCacheMinLength = 32;
+
+    explicit SvgTextMeasurer(const SvgFontRegistry &fonts, std::size_t cacheCapacity=4096, std::size_t cacheMinLength=defaultCacheMinLength)
+    : m_fonts(fonts)
+    , m_cacheMinLength(cacheMinLength)
+    {
+        setCacheCapacity(cacheCapacity);
+    }
+
+    //! Меняет размер кэша, кэш при этом очищается
+    void setCacheCapacity(std::size_t capacity)
+    {
+        m_nodes.clear();
+        m_nodes.reserve(capacity);
+        m_index.clear();
+        m_index.reserve(capacity);
+        m_capacity = capacity;
+        m_head = m_tail = noNode;
+    }
+
+    std::size_t cacheCapacity() const { return m_capacity; }
+    std::size_t cacheMinLength() const { return m_cacheMinLength; }
+    void setCacheMinLength(std::size_t len) { m_cacheMinLength = len; }
+    std::size_t cacheSize()     const { return m_nodes.size(); }
+    std::uint64_t cacheHits()   const { return m_hits; }
+    std::uint64_t cacheMisses() const { return m_misses; }
+
+    SvgTextMetrics measureText(std::string_view text, std::size_t fontIdx, double fontSize)
+    {
+        if (fontIdx>=m_fonts.size())
+            fontIdx = 0;
+
+        const SvgFontMetrics &font = m_fonts.font(fontIdx);
+        return font.metricsFromAdvance(cachedAdvance(text, fontIdx, font), fontSize);
+    }
+
+    SvgTextMetrics measureText(std::string_view text, std::string_view fontFamily, double fontSize)
+    {
+        const std::size_t fontIdx = m_fonts.findFont(fontFamily);
+        return measureText(text, fontIdx==SvgFontRegistry::npos ? 0 : fontIdx, fontSize);
+    }
+
+
+protected:
+
+    static constexpr std::uint32_t noNode = std::uint32_t(-1);
+
+    struct Node
+    {
+        std::string     text;
+        std::uint64_t   key     = 0;
+        std::int64_t    advance = 0;
+        std::uint32_t   fontIdx = 0;
+        std::uint32_t   prev    = noNode;
+        std::uint32_t   next    = noNode;
+    };
+
+    std::int64_t cachedAdvance(std::string_view text, std::size_t fontIdx, const SvgFontMetrics &font)
+    {
+        if (!m_capacity || text.size()<m_cacheMinLength)
+            return font.textAdvance(text);
+
+        const std::uint64_t key = hashBytes64(text.data(), text.size(), std::uint64_t(fontIdx));
+
+        const auto it = m_index.find(key);
+        if (it!=m_index.end())
+        {
+            Node &node = m_nodes[it->second];
+            if (node.fontIdx==fontIdx && node.text==text)
+            {
+                ++m_hits;
+                moveToFront(it->second);
+                return node.advance;
+            }
+        }
+
+        ++m_misses;
+        const std::int64_t advance = font.textAdvance(text);
+
+        std::uint32_t nodeIdx;
+        if (it!=m_index.end())
+        {
+            nodeIdx = it->second; // Коллизия хэшей - запись перезаписывается
+        }
+        else if (m_nodes.size()<m_capacity)
+        {
+            nodeIdx = std::uint32_t(m_nodes.size());
+            m_nodes.emplace_back();
+            linkFront(nodeIdx);
+            m_index.emplace(key, nodeIdx);
+        }
+        else
+        {
+            // Вытесняем самую давнюю; узел хэш-таблицы переиспользуется, без аллокации
+            nodeIdx = m_tail;
+            auto indexNode = m_index.extract(m_nodes[nodeIdx].key);
+            indexNode.key() = key;
+            m_index.insert(std::move(indexNode));
+        }
+
+        Node &node = m_nodes[nodeIdx];
+        node.text.assign(text.data(), text.size());
+        node.key     = key;
+        node.advance = advance;
+        node.fontIdx = std::uint32_t(fontIdx);
+        moveToFront(nodeIdx);
+
+        return advance;
+    }
+
+    void linkFront(std::uint32_t idx)
+    {
+        Node &node = m_nodes[idx];
+        node.prev = noNode;
+        node.next = m_head;
+        if (m_head!=noNode)
+            m_nodes[m_head].prev = idx;
+        m_head = idx;
+        if (m_tail==noNode)
+            m_tail = idx;
+    }
+
+    void moveToFront(std::uint32_t idx)
+    {
+        if (m_head==idx)
+            return;
+
+        Node &node = m_nodes[idx];
+        if (node.prev!=noNode)
+            m_nodes[node.prev].next = node.next;
+        if (node.next!=noNode)
+            m_nodes[node.next].prev = node.prev;
+        if (m_tail==idx)
+            m_tail = node.prev;
+
+        linkFront(idx);
+    }
+
+
+    const SvgFontRegistry                           &m_fonts;
+
+    std::size_t                                     m_capacity = 0;
+    std::size_t                                     m_cacheMinLength = defaultCacheMinLength;
+    std::vector<Node>                               m_nodes;
+    std::unordered_map<std::uint64_t, std::uint32_t> m_index;
+    std::uint32_t                                   m_head = noNode;
+    std::uint32_t                                   m_tail = noNode;
+
+    std::uint64_t                                   m_hits   = 0;
+    std::uint64_t                                   m_misses = 0;
+
+}; // class SvgTextMeasurer
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/font_metrics.h"
+
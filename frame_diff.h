@@ -0,0 +1,389 @@
+/*! \file
+    \brief Стабильные id элементов и покадровый diff - для живых диаграмм выводятся только изменившиеся элементы
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include "marty_svg.h"
+#include "svg_arena.h"
+#include "svg_checksum.h"
+//
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/frame_diff.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+//! Обёртка над потоком, назначающая id следующему выведенному элементу
+/*! id пишется атрибутом сразу после имени тега первого элемента после setNextId() - любого
+    примитива: drawRectEx, drawRect, drawLine, drawText, путей, batch_draw.h, <use> инстансинга.
+    Остальные хуки (bounds*, запись путей) передаются во вложенный поток, так что обёртку можно
+    сочетать с SvgBoundsStream, CompactPathStream и т.п. в любом порядке.
+
+    \code
+    marty::svg::SvgIdStream<marty::svg::SvgWriter> ids(oss);
+    ids.setNextId("cpu-load");
+    marty::svg::drawRectEx(ids, 10, 10, 120, 40, 8, 1, "black");
+    \endcode
+ */
+template<typename StreamType>
+class SvgIdStream : public SvgStreamWrapper<SvgIdStream<StreamType>, StreamType>
+{
+
+public:
+
+    explicit SvgIdStream(StreamType &oss)
+    : SvgStreamWrapper<SvgIdStream<StreamType>, StreamType>(oss)
+    {}
+
+    //! id для следующего элемента; строка должна быть жива до его вывода
+    void setNextId(std::string_view id) { m_nextId = id; }
+
+    void writePendingId()
+    {
+        if (m_nextId.empty())
+            return;
+
+        this->m_oss << "id=\""; writeEscapedText(this->m_oss, m_nextId); this->m_oss << "\" ";
+        m_nextId = std::string_view();
+    }
+
+
+protected:
+
+    std::string_view    m_nextId;
+
+}; // class SvgIdStream
+
+//! Остальные хуки передаются во вложенный поток по умолчанию (см. SvgStreamWrapper)
+template<typename StreamType> inline
+void elementTagOpened(SvgIdStream<StreamType> &oss)
+{
+    oss.writePendingId();
+    elementTagOpened(oss.stream());
+}
+
+//----------------------------------------------------------------------------
+//! Строка JSON в кавычках
+template<typename StreamType> inline
+void writeJsonString(StreamType &oss, std::string_view str)
+{
+    static constexpr char hexDigits[] = "0123456789abcdef";
+
+    oss << '\"';
+
+    std::size_t runStart = 0;
+    for(std::size_t i=0; i!=str.size(); ++i)
+    {
+        const unsigned char ch = static_cast<unsigned char>(str[i]);
+        if (ch>=0x20u && ch!='\"' && ch!='\\')
+            continue;
+
+        oss << str.substr(runStart, i-runStart);
+        runStart = i+1;
+
+        switch(ch)
+        {
+            case '\"': oss << "\\\""; break;
+            case '\\': oss << "\\\\"; break;
+            case '\n': oss << "\\n" ; break;
+            case '\r': oss << "\\r" ; break;
+            case '\t': oss << "\\t" ; break;
+            default  :
+            {
+                const char esc[6] = { '\\', 'u', '0', '0', hexDigits[ch>>4], hexDigits[ch&0x0Fu] };
+                oss << std::string_view(&esc[0], sizeof(esc));
+            }
+        }
+    }
+
+    oss << str.substr(runStart) << '\"';
+}
+
+//----------------------------------------------------------------------------
+//! Итоги кадра SvgFrameDiff
+struct SvgFrameDiffStats
+{
+    std::size_t added     = 0;
+    std::size_t replaced  = 0;
+    std::size_t removed   = 0;
+    std::size_t unchanged = 0;
+
+    std::size_t changes() const { return added+replaced+removed; }
+};
+
+//----------------------------------------------------------------------------
+//! Покадровое сравнение элементов по стабильным id, с выводом патча
+/*! Каждый элемент кадра выводится через element(patch, id, drawFn): его SVG-текст (с атрибутом id)
+    хэшируется и сравнивается с хэшем того же id в прошлом кадре. В патч попадают только отличия -
+    по одной строке JSON на изменение (JSON Lines):
+
+    \code
+    {"op":"add","id":"b7","after":"b6","svg":"<path id=\"b7\" ... />"}
+    {"op":"replace","id":"b3","svg":"<text id=\"b3\" ...>42%</text>"}
+    {"op":"remove","id":"b9"}
+    \endcode
+
+    after - id предыдущего элемента кадра (нет у первого), чтобы клиент вставил новый элемент на
+    место в порядке отрисовки. Перестановки элементов без изменения содержимого не отслеживаются.
+
+    Если drawFn выводит один элемент, id ставится на него самого; если несколько (или ни одного) -
+    вывод оборачивается в <g id="...">.
+
+    Объём патча зависит только от числа изменений. Хранится по 16 байт на id плюс сам id; проход по
+    всем элементам в endFrame() выполняется, только если в кадре были не все прежние элементы.
+    Для обновления без полного кадра - update()/remove(), их стоимость не зависит от размера документа.
+
+    \code
+    marty::svg::SvgFrameDiff diff;
+    diff.beginFrame();
+    for(const auto &b : boxes)
+        diff.element(patch, b.id, [&](auto &oss) { marty::svg::drawRectEx(oss, b.x, b.y, 120, 40, 8, 1, b.color); });
+    diff.endFrame(patch);
+    \endcode
+ */
+class SvgFrameDiff
+{
+
+public:
+
+    //! Поток, в который drawFn выводит элемент; отмечает, где открылись теги элементов
+    class ElementStream : public SvgStreamWrapper<ElementStream, SvgWriter>
+    {
+
+    public:
+
+        explicit ElementStream(SvgWriter &w) : SvgStreamWrapper<ElementStream, SvgWriter>(w) {}
+
+        friend void elementTagOpened(ElementStream &oss)
+        {
+            if (!oss.m_tagCount++)
+                oss.m_firstTagPos = oss.m_oss.size();
+        }
+
+        //! Число выведенных элементов и позиция, куда вставляется атрибут первого из них
+        std::size_t tagCount()    const { return m_tagCount; }
+        std::size_t firstTagPos() const { return m_firstTagPos; }
+
+
+    protected:
+
+        std::size_t     m_tagCount    = 0;
+        std::size_t     m_firstTagPos = 0;
+
+    }; // class ElementStream
+
+
+    SvgFrameDiff() = default;
+
+    SvgFrameDiff(const SvgFrameDiff&) = delete;
+    SvgFrameDiff& operator=(const SvgFrameDiff&) = delete;
+
+    //! Точность нецелых координат в выводе элементов
+    void setCoordPrecision(int precision)
+    {
+        m_scratch.setCoordPrecision(precision);
+        m_element.setCoordPrecision(precision);
+    }
+
+    //------------------------------
+    void beginFrame()
+    {
+        ++m_frame;
+        m_seenCount = 0;
+        m_prevId    = std::string_view();
+        m_stats     = SvgFrameDiffStats();
+    }
+
+    //! Элемент кадра; true - элемент добавлен или изменился
+    template<typename StreamType, typename DrawFn>
+    bool element(StreamType &patch, std::string_view id, DrawFn drawFn)
+    {
+        const SvgStringId sid = internId(id);
+        Entry &e = m_entries[sid];
+
+        if (e.alive && e.seenFrame!=m_frame)
+            ++m_seenCount;
+
+        const bool changed = putElement(patch, sid, drawFn, m_prevId);
+        e.seenFrame = m_frame;
+        m_prevId    = m_ids.get(sid);
+        return changed;
+    }
+
+    //! Завершает кадр: элементы прошлого кадра, не выведенные в этом, удаляются
+    template<typename StreamType>
+    const SvgFrameDiffStats& endFrame(StreamType &patch)
+    {
+        if (m_seenCount+m_stats.added!=m_aliveCount)
+        {
+            for(std::size_t sid=1; sid<m_entries.size(); ++sid)
+            {
+                Entry &e = m_entries[sid];
+                if (e.alive && e.seenFrame!=m_frame)
+                    removeEntry(patch, SvgStringId(sid));
+            }
+        }
+
+        m_stats.unchanged = m_aliveCount-m_stats.added-m_stats.replaced;
+        return m_stats;
+    }
+
+    const SvgFrameDiffStats& stats() const { return m_stats; }
+
+    //------------------------------
+    //! Обновление одного элемента вне кадра; новый элемент вставляется после after (пусто - в начало)
+    template<typename StreamType, typename DrawFn>
+    bool update(StreamType &patch, std::string_view id, DrawFn drawFn, std::string_view after=std::string_view())
+    {
+        return putElement(patch, internId(id), drawFn, after);
+    }
+
+    //! Удаление элемента вне кадра; false - такого элемента нет
+    template<typename StreamType>
+    bool remove(StreamType &patch, std::string_view id)
+    {
+        const SvgStringId sid = m_ids.find(id);
+        if (!sid || sid>=m_entries.size() || !m_entries[sid].alive)
+            return false;
+        removeEntry(patch, sid);
+        return true;
+    }
+
+    //------------------------------
+    //! Число элементов в текущем состоянии
+    std::size_t size() const { return m_aliveCount; }
+
+    //! Забывает всё; следующий кадр выводится целиком, как добавления
+    void clear()
+    {
+        m_ids.clear();
+        m_entries.clear();
+        m_aliveCount = 0;
+        m_seenCount  = 0;
+        m_prevId     = std::string_view();
+        m_stats      = SvgFrameDiffStats();
+    }
+
+
+protected:
+
+    struct Entry
+    {
+        std::uint64_t   hash      = 0;
+        std::uint32_t   seenFrame = 0;
+        bool            alive     = false;
+    };
+
+    SvgStringId internId(std::string_view id)
+    {
+        const SvgStringId sid = m_ids.intern(id);
+        if (sid>=m_entries.size())
+            m_entries.resize(std::size_t(sid)+1u);
+        return sid;
+    }
+
+    //! Выводит элемент в m_element с атрибутом id
+    template<typename DrawFn>
+    void renderElement(std::string_view id, DrawFn &drawFn)
+    {
+        m_scratch.clear();
+        m_element.clear();
+
+        ElementStream es(m_scratch);
+        drawFn(es);
+
+        std::string_view text = m_scratch.view();
+        while(!text.empty() && text.back()=='\n')
+            text.remove_suffix(1);
+
+        if (es.tagCount()==1)
+        {
+            m_element << text.substr(0, es.firstTagPos());
+            m_element << "id=\""; writeEscapedText(m_element, id); m_element << "\" ";
+            m_element << text.substr(es.firstTagPos());
+        }
+        else
+        {
+            m_element << "<g id=\""; writeEscapedText(m_element, id); m_element << "\">\n";
+            m_element << text;
+            m_element << "\n</g>";
+        }
+    }
+
+    template<typename StreamType, typename DrawFn>
+    bool putElement(StreamType &patch, SvgStringId sid, DrawFn &drawFn, std::string_view after)
+    {
+        const std::string_view id = m_ids.get(sid);
+        renderElement(id, drawFn);
+
+        const std::string_view svg  = m_element.view();
+        const std::uint64_t    hash = hashBytes64(svg.data(), svg.size());
+
+        Entry &e = m_entries[sid];
+        if (e.alive && e.hash==hash)
+            return false;
+
+        if (e.alive)
+        {
+            patch << "{\"op\":\"replace\",\"id\":"; writeJsonString(patch, id);
+            ++m_stats.replaced;
+        }
+        else
+        {
+            patch << "{\"op\":\"add\",\"id\":"; writeJsonString(patch, id);
+            if (!after.empty())
+            {
+                patch << ",\"after\":"; writeJsonString(patch, after);
+            }
+            e.alive = true;
+            ++m_aliveCount;
+            ++m_stats.added;
+        }
+
+        patch << ",\"svg\":"; writeJsonString(patch, svg); patch << "}\n";
+        e.hash = hash;
+        return true;
+    }
+
+    template<typename StreamType>
+    void removeEntry(StreamType &patch, SvgStringId sid)
+    {
+        patch << "{\"op\":\"remove\",\"id\":"; writeJsonString(patch, m_ids.get(sid)); patch << "}\n";
+        m_entries[sid].alive = false;
+        --m_aliveCount;
+        ++m_stats.removed;
+    }
+
+
+    SvgStringPool       m_ids;
+    std::vector<Entry>  m_entries;      // По SvgStringId
+    std::size_t         m_aliveCount = 0;
+    std::size_t         m_seenCount  = 0; // Прежние элементы, выведенные в текущем кадре
+    std::uint32_t       m_frame      = 0;
+    std::string_view    m_prevId;
+    SvgFrameDiffStats   m_stats;
+    SvgWriter           m_scratch;
+    SvgWriter           m_element;
+
+}; // class SvgFrameDiff
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/frame_diff.h"
+
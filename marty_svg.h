@@ -6,9 +6,23 @@
 
 //----------------------------------------------------------------------------
 #include "enums.h"
+#include "svg_coord.h"
+#include "svg_instrumentation.h"
+#include "svg_simd.h"
+#include "svg_writer.h"
 //
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <iterator>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
 
 //----------------------------------------------------------------------------
 
@@ -34,26 +48,213 @@ OutputIterator appendToOutputEscapeHelper(OutputIterator outIt, const char* ccSt
     return outIt;
 }
 
+//----------------------------------------------------------------------------
+//! Возвращает true, если символ нельзя выводить в XML как есть - спецсимвол XML или управляющий символ
+template<typename CharType> inline
+bool isEscapeTextChar(CharType ch)
+{
+    switch(ch)
+    {
+        case (CharType)'&' :
+        case (CharType)'<' :
+        case (CharType)'>' :
+        case (CharType)'\'':
+        case (CharType)'\"': return true;
+        default: break;
+    }
+
+    // TAB, LF и CR тоже попадают сюда, их обрабатываем отдельно, в escapeTextChar
+    return (typename std::make_unsigned<CharType>::type)ch < 0x20u;
+}
+
+//----------------------------------------------------------------------------
+//! Возвращает строку замены для спецсимвола XML, или nullptr, если символ не является спецсимволом
+template<typename CharType> inline
+const char* getEscapeTextEntity(CharType ch)
+{
+    switch(ch)
+    {
+        // https://en.wikipedia.org/w/index.php?title=List_of_XML_and_HTML_character_entity_references&mobile-app=true&theme=dark
+        case (CharType)'&' : return "&amp;" ;
+        case (CharType)'<' : return "&lt;"  ;
+        case (CharType)'>' : return "&gt;"  ;
+        case (CharType)'\'': return "&apos;";
+        case (CharType)'\"': return "&quot;";
+        default: return nullptr;
+    }
+}
+
+//----------------------------------------------------------------------------
+//! Выводит символ, для которого isEscapeTextChar вернула true
+/*! Управляющие символы, недопустимые в XML 1.0 (C0, кроме TAB, LF и CR), заменяются на replaceChar,
+    или выкидываются, если replaceChar равен нулю.
+ */
+template<typename CharType, typename OutputIterator> inline
+OutputIterator escapeTextChar(OutputIterator outIt, CharType ch, CharType replaceChar)
+{
+    const char* entity = getEscapeTextEntity(ch);
+    if (entity)
+        return appendToOutputEscapeHelper<CharType>(outIt, entity);
+
+    if (ch==(CharType)'\t' || ch==(CharType)'\n' || ch==(CharType)'\r')
+        *outIt++ = ch;
+    else if (replaceChar!=0)
+        *outIt++ = replaceChar;
+
+    return outIt;
+}
+
+//----------------------------------------------------------------------------
+//! Индекс младшего установленного бита, mask не должна быть нулевой
+inline
+unsigned bitScanForward(std::uint32_t mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long idx = 0;
+    _BitScanForward(&idx, (unsigned long)mask);
+    return (unsigned)idx;
+#else
+    return (unsigned)__builtin_ctz(mask);
+#endif
+}
+
+//----------------------------------------------------------------------------
+//! Ищет первый символ, требующий экранирования (см. isEscapeTextChar), возвращает e, если такого нет
+/*! Чистые участки просматриваются по 32/16 байт (AVX2/SSE2, см. svg_simd.h), хвост - поштучно.
+    С MARTY_SVG_NO_SIMD - только поштучно.
+ */
+inline
+const char* findEscapeTextChar(const char* b, const char* e)
+{
+#if defined(MARTY_SVG_IMPL_USE_AVX2)
+    {
+        const __m256i amp  = _mm256_set1_epi8('&');
+        const __m256i lt   = _mm256_set1_epi8('<');
+        const __m256i gt   = _mm256_set1_epi8('>');
+        const __m256i apos = _mm256_set1_epi8('\'');
+        const __m256i quot = _mm256_set1_epi8('\"');
+        const __m256i ctrl = _mm256_set1_epi8(0x1F);
+
+        for(; e-b>=32; b+=32)
+        {
+            const __m256i v = _mm256_loadu_si256((const __m256i*)b);
+            __m256i m = _mm256_or_si256( _mm256_cmpeq_epi8(v, amp), _mm256_cmpeq_epi8(v, lt));
+            m = _mm256_or_si256(m, _mm256_or_si256(_mm256_cmpeq_epi8(v, gt), _mm256_cmpeq_epi8(v, apos)));
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, quot));
+            // v<=0x1F (беззнаково) <=> min(v, 0x1F)==v
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(_mm256_min_epu8(v, ctrl), v));
+
+            const std::uint32_t mask = (std::uint32_t)_mm256_movemask_epi8(m);
+            if (mask)
+                return b + bitScanForward(mask);
+        }
+    }
+#endif
+
+#if defined(MARTY_SVG_IMPL_USE_SSE2)
+    {
+        const __m128i amp  = _mm_set1_epi8('&');
+        const __m128i lt   = _mm_set1_epi8('<');
+        const __m128i gt   = _mm_set1_epi8('>');
+        const __m128i apos = _mm_set1_epi8('\'');
+        const __m128i quot = _mm_set1_epi8('\"');
+        const __m128i ctrl = _mm_set1_epi8(0x1F);
+
+        for(; e-b>=16; b+=16)
+        {
+            const __m128i v = _mm_loadu_si128((const __m128i*)b);
+            __m128i m = _mm_or_si128( _mm_cmpeq_epi8(v, amp), _mm_cmpeq_epi8(v, lt));
+            m = _mm_or_si128(m, _mm_or_si128(_mm_cmpeq_epi8(v, gt), _mm_cmpeq_epi8(v, apos)));
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(v, quot));
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(_mm_min_epu8(v, ctrl), v));
+
+            const std::uint32_t mask = (std::uint32_t)_mm_movemask_epi8(m);
+            if (mask)
+                return b + bitScanForward(mask);
+        }
+    }
+#endif
+
+    for(; b!=e; ++b)
+    {
+        if (isEscapeTextChar(*b))
+            return b;
+    }
+
+    return e;
+}
+
+//----------------------------------------------------------------------------
+//! Экранирует непрерывный диапазон, отдавая результат кусками в runHandler(const char* p, std::size_t size)
+/*! Участки, не требующие экранирования, передаются обработчику целиком, без копирования.
+    Замер экранирования (MARTY_SVG_INSTR_ESCAPE_SCOPE) стоит здесь и во всех открытых функциях
+    экранирования; при вложенных вызовах учитывается только внешний.
+ */
+template<typename RunHandler> inline
+void escapeTextRuns(const char* b, const char* e, RunHandler runHandler, char replaceChar=0)
+{
+    MARTY_SVG_INSTR_ESCAPE_SCOPE(std::size_t(e-b));
+
+    while(b!=e)
+    {
+        const char* p = findEscapeTextChar(b, e);
+        if (p!=b)
+            runHandler(b, std::size_t(p-b));
+
+        if (p==e)
+            break;
+
+        MARTY_SVG_INSTR_ESCAPED();
+
+        const char* entity = getEscapeTextEntity(*p);
+        if (entity)
+        {
+            runHandler(entity, std::strlen(entity));
+        }
+        else if (*p=='\t' || *p=='\n' || *p=='\r')
+        {
+            runHandler(p, 1u);
+        }
+        else if (replaceChar!=0)
+        {
+            runHandler(&replaceChar, 1u);
+        }
+
+        b = p+1;
+    }
+}
+
+//----------------------------------------------------------------------------
+//! Размер входа для замера экранирования; однопроходный диапазон заранее не измерить - 0
+template<typename InputIterator> inline
+std::size_t escapeInputSize(InputIterator b, InputIterator e)
+{
+    if constexpr (std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>::value)
+        return std::size_t(std::distance(b, e));
+    else
+        return (void)b, (void)e, std::size_t(0);
+}
+
 //----------------------------------------------------------------------------
 template<typename InputIterator, typename OutputIterator> inline
-OutputIterator escapeText(OutputIterator outIt, InputIterator b, InputIterator e)
+OutputIterator escapeText( OutputIterator outIt, InputIterator b, InputIterator e
+                         , typename std::iterator_traits<InputIterator>::value_type replaceChar=0 // 0 - недопустимые символы выкидываются
+                         )
 {
-    using CharType = typename InputIterator::value_type;
+    MARTY_SVG_INSTR_ESCAPE_SCOPE(escapeInputSize(b, e));
 
     for(; b!=e; ++b)
     {
         auto ch = *b;
 
-        switch(ch)
+        if (!isEscapeTextChar(ch))
+        {
+            *outIt++ = ch;
+        }
+        else
         {
-            // https://en.wikipedia.org/w/index.php?title=List_of_XML_and_HTML_character_entity_references&mobile-app=true&theme=dark
-            case (CharType)'&' : outIt = appendToOutputEscapeHelper<CharType>(outIt, "&amp;" ); break;
-            case (CharType)'<' : outIt = appendToOutputEscapeHelper<CharType>(outIt, "&lt;"  ); break;
-            case (CharType)'>' : outIt = appendToOutputEscapeHelper<CharType>(outIt, "&gt;"  ); break;
-            case (CharType)'\'': outIt = appendToOutputEscapeHelper<CharType>(outIt, "&apos;"); break;
-            case (CharType)'\"': outIt = appendToOutputEscapeHelper<CharType>(outIt, "&quot;"); break;
-            default:
-                                *outIt++ = ch;
+            MARTY_SVG_INSTR_ESCAPED();
+            outIt = escapeTextChar(outIt, ch, replaceChar);
         }
     }
 
@@ -61,52 +262,387 @@ OutputIterator escapeText(OutputIterator outIt, InputIterator b, InputIterator e
 }
 
 //----------------------------------------------------------------------------
+template<typename OutputIterator> inline
+OutputIterator escapeText(OutputIterator outIt, const char* b, const char* e, char replaceChar=0)
+{
+    MARTY_SVG_INSTR_ESCAPE_SCOPE(std::size_t(e-b));
+
+    escapeTextRuns( b, e
+                  , [&](const char* p, std::size_t size)
+                    {
+                        outIt = std::copy(p, p+size, outIt);
+                    }
+                  , replaceChar
+                  );
+    return outIt;
+}
+
+//----------------------------------------------------------------------------
+//! Экранированная копия строки; строка без символов для экранирования копируется как есть
+/*! Копия - это аллокация для длинных строк; без неё обходятся escapeText(str, buf) и writeEscapedText.
+ */
 template<typename StringType> inline
 StringType escapeText(const StringType &str)
 {
-    StringType res; res.reserve(str.size());
-    escapeText(std::back_inserter(res), str.begin(), str.end());
-    return res;
+    using CharType = typename StringType::value_type;
+
+    MARTY_SVG_INSTR_ESCAPE_SCOPE(str.size());
+
+    if constexpr (sizeof(CharType)==1)
+    {
+        const char* b = (const char*)str.data();
+        const char* e = b + str.size();
+
+        if (findEscapeTextChar(b, e)==e)
+            return str; // Экранировать нечего
+
+        StringType res; res.reserve(str.size()+str.size()/8u);
+        escapeTextRuns( b, e
+                      , [&](const char* p, std::size_t size)
+                        {
+                            res.append((const CharType*)p, size);
+                        }
+                      );
+        return res;
+    }
+    else
+    {
+        StringType res; res.reserve(str.size());
+        escapeText(std::back_inserter(res), str.begin(), str.end());
+        return res;
+    }
+}
+
+//----------------------------------------------------------------------------
+//! Экранирует str в buf; если экранировать нечего - возвращает саму str, buf не трогается
+/*! Результат действителен, пока живы str и buf. buf можно переиспользовать между вызовами - тогда
+    и строки с экранированием, после первых, обходятся без аллокаций.
+ */
+inline
+std::string_view escapeText(std::string_view str, std::string &buf)
+{
+    MARTY_SVG_INSTR_ESCAPE_SCOPE(str.size());
+
+    const char* b = str.data();
+    const char* e = b + str.size();
+
+    if (findEscapeTextChar(b, e)==e)
+        return str; // Экранировать нечего
+
+    buf.clear();
+    escapeTextRuns( b, e
+                  , [&](const char* p, std::size_t size)
+                    {
+                        buf.append(p, size);
+                    }
+                  );
+    return buf;
+}
+
+//----------------------------------------------------------------------------
+//! Пишет экранированный текст прямо в поток, без промежуточной строки
+template<typename StreamType> inline
+void writeEscapedText(StreamType &oss, std::string_view str)
+{
+    MARTY_SVG_INSTR_ESCAPE_SCOPE(str.size());
+
+    escapeTextRuns( str.data(), str.data()+str.size()
+                  , [&](const char* p, std::size_t size)
+                    {
+                        oss << std::string_view(p, size);
+                    }
+                  );
+}
+
+//----------------------------------------------------------------------------
+//! Ключевые слова SVG для значений перечислений; invalid и неизвестные значения дают значение по умолчанию
+constexpr
+std::string_view svgKeyword(LineJoin v)
+{
+    constexpr std::string_view keywords[] = { "miter", "round", "bevel", "arcs", "miter-clip" };
+    return std::uint32_t(v)<std::size(keywords) ? keywords[std::uint32_t(v)] : keywords[0];
+}
+
+constexpr
+std::string_view svgKeyword(DominantBaseline v)
+{
+    constexpr std::string_view keywords[] = { "auto", "text-bottom", "alphabetic", "ideographic", "middle", "central", "mathematical", "hanging", "text-top" };
+    return std::uint32_t(v)<std::size(keywords) ? keywords[std::uint32_t(v)] : keywords[0];
+}
+
+constexpr
+std::string_view svgKeyword(TextAnchor v)
+{
+    constexpr std::string_view keywords[] = { "start", "middle", "end" };
+    return std::uint32_t(v)<std::size(keywords) ? keywords[std::uint32_t(v)] : keywords[0];
+}
+
+
+//----------------------------------------------------------------------------
+//! Открывающий тег <svg> документа writeSvg, с переводом строки
+template<typename StreamType>
+void writeSvgOpenTag( StreamType &oss
+                    , int viewPosX , int viewPosY
+                    , int viewSizeX, int viewSizeY
+                    )
+{
+    oss << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"100%\" viewBox=\"" << viewPosX << " " << viewPosY << " " << viewSizeX << " " << viewSizeY << "\" style=\"max-width: 1026px;\">\n";
 }
 
+//----------------------------------------------------------------------------
+//! Начало документа writeSvg - тег <svg> и стили; для вывода тела частями, без сборки в одну строку
+template<typename StreamType>
+void writeSvgHeader( StreamType &oss
+                   , int viewPosX , int viewPosY
+                   , int viewSizeX, int viewSizeY
+                   , std::string_view style
+                   )
+{
+    writeSvgOpenTag(oss, viewPosX, viewPosY, viewSizeX, viewSizeY);
+    oss << style << "\n";
+}
 
 //----------------------------------------------------------------------------
+//! Конец документа writeSvg, после тела
+template<typename StreamType>
+void writeSvgFooter(StreamType &oss)
+{
+    oss << "\n";
+    oss << "</svg>\n";
+}
+
+//----------------------------------------------------------------------------
+//! writeSvg с началом координат viewBox - для вывода окна (части) диаграммы
 template<typename StreamType>
 void writeSvg( StreamType &oss
+             , int viewPosX , int viewPosY
              , int viewSizeX, int viewSizeY
-             , const std::string &style
-             , const std::string &text
+             , std::string_view style
+             , std::string_view text
              )
 {
-    oss << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"100%\" viewBox=\"0 0 " << viewSizeX << " " << viewSizeY << "\" style=\"max-width: 1026px;\">\n";
-    oss << style << "\n";
-    oss << text << "\n";
-    oss << "</svg>\n";
+    MARTY_SVG_INSTR_SCOPE(writeSvg, oss);
+
+    writeSvgHeader(oss, viewPosX, viewPosY, viewSizeX, viewSizeY, style);
+    oss << text;
+    writeSvgFooter(oss);
 }
 
 //----------------------------------------------------------------------------
 template<typename StreamType>
-void pathStart(StreamType &oss, int posX, int posY, const std::string &pathClass=std::string(), bool bAbs=false )
+void writeSvg( StreamType &oss
+             , int viewSizeX, int viewSizeY
+             , std::string_view style
+             , std::string_view text
+             )
+{
+    writeSvg(oss, 0, 0, viewSizeX, viewSizeY, style, text);
+}
+
+//----------------------------------------------------------------------------
+//! Хук сразу после имени тега элемента ("<path ", "<rect " и т.п.) - место для атрибута id; по умолчанию ничего не делает
+/*! Перегружается для потоков, назначающих элементам id (см. SvgIdStream в frame_diff.h).
+    Этот и остальные хуки для обёрток (SvgStreamWrapper) по умолчанию передаются во вложенный поток.
+ */
+template<typename StreamType> inline
+void elementTagOpened(StreamType &oss)
 {
+    if constexpr (IsSvgStreamWrapper<StreamType>::value)
+        elementTagOpened(oss.stream());
+    else
+        (void)oss;
+}
+
+//----------------------------------------------------------------------------
+//! Хуки учёта габаритов: примитивы сообщают через них свою геометрию; по умолчанию ничего не делают
+/*! Перегружаются для потоков, считающих габариты (см. SvgBoundsStream в bounds_tracker.h).
+    strokeWidth<0 - стиль задан классом, толщина линии неизвестна. r у boundsRect - радиус скругления
+    углов (rx/ry у <rect>), 0 - углы прямые.
+ */
+template<typename StreamType, typename CoordType> inline
+void boundsPathStart(StreamType &oss, CoordType posX, CoordType posY, bool bAbs, int strokeWidth, std::string_view linejoin)
+{
+    if constexpr (IsSvgStreamWrapper<StreamType>::value)
+        boundsPathStart(oss.stream(), posX, posY, bAbs, strokeWidth, linejoin);
+    else
+        { (void)oss; (void)posX; (void)posY; (void)bAbs; (void)strokeWidth; (void)linejoin; }
+}
+
+template<typename StreamType, typename CoordType> inline
+void boundsPathLineTo(StreamType &oss, CoordType posX, CoordType posY, bool bAbs)
+{
+    if constexpr (IsSvgStreamWrapper<StreamType>::value)
+        boundsPathLineTo(oss.stream(), posX, posY, bAbs);
+    else
+        { (void)oss; (void)posX; (void)posY; (void)bAbs; }
+}
+
+template<typename StreamType, typename CoordType> inline
+void boundsPathHorzLineTo(StreamType &oss, CoordType posX, bool bAbs)
+{
+    if constexpr (IsSvgStreamWrapper<StreamType>::value)
+        boundsPathHorzLineTo(oss.stream(), posX, bAbs);
+    else
+        { (void)oss; (void)posX; (void)bAbs; }
+}
+
+template<typename StreamType, typename CoordType> inline
+void boundsPathVertLineTo(StreamType &oss, CoordType posY, bool bAbs)
+{
+    if constexpr (IsSvgStreamWrapper<StreamType>::value)
+        boundsPathVertLineTo(oss.stream(), posY, bAbs);
+    else
+        { (void)oss; (void)posY; (void)bAbs; }
+}
+
+template<typename StreamType, typename CoordType> inline
+void boundsPathQuadraticBezier(StreamType &oss, CoordType cpX, CoordType cpY, CoordType endX, CoordType endY, bool bAbs)
+{
+    if constexpr (IsSvgStreamWrapper<StreamType>::value)
+        boundsPathQuadraticBezier(oss.stream(), cpX, cpY, endX, endY, bAbs);
+    else
+        { (void)oss; (void)cpX; (void)cpY; (void)endX; (void)endY; (void)bAbs; }
+}
+
+template<typename StreamType> inline
+void boundsPathEnd(StreamType &oss, bool closePath)
+{
+    if constexpr (IsSvgStreamWrapper<StreamType>::value)
+        boundsPathEnd(oss.stream(), closePath);
+    else
+        { (void)oss; (void)closePath; }
+}
+
+template<typename StreamType, typename CoordType> inline
+void boundsRect(StreamType &oss, CoordType posX, CoordType posY, CoordType sizeX, CoordType sizeY, CoordType r, int strokeWidth)
+{
+    if constexpr (IsSvgStreamWrapper<StreamType>::value)
+        boundsRect(oss.stream(), posX, posY, sizeX, sizeY, r, strokeWidth);
+    else
+        { (void)oss; (void)posX; (void)posY; (void)sizeX; (void)sizeY; (void)r; (void)strokeWidth; }
+}
+
+template<typename StreamType, typename CoordType> inline
+void boundsLine(StreamType &oss, CoordType startX, CoordType startY, CoordType endX, CoordType endY, int strokeWidth)
+{
+    if constexpr (IsSvgStreamWrapper<StreamType>::value)
+        boundsLine(oss.stream(), startX, startY, endX, endY, strokeWidth);
+    else
+        { (void)oss; (void)startX; (void)startY; (void)endX; (void)endY; (void)strokeWidth; }
+}
+
+template<typename StreamType, typename CoordType> inline
+void boundsText(StreamType &oss, CoordType posX, CoordType posY, std::string_view text, std::string_view baseLine, std::string_view hAlign)
+{
+    if constexpr (IsSvgStreamWrapper<StreamType>::value)
+        boundsText(oss.stream(), posX, posY, text, baseLine, hAlign);
+    else
+        { (void)oss; (void)posX; (void)posY; (void)text; (void)baseLine; (void)hAlign; }
+}
+
+//----------------------------------------------------------------------------
+//! Начало атрибута d - начальный moveto. Вызывается из pathStart, обёртки потока могут его перегружать
+/*! Здесь и далее координаты - целые, float/double или SvgFixed16 (см. svg_coord.h). Вызовы с
+    координатами разных арифметических типов принимают перегрузки, приводящие их к общему типу
+    SvgMixedCoordType: целые - к int, с плавающими - к double/float, без потери дробной части.
+
+    pathBeginData и path*Data ниже только выводят данные пути, хуки bounds* вызывают pathStart/pathLineTo
+    и т.д.; поэтому обёртка, меняющая запись пути (CompactPathStream), перегружает path*Data, и при
+    любом порядке вложения обёрток каждый участок пути и выводится, и учитывается ровно один раз.
+ */
+template<typename StreamType, typename CoordType>
+void pathBeginData(StreamType &oss, CoordType posX, CoordType posY, bool bAbs)
+{
+    if constexpr (IsSvgStreamWrapper<StreamType>::value)
+        pathBeginData(oss.stream(), posX, posY, bAbs);
+    else
+        oss << "d=\"" << (bAbs?'M':'m') << " " << formatCoord(oss, posX) << " " << formatCoord(oss, posY);
+}
+
+//----------------------------------------------------------------------------
+template<typename StreamType, typename CoordType>
+void pathLineToData(StreamType &oss, CoordType posX, CoordType posY, bool bAbs)
+{
+    if constexpr (IsSvgStreamWrapper<StreamType>::value)
+        pathLineToData(oss.stream(), posX, posY, bAbs);
+    else
+        oss << " " << (bAbs?'L':'l') << " " << formatCoord(oss, posX) << " " << formatCoord(oss, posY);
+}
+
+template<typename StreamType, typename CoordType>
+void pathHorzLineToData(StreamType &oss, CoordType posX, bool bAbs)
+{
+    if constexpr (IsSvgStreamWrapper<StreamType>::value)
+        pathHorzLineToData(oss.stream(), posX, bAbs);
+    else
+        oss << " " << (bAbs?'H':'h') << " " << formatCoord(oss, posX);
+}
+
+template<typename StreamType, typename CoordType>
+void pathVertLineToData(StreamType &oss, CoordType posY, bool bAbs)
+{
+    if constexpr (IsSvgStreamWrapper<StreamType>::value)
+        pathVertLineToData(oss.stream(), posY, bAbs);
+    else
+        oss << " " << (bAbs?'V':'v') << " " << formatCoord(oss, posY);
+}
+
+template<typename StreamType, typename CoordType>
+void pathQuadraticBezierData(StreamType &oss, CoordType cpX, CoordType cpY, CoordType endX, CoordType endY, bool bAbs)
+{
+    if constexpr (IsSvgStreamWrapper<StreamType>::value)
+        pathQuadraticBezierData(oss.stream(), cpX, cpY, endX, endY, bAbs);
+    else
+        oss << " " << (bAbs?'Q':'q') << " " << formatCoord(oss, cpX) << " " << formatCoord(oss, cpY) << " " << formatCoord(oss, endX) << " " << formatCoord(oss, endY);
+}
+
+//! Конец атрибута d и тега пути
+template<typename StreamType>
+void pathEndData(StreamType &oss, bool closePath)
+{
+    if constexpr (IsSvgStreamWrapper<StreamType>::value)
+        pathEndData(oss.stream(), closePath);
+    else
+        oss << (closePath ? " z" : "") << "\" />\n";
+}
+
+//----------------------------------------------------------------------------
+template<typename StreamType, typename CoordType>
+void pathStart(StreamType &oss, CoordType posX, CoordType posY, std::string_view pathClass=std::string_view(), bool bAbs=false )
+{
+    MARTY_SVG_INSTR_SCOPE(pathStart, oss);
+
+    boundsPathStart(oss, posX, posY, bAbs, -1, std::string_view());
+
     oss << "<path ";
+    elementTagOpened(oss);
     if (!pathClass.empty())
     {
         oss << "class=\"" << pathClass << "\" ";
     }
-    oss << "d=\"" << (bAbs?'M':'m') << " " << posX << " " << posY;
+    pathBeginData(oss, posX, posY, bAbs);
+}
+
+//! Координаты разных типов - приводятся к SvgMixedCoordType
+template< typename StreamType, typename XType, typename YType
+        , typename std::enable_if<SvgMixedCoords<XType, YType>::value, int>::type = 0
+        >
+void pathStart(StreamType &oss, XType posX, YType posY, std::string_view pathClass=std::string_view(), bool bAbs=false )
+{
+    using CoordType = SvgMixedCoordType<XType, YType>;
+    pathStart<StreamType, CoordType>(oss, CoordType(posX), CoordType(posY), pathClass, bAbs);
 }
 
 //----------------------------------------------------------------------------
+//! Атрибуты стиля пути: stroke, stroke-width, stroke-linejoin и fill/fill-opacity
 template<typename StreamType>
-void pathStart( StreamType &oss, int posX, int posY
-              , int strokeWidth, const std::string &strokeColor
-              , const std::string &fillColor=std::string() /* no fill if empty */
-              , std::string linejoin=std::string() /* no fill if empty */
-              , bool bAbs=false )
+void writePathStyleAttributes( StreamType &oss
+                             , int strokeWidth, std::string_view strokeColor
+                             , std::string_view fillColor /* no fill if empty */
+                             , std::string_view linejoin  /* miter if empty */
+                             )
 {
-
-    oss << "<path ";
-    oss << "stroke=\"" << escapeText(strokeColor) << "\" ";
+    oss << "stroke=\""; writeEscapedText(oss, strokeColor); oss << "\" ";
     oss << "stroke-width=\"" << strokeWidth << "\" ";
     if (linejoin.empty())
         linejoin = "miter";
@@ -114,64 +650,154 @@ void pathStart( StreamType &oss, int posX, int posY
 
     if (!fillColor.empty())
     {
-        oss << "fill=\"" << escapeText(fillColor) << "\" ";
+        oss << "fill=\""; writeEscapedText(oss, fillColor); oss << "\" ";
     }
     else
     {
         oss << "fill-opacity=\"0\" "; // Непрозрачность - нулевая
     }
+}
 
-    oss << "d=\"" << (bAbs?'M':'m') << " " << posX << " " << posY;
+template<typename StreamType>
+void writePathStyleAttributes( StreamType &oss
+                             , int strokeWidth, std::string_view strokeColor
+                             , std::string_view fillColor /* no fill if empty */
+                             , LineJoin linejoin
+                             )
+{
+    writePathStyleAttributes(oss, strokeWidth, strokeColor, fillColor, svgKeyword(linejoin));
 }
 
 //----------------------------------------------------------------------------
-template<typename StreamType>
-void pathLineTo(StreamType &oss, int posX, int posY, bool bAbs=false)
+template<typename StreamType, typename CoordType>
+void pathStart( StreamType &oss, CoordType posX, CoordType posY
+              , int strokeWidth, std::string_view strokeColor
+              , std::string_view fillColor=std::string_view() /* no fill if empty */
+              , std::string_view linejoin=std::string_view() /* miter if empty */
+              , bool bAbs=false )
 {
-    oss << " " << (bAbs?'L':'l') << " " << posX << " " << posY;
+    MARTY_SVG_INSTR_SCOPE(pathStart, oss);
+
+    boundsPathStart(oss, posX, posY, bAbs, strokeWidth, linejoin);
+
+    oss << "<path ";
+    elementTagOpened(oss);
+    writePathStyleAttributes(oss, strokeWidth, strokeColor, fillColor, linejoin);
+
+    pathBeginData(oss, posX, posY, bAbs);
+}
+
+template< typename StreamType, typename XType, typename YType
+        , typename std::enable_if<SvgMixedCoords<XType, YType>::value, int>::type = 0
+        >
+void pathStart( StreamType &oss, XType posX, YType posY
+              , int strokeWidth, std::string_view strokeColor
+              , std::string_view fillColor=std::string_view() /* no fill if empty */
+              , std::string_view linejoin=std::string_view() /* miter if empty */
+              , bool bAbs=false )
+{
+    using CoordType = SvgMixedCoordType<XType, YType>;
+    pathStart<StreamType, CoordType>(oss, CoordType(posX), CoordType(posY), strokeWidth, strokeColor, fillColor, linejoin, bAbs);
+}
+
+//! То же, stroke-linejoin задаётся перечислением
+template<typename StreamType, typename CoordType>
+void pathStart( StreamType &oss, CoordType posX, CoordType posY
+              , int strokeWidth, std::string_view strokeColor
+              , std::string_view fillColor /* no fill if empty */
+              , LineJoin linejoin
+              , bool bAbs=false )
+{
+    pathStart(oss, posX, posY, strokeWidth, strokeColor, fillColor, svgKeyword(linejoin), bAbs);
+}
+
+template< typename StreamType, typename XType, typename YType
+        , typename std::enable_if<SvgMixedCoords<XType, YType>::value, int>::type = 0
+        >
+void pathStart( StreamType &oss, XType posX, YType posY
+              , int strokeWidth, std::string_view strokeColor
+              , std::string_view fillColor /* no fill if empty */
+              , LineJoin linejoin
+              , bool bAbs=false )
+{
+    using CoordType = SvgMixedCoordType<XType, YType>;
+    pathStart<StreamType, CoordType>(oss, CoordType(posX), CoordType(posY), strokeWidth, strokeColor, fillColor, svgKeyword(linejoin), bAbs);
 }
 
 //----------------------------------------------------------------------------
-template<typename StreamType>
-void pathHorzLineTo(StreamType &oss, int posX, bool bAbs=false)
+template<typename StreamType, typename CoordType>
+void pathLineTo(StreamType &oss, CoordType posX, CoordType posY, bool bAbs=false)
+{
+    boundsPathLineTo(oss, posX, posY, bAbs);
+    pathLineToData(oss, posX, posY, bAbs);
+}
+
+template< typename StreamType, typename XType, typename YType
+        , typename std::enable_if<SvgMixedCoords<XType, YType>::value, int>::type = 0
+        >
+void pathLineTo(StreamType &oss, XType posX, YType posY, bool bAbs=false)
 {
-    oss << " " << (bAbs?'H':'h') << " " << posX ;
+    using CoordType = SvgMixedCoordType<XType, YType>;
+    pathLineTo<StreamType, CoordType>(oss, CoordType(posX), CoordType(posY), bAbs);
 }
 
 //----------------------------------------------------------------------------
-template<typename StreamType>
-void pathVertLineTo(StreamType &oss, int posY, bool bAbs=false)
+template<typename StreamType, typename CoordType>
+void pathHorzLineTo(StreamType &oss, CoordType posX, bool bAbs=false)
 {
-    oss << " " << (bAbs?'V':'v') << " " << posY ;
+    boundsPathHorzLineTo(oss, posX, bAbs);
+    pathHorzLineToData(oss, posX, bAbs);
 }
 
 //----------------------------------------------------------------------------
-template<typename StreamType>
-void pathQuadraticBezier(StreamType &oss, int cpX, int cpY, int endX, int endY, bool bAbs=false)
+template<typename StreamType, typename CoordType>
+void pathVertLineTo(StreamType &oss, CoordType posY, bool bAbs=false)
 {
-    oss << " " << (bAbs?'Q':'q') << " " << cpX << " " << cpY << " " << endX << " " << endY;
+    boundsPathVertLineTo(oss, posY, bAbs);
+    pathVertLineToData(oss, posY, bAbs);
 }
 
 //----------------------------------------------------------------------------
-template<typename StreamType>
-void pathEnd(StreamType &oss, bool closePath=true)
+template<typename StreamType, typename CoordType>
+void pathQuadraticBezier(StreamType &oss, CoordType cpX, CoordType cpY, CoordType endX, CoordType endY, bool bAbs=false)
 {
-    oss << (closePath ? " z" : "") << "\" />\n";
+    boundsPathQuadraticBezier(oss, cpX, cpY, endX, endY, bAbs);
+    pathQuadraticBezierData(oss, cpX, cpY, endX, endY, bAbs);
+}
+
+template< typename StreamType, typename CpXType, typename CpYType, typename EndXType, typename EndYType
+        , typename std::enable_if<SvgMixedCoords<CpXType, CpYType, EndXType, EndYType>::value, int>::type = 0
+        >
+void pathQuadraticBezier(StreamType &oss, CpXType cpX, CpYType cpY, EndXType endX, EndYType endY, bool bAbs=false)
+{
+    using CoordType = SvgMixedCoordType<CpXType, CpYType, EndXType, EndYType>;
+    pathQuadraticBezier<StreamType, CoordType>(oss, CoordType(cpX), CoordType(cpY), CoordType(endX), CoordType(endY), bAbs);
 }
 
 //----------------------------------------------------------------------------
 template<typename StreamType>
-void drawRectEx( StreamType &oss
-               , int  posX , int posY
-               , int  sizeX, int sizeY
-               , int r
-               , int strokeWidth
-               , const std::string &strokeColor
-               , const std::string &fillColor = std::string() // no fill if empty
-               , RoundRectFlags flags=RoundRectFlags::round /* для отладки */  // RoundRectFlags::none
-               )
+void pathEnd(StreamType &oss, bool closePath=true)
 {
+    MARTY_SVG_INSTR_SCOPE(pathEnd, oss);
+
+    boundsPathEnd(oss, closePath);
+    pathEndData(oss, closePath);
+}
 
+//----------------------------------------------------------------------------
+//! Геометрия drawRectEx; начало пути (тег и атрибуты) выводит pathStartHandler(CoordType startX, CoordType startY)
+/*! Замер MARTY_SVG_INSTR_SCOPE(drawRectEx) - в вызывающих: символ инстансинга, выводимый через эту
+    функцию в <defs>, вызовом drawRectEx не считается.
+ */
+template<typename StreamType, typename CoordType, typename PathStartHandler>
+void drawRectExImpl( StreamType &oss
+                   , CoordType  posX , CoordType posY
+                   , CoordType  sizeX, CoordType sizeY
+                   , CoordType r
+                   , RoundRectFlags flags
+                   , PathStartHandler pathStartHandler
+                   )
+{
     // stroke="blue"
     // fill="purple"
     // fill-opacity="0.5"
@@ -254,10 +880,12 @@ void drawRectEx( StreamType &oss
     // roundTop           = roundLeftTop    | roundRightTop /*!< Top side angles are round */,
     // roundBottom        = roundLeftBottom | roundRightBottom /*!< Bottom side angles are round */,
 
-    int topSizeX    = sizeX;
-    int bottomSizeX = sizeX;
-    int leftSizeY   = sizeY;
-    int rightSizeY  = sizeY;
+    CoordType topSizeX    = sizeX;
+    CoordType bottomSizeX = sizeX;
+    CoordType leftSizeY   = sizeY;
+    CoordType rightSizeY  = sizeY;
+
+    const CoordType zero  = CoordType(0);
 
     if ((flags&RoundRectFlags::roundLeftTop)!=0)
     {
@@ -288,33 +916,33 @@ void drawRectEx( StreamType &oss
     // Начинаем с него
     if ((flags&RoundRectFlags::roundLeftTop)!=0)
     {
-        pathStart(oss, posX, posY+r, strokeWidth, strokeColor, fillColor, std::string(), true /* bAbs */ );
-        pathQuadraticBezier(oss, 0, -r, r, -r);
+        pathStartHandler(posX, posY+r);
+        pathQuadraticBezier(oss, zero, -r, r, -r);
     }
     else
     {
-        pathStart(oss, posX, posY, strokeWidth, strokeColor, fillColor, std::string(), true /* bAbs */ );
+        pathStartHandler(posX, posY);
     }
 
     pathHorzLineTo(oss, topSizeX);
 
     if ((flags&RoundRectFlags::roundRightTop)!=0)
     {
-        pathQuadraticBezier(oss, r, 0, r, r);
+        pathQuadraticBezier(oss, r, zero, r, r);
     }
 
     pathVertLineTo(oss, rightSizeY);
 
     if ((flags&RoundRectFlags::roundRightBottom)!=0)
     {
-        pathQuadraticBezier(oss, 0, r, -r, r);
+        pathQuadraticBezier(oss, zero, r, -r, r);
     }
 
     pathHorzLineTo(oss, -bottomSizeX);
 
     if ((flags&RoundRectFlags::roundLeftBottom)!=0)
     {
-        pathQuadraticBezier(oss, -r, 0, -r, -r);
+        pathQuadraticBezier(oss, -r, zero, -r, -r);
     }
 
     pathVertLineTo(oss, -leftSizeY);
@@ -323,15 +951,90 @@ void drawRectEx( StreamType &oss
 
 }
 
+//----------------------------------------------------------------------------
+template<typename StreamType, typename CoordType>
+void drawRectEx( StreamType &oss
+               , CoordType  posX , CoordType posY
+               , CoordType  sizeX, CoordType sizeY
+               , CoordType r
+               , int strokeWidth
+               , std::string_view strokeColor
+               , std::string_view fillColor = std::string_view() // no fill if empty
+               , RoundRectFlags flags=RoundRectFlags::round /* для отладки */  // RoundRectFlags::none
+               )
+{
+    MARTY_SVG_INSTR_SCOPE(drawRectEx, oss);
+
+    drawRectExImpl( oss, posX, posY, sizeX, sizeY, r, flags
+                  , [&](CoordType startX, CoordType startY)
+                    {
+                        pathStart(oss, startX, startY, strokeWidth, strokeColor, fillColor, std::string_view(), true /* bAbs */ );
+                    }
+                  );
+}
 
-template<typename StreamType>
+template< typename StreamType, typename PosXType, typename PosYType, typename SizeXType, typename SizeYType, typename RType
+        , typename std::enable_if<SvgMixedCoords<PosXType, PosYType, SizeXType, SizeYType, RType>::value, int>::type = 0
+        >
+void drawRectEx( StreamType &oss
+               , PosXType  posX , PosYType  posY
+               , SizeXType sizeX, SizeYType sizeY
+               , RType r
+               , int strokeWidth
+               , std::string_view strokeColor
+               , std::string_view fillColor = std::string_view() // no fill if empty
+               , RoundRectFlags flags=RoundRectFlags::round
+               )
+{
+    using CoordType = SvgMixedCoordType<PosXType, PosYType, SizeXType, SizeYType, RType>;
+    drawRectEx<StreamType, CoordType>(oss, CoordType(posX), CoordType(posY), CoordType(sizeX), CoordType(sizeY), CoordType(r), strokeWidth, strokeColor, fillColor, flags);
+}
+
+//----------------------------------------------------------------------------
+//! То же, но стиль задаётся классом
+template<typename StreamType, typename CoordType>
+void drawRectEx( StreamType &oss
+               , CoordType  posX , CoordType posY
+               , CoordType  sizeX, CoordType sizeY
+               , CoordType r
+               , std::string_view itemClass
+               , RoundRectFlags flags=RoundRectFlags::round
+               )
+{
+    MARTY_SVG_INSTR_SCOPE(drawRectEx, oss);
+
+    drawRectExImpl( oss, posX, posY, sizeX, sizeY, r, flags
+                  , [&](CoordType startX, CoordType startY)
+                    {
+                        pathStart(oss, startX, startY, itemClass, true /* bAbs */ );
+                    }
+                  );
+}
+
+template< typename StreamType, typename PosXType, typename PosYType, typename SizeXType, typename SizeYType, typename RType
+        , typename std::enable_if<SvgMixedCoords<PosXType, PosYType, SizeXType, SizeYType, RType>::value, int>::type = 0
+        >
+void drawRectEx( StreamType &oss
+               , PosXType  posX , PosYType  posY
+               , SizeXType sizeX, SizeYType sizeY
+               , RType r
+               , std::string_view itemClass
+               , RoundRectFlags flags=RoundRectFlags::round
+               )
+{
+    using CoordType = SvgMixedCoordType<PosXType, PosYType, SizeXType, SizeYType, RType>;
+    drawRectEx<StreamType, CoordType>(oss, CoordType(posX), CoordType(posY), CoordType(sizeX), CoordType(sizeY), CoordType(r), itemClass, flags);
+}
+
+
+template<typename StreamType, typename CoordType>
 void drawRect( StreamType &oss
-             , int  posX , int posY
-             , int  sizeX, int sizeY
-             , const std::string &itemClass
+             , CoordType  posX , CoordType posY
+             , CoordType  sizeX, CoordType sizeY
+             , std::string_view itemClass
              , bool roundLeft
              , bool roundRight
-             , int  r
+             , CoordType  r
              )
 {
     // https://stackoverflow.com/questions/34923888/rounded-corner-only-on-one-side-of-svg-rect
@@ -341,23 +1044,33 @@ void drawRect( StreamType &oss
 
     // https://developer.mozilla.org/en-US/docs/Web/CSS/stroke-linejoin
 
+    MARTY_SVG_INSTR_SCOPE(drawRect, oss);
+
+    const CoordType zero = CoordType(0);
+
     if (roundLeft && roundRight) // Both rounds
     {
-        oss << "<rect x=\"" << posX << "\" y=\"" << posY << "\" width=\"" << sizeX << "\" height=\"" << sizeY << "\" rx=\"" << r << "\" ry=\"" << r << "\" class=\"" << itemClass << "\" />\n";
+        boundsRect(oss, posX, posY, sizeX, sizeY, r, -1);
+        oss << "<rect ";
+        elementTagOpened(oss);
+        oss << "x=\"" << formatCoord(oss, posX) << "\" y=\"" << formatCoord(oss, posY) << "\" width=\"" << formatCoord(oss, sizeX) << "\" height=\"" << formatCoord(oss, sizeY) << "\" rx=\"" << formatCoord(oss, r) << "\" ry=\"" << formatCoord(oss, r) << "\" class=\"" << itemClass << "\" />\n";
     }
     else if (!roundLeft && !roundRight) // No rounds at all
     {
-        oss << "<rect x=\"" << posX << "\" y=\"" << posY << "\" width=\"" 
-            << sizeX << "\" height=\"" << sizeY << "\" class=\"" << itemClass << "\" />\n";
+        boundsRect(oss, posX, posY, sizeX, sizeY, zero, -1);
+        oss << "<rect ";
+        elementTagOpened(oss);
+        oss << "x=\"" << formatCoord(oss, posX) << "\" y=\"" << formatCoord(oss, posY) << "\" width=\"" 
+            << formatCoord(oss, sizeX) << "\" height=\"" << formatCoord(oss, sizeY) << "\" class=\"" << itemClass << "\" />\n";
     }
     else if (roundLeft)
     {
         pathStart(oss, posX+sizeX, posY, itemClass, true /* bAbs */);
         pathVertLineTo(oss, sizeY);
         pathHorzLineTo(oss, -(sizeX-r));
-        pathQuadraticBezier(oss, -r, 0, -r, -r);
+        pathQuadraticBezier(oss, -r, zero, -r, -r);
         pathVertLineTo(oss, -(sizeY-2*r));
-        pathQuadraticBezier(oss, 0, -r, r, -r);
+        pathQuadraticBezier(oss, zero, -r, r, -r);
         pathHorzLineTo(oss, (sizeX-r));
         pathEnd(oss, true /* closePath */ );
 
@@ -378,9 +1091,9 @@ void drawRect( StreamType &oss
         pathStart(oss, posX, posY, itemClass, true /* bAbs */);
         // pathVertLineTo(oss, sizeY);
         pathHorzLineTo(oss, (sizeX-r));
-        pathQuadraticBezier(oss, r, 0, r, r);
+        pathQuadraticBezier(oss, r, zero, r, r);
         pathVertLineTo(oss, (sizeY-2*r));
-        pathQuadraticBezier(oss, 0, r, -r, r);
+        pathQuadraticBezier(oss, zero, r, -r, r);
         pathHorzLineTo(oss, -(sizeX-r));
         pathEnd(oss, true /* closePath */ );
 
@@ -398,29 +1111,68 @@ void drawRect( StreamType &oss
 
 }
 
+template< typename StreamType, typename PosXType, typename PosYType, typename SizeXType, typename SizeYType, typename RType
+        , typename std::enable_if<SvgMixedCoords<PosXType, PosYType, SizeXType, SizeYType, RType>::value, int>::type = 0
+        >
+void drawRect( StreamType &oss
+             , PosXType  posX , PosYType  posY
+             , SizeXType sizeX, SizeYType sizeY
+             , std::string_view itemClass
+             , bool roundLeft
+             , bool roundRight
+             , RType r
+             )
+{
+    using CoordType = SvgMixedCoordType<PosXType, PosYType, SizeXType, SizeYType, RType>;
+    drawRect<StreamType, CoordType>(oss, CoordType(posX), CoordType(posY), CoordType(sizeX), CoordType(sizeY), itemClass, roundLeft, roundRight, CoordType(r));
+}
+
 //----------------------------------------------------------------------------
-template<typename StreamType>
+template<typename StreamType, typename CoordType>
+void drawLine( StreamType &oss
+             , CoordType startX, CoordType startY
+             , CoordType endX  , CoordType endY
+             , std::string_view lineClass
+             )
+{
+    MARTY_SVG_INSTR_SCOPE(drawLine, oss);
+
+    boundsLine(oss, startX, startY, endX, endY, -1);
+    oss << "<line ";
+    elementTagOpened(oss);
+    oss << "x1=\"" << formatCoord(oss, startX) << "\" y1=\"" << formatCoord(oss, startY) << "\" x2=\"" << formatCoord(oss, endX) << "\" y2=\"" << formatCoord(oss, endY) << "\" class=\"" << lineClass << "\"/>\n";
+}
+
+template< typename StreamType, typename StartXType, typename StartYType, typename EndXType, typename EndYType
+        , typename std::enable_if<SvgMixedCoords<StartXType, StartYType, EndXType, EndYType>::value, int>::type = 0
+        >
 void drawLine( StreamType &oss
-             , int startX, int startY
-             , int endX  , int endY
-             , const std::string &lineClass
+             , StartXType startX, StartYType startY
+             , EndXType   endX  , EndYType   endY
+             , std::string_view lineClass
              )
 {
-    oss << "<line x1=\"" << startX << "\" y1=\"" << startY << "\" x2=\"" << endX << "\" y2=\"" << endY << "\" class=\"" << lineClass << "\"/>\n";
+    using CoordType = SvgMixedCoordType<StartXType, StartYType, EndXType, EndYType>;
+    drawLine<StreamType, CoordType>(oss, CoordType(startX), CoordType(startY), CoordType(endX), CoordType(endY), lineClass);
 }
 
 //----------------------------------------------------------------------------
-template<typename StreamType>
+template<typename StreamType, typename CoordType>
 void drawLine( StreamType &oss
-             , int startX, int startY
-             , int endX  , int endY
+             , CoordType startX, CoordType startY
+             , CoordType endX  , CoordType endY
              , int strokeWidth
-             , const std::string &strokeColor
-              , std::string linejoin=std::string() /* no fill if empty */
+             , std::string_view strokeColor
+             , std::string_view linejoin=std::string_view() /* miter if empty */
              )
 {
-    oss << "<line x1=\"" << startX << "\" y1=\"" << startY << "\" x2=\"" << endX << "\" y2=\"" << endY << "\" ";
-    oss << "stroke=\"" << escapeText(strokeColor) << "\" ";
+    MARTY_SVG_INSTR_SCOPE(drawLine, oss);
+
+    boundsLine(oss, startX, startY, endX, endY, strokeWidth);
+    oss << "<line ";
+    elementTagOpened(oss);
+    oss << "x1=\"" << formatCoord(oss, startX) << "\" y1=\"" << formatCoord(oss, startY) << "\" x2=\"" << formatCoord(oss, endX) << "\" y2=\"" << formatCoord(oss, endY) << "\" ";
+    oss << "stroke=\""; writeEscapedText(oss, strokeColor); oss << "\" ";
     oss << "stroke-width=\"" << strokeWidth << "\" ";
     if (linejoin.empty())
         linejoin = "miter";
@@ -429,17 +1181,110 @@ void drawLine( StreamType &oss
     oss << " />\n";
 }
 
+template< typename StreamType, typename StartXType, typename StartYType, typename EndXType, typename EndYType
+        , typename std::enable_if<SvgMixedCoords<StartXType, StartYType, EndXType, EndYType>::value, int>::type = 0
+        >
+void drawLine( StreamType &oss
+             , StartXType startX, StartYType startY
+             , EndXType   endX  , EndYType   endY
+             , int strokeWidth
+             , std::string_view strokeColor
+             , std::string_view linejoin=std::string_view()
+             )
+{
+    using CoordType = SvgMixedCoordType<StartXType, StartYType, EndXType, EndYType>;
+    drawLine<StreamType, CoordType>(oss, CoordType(startX), CoordType(startY), CoordType(endX), CoordType(endY), strokeWidth, strokeColor, linejoin);
+}
+
+//! То же, stroke-linejoin задаётся перечислением
+template<typename StreamType, typename CoordType>
+void drawLine( StreamType &oss
+             , CoordType startX, CoordType startY
+             , CoordType endX  , CoordType endY
+             , int strokeWidth
+             , std::string_view strokeColor
+             , LineJoin linejoin
+             )
+{
+    drawLine(oss, startX, startY, endX, endY, strokeWidth, strokeColor, svgKeyword(linejoin));
+}
+
+template< typename StreamType, typename StartXType, typename StartYType, typename EndXType, typename EndYType
+        , typename std::enable_if<SvgMixedCoords<StartXType, StartYType, EndXType, EndYType>::value, int>::type = 0
+        >
+void drawLine( StreamType &oss
+             , StartXType startX, StartYType startY
+             , EndXType   endX  , EndYType   endY
+             , int strokeWidth
+             , std::string_view strokeColor
+             , LineJoin linejoin
+             )
+{
+    using CoordType = SvgMixedCoordType<StartXType, StartYType, EndXType, EndYType>;
+    drawLine<StreamType, CoordType>(oss, CoordType(startX), CoordType(startY), CoordType(endX), CoordType(endY), strokeWidth, strokeColor, svgKeyword(linejoin));
+}
+
 //----------------------------------------------------------------------------
-template<typename StreamType>
+template<typename StreamType, typename CoordType>
+void drawText( StreamType &oss
+             , CoordType  posX, CoordType posY
+             , std::string_view text
+             , std::string_view textClass
+             , std::string_view baseLine  = "auto" // auto|middle|hanging - https://developer.mozilla.org/en-US/docs/Web/SVG/Attribute/dominant-baseline
+             , std::string_view hAlign    = "start" // start|middle|end   - https://developer.mozilla.org/en-US/docs/Web/SVG/Attribute/text-anchor
+             )
+{
+    MARTY_SVG_INSTR_SCOPE(drawText, oss);
+
+    boundsText(oss, posX, posY, text, baseLine, hAlign);
+    oss << "<text ";
+    elementTagOpened(oss);
+    oss << "x=\"" << formatCoord(oss, posX) << "\" y=\"" << formatCoord(oss, posY) << "\" class=\"" << textClass << "\" dominant-baseline=\"" << baseLine << "\" text-anchor=\"" << hAlign << "\">";
+    writeEscapedText(oss, text);
+    oss << "</text>\n";
+}
+
+template< typename StreamType, typename XType, typename YType
+        , typename std::enable_if<SvgMixedCoords<XType, YType>::value, int>::type = 0
+        >
+void drawText( StreamType &oss
+             , XType posX, YType posY
+             , std::string_view text
+             , std::string_view textClass
+             , std::string_view baseLine  = "auto"
+             , std::string_view hAlign    = "start"
+             )
+{
+    using CoordType = SvgMixedCoordType<XType, YType>;
+    drawText<StreamType, CoordType>(oss, CoordType(posX), CoordType(posY), text, textClass, baseLine, hAlign);
+}
+
+//! То же, выравнивание задаётся перечислениями
+template<typename StreamType, typename CoordType>
+void drawText( StreamType &oss
+             , CoordType  posX, CoordType posY
+             , std::string_view text
+             , std::string_view textClass
+             , DominantBaseline baseLine
+             , TextAnchor       hAlign = TextAnchor::start
+             )
+{
+    drawText(oss, posX, posY, text, textClass, svgKeyword(baseLine), svgKeyword(hAlign));
+}
+
+template< typename StreamType, typename XType, typename YType
+        , typename std::enable_if<SvgMixedCoords<XType, YType>::value, int>::type = 0
+        >
 void drawText( StreamType &oss
-             , int  posX, int posY
-             , const std::string &text
-             , const std::string &textClass
-             , const std::string &baseLine  = "auto" // auto|middle|hanging - https://developer.mozilla.org/en-US/docs/Web/SVG/Attribute/dominant-baseline
-             , const std::string &hAlign    = "start" // start|middle|end   - https://developer.mozilla.org/en-US/docs/Web/SVG/Attribute/text-anchor
+             , XType posX, YType posY
+             , std::string_view text
+             , std::string_view textClass
+             , DominantBaseline baseLine
+             , TextAnchor       hAlign = TextAnchor::start
              )
 {
-    oss << "<text x=\"" << posX << "\" y=\"" << posY << "\" class=\"" << textClass << "\" dominant-baseline=\"" << baseLine << "\" text-anchor=\"" << hAlign << "\">" << escapeText(text) << "</text>\n";
+    using CoordType = SvgMixedCoordType<XType, YType>;
+    drawText<StreamType, CoordType>(oss, CoordType(posX), CoordType(posY), text, textClass, svgKeyword(baseLine), svgKeyword(hAlign));
 }
 
 //----------------------------------------------------------------------------
@@ -0,0 +1,256 @@
+/*! \file
+    \brief Параллельная генерация SVG: элементы выводятся несколькими потоками в буферы кусков, склейка - в порядке индексов
+
+    Использует std::thread - при сборке нужна библиотека потоков (Threads::Threads в CMake, -pthread).
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include "marty_svg.h"
+//
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/parallel_writer.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+//! Параллельный вывод элементов с детерминированным результатом
+/*! Диапазон индексов элементов [0, count) делится на куски по chunkSize; потоки забирают
+    следующий свободный кусок через атомарный счётчик (без мьютексов) и пишут его в собственный
+    SvgWriter этого куска. Результат - конкатенация кусков по возрастанию индексов, то есть
+    ровно то, что дал бы последовательный вызов drawFn(oss, 0) ... drawFn(oss, count-1),
+    независимо от числа потоков.
+
+    drawFn(SvgWriter &oss, std::size_t idx) вызывается из разных потоков одновременно, поэтому
+    не должен менять общее состояние без синхронизации (например, SvgStyleRegistry или
+    SvgShapeInstancer - их нужно заполнить заранее или завести по одному на поток).
+
+    Буферы кусков переиспользуются между вызовами generate().
+
+    \code
+    marty::svg::SvgParallelWriter pw;
+    pw.generate(1000000, [&](marty::svg::SvgWriter &oss, std::size_t i)
+    {
+        marty::svg::drawRectEx(oss, x(i), y(i), 120, 40, 8, 1, "black");
+    });
+    pw.writeSvg(out, 10000, 10000, style);
+    \endcode
+ */
+class SvgParallelWriter
+{
+
+public:
+
+    //! nThreads==0 - по числу аппаратных потоков
+    explicit SvgParallelWriter(unsigned nThreads=0, std::size_t chunkSize=4096)
+    : m_nThreads(nThreads ? nThreads : std::max(1u, std::thread::hardware_concurrency()))
+    , m_chunkSize(chunkSize ? chunkSize : 1u)
+    {}
+
+    SvgParallelWriter(const SvgParallelWriter&) = delete;
+    SvgParallelWriter& operator=(const SvgParallelWriter&) = delete;
+
+    unsigned    threadCount() const { return m_nThreads; }
+    std::size_t chunkSize()   const { return m_chunkSize; }
+
+    //! Выводит элементы [0, count); исключение из drawFn останавливает раздачу кусков и пробрасывается после join
+    template<typename DrawFn>
+    void generate(std::size_t count, DrawFn drawFn)
+    {
+        const std::size_t nChunks = (count+m_chunkSize-1)/m_chunkSize;
+
+        if (m_chunks.size()<nChunks)
+            m_chunks.resize(nChunks);
+        for(std::size_t k=0; k!=nChunks; ++k)
+            m_chunks[k].writer.clear();
+        m_nChunks = nChunks;
+
+        std::atomic<std::size_t> nextChunk{0};
+        std::atomic<bool>        failed{false};
+
+        const unsigned nWorkers = unsigned(std::min<std::size_t>(m_nThreads, nChunks));
+        std::vector<std::exception_ptr> errors(nWorkers ? nWorkers : 1u);
+
+        auto worker = [&](unsigned workerIdx)
+        {
+            try
+            {
+                for(;;)
+                {
+                    const std::size_t k = nextChunk.fetch_add(1, std::memory_order_relaxed);
+                    if (k>=nChunks || failed.load(std::memory_order_relaxed))
+                        break;
+
+                    SvgWriter &oss = m_chunks[k].writer;
+                    const std::size_t idxEnd = std::min(count, (k+1)*m_chunkSize);
+                    for(std::size_t idx=k*m_chunkSize; idx!=idxEnd; ++idx)
+                        drawFn(oss, idx);
+                }
+            }
+            catch(...)
+            {
+                errors[workerIdx] = std::current_exception();
+                failed.store(true, std::memory_order_relaxed);
+            }
+        };
+
+        // Вызывающий поток работает наравне с остальными
+        std::vector<std::thread> threads;
+        ThreadJoiner             joiner(threads);
+        if (nWorkers>1)
+        {
+            threads.reserve(nWorkers-1);
+            try
+            {
+                for(unsigned t=1; t<nWorkers; ++t)
+                    threads.emplace_back(worker, t);
+            }
+            catch(...)
+            {
+                // Поток не запустился (std::system_error) - запущенные останавливаются, joiner их дожидается
+                failed.store(true, std::memory_order_relaxed);
+                m_nChunks = 0;
+                throw;
+            }
+        }
+
+        worker(0);
+
+        joiner.join();
+
+        for(const auto &e : errors)
+        {
+            if (e)
+            {
+                m_nChunks = 0;
+                std::rethrow_exception(e);
+            }
+        }
+    }
+
+    //! Суммарный размер вывода последнего generate()
+    std::size_t size() const
+    {
+        std::size_t res = 0;
+        for(std::size_t k=0; k!=m_nChunks; ++k)
+            res += m_chunks[k].writer.size();
+        return res;
+    }
+
+    std::size_t      chunkCount() const { return m_nChunks; }
+    std::string_view chunkView(std::size_t k) const { return m_chunks[k].writer.view(); }
+
+    //! Выводит куски по порядку - без промежуточной склейки
+    template<typename StreamType>
+    void write(StreamType &oss) const
+    {
+        for(std::size_t k=0; k!=m_nChunks; ++k)
+            oss << m_chunks[k].writer.view();
+    }
+
+    //! Склеивает куски в одну строку; копирование идёт параллельно, каждый поток пишет в свой участок
+    std::string str() const
+    {
+        std::vector<std::size_t> offsets(m_nChunks+1u, 0u);
+        for(std::size_t k=0; k!=m_nChunks; ++k)
+            offsets[k+1] = offsets[k] + m_chunks[k].writer.size();
+
+        std::string res(offsets[m_nChunks], '\0');
+        char *pDst = res.empty() ? nullptr : &res[0];
+
+        std::atomic<std::size_t> nextChunk{0};
+        auto copier = [&]()
+        {
+            for(std::size_t k=nextChunk.fetch_add(1, std::memory_order_relaxed); k<m_nChunks; k=nextChunk.fetch_add(1, std::memory_order_relaxed))
+            {
+                const SvgWriter &w = m_chunks[k].writer;
+                if (w.size())
+                    std::memcpy(pDst+offsets[k], w.data(), w.size());
+            }
+        };
+
+        // Небольшой результат быстрее скопировать одним потоком, чем запускать остальные
+        const unsigned nWorkers = res.size()<parallelCopyMinSize ? 1u : unsigned(std::min<std::size_t>(m_nThreads, m_nChunks));
+        std::vector<std::thread> threads;
+        ThreadJoiner             joiner(threads); // Если поток не запустился - запущенные дожидаются до выброса исключения
+        for(unsigned t=1; t<nWorkers; ++t)
+            threads.emplace_back(copier);
+        copier();
+        joiner.join();
+
+        return res;
+    }
+
+    //! Документ SVG целиком, см. marty::svg::writeSvg; тело выводится кусками, без склейки
+    template<typename StreamType>
+    void writeSvg(StreamType &oss, int viewSizeX, int viewSizeY, std::string_view style) const
+    {
+        writeSvgHeader(oss, 0, 0, viewSizeX, viewSizeY, style);
+        write(oss);
+        writeSvgFooter(oss);
+    }
+
+
+protected:
+
+    static constexpr std::size_t parallelCopyMinSize = 1024u*1024u;
+
+    //! Дожидается запущенных потоков и при выходе по исключению - иначе деструктор std::thread вызовет terminate
+    struct ThreadJoiner
+    {
+        std::vector<std::thread> &threads;
+
+        explicit ThreadJoiner(std::vector<std::thread> &t) : threads(t) {}
+        ~ThreadJoiner() { join(); }
+
+        ThreadJoiner(const ThreadJoiner&) = delete;
+        ThreadJoiner& operator=(const ThreadJoiner&) = delete;
+
+        void join()
+        {
+            for(auto &t : threads)
+            {
+                if (t.joinable())
+                    t.join();
+            }
+        }
+    };
+
+    //! Буфер куска на отдельной строке кэша - соседние куски пишутся разными потоками
+    struct alignas(64) Chunk
+    {
+        SvgWriter   writer;
+    };
+
+    unsigned                m_nThreads  = 1;
+    std::size_t             m_chunkSize = 4096;
+    std::vector<Chunk>      m_chunks;
+    std::size_t             m_nChunks   = 0;
+
+}; // class SvgParallelWriter
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/parallel_writer.h"
+
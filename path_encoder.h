@@ -0,0 +1,496 @@
+/*! \file
+    \brief Компактная запись данных пути (атрибут d)
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include "marty_svg.h"
+//
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/path_encoder.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+//! Число символов в десятичной записи целого, со знаком
+inline
+std::size_t decimalLength(int v)
+{
+    std::uint32_t u = v<0 ? std::uint32_t(0)-std::uint32_t(v) : std::uint32_t(v);
+    std::size_t len = v<0 ? 2u : 1u;
+    for(; u>=10u; u/=10u)
+        ++len;
+    return len;
+}
+
+//----------------------------------------------------------------------------
+//! Пишет данные пути в минимальном виде
+/*! - для каждого сегмента выбирается более короткая форма - абсолютная или относительная;
+    - повторяющиеся буквы команд опускаются, разделители ставятся только там, где без них нельзя
+      (перед неотрицательным числом, идущим за числом);
+    - lineto с нулевым dx или dy превращается в h/v, подряд идущие h/v одного направления сливаются;
+    - сегменты нулевой длины выкидываются, как и прямой сегмент, который заканчивается в начале
+      контура и за которым идёт closepath - z рисует ту же линию.
+
+    Координаты принимаются так же, как в pathLineTo и т.п. - относительные или абсолютные, по bAbs.
+    Текущая точка в начале пути - (0,0), как того требует SVG для начального 'm'.
+
+    CoordType задаёт сетку: с целым (по умолчанию) принимаются только целые координаты; с float/double
+    или SvgFixed16 принимаются любые, и в reset() они округляются до coordPrecision потока (не больше
+    maxFracDigits знаков). Всё считается в целых единицах этой сетки, поэтому относительные смещения
+    точные и при чтении не накапливают ошибку округления.
+ */
+template<typename StreamType, typename CoordType=int>
+class SvgPathEncoder
+{
+
+public:
+
+    static constexpr int maxFracDigits = 9;
+
+    explicit SvgPathEncoder(StreamType &oss)
+    : m_oss(oss)
+    {}
+
+    //! Начинает новый путь
+    void reset()
+    {
+        m_posX = m_posY = m_emittedX = m_emittedY = m_startX = m_startY = 0;
+        m_pending        = PendingNone;
+        m_lastCmd        = 0;
+        m_lastWasNumber  = false;
+
+        if constexpr (!std::is_integral<CoordType>::value)
+        {
+            m_fracDigits = std::max(0, std::min(coordPrecision(m_oss), maxFracDigits));
+            m_scale      = 1;
+            for(int i=0; i!=m_fracDigits; ++i)
+                m_scale *= 10;
+        }
+    }
+
+    template<typename ArgType>
+    void moveTo(ArgType x, ArgType y, bool bAbs)
+    {
+        Units ux = toUnits(x);
+        Units uy = toUnits(y);
+
+        flushPending();
+        makeAbs(ux, uy, bAbs);
+
+        const Units absArgs[2] = { ux, uy };
+        const Units relArgs[2] = { ux-m_posX, uy-m_posY };
+        emitShortest('M', 'm', absArgs, relArgs, 2);
+
+        // Пары координат после M/m - неявные L/l
+        m_lastCmd = m_lastCmd=='M' ? 'L' : 'l';
+
+        m_posX = m_emittedX = m_startX = ux;
+        m_posY = m_emittedY = m_startY = uy;
+    }
+
+    template<typename ArgType>
+    void lineTo(ArgType x, ArgType y, bool bAbs)
+    {
+        Units ux = toUnits(x);
+        Units uy = toUnits(y);
+        makeAbs(ux, uy, bAbs);
+        lineToAbs(ux, uy);
+    }
+
+    template<typename ArgType>
+    void horzLineTo(ArgType x, bool bAbs)
+    {
+        const Units ux = toUnits(x);
+        lineToAbs(bAbs ? ux : m_posX+ux, m_posY);
+    }
+
+    template<typename ArgType>
+    void vertLineTo(ArgType y, bool bAbs)
+    {
+        const Units uy = toUnits(y);
+        lineToAbs(m_posX, bAbs ? uy : m_posY+uy);
+    }
+
+    template<typename ArgType>
+    void quadraticBezier(ArgType cpX, ArgType cpY, ArgType endX, ArgType endY, bool bAbs)
+    {
+        Units ucpX  = toUnits(cpX);
+        Units ucpY  = toUnits(cpY);
+        Units uendX = toUnits(endX);
+        Units uendY = toUnits(endY);
+        makeAbs(ucpX , ucpY , bAbs);
+        makeAbs(uendX, uendY, bAbs);
+
+        if (ucpX==m_posX && ucpY==m_posY && uendX==m_posX && uendY==m_posY)
+            return; // Нулевая длина
+
+        flushPending();
+
+        const Units absArgs[4] = { ucpX, ucpY, uendX, uendY };
+        const Units relArgs[4] = { ucpX-m_posX, ucpY-m_posY, uendX-m_posX, uendY-m_posY };
+        emitShortest('Q', 'q', absArgs, relArgs, 4);
+        setEmittedPos(uendX, uendY);
+    }
+
+    void closePath()
+    {
+        if (m_pending!=PendingNone && m_posX==m_startX && m_posY==m_startY)
+            m_pending = PendingNone; // z проведёт ту же линию
+        else
+            flushPending();
+
+        m_oss << 'z';
+        m_lastCmd       = 0;
+        m_lastWasNumber = false;
+        setEmittedPos(m_startX, m_startY);
+    }
+
+    //! Дописывает отложенный сегмент; вызывать в конце пути
+    void finish(bool closePath_)
+    {
+        if (closePath_)
+            closePath();
+        else
+            flushPending();
+    }
+
+
+protected:
+
+    //! Координаты в единицах сетки (1/10^m_fracDigits)
+    using Units = std::int64_t;
+
+    //! Текст одного числа
+    struct Number
+    {
+        char            buf[24];
+        std::size_t     size = 0;
+
+        bool nonNegative() const { return buf[0]!='-'; }
+    };
+
+    enum PendingKind
+    {
+        PendingNone,
+        PendingHorz,
+        PendingVert
+    };
+
+    static int sign(Units v) { return v<0 ? -1 : (v>0 ? 1 : 0); }
+
+    template<typename ArgType>
+    Units toUnits(ArgType v) const
+    {
+        if constexpr (std::is_integral<ArgType>::value)
+        {
+            return Units(v)*m_scale;
+        }
+        else
+        {
+            static_assert(!std::is_integral<CoordType>::value, "SvgPathEncoder: integer CoordType accepts only integer coordinates");
+
+            // Как и formatFloatCoord: nan - ноль, половины округляются к чётному; огромные значения прижимаются
+            const double d = coordToDouble(v)*double(m_scale);
+            if (std::isnan(d))
+                return 0;
+            return Units(std::llrint(std::max(-1e18, std::min(d, 1e18))));
+        }
+    }
+
+    Number formatUnits(Units v) const
+    {
+        Number res;
+        char *p    = &res.buf[0];
+        char *pEnd = p+sizeof(res.buf);
+
+        const bool          neg  = v<0;
+        const std::uint64_t mag  = neg ? std::uint64_t(0)-std::uint64_t(v) : std::uint64_t(v);
+        std::uint64_t       frac = mag%std::uint64_t(m_scale);
+
+        if (neg)
+            *p++ = '-';
+        p = std::to_chars(p, pEnd, mag/std::uint64_t(m_scale)).ptr;
+
+        if (frac)
+        {
+            int nDigits = m_fracDigits;
+            for(; frac%10u==0; frac/=10u)
+                --nDigits;
+
+            *p++ = '.';
+            for(int i=nDigits-1; i>=0; --i)
+            {
+                p[i]  = char('0' + frac%10u);
+                frac /= 10u;
+            }
+            p += nDigits;
+        }
+
+        res.size = std::size_t(p-&res.buf[0]);
+        return res;
+    }
+
+    void makeAbs(Units &x, Units &y, bool bAbs) const
+    {
+        if (!bAbs)
+        {
+            x += m_posX;
+            y += m_posY;
+        }
+    }
+
+    void setEmittedPos(Units x, Units y)
+    {
+        m_posX = m_emittedX = x;
+        m_posY = m_emittedY = y;
+    }
+
+    void lineToAbs(Units x, Units y)
+    {
+        if (x==m_posX && y==m_posY)
+            return; // Нулевая длина
+
+        if (y==m_posY)
+        {
+            addHorz(x);
+            return;
+        }
+
+        if (x==m_posX)
+        {
+            addVert(y);
+            return;
+        }
+
+        flushPending();
+
+        const Units absArgs[2] = { x, y };
+        const Units relArgs[2] = { x-m_posX, y-m_posY };
+        emitShortest('L', 'l', absArgs, relArgs, 2);
+        setEmittedPos(x, y);
+    }
+
+    void addHorz(Units x)
+    {
+        if (m_pending==PendingHorz && sign(x-m_posX)==sign(m_posX-m_emittedX))
+        {
+            m_posX = x; // Продолжение в ту же сторону
+            return;
+        }
+
+        flushPending();
+        m_pending = PendingHorz;
+        m_posX    = x;
+    }
+
+    void addVert(Units y)
+    {
+        if (m_pending==PendingVert && sign(y-m_posY)==sign(m_posY-m_emittedY))
+        {
+            m_posY = y;
+            return;
+        }
+
+        flushPending();
+        m_pending = PendingVert;
+        m_posY    = y;
+    }
+
+    void flushPending()
+    {
+        if (m_pending==PendingHorz)
+        {
+            const Units absArg = m_posX;
+            const Units relArg = m_posX-m_emittedX;
+            emitShortest('H', 'h', &absArg, &relArg, 1);
+        }
+        else if (m_pending==PendingVert)
+        {
+            const Units absArg = m_posY;
+            const Units relArg = m_posY-m_emittedY;
+            emitShortest('V', 'v', &absArg, &relArg, 1);
+        }
+
+        m_pending  = PendingNone;
+        m_emittedX = m_posX;
+        m_emittedY = m_posY;
+    }
+
+    //! Сколько символов займёт команда с аргументами при текущем состоянии вывода
+    std::size_t commandLength(char cmd, const Number *args, std::size_t n) const
+    {
+        std::size_t len = 0;
+        if (cmd!=m_lastCmd)
+            ++len;
+        else if (m_lastWasNumber && args[0].nonNegative())
+            ++len;
+
+        for(std::size_t i=0; i!=n; ++i)
+        {
+            if (i && args[i].nonNegative())
+                ++len;
+            len += args[i].size;
+        }
+
+        return len;
+    }
+
+    void emitCommand(char cmd, const Number *args, std::size_t n)
+    {
+        if (cmd!=m_lastCmd)
+            m_oss << cmd;
+        else if (m_lastWasNumber && args[0].nonNegative())
+            m_oss << ' ';
+
+        for(std::size_t i=0; i!=n; ++i)
+        {
+            if (i && args[i].nonNegative())
+                m_oss << ' ';
+            m_oss << std::string_view(&args[i].buf[0], args[i].size);
+        }
+
+        m_lastCmd       = cmd;
+        m_lastWasNumber = true;
+    }
+
+    void emitShortest(char absCmd, char relCmd, const Units *absArgs, const Units *relArgs, std::size_t n)
+    {
+        Number absText[4];
+        Number relText[4];
+        for(std::size_t i=0; i!=n; ++i)
+        {
+            absText[i] = formatUnits(absArgs[i]);
+            relText[i] = formatUnits(relArgs[i]);
+        }
+
+        if (commandLength(relCmd, &relText[0], n)<=commandLength(absCmd, &absText[0], n))
+            emitCommand(relCmd, &relText[0], n);
+        else
+            emitCommand(absCmd, &absText[0], n);
+    }
+
+
+    StreamType      &m_oss;
+
+    Units           m_posX     = 0; // Текущая точка, с учётом отложенного сегмента
+    Units           m_posY     = 0;
+    Units           m_emittedX = 0; // Точка, в которой заканчивается уже выведенное
+    Units           m_emittedY = 0;
+    Units           m_startX   = 0; // Начало текущего контура
+    Units           m_startY   = 0;
+
+    Units           m_scale      = 1; // 10^m_fracDigits
+    int             m_fracDigits = 0;
+
+    PendingKind     m_pending       = PendingNone;
+    char            m_lastCmd       = 0;
+    bool            m_lastWasNumber = false;
+
+}; // class SvgPathEncoder
+
+//----------------------------------------------------------------------------
+//! Обёртка над потоком: все пути, выводимые хелперами marty_svg.h, пишутся через SvgPathEncoder
+/*! Остальной вывод и хуки передаются в исходный поток как есть; перегружены только pathBeginData
+    и path*Data, поэтому обёртку можно вкладывать в SvgBoundsStream, SvgIdStream и т.п. и наоборот.
+
+    CoordType - как у SvgPathEncoder: по умолчанию пути с float/double/SvgFixed16 не компилируются,
+    для них нужна CompactPathStream<StreamType, double> (целые координаты она тоже принимает).
+
+    \code
+    marty::svg::SvgWriter w;
+    marty::svg::CompactPathStream<marty::svg::SvgWriter> cps(w);
+    marty::svg::drawRectEx(cps, 10, 10, 100, 40, 8, 1, "black");
+    \endcode
+ */
+template<typename StreamType, typename CoordType=int>
+class CompactPathStream : public SvgStreamWrapper<CompactPathStream<StreamType, CoordType>, StreamType>
+{
+
+public:
+
+    explicit CompactPathStream(StreamType &oss)
+    : SvgStreamWrapper<CompactPathStream<StreamType, CoordType>, StreamType>(oss)
+    , m_encoder(oss)
+    {}
+
+    SvgPathEncoder<StreamType, CoordType>& pathEncoder() { return m_encoder; }
+
+
+protected:
+
+    SvgPathEncoder<StreamType, CoordType>  m_encoder;
+
+}; // class CompactPathStream
+
+//----------------------------------------------------------------------------
+template<typename StreamType, typename CoordType, typename ArgType>
+void pathBeginData(CompactPathStream<StreamType, CoordType> &oss, ArgType posX, ArgType posY, bool bAbs)
+{
+    oss.stream() << "d=\"";
+    oss.pathEncoder().reset();
+    oss.pathEncoder().moveTo(posX, posY, bAbs);
+}
+
+//----------------------------------------------------------------------------
+template<typename StreamType, typename CoordType, typename ArgType>
+void pathLineToData(CompactPathStream<StreamType, CoordType> &oss, ArgType posX, ArgType posY, bool bAbs)
+{
+    oss.pathEncoder().lineTo(posX, posY, bAbs);
+}
+
+//----------------------------------------------------------------------------
+template<typename StreamType, typename CoordType, typename ArgType>
+void pathHorzLineToData(CompactPathStream<StreamType, CoordType> &oss, ArgType posX, bool bAbs)
+{
+    oss.pathEncoder().horzLineTo(posX, bAbs);
+}
+
+//----------------------------------------------------------------------------
+template<typename StreamType, typename CoordType, typename ArgType>
+void pathVertLineToData(CompactPathStream<StreamType, CoordType> &oss, ArgType posY, bool bAbs)
+{
+    oss.pathEncoder().vertLineTo(posY, bAbs);
+}
+
+//----------------------------------------------------------------------------
+template<typename StreamType, typename CoordType, typename ArgType>
+void pathQuadraticBezierData(CompactPathStream<StreamType, CoordType> &oss, ArgType cpX, ArgType cpY, ArgType endX, ArgType endY, bool bAbs)
+{
+    oss.pathEncoder().quadraticBezier(cpX, cpY, endX, endY, bAbs);
+}
+
+//----------------------------------------------------------------------------
+template<typename StreamType, typename CoordType>
+void pathEndData(CompactPathStream<StreamType, CoordType> &oss, bool closePath)
+{
+    oss.pathEncoder().finish(closePath);
+    oss.stream() << "\" />\n";
+}
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/path_encoder.h"
+
@@ -0,0 +1,432 @@
+/*! \file
+    \brief Ломаные и многоугольники из больших массивов точек, с прореживанием до разрешения вывода
+
+    Объём вывода и время генерации определяются числом колонок (пикселей) по X, а не числом исходных точек.
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include "marty_svg.h"
+#include "batch_draw.h"
+#include "path_encoder.h"
+//
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/polyline_simplify.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+//! Настройки упрощения ломаной
+struct SvgSimplifyOptions
+{
+    //! Прореживание по колонкам: из подряд идущих точек одной колонки остаются первая, нижняя, верхняя и последняя
+    /*! Для ломаной, выводимой с шириной колонки в пиксель, картинка не меняется - все экстремумы на месте. */
+    bool    columnDecimation = true;
+    int     columnWidth      = 1;       //!< Ширина колонки в единицах координат
+
+    //! Выкидывать средние точки на прямых участках (точно, без допуска); развороты назад сохраняются
+    bool    removeCollinear  = true;
+
+    //! Допуск Douglas-Peucker в единицах координат; 0 - не применять
+    double  tolerance        = 0.0;
+};
+
+//----------------------------------------------------------------------------
+//! Линейное отображение значений ряда в координаты вывода: x' = x*scaleX + offsetX, y' = y*scaleY + offsetY
+struct SvgSeriesTransform
+{
+    double  scaleX  = 1.0;
+    double  offsetX = 0.0;
+    double  scaleY  = 1.0;
+    double  offsetY = 0.0;
+};
+
+//----------------------------------------------------------------------------
+//! Потоковое упрощение ломаной: точки подаются по одной, результат - в points()
+/*! Конвейер: прореживание по колонкам -> удаление дубликатов и коллинеарных точек (на лету) ->
+    Douglas-Peucker (в finish(), по уже прореженному, то есть небольшому, массиву).
+    Буферы переиспользуются между ломаными.
+
+    \code
+    marty::svg::SvgPolylineSimplifier simplifier;
+    simplifier.begin();
+    for(std::size_t i=0; i!=nSamples; ++i)
+        simplifier.add(int(i/1000), toPixelY(samples[i]));
+    const auto &points = simplifier.finish();
+    \endcode
+ */
+class SvgPolylineSimplifier
+{
+
+public:
+
+    SvgPolylineSimplifier() = default;
+
+    explicit SvgPolylineSimplifier(const SvgSimplifyOptions &opts)
+    : m_opts(opts)
+    {}
+
+    const SvgSimplifyOptions& options() const           { return m_opts; }
+    void setOptions(const SvgSimplifyOptions &opts)     { m_opts = opts; }
+
+    //! Начинает новую ломаную
+    void begin()
+    {
+        m_points.clear();
+        m_colValid = false;
+        m_seq      = 0;
+    }
+
+    void add(int x, int y)
+    {
+        if (!m_opts.columnDecimation)
+        {
+            addOut(SvgPoint{x, y});
+            return;
+        }
+
+        const long long col = columnOf(x);
+        const ColPoint  cp  = { SvgPoint{x, y}, m_seq++ };
+
+        if (!m_colValid || col!=m_col)
+        {
+            flushColumn();
+            m_col      = col;
+            m_colValid = true;
+            m_first = m_min = m_max = m_last = cp;
+            return;
+        }
+
+        if (y<m_min.pt.y)
+            m_min = cp;
+        if (y>m_max.pt.y)
+            m_max = cp;
+        m_last = cp;
+    }
+
+    //! Завершает ломаную и возвращает результат
+    const std::vector<SvgPoint>& finish()
+    {
+        flushColumn();
+        m_colValid = false;
+
+        if (m_opts.tolerance>0.0)
+            douglasPeucker(m_opts.tolerance);
+
+        return m_points;
+    }
+
+    const std::vector<SvgPoint>& points() const { return m_points; }
+
+
+protected:
+
+    struct ColPoint
+    {
+        SvgPoint        pt;
+        std::size_t     seq = 0;
+    };
+
+    long long columnOf(int x) const
+    {
+        const long long w = m_opts.columnWidth>1 ? m_opts.columnWidth : 1;
+        const long long v = x;
+        return v>=0 ? v/w : -((-v+w-1)/w);
+    }
+
+    //! Точки колонки - в исходном порядке, без повторов
+    void flushColumn()
+    {
+        if (!m_colValid)
+            return;
+
+        ColPoint pts[4] = { m_first, m_min, m_max, m_last };
+        std::sort(&pts[0], &pts[0]+4, [](const ColPoint &a, const ColPoint &b) { return a.seq<b.seq; });
+
+        for(std::size_t i=0; i!=4; ++i)
+        {
+            if (i && pts[i].seq==pts[i-1].seq)
+                continue;
+            addOut(pts[i].pt);
+        }
+
+        m_colValid = false;
+    }
+
+    void addOut(SvgPoint p)
+    {
+        const std::size_t n = m_points.size();
+        if (n && m_points[n-1].x==p.x && m_points[n-1].y==p.y)
+            return;
+
+        if (m_opts.removeCollinear && n>=2)
+        {
+            const SvgPoint &a = m_points[n-2];
+            const SvgPoint &b = m_points[n-1];
+
+            const long long abx = (long long)b.x-a.x, aby = (long long)b.y-a.y;
+            const long long bpx = (long long)p.x-b.x, bpy = (long long)p.y-b.y;
+
+            // На одной прямой и в ту же сторону - b лишняя
+            if (abx*bpy-aby*bpx==0 && abx*bpx+aby*bpy>0)
+            {
+                m_points[n-1] = p;
+                return;
+            }
+        }
+
+        m_points.emplace_back(p);
+    }
+
+    //! Квадрат расстояния от p до отрезка [a, b]
+    static double segmentDistance2(const SvgPoint &p, const SvgPoint &a, const SvgPoint &b)
+    {
+        const double dx = double(b.x)-a.x, dy = double(b.y)-a.y;
+        const double px = double(p.x)-a.x, py = double(p.y)-a.y;
+        const double len2 = dx*dx+dy*dy;
+
+        double t = len2>0.0 ? (px*dx+py*dy)/len2 : 0.0;
+        t = std::max(0.0, std::min(1.0, t));
+
+        const double ex = px-t*dx, ey = py-t*dy;
+        return ex*ex+ey*ey;
+    }
+
+    //! Douglas-Peucker без рекурсии; первая и последняя точки остаются всегда
+    void douglasPeucker(double tolerance)
+    {
+        const std::size_t n = m_points.size();
+        if (n<3)
+            return;
+
+        const double tol2 = tolerance*tolerance;
+
+        m_keep.assign(n, 0);
+        m_keep[0] = m_keep[n-1] = 1;
+
+        m_stack.clear();
+        m_stack.emplace_back(std::size_t(0), n-1);
+
+        while(!m_stack.empty())
+        {
+            const auto range = m_stack.back();
+            m_stack.pop_back();
+
+            double      maxDist2 = -1.0;
+            std::size_t maxIdx   = range.first;
+
+            for(std::size_t i=range.first+1; i<range.second; ++i)
+            {
+                const double d2 = segmentDistance2(m_points[i], m_points[range.first], m_points[range.second]);
+                if (d2>maxDist2)
+                {
+                    maxDist2 = d2;
+                    maxIdx   = i;
+                }
+            }
+
+            if (maxDist2>tol2)
+            {
+                m_keep[maxIdx] = 1;
+                if (maxIdx-range.first>1)
+                    m_stack.emplace_back(range.first, maxIdx);
+                if (range.second-maxIdx>1)
+                    m_stack.emplace_back(maxIdx, range.second);
+            }
+        }
+
+        std::size_t out = 0;
+        for(std::size_t i=0; i!=n; ++i)
+        {
+            if (m_keep[i])
+                m_points[out++] = m_points[i];
+        }
+        m_points.resize(out);
+    }
+
+
+    SvgSimplifyOptions                                  m_opts;
+
+    std::vector<SvgPoint>                               m_points;
+    std::vector<unsigned char>                          m_keep;
+    std::vector<std::pair<std::size_t, std::size_t>>    m_stack;
+
+    bool            m_colValid = false;
+    long long       m_col      = 0;
+    std::size_t     m_seq      = 0;
+    ColPoint        m_first;
+    ColPoint        m_min;
+    ColPoint        m_max;
+    ColPoint        m_last;
+
+}; // class SvgPolylineSimplifier
+
+//----------------------------------------------------------------------------
+//! Выводит упрощённые точки одним элементом <path> через SvgPathEncoder; меньше двух точек - ничего не выводится
+template<typename StreamType>
+void drawSimplifiedPath( StreamType &oss
+                       , const std::vector<SvgPoint> &points
+                       , const SvgPathStyle &style
+                       , bool closePath
+                       )
+{
+    if (points.size()<2)
+        return;
+
+    boundsPathStart(oss, points[0].x, points[0].y, true, style.boundsStrokeWidth(), style.linejoin);
+    for(std::size_t i=1; i!=points.size(); ++i)
+        boundsPathLineTo(oss, points[i].x, points[i].y, true);
+    boundsPathEnd(oss, closePath);
+
+    pathStartBatch(oss, style);
+
+    SvgPathEncoder<StreamType> encoder(oss);
+    encoder.moveTo(points[0].x, points[0].y, true);
+    for(std::size_t i=1; i!=points.size(); ++i)
+        encoder.lineTo(points[i].x, points[i].y, true);
+    encoder.finish(closePath);
+
+    pathEndBatch(oss);
+}
+
+//----------------------------------------------------------------------------
+//! Ломаная из непрерывного массива точек, с упрощением; simplifier хранит настройки и буферы
+template<typename StreamType>
+void drawPolyline( StreamType &oss
+                 , SvgPolylineSimplifier &simplifier
+                 , const SvgPoint *pPoints, std::size_t count
+                 , const SvgPathStyle &style
+                 , bool closePath=false
+                 )
+{
+    simplifier.begin();
+    for(const SvgPoint *pEnd=pPoints+count; pPoints!=pEnd; ++pPoints)
+        simplifier.add(pPoints->x, pPoints->y);
+
+    drawSimplifiedPath(oss, simplifier.finish(), style, closePath);
+}
+
+template<typename StreamType>
+void drawPolyline( StreamType &oss
+                 , const SvgPoint *pPoints, std::size_t count
+                 , const SvgPathStyle &style
+                 , const SvgSimplifyOptions &opts=SvgSimplifyOptions()
+                 )
+{
+    SvgPolylineSimplifier simplifier(opts);
+    drawPolyline(oss, simplifier, pPoints, count, style, false);
+}
+
+//----------------------------------------------------------------------------
+//! Замкнутый многоугольник; прореживание по колонкам для заливки тоже годится - огибающая сохраняется
+template<typename StreamType>
+void drawPolygon( StreamType &oss
+                , SvgPolylineSimplifier &simplifier
+                , const SvgPoint *pPoints, std::size_t count
+                , const SvgPathStyle &style
+                )
+{
+    drawPolyline(oss, simplifier, pPoints, count, style, true);
+}
+
+template<typename StreamType>
+void drawPolygon( StreamType &oss
+                , const SvgPoint *pPoints, std::size_t count
+                , const SvgPathStyle &style
+                , const SvgSimplifyOptions &opts=SvgSimplifyOptions()
+                )
+{
+    SvgPolylineSimplifier simplifier(opts);
+    drawPolyline(oss, simplifier, pPoints, count, style, true);
+}
+
+//----------------------------------------------------------------------------
+//! Предел координат ряда: разность двух координат в этих пределах помещается в int
+constexpr int seriesCoordLimit = std::numeric_limits<int>::max()/2;
+
+//----------------------------------------------------------------------------
+//! Округление к ближайшему целому с ограничением диапазоном [-seriesCoordLimit, seriesCoordLimit]; NaN даёт false
+/*! Упрощение и SvgPathEncoder считают относительные смещения в int; при ограничении всем
+    диапазоном int смещение между точками на разных краях переполнялось бы.
+ */
+inline
+bool seriesCoordToInt(double v, int &res)
+{
+    if (std::isnan(v))
+        return false;
+
+    v = std::floor(v+0.5);
+    if (v<-double(seriesCoordLimit))
+        v = -double(seriesCoordLimit);
+    else if (v>double(seriesCoordLimit))
+        v = double(seriesCoordLimit);
+
+    res = int(v);
+    return true;
+}
+
+//----------------------------------------------------------------------------
+//! Ряд данных (float/double/целые) в виде ломаной
+/*! pX может быть nullptr - тогда x равен индексу отсчёта. Значения переводятся в координаты
+    вывода через transform и округляются до целых единиц вывода (упрощение по колонкам работает
+    в целых координатах), отсчёты с NaN пропускаются. Точки за пределами
+    ±seriesCoordLimit прижимаются к пределу.
+
+    Дробная часть координат вывода теряется: если нужна точность мельче единицы, transform
+    масштабируется (например, в 100 раз), а viewBox документа - в той же пропорции.
+ */
+template<typename StreamType, typename ValueType>
+void drawSeries( StreamType &oss
+               , SvgPolylineSimplifier &simplifier
+               , const ValueType *pX, const ValueType *pY, std::size_t count
+               , const SvgSeriesTransform &transform
+               , const SvgPathStyle &style
+               )
+{
+    simplifier.begin();
+    for(std::size_t i=0; i!=count; ++i)
+    {
+        const double vx = pX ? double(pX[i]) : double(i);
+        int x = 0, y = 0;
+        if (!seriesCoordToInt(vx*transform.scaleX+transform.offsetX, x) || !seriesCoordToInt(double(pY[i])*transform.scaleY+transform.offsetY, y))
+            continue;
+        simplifier.add(x, y);
+    }
+
+    drawSimplifiedPath(oss, simplifier.finish(), style, false);
+}
+
+template<typename StreamType, typename ValueType>
+void drawSeries( StreamType &oss
+               , const ValueType *pX, const ValueType *pY, std::size_t count
+               , const SvgSeriesTransform &transform
+               , const SvgPathStyle &style
+               , const SvgSimplifyOptions &opts=SvgSimplifyOptions()
+               )
+{
+    SvgPolylineSimplifier simplifier(opts);
+    drawSeries(oss, simplifier, pX, pY, count, transform, style);
+}
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/polyline_simplify.h"
+
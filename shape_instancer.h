@@ -0,0 +1,273 @@
+/*! \file
+    \brief Инстансинг фигур: одинаковые скруглённые прямоугольники выводятся один раз в <defs>, далее - через <use>
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include "marty_svg.h"
+#include "svg_arena.h"
+//
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/shape_instancer.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+//! Кэш геометрии drawRectEx
+/*! Для каждого уникального набора (sizeX, sizeY, r, flags, стиль) один раз строится <symbol>
+    с путём в точке (0,0), каждое вхождение выводится коротким <use href="#id" x="" y=""/>.
+    Символы копятся внутри и выводятся блоком <defs> - см. writeDefs/defsText.
+    Повторный вызов для уже известной фигуры память не выделяет.
+
+    \code
+    marty::svg::SvgShapeInstancer shapes;
+    marty::svg::SvgWriter body;
+    for(...)
+        marty::svg::drawRectEx(body, x, y, 120, 40, 8, shapes, "cell");
+    marty::svg::writeSvg(out, 1000, 700, style, shapes, body.view());
+    \endcode
+ */
+class SvgShapeInstancer
+{
+
+public:
+
+    explicit SvgShapeInstancer(std::string_view idPrefix="r")
+    : m_idPrefix(idPrefix)
+    {}
+
+    SvgShapeInstancer(const SvgShapeInstancer&) = delete;
+    SvgShapeInstancer& operator=(const SvgShapeInstancer&) = delete;
+    SvgShapeInstancer(SvgShapeInstancer&&) = default;
+    SvgShapeInstancer& operator=(SvgShapeInstancer&&) = default;
+
+    //! Номер символа для прямоугольника со стилем inline-атрибутами; при необходимости символ создаётся
+    std::size_t getRectExSymbol( int sizeX, int sizeY, int r, RoundRectFlags flags
+                               , int strokeWidth, std::string_view strokeColor, std::string_view fillColor
+                               )
+    {
+        ShapeKey key;
+        key.sizeX       = sizeX;
+        key.sizeY       = sizeY;
+        key.r           = r;
+        key.flags       = std::uint32_t(flags);
+        key.strokeWidth = strokeWidth;
+        key.strokeColor = m_strings.intern(strokeColor);
+        key.fillColor   = m_strings.intern(fillColor);
+
+        return findOrAddSymbol( key
+                              , [&](int startX, int startY)
+                                {
+                                    pathStart(m_defs, startX, startY, strokeWidth, strokeColor, fillColor, std::string_view(), true /* bAbs */ );
+                                }
+                              );
+    }
+
+    //! То же, стиль задаётся классом
+    std::size_t getRectExSymbol(int sizeX, int sizeY, int r, RoundRectFlags flags, std::string_view itemClass)
+    {
+        ShapeKey key;
+        key.sizeX       = sizeX;
+        key.sizeY       = sizeY;
+        key.r           = r;
+        key.flags       = std::uint32_t(flags);
+        key.itemClass   = m_strings.intern(itemClass);
+        key.isClass     = true;
+
+        return findOrAddSymbol( key
+                              , [&](int startX, int startY)
+                                {
+                                    pathStart(m_defs, startX, startY, itemClass, true /* bAbs */ );
+                                }
+                              );
+    }
+
+    //! Вхождение символа в точке (posX, posY)
+    template<typename StreamType>
+    void writeUse(StreamType &oss, std::size_t symbolIdx, int posX, int posY) const
+    {
+        oss << "<use ";
+        elementTagOpened(oss);
+        oss << "href=\"#" << m_idPrefix << symbolIdx << "\" x=\"" << posX << "\" y=\"" << posY << "\"/>\n";
+    }
+
+    std::size_t size() const  { return m_symbolCount; }
+    bool        empty() const { return m_symbolCount==0; }
+
+    //! Символы без обрамления <defs>
+    std::string_view symbolsText() const { return m_defs.view(); }
+
+    //! Блок <defs> целиком; при отсутствии символов ничего не выводится
+    template<typename StreamType>
+    void writeDefs(StreamType &oss) const
+    {
+        if (empty())
+            return;
+
+        oss << "<defs>\n";
+        oss << m_defs.view();
+        oss << "</defs>";
+    }
+
+    std::string defsText() const
+    {
+        SvgWriter w;
+        writeDefs(w);
+        return w.str();
+    }
+
+    void clear()
+    {
+        m_symbolIndex.clear();
+        m_strings.clear();
+        m_defs.clear();
+        m_symbolCount = 0;
+    }
+
+
+protected:
+
+    struct ShapeKey
+    {
+        int             sizeX       = 0;
+        int             sizeY       = 0;
+        int             r           = 0;
+        std::uint32_t   flags       = 0;
+        int             strokeWidth = 0;
+        SvgStringId     strokeColor = 0;
+        SvgStringId     fillColor   = 0;
+        SvgStringId     itemClass   = 0;
+        bool            isClass     = false;
+
+        bool operator==(const ShapeKey &other) const
+        {
+            return sizeX==other.sizeX && sizeY==other.sizeY && r==other.r && flags==other.flags
+                && strokeWidth==other.strokeWidth && strokeColor==other.strokeColor
+                && fillColor==other.fillColor && itemClass==other.itemClass && isClass==other.isClass;
+        }
+    };
+
+    struct ShapeKeyHash
+    {
+        std::size_t operator()(const ShapeKey &key) const
+        {
+            std::uint64_t h = std::uint64_t(std::uint32_t(key.sizeX));
+            h = h*0x9E3779B97F4A7C15ull ^ std::uint32_t(key.sizeY);
+            h = h*0x9E3779B97F4A7C15ull ^ std::uint32_t(key.r);
+            h = h*0x9E3779B97F4A7C15ull ^ (key.flags | (key.isClass ? 0x100u : 0u));
+            h = h*0x9E3779B97F4A7C15ull ^ std::uint32_t(key.strokeWidth);
+            h = h*0x9E3779B97F4A7C15ull ^ key.strokeColor;
+            h = h*0x9E3779B97F4A7C15ull ^ key.fillColor;
+            h = h*0x9E3779B97F4A7C15ull ^ key.itemClass;
+            return std::size_t(h ^ (h>>29));
+        }
+    };
+
+    template<typename PathStartHandler>
+    std::size_t findOrAddSymbol(const ShapeKey &key, PathStartHandler pathStartHandler)
+    {
+        auto it = m_symbolIndex.find(key);
+        if (it!=m_symbolIndex.end())
+            return it->second;
+
+        const std::size_t idx = m_symbolCount++;
+        m_symbolIndex.emplace(key, idx);
+
+        // Обводка выходит за границы фигуры, поэтому символ не обрезается по своей области
+        m_defs << "<symbol id=\"" << m_idPrefix << idx << "\" overflow=\"visible\">\n";
+        drawRectExImpl(m_defs, 0, 0, key.sizeX, key.sizeY, key.r, RoundRectFlags(key.flags), pathStartHandler);
+        m_defs << "</symbol>\n";
+
+        return idx;
+    }
+
+
+    std::string                                             m_idPrefix;
+    SvgStringPool                                           m_strings;
+    SvgWriter                                               m_defs;
+    std::size_t                                             m_symbolCount = 0;
+    std::unordered_map<ShapeKey, std::size_t, ShapeKeyHash> m_symbolIndex;
+
+}; // class SvgShapeInstancer
+
+//----------------------------------------------------------------------------
+//! drawRectEx через инстансинг - выводится только <use>; радиус в boundsRect передаётся, только если скруглены все углы
+template<typename StreamType>
+void drawRectEx( StreamType &oss
+               , int  posX , int posY
+               , int  sizeX, int sizeY
+               , int r
+               , SvgShapeInstancer &shapes
+               , int strokeWidth
+               , std::string_view strokeColor
+               , std::string_view fillColor = std::string_view()
+               , RoundRectFlags flags=RoundRectFlags::round
+               )
+{
+    MARTY_SVG_INSTR_SCOPE(drawRectEx, oss);
+
+    boundsRect(oss, posX, posY, sizeX, sizeY, flags==RoundRectFlags::round ? r : 0, strokeWidth);
+    shapes.writeUse(oss, shapes.getRectExSymbol(sizeX, sizeY, r, flags, strokeWidth, strokeColor, fillColor), posX, posY);
+}
+
+//----------------------------------------------------------------------------
+template<typename StreamType>
+void drawRectEx( StreamType &oss
+               , int  posX , int posY
+               , int  sizeX, int sizeY
+               , int r
+               , SvgShapeInstancer &shapes
+               , std::string_view itemClass
+               , RoundRectFlags flags=RoundRectFlags::round
+               )
+{
+    MARTY_SVG_INSTR_SCOPE(drawRectEx, oss);
+
+    boundsRect(oss, posX, posY, sizeX, sizeY, flags==RoundRectFlags::round ? r : 0, -1);
+    shapes.writeUse(oss, shapes.getRectExSymbol(sizeX, sizeY, r, flags, itemClass), posX, posY);
+}
+
+//----------------------------------------------------------------------------
+//! writeSvg с блоком <defs> после стилей
+template<typename StreamType>
+void writeSvg( StreamType &oss
+             , int viewSizeX, int viewSizeY
+             , std::string_view style
+             , const SvgShapeInstancer &shapes
+             , std::string_view text
+             )
+{
+    SvgWriter head;
+    head << style;
+    if (!shapes.empty())
+    {
+        head << "\n";
+        shapes.writeDefs(head);
+    }
+    writeSvg(oss, viewSizeX, viewSizeY, head.view(), text);
+}
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/shape_instancer.h"
+
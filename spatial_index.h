@@ -0,0 +1,398 @@
+/*! \file
+    \brief Отсечение по окну просмотра: равномерная сетка над габаритами элементов SvgDocument
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include "svg_box.h"
+#include "svg_document.h"
+//
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/spatial_index.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+//! Габариты элемента документа с учётом толщины линии
+/*! Оценка консервативная - область может быть больше реальной, но не меньше:
+    - обводка расширяет фигуру на толщину линии (с запасом на углы miter), у путей с linejoin miter - на две;
+    - для текста известна только точка привязки, ширина оценивается по числу байт строки,
+      выравнивание и базовая линия не учитываются - область берётся в обе стороны от точки.
+ */
+inline
+SvgBox elementBounds(const SvgDocument &doc, std::size_t elementIdx, const SvgBoundsOptions &opts=SvgBoundsOptions())
+{
+    const std::size_t i = doc.elementIndex(elementIdx);
+    SvgBox box;
+
+    switch(doc.elementKind(elementIdx))
+    {
+        case SvgElementKind::rectEx:
+        {
+            const auto &c = doc.rectExColumns();
+            box = SvgBox::fromRect(c.posX[i], c.posY[i], c.sizeX[i], c.sizeY[i]);
+            box.inflate(c.strokeWidth[i]);
+            break;
+        }
+
+        case SvgElementKind::rect:
+        {
+            const auto &c = doc.rectColumns();
+            box = SvgBox::fromRect(c.posX[i], c.posY[i], c.sizeX[i], c.sizeY[i]);
+            box.inflate(opts.classStrokeWidth);
+            break;
+        }
+
+        case SvgElementKind::line:
+        {
+            const auto &c = doc.lineColumns();
+            box.addPoint(c.startX[i], c.startY[i]);
+            box.addPoint(c.endX[i]  , c.endY[i]  );
+            box.inflate(opts.classStrokeWidth);
+            break;
+        }
+
+        case SvgElementKind::lineStyled:
+        {
+            const auto &c = doc.lineStyledColumns();
+            box.addPoint(c.startX[i], c.startY[i]);
+            box.addPoint(c.endX[i]  , c.endY[i]  );
+            box.inflate(c.strokeWidth[i]);
+            break;
+        }
+
+        case SvgElementKind::text:
+        {
+            const auto &c = doc.textColumns();
+            const int w = int(doc.getString(c.text[i]).size())*opts.textCharWidth;
+            box.addPoint(c.posX[i]-w, c.posY[i]-opts.textHeight);
+            box.addPoint(c.posX[i]+w, c.posY[i]+opts.textHeight);
+            break;
+        }
+
+        case SvgElementKind::path:
+        {
+            const auto &c   = doc.pathColumns();
+            const auto &seg = doc.pathSegmentColumns();
+
+            // Квадратичная кривая лежит внутри треугольника своих опорных точек,
+            // поэтому достаточно охватить все вершины и контрольные точки
+            int curX = c.posX[i];
+            int curY = c.posY[i];
+            box.addPoint(curX, curY);
+
+            const std::size_t segEnd = std::size_t(c.firstSegment[i]) + c.segmentCount[i];
+            for(std::size_t s=c.firstSegment[i]; s!=segEnd; ++s)
+            {
+                const std::uint8_t kind = seg.kind[s];
+                const bool  bAbs = (kind & std::uint8_t(SvgPathSegmentKind::absFlag))!=0;
+                const int  *a    = &seg.args[seg.firstArg[s]];
+                const int   baseX = bAbs ? 0 : curX;
+                const int   baseY = bAbs ? 0 : curY;
+
+                switch(SvgPathSegmentKind(kind & ~std::uint8_t(SvgPathSegmentKind::absFlag)))
+                {
+                    case SvgPathSegmentKind::lineTo    : curX = baseX+a[0]; curY = baseY+a[1]; break;
+                    case SvgPathSegmentKind::horzLineTo: curX = baseX+a[0]; break;
+                    case SvgPathSegmentKind::vertLineTo: curY = baseY+a[0]; break;
+                    case SvgPathSegmentKind::quadraticBezier:
+                        box.addPoint(baseX+a[0], baseY+a[1]);
+                        curX = baseX+a[2]; curY = baseY+a[3];
+                        break;
+                    default: break;
+                }
+
+                box.addPoint(curX, curY);
+            }
+
+            int strokeWidth = opts.classStrokeWidth;
+            bool miter      = true;
+            if (c.styled[i])
+            {
+                strokeWidth = c.strokeWidth[i];
+                const std::string_view linejoin = doc.getString(c.linejoin[i]);
+                miter = linejoin.empty() || linejoin=="miter";
+            }
+
+            box.inflate(miter ? 2*strokeWidth : strokeWidth);
+            break;
+        }
+    }
+
+    return box;
+}
+
+//----------------------------------------------------------------------------
+//! Пространственный индекс элементов документа - равномерная сетка
+/*! build() один раз считает габариты всех элементов и раскладывает их по ячейкам сетки;
+    query() перебирает только ячейки, попадающие в окно, поэтому повторные запросы к тому же
+    набору элементов не просматривают его целиком. Элементы, накрывающие слишком много ячеек,
+    хранятся отдельным списком и проверяются при каждом запросе.
+
+    Результат запроса - индексы элементов в порядке документа, то есть в порядке отрисовки.
+    После изменения документа индекс нужно построить заново.
+
+    \code
+    marty::svg::SvgSpatialIndex index;
+    index.build(doc);
+    index.writeSvg(oss, doc, marty::svg::SvgBox::fromRect(1000, 500, 800, 600), style);
+    \endcode
+ */
+class SvgSpatialIndex
+{
+
+public:
+
+    //! Строит индекс; cellSize<=0 - размер ячейки подбирается по среднему размеру элементов
+    void build(const SvgDocument &doc, int cellSize=0, const SvgBoundsOptions &opts=SvgBoundsOptions())
+    {
+        const std::size_t n = doc.size();
+
+        m_bounds.resize(n);
+        m_worldBox = SvgBox();
+
+        double sumSize = 0;
+        for(std::size_t idx=0; idx!=n; ++idx)
+        {
+            m_bounds[idx] = elementBounds(doc, idx, opts);
+            m_worldBox.addBox(m_bounds[idx]);
+            sumSize += double(std::max(m_bounds[idx].sizeX(), m_bounds[idx].sizeY()));
+        }
+
+        m_queryStamp.assign(n, 0u);
+        m_queryGeneration = 0;
+
+        chooseGrid(cellSize, n ? sumSize/double(n) : 0.0, n);
+        fillCells();
+    }
+
+    std::size_t size() const { return m_bounds.size(); }
+
+    const SvgBox& worldBox() const { return m_worldBox; }
+    const SvgBox& elementBox(std::size_t elementIdx) const { return m_bounds[elementIdx]; }
+
+    int cellSize()   const { return m_cellSize; }
+    int gridSizeX()  const { return m_gridX; }
+    int gridSizeY()  const { return m_gridY; }
+
+    //! Индексы элементов, пересекающих окно, в порядке документа; результат дописывается в res
+    void query(const SvgBox &viewport, std::vector<std::uint32_t> &res)
+    {
+        const std::size_t firstRes = res.size();
+
+        if (viewport.empty() || !viewport.intersects(m_worldBox))
+            return;
+
+        nextGeneration();
+
+        const int cx0 = cellX(viewport.minX), cx1 = cellX(viewport.maxX);
+        const int cy0 = cellY(viewport.minY), cy1 = cellY(viewport.maxY);
+
+        for(int cy=cy0; cy<=cy1; ++cy)
+        {
+            for(int cx=cx0; cx<=cx1; ++cx)
+            {
+                const std::size_t cell = std::size_t(cy)*std::size_t(m_gridX) + std::size_t(cx);
+                for(std::uint32_t k=m_cellStart[cell]; k!=m_cellStart[cell+1]; ++k)
+                    testElement(m_cellItems[k], viewport, res);
+            }
+        }
+
+        for(std::uint32_t idx : m_oversized)
+            testElement(idx, viewport, res);
+
+        std::sort(res.begin()+std::ptrdiff_t(firstRes), res.end());
+    }
+
+    //! Выводит только элементы, пересекающие окно
+    template<typename StreamType>
+    void serialize(StreamType &oss, const SvgDocument &doc, const SvgBox &viewport)
+    {
+        checkDocument(doc);
+
+        m_queryResult.clear();
+        query(viewport, m_queryResult);
+        doc.serialize(oss, m_queryResult.data(), m_queryResult.size());
+    }
+
+    //! Документ SVG с viewBox, равным окну, и только видимыми в нём элементами
+    template<typename StreamType>
+    void writeSvg(StreamType &oss, const SvgDocument &doc, const SvgBox &viewport, std::string_view style)
+    {
+        SvgWriter body;
+        serialize(body, doc, viewport);
+        marty::svg::writeSvg(oss, viewport.minX, viewport.minY, viewport.sizeX(), viewport.sizeY(), style, body.view());
+    }
+
+
+protected:
+
+    //! Ограничение на число ячеек сетки относительно числа элементов
+    static constexpr std::size_t cellsPerElement    = 4;
+    static constexpr std::size_t minCells           = 1024;
+    //! Элемент, накрывающий больше ячеек, в сетку не кладётся
+    static constexpr std::size_t maxElementCells    = 64;
+
+    void checkDocument(const SvgDocument &doc) const
+    {
+        if (doc.size()!=m_bounds.size())
+            throw std::logic_error("marty::svg::SvgSpatialIndex: index is out of date, call build() again");
+    }
+
+    void chooseGrid(int cellSize, double avgElementSize, std::size_t n)
+    {
+        if (m_worldBox.empty())
+        {
+            m_cellSize = 1;
+            m_gridX = m_gridY = 0;
+            return;
+        }
+
+        const double worldX = double(m_worldBox.sizeX()) + 1.0;
+        const double worldY = double(m_worldBox.sizeY()) + 1.0;
+
+        double cs = cellSize>0 ? double(cellSize) : std::max(1.0, 2.0*avgElementSize);
+
+        const double maxCells = double(std::max(minCells, n*cellsPerElement));
+        while(std::ceil(worldX/cs)*std::ceil(worldY/cs) > maxCells)
+            cs *= 2.0;
+
+        m_cellSize = int(std::min(cs, double(INT_MAX/2)));
+        m_gridX    = int(std::ceil(worldX/double(m_cellSize)));
+        m_gridY    = int(std::ceil(worldY/double(m_cellSize)));
+    }
+
+    int cellX(int x) const
+    {
+        const long long c = (static_cast<long long>(x)-m_worldBox.minX)/m_cellSize;
+        return int(std::max(0LL, std::min(c, static_cast<long long>(m_gridX-1))));
+    }
+
+    int cellY(int y) const
+    {
+        const long long c = (static_cast<long long>(y)-m_worldBox.minY)/m_cellSize;
+        return int(std::max(0LL, std::min(c, static_cast<long long>(m_gridY-1))));
+    }
+
+    bool isOversized(const SvgBox &box) const
+    {
+        const std::size_t cells = std::size_t(cellX(box.maxX)-cellX(box.minX)+1)
+                                * std::size_t(cellY(box.maxY)-cellY(box.minY)+1);
+        return cells>maxElementCells;
+    }
+
+    //! Раскладка по ячейкам в два прохода - подсчёт и заполнение (CSR)
+    void fillCells()
+    {
+        const std::size_t nCells = std::size_t(m_gridX)*std::size_t(m_gridY);
+
+        m_cellStart.assign(nCells+1u, 0u);
+        m_cellItems.clear();
+        m_oversized.clear();
+
+        if (!nCells)
+            return;
+
+        for(std::size_t idx=0; idx!=m_bounds.size(); ++idx)
+        {
+            const SvgBox &box = m_bounds[idx];
+            if (box.empty() || isOversized(box))
+                continue;
+
+            forEachCell(box, [&](std::size_t cell) { ++m_cellStart[cell+1]; });
+        }
+
+        for(std::size_t cell=0; cell!=nCells; ++cell)
+            m_cellStart[cell+1] += m_cellStart[cell];
+
+        m_cellItems.resize(m_cellStart[nCells]);
+        std::vector<std::uint32_t> fillPos(m_cellStart.begin(), m_cellStart.end()-1);
+
+        for(std::size_t idx=0; idx!=m_bounds.size(); ++idx)
+        {
+            const SvgBox &box = m_bounds[idx];
+            if (box.empty())
+                continue;
+
+            if (isOversized(box))
+            {
+                m_oversized.push_back(std::uint32_t(idx));
+                continue;
+            }
+
+            forEachCell(box, [&](std::size_t cell) { m_cellItems[fillPos[cell]++] = std::uint32_t(idx); });
+        }
+    }
+
+    template<typename Handler>
+    void forEachCell(const SvgBox &box, Handler handler) const
+    {
+        const int cx0 = cellX(box.minX), cx1 = cellX(box.maxX);
+        const int cy0 = cellY(box.minY), cy1 = cellY(box.maxY);
+
+        for(int cy=cy0; cy<=cy1; ++cy)
+            for(int cx=cx0; cx<=cx1; ++cx)
+                handler(std::size_t(cy)*std::size_t(m_gridX) + std::size_t(cx));
+    }
+
+    void nextGeneration()
+    {
+        if (++m_queryGeneration==0)
+        {
+            // Переполнение счётчика - метки сбрасываются
+            std::fill(m_queryStamp.begin(), m_queryStamp.end(), 0u);
+            m_queryGeneration = 1;
+        }
+    }
+
+    void testElement(std::uint32_t idx, const SvgBox &viewport, std::vector<std::uint32_t> &res)
+    {
+        // Элемент может лежать в нескольких ячейках - проверяем один раз за запрос
+        if (m_queryStamp[idx]==m_queryGeneration)
+            return;
+        m_queryStamp[idx] = m_queryGeneration;
+
+        if (m_bounds[idx].intersects(viewport))
+            res.push_back(idx);
+    }
+
+
+    std::vector<SvgBox>         m_bounds;
+    SvgBox                      m_worldBox;
+
+    int                         m_cellSize = 1;
+    int                         m_gridX    = 0;
+    int                         m_gridY    = 0;
+
+    std::vector<std::uint32_t>  m_cellStart;  // nCells+1
+    std::vector<std::uint32_t>  m_cellItems;
+    std::vector<std::uint32_t>  m_oversized;
+
+    std::vector<std::uint32_t>  m_queryStamp;
+    std::uint32_t               m_queryGeneration = 0;
+    std::vector<std::uint32_t>  m_queryResult;
+
+}; // class SvgSpatialIndex
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/spatial_index.h"
+
@@ -0,0 +1,205 @@
+/*! \file
+    \brief Потоковая выдача документа SVG кусками по запросу - в буфер вызывающего (pull-модель, например, для ответа HTTP)
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include "marty_svg.h"
+//
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include <utility>
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/stream_producer.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+//! Документ SVG, выдаваемый кусками по запросу
+/*! Каждый вызов read() заполняет буфер вызывающего следующей порцией документа: заголовок
+    (тег <svg>), стили, элементы, окончание - и возвращает число записанных байт; 0 - документ
+    выдан целиком. Результат побайтно совпадает с writeSvg(oss, viewPosX, ..., style, text),
+    где text - вывод drawFn(oss, 0) ... drawFn(oss, count-1).
+
+    Элементы генерируются по мере надобности, в промежуточный буфер порциями примерно по
+    batchSize байт; текст стилей копируется прямо из style. Память не зависит от размера документа,
+    первые байты доступны сразу, без генерации остального.
+
+    style должен быть жив, пока документ не выдан. drawFn может бросать исключения - они
+    проходят через read().
+
+    \code
+    marty::svg::SvgStreamProducer producer( 0, 0, 10000, 10000, style, items.size()
+                                          , [&](marty::svg::SvgWriter &oss, std::size_t i)
+                                            {
+                                                marty::svg::drawRectEx(oss, items[i].x, items[i].y, 120, 40, 8, 1, "black");
+                                            }
+                                          );
+    char buf[16384];
+    while(std::size_t n = producer.read(buf, sizeof(buf)))
+        sendChunk(buf, n);
+    \endcode
+ */
+class SvgStreamProducer
+{
+
+public:
+
+    using DrawFn = std::function<void(SvgWriter& /* oss */, std::size_t /* idx */)>;
+
+    static constexpr std::size_t defaultBatchSize = 16u*1024u;
+
+    SvgStreamProducer( int viewPosX , int viewPosY
+                     , int viewSizeX, int viewSizeY
+                     , std::string_view style
+                     , std::size_t count
+                     , DrawFn drawFn
+                     , std::size_t batchSize=defaultBatchSize
+                     )
+    : m_viewPosX(viewPosX), m_viewPosY(viewPosY), m_viewSizeX(viewSizeX), m_viewSizeY(viewSizeY)
+    , m_style(style)
+    , m_count(count)
+    , m_drawFn(std::move(drawFn))
+    , m_batchSize(batchSize ? batchSize : 1u)
+    {}
+
+    SvgStreamProducer( int viewSizeX, int viewSizeY
+                     , std::string_view style
+                     , std::size_t count
+                     , DrawFn drawFn
+                     , std::size_t batchSize=defaultBatchSize
+                     )
+    : SvgStreamProducer(0, 0, viewSizeX, viewSizeY, style, count, std::move(drawFn), batchSize)
+    {}
+
+    SvgStreamProducer(const SvgStreamProducer&) = delete;
+    SvgStreamProducer& operator=(const SvgStreamProducer&) = delete;
+
+    //! Записывает в pBuf до bufSize байт; 0 - документ выдан целиком (или bufSize==0)
+    std::size_t read(char *pBuf, std::size_t bufSize)
+    {
+        std::size_t res = 0;
+
+        while(res!=bufSize)
+        {
+            if (m_pendingPos!=m_pending.size())
+            {
+                res += copyOut(m_pending.view().substr(m_pendingPos), pBuf+res, bufSize-res, m_pendingPos);
+                continue;
+            }
+
+            if (m_state==State::style && m_stylePos!=m_style.size())
+            {
+                // Стили не копируются в промежуточный буфер - берутся прямо из style
+                res += copyOut(m_style.substr(m_stylePos), pBuf+res, bufSize-res, m_stylePos);
+                continue;
+            }
+
+            if (!produceNext())
+                break;
+        }
+
+        return res;
+    }
+
+    //! Документ выдан целиком
+    bool done() const
+    {
+        return m_state==State::done && m_pendingPos==m_pending.size();
+    }
+
+    //! Номер следующего генерируемого элемента - для индикации прогресса
+    std::size_t elementsProduced() const { return m_nextIdx; }
+
+
+protected:
+
+    enum class State
+    {
+        header,
+        style,
+        elements,
+        footer,
+        done
+    };
+
+    static std::size_t copyOut(std::string_view src, char *pDst, std::size_t dstSize, std::size_t &srcPos)
+    {
+        const std::size_t n = std::min(src.size(), dstSize);
+        std::memcpy(pDst, src.data(), n);
+        srcPos += n;
+        return n;
+    }
+
+    //! Готовит следующую порцию в m_pending (или переключает на стили); false - документ закончен
+    bool produceNext()
+    {
+        m_pending.clear();
+        m_pendingPos = 0;
+
+        switch(m_state)
+        {
+            case State::header:
+                writeSvgOpenTag(m_pending, m_viewPosX, m_viewPosY, m_viewSizeX, m_viewSizeY);
+                m_state = State::style;
+                return true;
+
+            case State::style: // Текст стилей выдан, остался перевод строки после него
+                m_pending << "\n";
+                m_state = State::elements;
+                return true;
+
+            case State::elements:
+                while(m_nextIdx!=m_count && m_pending.size()<m_batchSize)
+                    m_drawFn(m_pending, m_nextIdx++);
+                if (m_nextIdx==m_count)
+                    m_state = State::footer;
+                return true;
+
+            case State::footer:
+                writeSvgFooter(m_pending);
+                m_state = State::done;
+                return true;
+
+            case State::done:
+            default:
+                return false;
+        }
+    }
+
+
+    int                 m_viewPosX  = 0;
+    int                 m_viewPosY  = 0;
+    int                 m_viewSizeX = 0;
+    int                 m_viewSizeY = 0;
+    std::string_view    m_style;
+    std::size_t         m_count     = 0;
+    DrawFn              m_drawFn;
+    std::size_t         m_batchSize = defaultBatchSize;
+
+    State               m_state      = State::header;
+    std::size_t         m_stylePos   = 0;
+    std::size_t         m_nextIdx    = 0;
+    SvgWriter           m_pending;
+    std::size_t         m_pendingPos = 0;
+
+}; // class SvgStreamProducer
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/stream_producer.h"
+
@@ -0,0 +1,230 @@
+/*! \file
+    \brief Интернирование стилей: inline-атрибуты stroke/fill заменяются общими CSS-классами
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include "marty_svg.h"
+#include "svg_arena.h"
+//
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/style_registry.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+//! Реестр стилей линий и путей
+/*! Каждый уникальный набор (stroke, stroke-width, stroke-linejoin, fill) получает короткое имя класса
+    (prefix + номер), сами стили выводятся одним блоком <style> - см. writeStyle/styleText.
+    Строки цветов интернируются, поиск уже известного стиля не выделяет память.
+ */
+class SvgStyleRegistry
+{
+
+public:
+
+    explicit SvgStyleRegistry(std::string_view classPrefix="s")
+    : m_classPrefix(classPrefix)
+    {}
+
+    //! Имя класса для стиля; пустой fillColor - без заливки, пустой linejoin - miter, как в pathStart
+    /*! Имя хранится в арене строк реестра: строка действительна до clear(), новые стили её не портят. */
+    std::string_view getClass( int strokeWidth
+                             , std::string_view strokeColor
+                             , std::string_view fillColor=std::string_view()
+                             , std::string_view linejoin=std::string_view()
+                             )
+    {
+        StyleKey key;
+        key.strokeWidth = strokeWidth;
+        key.strokeColor = m_strings.intern(strokeColor);
+        key.fillColor   = m_strings.intern(fillColor);
+        key.linejoin    = m_strings.intern(linejoin.empty() ? std::string_view("miter") : linejoin);
+
+        auto it = m_styleIndex.find(key);
+        if (it!=m_styleIndex.end())
+            return m_strings.get(m_classNames[it->second]);
+
+        const std::size_t idx = m_styles.size();
+        m_styles.emplace_back(key);
+        m_classNames.emplace_back(m_strings.intern(m_classPrefix + std::to_string(idx)));
+        m_styleIndex.emplace(key, idx);
+        return m_strings.get(m_classNames.back());
+    }
+
+    std::size_t size() const  { return m_styles.size(); }
+    bool        empty() const { return m_styles.empty(); }
+
+    //! Правила CSS для всех зарегистрированных стилей, без обрамления <style>
+    template<typename StreamType>
+    void writeRules(StreamType &oss) const
+    {
+        for(std::size_t i=0; i!=m_styles.size(); ++i)
+        {
+            const StyleKey &key = m_styles[i];
+
+            oss << "." << m_strings.get(m_classNames[i]) << "{stroke:";
+            writeEscapedText(oss, m_strings.get(key.strokeColor));
+            oss << ";stroke-width:" << key.strokeWidth << ";stroke-linejoin:";
+            writeEscapedText(oss, m_strings.get(key.linejoin));
+
+            if (key.fillColor)
+            {
+                oss << ";fill:";
+                writeEscapedText(oss, m_strings.get(key.fillColor));
+            }
+            else
+            {
+                oss << ";fill-opacity:0";
+            }
+
+            oss << "}\n";
+        }
+    }
+
+    //! Блок <style> целиком
+    template<typename StreamType>
+    void writeStyle(StreamType &oss) const
+    {
+        oss << "<style>\n";
+        writeRules(oss);
+        oss << "</style>";
+    }
+
+    //! Блок <style> строкой - для параметра style функции writeSvg
+    std::string styleText() const
+    {
+        SvgWriter w;
+        writeStyle(w);
+        return w.str();
+    }
+
+    void clear()
+    {
+        m_styles.clear();
+        m_classNames.clear();
+        m_styleIndex.clear();
+        m_strings.clear();
+    }
+
+
+protected:
+
+    struct StyleKey
+    {
+        int             strokeWidth = 0;
+        SvgStringId     strokeColor = 0;
+        SvgStringId     fillColor   = 0;
+        SvgStringId     linejoin    = 0;
+
+        bool operator==(const StyleKey &other) const
+        {
+            return strokeWidth==other.strokeWidth && strokeColor==other.strokeColor
+                && fillColor==other.fillColor && linejoin==other.linejoin;
+        }
+    };
+
+    struct StyleKeyHash
+    {
+        std::size_t operator()(const StyleKey &key) const
+        {
+            std::uint64_t h = std::uint64_t(std::uint32_t(key.strokeWidth));
+            h = h*0x9E3779B97F4A7C15ull ^ key.strokeColor;
+            h = h*0x9E3779B97F4A7C15ull ^ key.fillColor;
+            h = h*0x9E3779B97F4A7C15ull ^ key.linejoin;
+            return std::size_t(h ^ (h>>29));
+        }
+    };
+
+
+    std::string                                             m_classPrefix;
+    SvgStringPool                                           m_strings;
+    std::vector<StyleKey>                                   m_styles;
+    std::vector<SvgStringId>                                m_classNames;   // Имена классов - в m_strings
+    std::unordered_map<StyleKey, std::size_t, StyleKeyHash> m_styleIndex;
+
+}; // class SvgStyleRegistry
+
+//----------------------------------------------------------------------------
+//! pathStart со стилем через реестр - вместо inline-атрибутов выводится класс
+template<typename StreamType>
+void pathStart( StreamType &oss, int posX, int posY
+              , SvgStyleRegistry &styles
+              , int strokeWidth, std::string_view strokeColor
+              , std::string_view fillColor=std::string_view()
+              , std::string_view linejoin=std::string_view()
+              , bool bAbs=false
+              )
+{
+    pathStart(oss, posX, posY, styles.getClass(strokeWidth, strokeColor, fillColor, linejoin), bAbs);
+}
+
+//----------------------------------------------------------------------------
+template<typename StreamType>
+void drawRectEx( StreamType &oss
+               , int  posX , int posY
+               , int  sizeX, int sizeY
+               , int r
+               , SvgStyleRegistry &styles
+               , int strokeWidth
+               , std::string_view strokeColor
+               , std::string_view fillColor = std::string_view()
+               , RoundRectFlags flags=RoundRectFlags::round
+               )
+{
+    drawRectEx(oss, posX, posY, sizeX, sizeY, r, styles.getClass(strokeWidth, strokeColor, fillColor), flags);
+}
+
+//----------------------------------------------------------------------------
+template<typename StreamType>
+void drawLine( StreamType &oss
+             , int startX, int startY
+             , int endX  , int endY
+             , SvgStyleRegistry &styles
+             , int strokeWidth
+             , std::string_view strokeColor
+             , std::string_view linejoin=std::string_view()
+             )
+{
+    drawLine(oss, startX, startY, endX, endY, styles.getClass(strokeWidth, strokeColor, std::string_view(), linejoin));
+}
+
+//----------------------------------------------------------------------------
+//! writeSvg со стилями из реестра
+template<typename StreamType>
+void writeSvg( StreamType &oss
+             , int viewSizeX, int viewSizeY
+             , const SvgStyleRegistry &styles
+             , std::string_view text
+             )
+{
+    SvgWriter style;
+    styles.writeStyle(style);
+    writeSvg(oss, viewSizeX, viewSizeY, style.view(), text);
+}
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/style_registry.h"
+
@@ -0,0 +1,298 @@
+/*! \file
+    \brief Арена (bump-аллокатор) и пул интернированных строк
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/svg_arena.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+//! Bump-аллокатор: память выдаётся из больших блоков и освобождается только целиком
+/*! reset() работает за O(1) - блоки остаются за ареной и используются повторно.
+ */
+class SvgArena
+{
+
+public:
+
+    explicit SvgArena(std::size_t blockSize=64*1024u)
+    : m_blockSize(blockSize ? blockSize : 1u)
+    {}
+
+    SvgArena(const SvgArena&) = delete;
+    SvgArena& operator=(const SvgArena&) = delete;
+    SvgArena(SvgArena&&) = default;
+    SvgArena& operator=(SvgArena&&) = default;
+
+    void* allocate(std::size_t size, std::size_t align=alignof(std::max_align_t))
+    {
+        std::size_t pad = alignPadding(m_pCur, align);
+        if (!m_pCur || pad+size > std::size_t(m_pEnd-m_pCur))
+        {
+            nextBlock(size+align);
+            pad = alignPadding(m_pCur, align);
+        }
+
+        char *p = m_pCur + pad;
+        m_pCur  = p + size;
+        return p;
+    }
+
+    //! Копирует строку в арену
+    std::string_view storeString(std::string_view str)
+    {
+        if (str.empty())
+            return std::string_view();
+
+        char *p = (char*)allocate(str.size(), 1u);
+        std::memcpy(p, str.data(), str.size());
+        return std::string_view(p, str.size());
+    }
+
+    //! Освобождает всё выделенное; память блоков не возвращается системе
+    void reset()
+    {
+        m_curBlock = 0;
+        m_pCur     = m_blocks.empty() ? nullptr : m_blocks[0].pData.get();
+        m_pEnd     = m_blocks.empty() ? nullptr : m_pCur + m_blocks[0].size;
+    }
+
+    //! Возвращает память блоков системе
+    void release()
+    {
+        m_blocks.clear();
+        reset();
+    }
+
+    std::size_t allocatedBytes() const
+    {
+        std::size_t res = 0;
+        for(const auto &b : m_blocks)
+            res += b.size;
+        return res;
+    }
+
+
+protected:
+
+    struct Block
+    {
+        std::unique_ptr<char[]>     pData;
+        std::size_t                 size = 0;
+    };
+
+    static std::size_t alignPadding(const char *p, std::size_t align)
+    {
+        const std::size_t rem = std::size_t(reinterpret_cast<std::uintptr_t>(p) % align);
+        return rem ? align-rem : 0u;
+    }
+
+    void nextBlock(std::size_t minSize)
+    {
+        // Сначала пробуем использовать блоки, оставшиеся после reset()
+        std::size_t idx = m_pCur ? m_curBlock+1u : 0u;
+        for(; idx<m_blocks.size(); ++idx)
+        {
+            if (m_blocks[idx].size>=minSize)
+                break;
+        }
+
+        if (idx>=m_blocks.size())
+        {
+            Block b;
+            b.size  = std::max(m_blockSize, minSize);
+            b.pData.reset(new char[b.size]);
+            m_blocks.emplace_back(std::move(b));
+            idx = m_blocks.size()-1u;
+        }
+        else if (m_pCur && idx!=m_curBlock+1u)
+        {
+            // Пропущенные маленькие блоки переставляем в конец, чтобы reset() их не потерял
+            std::swap(m_blocks[m_curBlock+1u], m_blocks[idx]);
+            idx = m_curBlock+1u;
+        }
+
+        m_curBlock = idx;
+        m_pCur     = m_blocks[idx].pData.get();
+        m_pEnd     = m_pCur + m_blocks[idx].size;
+    }
+
+
+    std::size_t             m_blockSize;
+    std::vector<Block>      m_blocks;
+    std::size_t             m_curBlock = 0;
+    char*                   m_pCur     = nullptr;
+    char*                   m_pEnd     = nullptr;
+
+}; // class SvgArena
+
+//----------------------------------------------------------------------------
+//! Идентификатор строки в SvgStringPool, 0 - пустая строка
+using SvgStringId = std::uint32_t;
+
+//----------------------------------------------------------------------------
+//! Интернирование строк: каждая уникальная строка хранится в арене один раз
+/*! Хэш-таблица с открытой адресацией; clear() - O(1), за счёт номера поколения в слотах.
+ */
+class SvgStringPool
+{
+
+public:
+
+    SvgStringPool()
+    {
+        clear();
+    }
+
+    SvgStringId intern(std::string_view str)
+    {
+        if (str.empty())
+            return 0;
+
+        if ((m_strings.size()+1u)*2u > m_slots.size())
+            rehash(m_slots.empty() ? 64u : m_slots.size()*2u);
+
+        const std::uint64_t h    = hashString(str);
+        const std::size_t   mask = m_slots.size()-1u;
+
+        for(std::size_t idx=std::size_t(h)&mask; ; idx=(idx+1u)&mask)
+        {
+            Slot &slot = m_slots[idx];
+            if (slot.generation!=m_generation)
+            {
+                slot.generation = m_generation;
+                slot.hash       = h;
+                slot.id         = SvgStringId(m_strings.size());
+                m_strings.emplace_back(m_arena.storeString(str));
+                return slot.id;
+            }
+
+            if (slot.hash==h && m_strings[slot.id]==str)
+                return slot.id;
+        }
+    }
+
+    //! Поиск без добавления; 0 - строки в пуле нет (или она пустая)
+    SvgStringId find(std::string_view str) const
+    {
+        if (str.empty() || m_slots.empty())
+            return 0;
+
+        const std::uint64_t h    = hashString(str);
+        const std::size_t   mask = m_slots.size()-1u;
+
+        for(std::size_t idx=std::size_t(h)&mask; ; idx=(idx+1u)&mask)
+        {
+            const Slot &slot = m_slots[idx];
+            if (slot.generation!=m_generation)
+                return 0;
+
+            if (slot.hash==h && m_strings[slot.id]==str)
+                return slot.id;
+        }
+    }
+
+    std::string_view get(SvgStringId id) const
+    {
+        return m_strings[id];
+    }
+
+    std::size_t size() const
+    {
+        return m_strings.size();
+    }
+
+    void clear()
+    {
+        if (++m_generation==0)
+        {
+            // Номер поколения переполнился - чистим слоты честно
+            for(auto &slot : m_slots)
+                slot.generation = 0;
+            m_generation = 1;
+        }
+
+        m_strings.clear();
+        m_strings.emplace_back(std::string_view()); // id 0
+        m_arena.reset();
+    }
+
+
+protected:
+
+    struct Slot
+    {
+        std::uint64_t   hash       = 0;
+        std::uint32_t   generation = 0; // Слот занят, только если generation совпадает с текущим
+        SvgStringId     id         = 0;
+    };
+
+    //! FNV-1a
+    static std::uint64_t hashString(std::string_view str)
+    {
+        std::uint64_t h = 14695981039346656037ull;
+        for(char ch : str)
+        {
+            h ^= std::uint64_t((unsigned char)ch);
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    void rehash(std::size_t newSize)
+    {
+        std::vector<Slot> newSlots(newSize);
+        const std::size_t mask = newSize-1u;
+
+        for(const auto &slot : m_slots)
+        {
+            if (slot.generation!=m_generation)
+                continue;
+
+            std::size_t idx = std::size_t(slot.hash)&mask;
+            while(newSlots[idx].generation==m_generation)
+                idx = (idx+1u)&mask;
+            newSlots[idx] = slot;
+        }
+
+        m_slots.swap(newSlots);
+    }
+
+
+    SvgArena                        m_arena;
+    std::vector<std::string_view>   m_strings;
+    std::vector<Slot>               m_slots;
+    std::uint32_t                   m_generation = 0;
+
+}; // class SvgStringPool
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/svg_arena.h"
+
@@ -0,0 +1,96 @@
+/*! \file
+    \brief SvgBox - прямоугольная область (bounding box) в целых координатах
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include <algorithm>
+#include <climits>
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/svg_box.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+//! Прямоугольная область, границы включаются; по умолчанию - пустая
+struct SvgBox
+{
+    int minX = INT_MAX;
+    int minY = INT_MAX;
+    int maxX = INT_MIN;
+    int maxY = INT_MIN;
+
+    //! Область по левому верхнему углу и размеру; отрицательный размер допускается
+    static SvgBox fromRect(int posX, int posY, int sizeX, int sizeY)
+    {
+        SvgBox box;
+        box.addPoint(posX      , posY      );
+        box.addPoint(posX+sizeX, posY+sizeY);
+        return box;
+    }
+
+    bool empty() const { return minX>maxX || minY>maxY; }
+
+    int  sizeX() const { return empty() ? 0 : maxX-minX; }
+    int  sizeY() const { return empty() ? 0 : maxY-minY; }
+
+    void addPoint(int x, int y)
+    {
+        minX = std::min(minX, x); maxX = std::max(maxX, x);
+        minY = std::min(minY, y); maxY = std::max(maxY, y);
+    }
+
+    void addBox(const SvgBox &other)
+    {
+        if (other.empty())
+            return;
+        minX = std::min(minX, other.minX); maxX = std::max(maxX, other.maxX);
+        minY = std::min(minY, other.minY); maxY = std::max(maxY, other.maxY);
+    }
+
+    //! Расширяет область на d во все стороны - например, на половину толщины линии
+    void inflate(int d)
+    {
+        if (empty())
+            return;
+        minX -= d; minY -= d;
+        maxX += d; maxY += d;
+    }
+
+    bool intersects(const SvgBox &other) const
+    {
+        return minX<=other.maxX && other.minX<=maxX
+            && minY<=other.maxY && other.minY<=maxY;
+    }
+
+    bool contains(const SvgBox &other) const
+    {
+        return minX<=other.minX && other.maxX<=maxX
+            && minY<=other.minY && other.maxY<=maxY;
+    }
+};
+
+//----------------------------------------------------------------------------
+//! Параметры оценки габаритов для того, что по самому документу неизвестно
+struct SvgBoundsOptions
+{
+    int classStrokeWidth = 2;  //!< Толщина линии для элементов, стиль которых задан классом
+    int textCharWidth    = 10; //!< Оценка ширины символа текста сверху
+    int textHeight       = 16; //!< Оценка высоты строки текста сверху
+};
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/svg_box.h"
+
@@ -0,0 +1,154 @@
+/*! \file
+    \brief Контрольные суммы для выходных форматов (gzip, PNG и т.п.) - CRC-32, Adler-32, и быстрый 64-битный хэш содержимого
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/svg_checksum.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+//! Таблицы CRC-32 (полином 0xEDB88320, как в gzip/zlib/PNG) для обработки по 8 байт за шаг
+struct SvgCrc32Tables
+{
+    std::uint32_t t[8][256] = {};
+
+    constexpr SvgCrc32Tables()
+    {
+        for(std::uint32_t n=0; n!=256; ++n)
+        {
+            std::uint32_t c = n;
+            for(int k=0; k!=8; ++k)
+                c = (c&1u) ? 0xEDB88320u^(c>>1) : (c>>1);
+            t[0][n] = c;
+        }
+
+        for(std::uint32_t n=0; n!=256; ++n)
+        {
+            for(int k=1; k!=8; ++k)
+                t[k][n] = t[0][t[k-1][n]&0xFFu] ^ (t[k-1][n]>>8);
+        }
+    }
+};
+
+inline
+const SvgCrc32Tables& crc32Tables()
+{
+    static constexpr SvgCrc32Tables tables;
+    return tables;
+}
+
+//----------------------------------------------------------------------------
+//! Продолжает подсчёт CRC-32; начальное значение - 0, результат - готовое значение CRC
+inline
+std::uint32_t crc32Update(std::uint32_t crc, const void *pData, std::size_t size)
+{
+    const auto &t = crc32Tables().t;
+    const unsigned char *p = static_cast<const unsigned char*>(pData);
+
+    crc = ~crc;
+
+    for(; size>=8; p+=8, size-=8)
+    {
+        // Сборка слов побайтно - не зависит от порядка байт платформы
+        const std::uint32_t lo = crc ^ ( std::uint32_t(p[0])      | std::uint32_t(p[1])<<8
+                                       | std::uint32_t(p[2])<<16  | std::uint32_t(p[3])<<24 );
+        crc = t[7][ lo     &0xFFu] ^ t[6][(lo>> 8)&0xFFu] ^ t[5][(lo>>16)&0xFFu] ^ t[4][lo>>24]
+            ^ t[3][p[4]]           ^ t[2][p[5]]           ^ t[1][p[6]]           ^ t[0][p[7]];
+    }
+
+    for(; size; ++p, --size)
+        crc = t[0][(crc^*p)&0xFFu] ^ (crc>>8);
+
+    return ~crc;
+}
+
+//----------------------------------------------------------------------------
+//! Продолжает подсчёт Adler-32 (контрольная сумма потока zlib); начальное значение - 1
+inline
+std::uint32_t adler32Update(std::uint32_t adler, const void *pData, std::size_t size)
+{
+    constexpr std::uint32_t base = 65521u;
+    constexpr std::size_t   nMax = 5552u; // Максимум байт, при котором суммы не переполняют 32 бита
+
+    const unsigned char *p = static_cast<const unsigned char*>(pData);
+    std::uint32_t a = adler&0xFFFFu;
+    std::uint32_t b = adler>>16;
+
+    while(size)
+    {
+        std::size_t n = std::min(size, nMax);
+        size -= n;
+
+        for(; n>=8; p+=8, n-=8)
+        {
+            a += p[0]; b += a; a += p[1]; b += a; a += p[2]; b += a; a += p[3]; b += a;
+            a += p[4]; b += a; a += p[5]; b += a; a += p[6]; b += a; a += p[7]; b += a;
+        }
+
+        for(; n; ++p, --n)
+        {
+            a += *p; b += a;
+        }
+
+        a %= base;
+        b %= base;
+    }
+
+    return (b<<16) | a;
+}
+
+//----------------------------------------------------------------------------
+//! Быстрый некриптографический 64-битный хэш - для сравнения содержимого, не для контроля целостности
+/*! Обрабатывает по 8 байт за шаг, финальное перемешивание - как в MurmurHash3 (fmix64). */
+inline
+std::uint64_t hashBytes64(const void *pData, std::size_t size, std::uint64_t seed=0)
+{
+    constexpr std::uint64_t k1 = 0x9E3779B97F4A7C15ull;
+    constexpr std::uint64_t k2 = 0xC2B2AE3D27D4EB4Full;
+
+    const unsigned char *p = static_cast<const unsigned char*>(pData);
+    std::uint64_t h = seed ^ (std::uint64_t(size)*k1);
+
+    for(; size>=8; p+=8, size-=8)
+    {
+        std::uint64_t w;
+        std::memcpy(&w, p, 8);
+        w *= k2;
+        w  = (w<<31) | (w>>33);
+        h ^= w*k1;
+        h  = ((h<<27) | (h>>37))*5u + 0x52DCE729u;
+    }
+
+    std::uint64_t tail = 0;
+    for(std::size_t i=0; i!=size; ++i)
+        tail |= std::uint64_t(p[i])<<(8*i);
+    h ^= tail*k2;
+
+    h ^= h>>33; h *= 0xFF51AFD7ED558CCDull;
+    h ^= h>>33; h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h>>33;
+    return h;
+}
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/svg_checksum.h"
+
@@ -0,0 +1,340 @@
+/*! \file
+    \brief Типы координат: целые, float/double и фиксированная точка 16.16, и их форматирование
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include "svg_stream_wrapper.h"
+//
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+//----------------------------------------------------------------------------
+//! Число знаков после точки по умолчанию для нецелых координат
+#if !defined(MARTY_SVG_DEFAULT_COORD_PRECISION)
+    #define MARTY_SVG_DEFAULT_COORD_PRECISION 3
+#endif
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/svg_coord.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+//! Фиксированная точка 16.16
+/*! Поддерживает только ту арифметику, которая нужна хелперам marty_svg.h.
+    При выводе даёт самую короткую запись, которая читается обратно в то же значение.
+
+    Диапазон - от -32768 до 32767.99998 (целые - ±32767 и -32768). Значения вне диапазона при
+    создании и результаты арифметики прижимаются к его границам (насыщение), NaN даёт 0.
+ */
+struct SvgFixed16
+{
+    std::int32_t raw = 0;
+
+    static constexpr int fracBits = 16;
+    static constexpr std::int32_t one = std::int32_t(1)<<fracBits;
+
+    static constexpr int minInt = -32768;
+    static constexpr int maxInt =  32767;
+
+    constexpr SvgFixed16() = default;
+    constexpr explicit SvgFixed16(int v) : raw(std::int32_t(std::uint32_t(v<minInt ? minInt : (v>maxInt ? maxInt : v))<<fracBits)) {}
+    explicit SvgFixed16(double v) : raw(fromDouble(v)) {}
+
+    static constexpr SvgFixed16 fromRaw(std::int32_t raw_) { SvgFixed16 res; res.raw = raw_; return res; }
+
+    //! Сырое значение с насыщением до диапазона int32
+    static constexpr SvgFixed16 fromRawSaturated(std::int64_t raw_)
+    {
+        return fromRaw( raw_<std::int64_t(INT32_MIN) ? INT32_MIN
+                      : raw_>std::int64_t(INT32_MAX) ? INT32_MAX
+                      : std::int32_t(raw_)
+                      );
+    }
+
+    double toDouble() const { return double(raw)/double(one); }
+
+    constexpr SvgFixed16 operator-() const { return fromRawSaturated(-std::int64_t(raw)); }
+
+    SvgFixed16& operator+=(SvgFixed16 other) { *this = *this+other; return *this; }
+    SvgFixed16& operator-=(SvgFixed16 other) { *this = *this-other; return *this; }
+
+    friend constexpr SvgFixed16 operator+(SvgFixed16 a, SvgFixed16 b) { return fromRawSaturated(std::int64_t(a.raw)+b.raw); }
+    friend constexpr SvgFixed16 operator-(SvgFixed16 a, SvgFixed16 b) { return fromRawSaturated(std::int64_t(a.raw)-b.raw); }
+    friend constexpr SvgFixed16 operator*(SvgFixed16 a, int b)        { return fromRawSaturated(std::int64_t(a.raw)*b); }
+    friend constexpr SvgFixed16 operator*(int a, SvgFixed16 b)        { return fromRawSaturated(std::int64_t(a)*b.raw); }
+    friend constexpr SvgFixed16 operator/(SvgFixed16 a, int b)        { return fromRawSaturated(std::int64_t(a.raw)/b); }
+
+    friend constexpr bool operator==(SvgFixed16 a, SvgFixed16 b) { return a.raw==b.raw; }
+    friend constexpr bool operator!=(SvgFixed16 a, SvgFixed16 b) { return a.raw!=b.raw; }
+    friend constexpr bool operator< (SvgFixed16 a, SvgFixed16 b) { return a.raw< b.raw; }
+    friend constexpr bool operator> (SvgFixed16 a, SvgFixed16 b) { return a.raw> b.raw; }
+    friend constexpr bool operator<=(SvgFixed16 a, SvgFixed16 b) { return a.raw<=b.raw; }
+    friend constexpr bool operator>=(SvgFixed16 a, SvgFixed16 b) { return a.raw>=b.raw; }
+
+
+protected:
+
+    static std::int32_t fromDouble(double v)
+    {
+        if (std::isnan(v))
+            return 0;
+
+        v = std::round(v*double(one));
+        if (v<=double(INT32_MIN))
+            return INT32_MIN;
+        if (v>=double(INT32_MAX))
+            return INT32_MAX;
+        return std::int32_t(v);
+    }
+};
+
+//----------------------------------------------------------------------------
+//! Координаты одного вызова разных арифметических типов - например, pathLineTo(oss, 1.5, 2)
+/*! CoordType в таких вызовах не выводится; их принимают перегрузки, приводящие все координаты к
+    SvgMixedCoordType: только целые - к int, есть плавающие - к std::common_type (1.5 и 2 - double).
+    SvgFixed16 с другими типами не смешивается - такой вызов не компилируется.
+ */
+template<typename FirstType, typename... CoordTypes>
+struct SvgMixedCoords
+{
+    static constexpr bool allArithmetic = std::is_arithmetic<FirstType>::value && (std::is_arithmetic<CoordTypes>::value && ...);
+    static constexpr bool allIntegral   = std::is_integral<FirstType>::value && (std::is_integral<CoordTypes>::value && ...);
+    static constexpr bool allSame       = (std::is_same<FirstType, CoordTypes>::value && ...);
+
+    static constexpr bool value = allArithmetic && !allSame;
+};
+
+template<bool bIntegral, typename... CoordTypes>
+struct SvgMixedCoordTypeSelector
+{
+    using type = int;
+};
+
+template<typename... CoordTypes>
+struct SvgMixedCoordTypeSelector<false, CoordTypes...>
+{
+    using type = typename std::common_type<CoordTypes...>::type;
+};
+
+template<typename... CoordTypes>
+using SvgMixedCoordType = typename SvgMixedCoordTypeSelector<SvgMixedCoords<CoordTypes...>::allIntegral, CoordTypes...>::type;
+
+//----------------------------------------------------------------------------
+//! Значение координаты любого типа - для вычислений, не для вывода
+template< typename CoordType
+        , typename std::enable_if<std::is_arithmetic<CoordType>::value, int>::type = 0
+        > inline
+constexpr double coordToDouble(CoordType v)
+{
+    return double(v);
+}
+
+inline
+double coordToDouble(SvgFixed16 v)
+{
+    return v.toDouble();
+}
+
+//----------------------------------------------------------------------------
+//! Текст нецелой координаты - выводится в поток как строка
+struct SvgCoordText
+{
+    static constexpr std::size_t maxChars = 64;
+
+    char            buf[maxChars];
+    std::size_t     size = 0;
+
+    std::string_view view() const { return std::string_view(&buf[0], size); }
+    operator std::string_view() const { return view(); }
+};
+
+inline
+std::ostream& operator<<(std::ostream &oss, const SvgCoordText &coordText)
+{
+    return oss.write(&coordText.buf[0], std::streamsize(coordText.size));
+}
+
+//----------------------------------------------------------------------------
+//! Точность вывода нецелых координат для потока; перегружается для конкретных потоков (см. SvgWriter)
+/*! Обёртки (SvgStreamWrapper) берут точность вложенного потока. */
+template<typename StreamType> inline
+int coordPrecision(const StreamType &oss)
+{
+    if constexpr (IsSvgStreamWrapper<StreamType>::value)
+    {
+        return coordPrecision(oss.stream());
+    }
+    else
+    {
+        (void)oss;
+        return MARTY_SVG_DEFAULT_COORD_PRECISION;
+    }
+}
+
+//----------------------------------------------------------------------------
+//! Убирает хвостовые нули дробной части, точку без дробной части и знак у нуля
+inline
+void trimCoordText(SvgCoordText &res)
+{
+    const std::string_view str = res.view();
+    if (str.find('.')!=str.npos)
+    {
+        while(res.buf[res.size-1]=='0')
+            --res.size;
+        if (res.buf[res.size-1]=='.')
+            --res.size;
+    }
+
+    if (res.size==2 && res.buf[0]=='-' && res.buf[1]=='0')
+    {
+        res.buf[0] = '0';
+        res.size   = 1;
+    }
+}
+
+//----------------------------------------------------------------------------
+//! Самая короткая запись, читаемая обратно в то же значение, но не больше precision знаков после точки
+template<typename FloatType> inline
+SvgCoordText formatFloatCoord(FloatType v, int precision)
+{
+    static_assert(std::is_floating_point<FloatType>::value, "formatFloatCoord: floating point type required");
+
+    SvgCoordText res;
+    char *pBegin = &res.buf[0];
+    char *pEnd   = pBegin+SvgCoordText::maxChars;
+
+    if (!std::isfinite(v))
+    {
+        res.buf[0] = '0'; // В SVG нет записи для inf/nan
+        res.size   = 1;
+        return res;
+    }
+
+    if (std::fabs(v)<FloatType(1e15) && v==std::trunc(v))
+    {
+        // Целое значение - быстрый путь, без форматирования с плавающей точкой
+        res.size = std::size_t(std::to_chars(pBegin, pEnd, static_cast<long long>(v)).ptr-pBegin);
+        return res;
+    }
+
+    precision = std::max(0, std::min(precision, 17));
+
+    auto r = std::to_chars(pBegin, pEnd, v, std::chars_format::fixed);
+    if (r.ec==std::errc())
+    {
+        res.size = std::size_t(r.ptr-pBegin);
+        const std::size_t dotPos = res.view().find('.');
+        if (dotPos==std::string_view::npos || res.size-dotPos-1<=std::size_t(precision))
+        {
+            trimCoordText(res);
+            return res;
+        }
+    }
+
+    r = std::to_chars(pBegin, pEnd, v, std::chars_format::fixed, precision);
+    if (r.ec!=std::errc())
+        r = std::to_chars(pBegin, pEnd, v); // Огромные значения - в экспоненциальной записи
+
+    res.size = std::size_t(r.ptr-pBegin);
+    trimCoordText(res);
+    return res;
+}
+
+//----------------------------------------------------------------------------
+//! Самая короткая точная запись числа 16.16, не больше precision знаков после точки (точной хватает 5)
+inline
+SvgCoordText formatFixed16Coord(SvgFixed16 v, int precision)
+{
+    SvgCoordText res;
+    char *pBegin = &res.buf[0];
+    char *pEnd   = pBegin+SvgCoordText::maxChars;
+
+    const bool          neg  = v.raw<0;
+    const std::uint32_t mag  = neg ? std::uint32_t(0)-std::uint32_t(v.raw) : std::uint32_t(v.raw);
+    std::uint32_t       ip   = mag>>SvgFixed16::fracBits;
+    const std::uint64_t frac = mag&std::uint32_t(SvgFixed16::one-1);
+
+    precision = std::max(0, std::min(precision, 5));
+
+    std::uint64_t scale  = 1;
+    std::uint64_t digits = 0;
+    int           nDigits = 0;
+    for(; ; ++nDigits, scale*=10u)
+    {
+        // Округление до nDigits знаков и проверка, что значение восстанавливается
+        digits = (frac*scale + (std::uint64_t(SvgFixed16::one)>>1)) >> SvgFixed16::fracBits;
+        const std::uint64_t back = (digits*std::uint64_t(SvgFixed16::one)*2u + scale) / (2u*scale);
+        if (back==frac || nDigits==precision)
+            break;
+    }
+
+    if (digits==scale)
+    {
+        ++ip; // Перенос в целую часть
+        digits = 0;
+    }
+
+    char *p = pBegin;
+    if (neg && (ip || digits))
+        *p++ = '-';
+    p = std::to_chars(p, pEnd, ip).ptr;
+
+    if (digits)
+    {
+        *p++ = '.';
+        for(int i=nDigits-1; i>=0; --i)
+        {
+            p[i]    = char('0' + digits%10u);
+            digits /= 10u;
+        }
+        p += nDigits;
+    }
+
+    res.size = std::size_t(p-pBegin);
+    trimCoordText(res);
+    return res;
+}
+
+//----------------------------------------------------------------------------
+//! Координата для вывода в поток: целые отдаются как есть, остальное - текстом
+template< typename StreamType, typename CoordType
+        , typename std::enable_if<std::is_integral<CoordType>::value, int>::type = 0
+        > inline
+constexpr CoordType formatCoord(const StreamType &, CoordType v)
+{
+    return v;
+}
+
+template< typename StreamType, typename CoordType
+        , typename std::enable_if<std::is_floating_point<CoordType>::value, int>::type = 0
+        > inline
+SvgCoordText formatCoord(const StreamType &oss, CoordType v)
+{
+    return formatFloatCoord(v, coordPrecision(oss));
+}
+
+template<typename StreamType> inline
+SvgCoordText formatCoord(const StreamType &oss, SvgFixed16 v)
+{
+    return formatFixed16Coord(v, coordPrecision(oss));
+}
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/svg_coord.h"
+
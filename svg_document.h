@@ -0,0 +1,523 @@
+/*! \file
+    \brief SvgDocument - модель SVG-диаграммы в памяти (retained mode)
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include "marty_svg.h"
+#include "svg_arena.h"
+//
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/svg_document.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+enum class SvgElementKind : std::uint8_t
+{
+    rectEx    , //!< drawRectEx
+    rect      , //!< drawRect
+    line      , //!< drawLine с классом
+    lineStyled, //!< drawLine со стилем
+    text      , //!< drawText
+    path        //!< pathStart ... pathEnd
+};
+
+//----------------------------------------------------------------------------
+//! Сегмент пути, младший бит - абсолютные координаты
+enum class SvgPathSegmentKind : std::uint8_t
+{
+    lineTo            = 0x00,
+    horzLineTo        = 0x02,
+    vertLineTo        = 0x04,
+    quadraticBezier   = 0x06,
+    absFlag           = 0x01
+};
+
+//----------------------------------------------------------------------------
+//! Выводит сегмент пути; kind - SvgPathSegmentKind с флагом absFlag
+/*! Вызовы хелперов неквалифицированные, чтобы для обёрток потока находились их перегрузки (см. path_encoder.h).
+ */
+template<typename StreamType> inline
+void writePathSegment(StreamType &oss, std::uint8_t kind, const int *a)
+{
+    const bool bAbs = (kind & std::uint8_t(SvgPathSegmentKind::absFlag))!=0;
+
+    switch(SvgPathSegmentKind(kind & ~std::uint8_t(SvgPathSegmentKind::absFlag)))
+    {
+        case SvgPathSegmentKind::lineTo         : pathLineTo(oss, a[0], a[1], bAbs); break;
+        case SvgPathSegmentKind::horzLineTo     : pathHorzLineTo(oss, a[0], bAbs); break;
+        case SvgPathSegmentKind::vertLineTo     : pathVertLineTo(oss, a[0], bAbs); break;
+        case SvgPathSegmentKind::quadraticBezier: pathQuadraticBezier(oss, a[0], a[1], a[2], a[3], bAbs); break;
+        default: break;
+    }
+}
+
+//----------------------------------------------------------------------------
+template<typename StreamType> inline
+void writePathEnd(StreamType &oss, bool closePath)
+{
+    pathEnd(oss, closePath);
+}
+
+//----------------------------------------------------------------------------
+//! Модель диаграммы: элементы хранятся POD-записями в колонках (structure of arrays), строки интернируются
+/*! Методы повторяют хелперы marty_svg.h; serialize() выводит элементы через эти же хелперы,
+    поэтому результат побайтно совпадает с прямым выводом в поток.
+    clear() не освобождает память - документ можно строить заново без аллокаций.
+
+    Путь строится как при выводе в поток: pathStart, сегменты, pathEnd. Сегмент или pathEnd без
+    открытого пути, а также новый элемент (и новый путь) до pathEnd - std::logic_error.
+ */
+class SvgDocument
+{
+
+public:
+
+    struct RectExColumns
+    {
+        std::vector<int>            posX, posY, sizeX, sizeY, r, strokeWidth;
+        std::vector<SvgStringId>    strokeColor, fillColor;
+        std::vector<RoundRectFlags> flags;
+    };
+
+    struct RectColumns
+    {
+        std::vector<int>            posX, posY, sizeX, sizeY, r;
+        std::vector<SvgStringId>    itemClass;
+        std::vector<std::uint8_t>   roundLeft, roundRight;
+    };
+
+    struct LineColumns
+    {
+        std::vector<int>            startX, startY, endX, endY;
+        std::vector<SvgStringId>    lineClass;
+    };
+
+    struct LineStyledColumns
+    {
+        std::vector<int>            startX, startY, endX, endY, strokeWidth;
+        std::vector<SvgStringId>    strokeColor, linejoin;
+    };
+
+    struct TextColumns
+    {
+        std::vector<int>            posX, posY;
+        std::vector<SvgStringId>    text, textClass, baseLine, hAlign;
+    };
+
+    struct PathColumns
+    {
+        std::vector<int>            posX, posY;
+        std::vector<std::uint8_t>   bAbs, styled, closePath;
+        std::vector<SvgStringId>    pathClass;                   // для styled==0
+        std::vector<int>            strokeWidth;                 // для styled!=0
+        std::vector<SvgStringId>    strokeColor, fillColor, linejoin;
+        std::vector<std::uint32_t>  firstSegment, segmentCount;
+    };
+
+    //! Сегменты всех путей; аргументы лежат подряд в segmentArgs, их количество зависит от вида сегмента
+    struct PathSegmentColumns
+    {
+        std::vector<std::uint8_t>   kind; // SvgPathSegmentKind
+        std::vector<std::uint32_t>  firstArg;
+        std::vector<int>            args;
+    };
+
+
+    //------------------------------
+    void drawRectEx( int posX , int posY
+                   , int sizeX, int sizeY
+                   , int r
+                   , int strokeWidth
+                   , std::string_view strokeColor
+                   , std::string_view fillColor = std::string_view() // no fill if empty
+                   , RoundRectFlags flags=RoundRectFlags::round
+                   )
+    {
+        auto &c = m_rectEx;
+        addElement(SvgElementKind::rectEx, c.posX.size());
+        c.posX.push_back(posX); c.posY.push_back(posY); c.sizeX.push_back(sizeX); c.sizeY.push_back(sizeY);
+        c.r.push_back(r); c.strokeWidth.push_back(strokeWidth);
+        c.strokeColor.push_back(m_strings.intern(strokeColor));
+        c.fillColor.push_back(m_strings.intern(fillColor));
+        c.flags.push_back(flags);
+    }
+
+    void drawRect( int posX , int posY
+                 , int sizeX, int sizeY
+                 , std::string_view itemClass
+                 , bool roundLeft
+                 , bool roundRight
+                 , int  r
+                 )
+    {
+        auto &c = m_rect;
+        addElement(SvgElementKind::rect, c.posX.size());
+        c.posX.push_back(posX); c.posY.push_back(posY); c.sizeX.push_back(sizeX); c.sizeY.push_back(sizeY);
+        c.r.push_back(r);
+        c.itemClass.push_back(m_strings.intern(itemClass));
+        c.roundLeft.push_back(roundLeft ? 1u : 0u);
+        c.roundRight.push_back(roundRight ? 1u : 0u);
+    }
+
+    void drawLine( int startX, int startY
+                 , int endX  , int endY
+                 , std::string_view lineClass
+                 )
+    {
+        auto &c = m_line;
+        addElement(SvgElementKind::line, c.startX.size());
+        c.startX.push_back(startX); c.startY.push_back(startY); c.endX.push_back(endX); c.endY.push_back(endY);
+        c.lineClass.push_back(m_strings.intern(lineClass));
+    }
+
+    void drawLine( int startX, int startY
+                 , int endX  , int endY
+                 , int strokeWidth
+                 , std::string_view strokeColor
+                 , std::string_view linejoin=std::string_view()
+                 )
+    {
+        auto &c = m_lineStyled;
+        addElement(SvgElementKind::lineStyled, c.startX.size());
+        c.startX.push_back(startX); c.startY.push_back(startY); c.endX.push_back(endX); c.endY.push_back(endY);
+        c.strokeWidth.push_back(strokeWidth);
+        c.strokeColor.push_back(m_strings.intern(strokeColor));
+        c.linejoin.push_back(m_strings.intern(linejoin));
+    }
+
+    void drawLine( int startX, int startY
+                 , int endX  , int endY
+                 , int strokeWidth
+                 , std::string_view strokeColor
+                 , LineJoin linejoin
+                 )
+    {
+        drawLine(startX, startY, endX, endY, strokeWidth, strokeColor, svgKeyword(linejoin));
+    }
+
+    void drawText( int posX, int posY
+                 , std::string_view text
+                 , std::string_view textClass
+                 , std::string_view baseLine = "auto"
+                 , std::string_view hAlign   = "start"
+                 )
+    {
+        auto &c = m_text;
+        addElement(SvgElementKind::text, c.posX.size());
+        c.posX.push_back(posX); c.posY.push_back(posY);
+        c.text.push_back(m_strings.intern(text));
+        c.textClass.push_back(m_strings.intern(textClass));
+        c.baseLine.push_back(m_strings.intern(baseLine));
+        c.hAlign.push_back(m_strings.intern(hAlign));
+    }
+
+    void drawText( int posX, int posY
+                 , std::string_view text
+                 , std::string_view textClass
+                 , DominantBaseline baseLine
+                 , TextAnchor       hAlign = TextAnchor::start
+                 )
+    {
+        drawText(posX, posY, text, textClass, svgKeyword(baseLine), svgKeyword(hAlign));
+    }
+
+    //------------------------------
+    void pathStart(int posX, int posY, std::string_view pathClass=std::string_view(), bool bAbs=false)
+    {
+        addPath(posX, posY, bAbs, false);
+        m_path.pathClass.back() = m_strings.intern(pathClass);
+    }
+
+    void pathStart( int posX, int posY
+                  , int strokeWidth, std::string_view strokeColor
+                  , std::string_view fillColor=std::string_view()
+                  , std::string_view linejoin=std::string_view()
+                  , bool bAbs=false
+                  )
+    {
+        addPath(posX, posY, bAbs, true);
+        m_path.strokeWidth.back() = strokeWidth;
+        m_path.strokeColor.back() = m_strings.intern(strokeColor);
+        m_path.fillColor  .back() = m_strings.intern(fillColor);
+        m_path.linejoin   .back() = m_strings.intern(linejoin);
+    }
+
+    void pathStart( int posX, int posY
+                  , int strokeWidth, std::string_view strokeColor
+                  , std::string_view fillColor
+                  , LineJoin linejoin
+                  , bool bAbs=false
+                  )
+    {
+        pathStart(posX, posY, strokeWidth, strokeColor, fillColor, svgKeyword(linejoin), bAbs);
+    }
+
+    void pathLineTo(int posX, int posY, bool bAbs=false)
+    {
+        addSegment(SvgPathSegmentKind::lineTo, bAbs, { posX, posY });
+    }
+
+    void pathHorzLineTo(int posX, bool bAbs=false)
+    {
+        addSegment(SvgPathSegmentKind::horzLineTo, bAbs, { posX });
+    }
+
+    void pathVertLineTo(int posY, bool bAbs=false)
+    {
+        addSegment(SvgPathSegmentKind::vertLineTo, bAbs, { posY });
+    }
+
+    void pathQuadraticBezier(int cpX, int cpY, int endX, int endY, bool bAbs=false)
+    {
+        addSegment(SvgPathSegmentKind::quadraticBezier, bAbs, { cpX, cpY, endX, endY });
+    }
+
+    void pathEnd(bool closePath=true)
+    {
+        checkPathOpen();
+        m_path.closePath.back() = closePath ? 1u : 0u;
+        m_pathOpen = false;
+    }
+
+    //! Путь начат pathStart и ещё не завершён pathEnd
+    bool pathOpen() const { return m_pathOpen; }
+
+
+    //------------------------------
+    std::size_t size() const  { return m_elementKind.size(); }
+    bool        empty() const { return m_elementKind.empty(); }
+
+    SvgElementKind elementKind(std::size_t idx) const { return m_elementKind[idx]; }
+    //! Индекс элемента в колонках его вида
+    std::uint32_t  elementIndex(std::size_t idx) const { return m_elementIndex[idx]; }
+
+    std::string_view getString(SvgStringId id) const { return m_strings.get(id); }
+
+    const RectExColumns&        rectExColumns()       const { return m_rectEx;     }
+    const RectColumns&          rectColumns()         const { return m_rect;       }
+    const LineColumns&          lineColumns()         const { return m_line;       }
+    const LineStyledColumns&    lineStyledColumns()   const { return m_lineStyled; }
+    const TextColumns&          textColumns()         const { return m_text;       }
+    const PathColumns&          pathColumns()         const { return m_path;       }
+    const PathSegmentColumns&   pathSegmentColumns()  const { return m_segments;   }
+
+    //! Удаляет все элементы; память колонок и арены строк остаётся за документом
+    void clear()
+    {
+        m_elementKind.clear(); m_elementIndex.clear();
+        m_pathOpen = false;
+
+        clearColumns(m_rectEx.posX, m_rectEx.posY, m_rectEx.sizeX, m_rectEx.sizeY, m_rectEx.r, m_rectEx.strokeWidth, m_rectEx.strokeColor, m_rectEx.fillColor, m_rectEx.flags);
+        clearColumns(m_rect.posX, m_rect.posY, m_rect.sizeX, m_rect.sizeY, m_rect.r, m_rect.itemClass, m_rect.roundLeft, m_rect.roundRight);
+        clearColumns(m_line.startX, m_line.startY, m_line.endX, m_line.endY, m_line.lineClass);
+        clearColumns(m_lineStyled.startX, m_lineStyled.startY, m_lineStyled.endX, m_lineStyled.endY, m_lineStyled.strokeWidth, m_lineStyled.strokeColor, m_lineStyled.linejoin);
+        clearColumns(m_text.posX, m_text.posY, m_text.text, m_text.textClass, m_text.baseLine, m_text.hAlign);
+        clearColumns(m_path.posX, m_path.posY, m_path.bAbs, m_path.styled, m_path.closePath, m_path.pathClass, m_path.strokeWidth, m_path.strokeColor, m_path.fillColor, m_path.linejoin, m_path.firstSegment, m_path.segmentCount);
+        clearColumns(m_segments.kind, m_segments.firstArg, m_segments.args);
+
+        m_strings.clear();
+    }
+
+
+    //------------------------------
+    //! Выводит один элемент документа
+    template<typename StreamType>
+    void serializeElement(StreamType &oss, std::size_t elementIdx) const
+    {
+        const std::size_t i = m_elementIndex[elementIdx];
+
+        switch(m_elementKind[elementIdx])
+        {
+            case SvgElementKind::rectEx:
+            {
+                const auto &c = m_rectEx;
+                marty::svg::drawRectEx( oss, c.posX[i], c.posY[i], c.sizeX[i], c.sizeY[i], c.r[i], c.strokeWidth[i]
+                                      , getString(c.strokeColor[i]), getString(c.fillColor[i]), c.flags[i]
+                                      );
+                break;
+            }
+
+            case SvgElementKind::rect:
+            {
+                const auto &c = m_rect;
+                marty::svg::drawRect( oss, c.posX[i], c.posY[i], c.sizeX[i], c.sizeY[i], getString(c.itemClass[i])
+                                    , c.roundLeft[i]!=0, c.roundRight[i]!=0, c.r[i]
+                                    );
+                break;
+            }
+
+            case SvgElementKind::line:
+            {
+                const auto &c = m_line;
+                marty::svg::drawLine(oss, c.startX[i], c.startY[i], c.endX[i], c.endY[i], getString(c.lineClass[i]));
+                break;
+            }
+
+            case SvgElementKind::lineStyled:
+            {
+                const auto &c = m_lineStyled;
+                marty::svg::drawLine( oss, c.startX[i], c.startY[i], c.endX[i], c.endY[i], c.strokeWidth[i]
+                                    , getString(c.strokeColor[i]), getString(c.linejoin[i])
+                                    );
+                break;
+            }
+
+            case SvgElementKind::text:
+            {
+                const auto &c = m_text;
+                marty::svg::drawText( oss, c.posX[i], c.posY[i], getString(c.text[i]), getString(c.textClass[i])
+                                    , getString(c.baseLine[i]), getString(c.hAlign[i])
+                                    );
+                break;
+            }
+
+            case SvgElementKind::path:
+                serializePath(oss, i);
+                break;
+        }
+    }
+
+    //! Выводит все элементы в порядке добавления, за один проход
+    template<typename StreamType>
+    void serialize(StreamType &oss) const
+    {
+        for(std::size_t idx=0; idx!=m_elementKind.size(); ++idx)
+            serializeElement(oss, idx);
+    }
+
+    //! Выводит элементы с заданными индексами в заданном порядке - для переупорядочивания и выборок
+    template<typename StreamType>
+    void serialize(StreamType &oss, const std::uint32_t *pElementIndices, std::size_t count) const
+    {
+        for(std::size_t k=0; k!=count; ++k)
+            serializeElement(oss, pElementIndices[k]);
+    }
+
+    //! Документ SVG целиком, см. marty::svg::writeSvg
+    template<typename StreamType>
+    void writeSvg(StreamType &oss, int viewSizeX, int viewSizeY, std::string_view style) const
+    {
+        SvgWriter body;
+        serialize(body);
+        marty::svg::writeSvg(oss, viewSizeX, viewSizeY, style, body.view());
+    }
+
+
+protected:
+
+    template<typename... Columns>
+    static void clearColumns(Columns&... columns)
+    {
+        (columns.clear(), ...);
+    }
+
+    void checkPathOpen() const
+    {
+        if (!m_pathOpen)
+            throw std::logic_error("marty::svg::SvgDocument: no open path, pathStart must be called first");
+    }
+
+    void addElement(SvgElementKind kind, std::size_t kindIndex)
+    {
+        if (m_pathOpen)
+            throw std::logic_error("marty::svg::SvgDocument: path is not finished, pathEnd must be called before adding elements");
+
+        m_elementKind.push_back(kind);
+        m_elementIndex.push_back(std::uint32_t(kindIndex));
+    }
+
+    void addPath(int posX, int posY, bool bAbs, bool styled)
+    {
+        auto &c = m_path;
+        addElement(SvgElementKind::path, c.posX.size());
+        c.posX.push_back(posX); c.posY.push_back(posY);
+        c.bAbs.push_back(bAbs ? 1u : 0u);
+        c.styled.push_back(styled ? 1u : 0u);
+        c.closePath.push_back(1u);
+        c.pathClass.push_back(0); c.strokeWidth.push_back(0);
+        c.strokeColor.push_back(0); c.fillColor.push_back(0); c.linejoin.push_back(0);
+        c.firstSegment.push_back(std::uint32_t(m_segments.kind.size()));
+        c.segmentCount.push_back(0);
+        m_pathOpen = true;
+    }
+
+    void addSegment(SvgPathSegmentKind kind, bool bAbs, std::initializer_list<int> args)
+    {
+        checkPathOpen();
+        m_segments.kind.push_back(std::uint8_t(std::uint8_t(kind) | (bAbs ? std::uint8_t(SvgPathSegmentKind::absFlag) : 0u)));
+        m_segments.firstArg.push_back(std::uint32_t(m_segments.args.size()));
+        m_segments.args.insert(m_segments.args.end(), args);
+        ++m_path.segmentCount.back();
+    }
+
+    template<typename StreamType>
+    void serializePath(StreamType &oss, std::size_t i) const
+    {
+        const auto &c = m_path;
+
+        if (c.styled[i])
+        {
+            marty::svg::pathStart( oss, c.posX[i], c.posY[i], c.strokeWidth[i], getString(c.strokeColor[i])
+                                 , getString(c.fillColor[i]), getString(c.linejoin[i]), c.bAbs[i]!=0
+                                 );
+        }
+        else
+        {
+            marty::svg::pathStart(oss, c.posX[i], c.posY[i], getString(c.pathClass[i]), c.bAbs[i]!=0);
+        }
+
+        const std::size_t segEnd = std::size_t(c.firstSegment[i]) + c.segmentCount[i];
+        for(std::size_t s=c.firstSegment[i]; s!=segEnd; ++s)
+            writePathSegment(oss, m_segments.kind[s], &m_segments.args[m_segments.firstArg[s]]);
+
+        writePathEnd(oss, c.closePath[i]!=0);
+    }
+
+
+    std::vector<SvgElementKind>     m_elementKind;
+    std::vector<std::uint32_t>      m_elementIndex;
+
+    RectExColumns                   m_rectEx;
+    RectColumns                     m_rect;
+    LineColumns                     m_line;
+    LineStyledColumns               m_lineStyled;
+    TextColumns                     m_text;
+    PathColumns                     m_path;
+    PathSegmentColumns              m_segments;
+
+    SvgStringPool                   m_strings;
+    bool                            m_pathOpen = false;
+
+}; // class SvgDocument
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/svg_document.h"
+
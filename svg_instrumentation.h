@@ -0,0 +1,475 @@
+/*! \file
+    \brief Инструментирование вывода: число вызовов, байты, экранированные символы и время по примитивам
+
+    Включается макросом MARTY_SVG_INSTRUMENTATION (до подключения marty_svg.h, лучше - в настройках сборки).
+    Без него макросы MARTY_SVG_INSTR_* раскрываются в пустоту, а отчёт всегда пустой.
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include "svg_stream_wrapper.h"
+#include "svg_writer.h"
+//
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#if defined(MARTY_SVG_INSTRUMENTATION)
+    #include <atomic>
+    #include <chrono>
+    #include <ios>
+    #include <mutex>
+    #include <type_traits>
+    #include <vector>
+#endif
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/svg_instrumentation.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+//! Инструментируемые точки вывода
+enum class SvgInstrPoint : std::uint32_t
+{
+    writeSvg,
+    pathStart,
+    pathEnd,
+    drawRectEx,
+    drawRect,
+    drawLine,
+    drawText,
+    escapeText,
+
+    count
+};
+
+constexpr std::size_t svgInstrPointCount = std::size_t(SvgInstrPoint::count);
+
+constexpr
+std::string_view svgInstrPointName(SvgInstrPoint p)
+{
+    constexpr std::string_view names[] = { "writeSvg", "pathStart", "pathEnd", "drawRectEx", "drawRect", "drawLine", "drawText", "escapeText" };
+    return std::uint32_t(p)<std::size(names) ? names[std::uint32_t(p)] : std::string_view("unknown");
+}
+
+//----------------------------------------------------------------------------
+//! Счётчики одной точки
+/*! Время и байты - включительно: drawRectEx содержит и вложенные pathStart/pathEnd, а те учитываются
+    ещё и в своих строках. Для escapeText bytes - размер входного текста.
+ */
+struct SvgInstrStats
+{
+    std::uint64_t calls        = 0;
+    std::uint64_t bytes        = 0;
+    std::uint64_t escapedChars = 0;
+    std::uint64_t nanoseconds  = 0;
+
+    SvgInstrStats& operator+=(const SvgInstrStats &other)
+    {
+        calls        += other.calls;
+        bytes        += other.bytes;
+        escapedChars += other.escapedChars;
+        nanoseconds  += other.nanoseconds;
+        return *this;
+    }
+};
+
+//! Снимок счётчиков всех потоков
+struct SvgInstrReport
+{
+    bool          enabled = false; // false - сборка без MARTY_SVG_INSTRUMENTATION
+    SvgInstrStats points[svgInstrPointCount];
+
+    const SvgInstrStats& operator[](SvgInstrPoint p) const { return points[std::size_t(p)]; }
+    SvgInstrStats&       operator[](SvgInstrPoint p)       { return points[std::size_t(p)]; }
+};
+
+//----------------------------------------------------------------------------
+#if defined(MARTY_SVG_INSTRUMENTATION)
+
+//! Счётчики одного потока; пишет только поток-владелец, поэтому без атомарных RMW - только relaxed load/store
+struct SvgInstrThreadCounters
+{
+    struct Counters
+    {
+        std::atomic<std::uint64_t> calls       {0};
+        std::atomic<std::uint64_t> bytes       {0};
+        std::atomic<std::uint64_t> escapedChars{0};
+        std::atomic<std::uint64_t> nanoseconds {0};
+    };
+
+    Counters points[svgInstrPointCount];
+
+    SvgInstrThreadCounters();
+    ~SvgInstrThreadCounters();
+
+    SvgInstrThreadCounters(const SvgInstrThreadCounters&) = delete;
+    SvgInstrThreadCounters& operator=(const SvgInstrThreadCounters&) = delete;
+
+    static void add(std::atomic<std::uint64_t> &c, std::uint64_t v)
+    {
+        c.store(c.load(std::memory_order_relaxed)+v, std::memory_order_relaxed);
+    }
+
+    void addTo(SvgInstrReport &report) const
+    {
+        for(std::size_t i=0; i!=svgInstrPointCount; ++i)
+        {
+            report.points[i].calls        += points[i].calls       .load(std::memory_order_relaxed);
+            report.points[i].bytes        += points[i].bytes       .load(std::memory_order_relaxed);
+            report.points[i].escapedChars += points[i].escapedChars.load(std::memory_order_relaxed);
+            report.points[i].nanoseconds  += points[i].nanoseconds .load(std::memory_order_relaxed);
+        }
+    }
+
+    void reset()
+    {
+        for(auto &c : points)
+        {
+            c.calls       .store(0, std::memory_order_relaxed);
+            c.bytes       .store(0, std::memory_order_relaxed);
+            c.escapedChars.store(0, std::memory_order_relaxed);
+            c.nanoseconds .store(0, std::memory_order_relaxed);
+        }
+    }
+
+}; // struct SvgInstrThreadCounters
+
+//----------------------------------------------------------------------------
+//! Реестр счётчиков живых потоков и итогов завершившихся; мьютекс берётся только при старте/завершении потока и при снятии отчёта
+class SvgInstrRegistry
+{
+
+public:
+
+    static SvgInstrRegistry& instance()
+    {
+        static SvgInstrRegistry registry;
+        return registry;
+    }
+
+    void attach(SvgInstrThreadCounters *pCounters)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_threads.push_back(pCounters);
+    }
+
+    //! Счётчики завершающегося потока переносятся в общие итоги
+    void detach(SvgInstrThreadCounters *pCounters)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        pCounters->addTo(m_retired);
+        for(auto it=m_threads.begin(); it!=m_threads.end(); ++it)
+        {
+            if (*it==pCounters)
+            {
+                m_threads.erase(it);
+                break;
+            }
+        }
+    }
+
+    SvgInstrReport report()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        SvgInstrReport res = m_retired;
+        res.enabled = true;
+        for(const auto *pCounters : m_threads)
+            pCounters->addTo(res);
+        return res;
+    }
+
+    //! Вызывать, когда вывод не идёт: одновременная запись из другого потока может пережить сброс
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_retired = SvgInstrReport();
+        for(auto *pCounters : m_threads)
+            pCounters->reset();
+    }
+
+
+protected:
+
+    std::mutex                              m_mutex;
+    std::vector<SvgInstrThreadCounters*>    m_threads;
+    SvgInstrReport                          m_retired;
+
+}; // class SvgInstrRegistry
+
+inline
+SvgInstrThreadCounters::SvgInstrThreadCounters()
+{
+    SvgInstrRegistry::instance().attach(this);
+}
+
+inline
+SvgInstrThreadCounters::~SvgInstrThreadCounters()
+{
+    SvgInstrRegistry::instance().detach(this);
+}
+
+inline
+SvgInstrThreadCounters& instrThreadCounters()
+{
+    thread_local SvgInstrThreadCounters counters;
+    return counters;
+}
+
+//----------------------------------------------------------------------------
+//! Сколько байт уже выведено в поток - для подсчёта байт примитива по разнице
+/*! Известны SvgWriter, std::basic_ostream (через tellp) и обёртки SvgStreamWrapper (по вложенному
+    потоку); для прочих потоков - 0, их можно поддержать перегрузкой instrStreamBytes
+    в пространстве имён потока (находится через ADL).
+ */
+template<typename StreamType> inline
+std::uint64_t instrStreamBytes(StreamType &oss)
+{
+    if constexpr (IsSvgStreamWrapper<StreamType>::value)
+    {
+        return instrStreamBytes(oss.stream());
+    }
+    else if constexpr (std::is_base_of<std::ios_base, StreamType>::value)
+    {
+        const auto pos = oss.tellp();
+        return pos<0 ? 0u : std::uint64_t(pos);
+    }
+    else
+    {
+        (void)oss;
+        return 0;
+    }
+}
+
+inline
+std::uint64_t instrStreamBytes(SvgWriter &oss)
+{
+    return oss.totalSize();
+}
+
+//----------------------------------------------------------------------------
+//! RAII-замер одного вызова: время и приращение размера потока
+template<typename StreamType>
+class SvgInstrScope
+{
+
+public:
+
+    SvgInstrScope(SvgInstrPoint point, StreamType &oss)
+    : m_oss(oss)
+    , m_point(point)
+    , m_startBytes(instrStreamBytes(oss))
+    , m_startTime(std::chrono::steady_clock::now())
+    {}
+
+    ~SvgInstrScope()
+    {
+        const auto endTime = std::chrono::steady_clock::now();
+        const std::uint64_t endBytes = instrStreamBytes(m_oss);
+
+        auto &c = instrThreadCounters().points[std::size_t(m_point)];
+        SvgInstrThreadCounters::add(c.calls, 1);
+        SvgInstrThreadCounters::add(c.bytes, endBytes>m_startBytes ? endBytes-m_startBytes : 0u);
+        SvgInstrThreadCounters::add(c.nanoseconds, std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(endTime-m_startTime).count()));
+    }
+
+    SvgInstrScope(const SvgInstrScope&) = delete;
+    SvgInstrScope& operator=(const SvgInstrScope&) = delete;
+
+
+protected:
+
+    StreamType                              &m_oss;
+    SvgInstrPoint                           m_point;
+    std::uint64_t                           m_startBytes;
+    std::chrono::steady_clock::time_point   m_startTime;
+
+}; // class SvgInstrScope
+
+//! Замер экранирования: вход - size байт, экранированные символы добавляются по ходу
+/*! Замер ставится во все открытые функции экранирования. Если одна из них вызывает другую,
+    замер учитывает только внешний вызов, а экранированные символы вложенного
+    вызова добавляются во внешний.
+ */
+class SvgInstrEscapeScope
+{
+
+public:
+
+    explicit SvgInstrEscapeScope(std::size_t size)
+    : m_size(size)
+    , m_outer(activeScope())
+    , m_startTime(m_outer ? std::chrono::steady_clock::time_point() : std::chrono::steady_clock::now())
+    {
+        if (!m_outer)
+            activeScope() = this;
+    }
+
+    ~SvgInstrEscapeScope()
+    {
+        if (m_outer)
+            return;
+
+        activeScope() = nullptr;
+
+        const auto endTime = std::chrono::steady_clock::now();
+
+        auto &c = instrThreadCounters().points[std::size_t(SvgInstrPoint::escapeText)];
+        SvgInstrThreadCounters::add(c.calls, 1);
+        SvgInstrThreadCounters::add(c.bytes, m_size);
+        SvgInstrThreadCounters::add(c.escapedChars, m_escaped);
+        SvgInstrThreadCounters::add(c.nanoseconds, std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(endTime-m_startTime).count()));
+    }
+
+    SvgInstrEscapeScope(const SvgInstrEscapeScope&) = delete;
+    SvgInstrEscapeScope& operator=(const SvgInstrEscapeScope&) = delete;
+
+    void addEscaped() { ++(m_outer ? m_outer : this)->m_escaped; }
+
+
+protected:
+
+    //! Внешний замер текущего потока
+    static SvgInstrEscapeScope*& activeScope()
+    {
+        thread_local SvgInstrEscapeScope *scope = nullptr;
+        return scope;
+    }
+
+    std::size_t                             m_size;
+    std::uint64_t                           m_escaped = 0;
+    SvgInstrEscapeScope                    *m_outer;
+    std::chrono::steady_clock::time_point   m_startTime;
+
+}; // class SvgInstrEscapeScope
+
+//----------------------------------------------------------------------------
+//! Итоги всех потоков - завершившихся и ещё работающих (значения работающих - на момент чтения)
+inline
+SvgInstrReport instrumentationReport()
+{
+    return SvgInstrRegistry::instance().report();
+}
+
+inline
+void resetInstrumentation()
+{
+    SvgInstrRegistry::instance().reset();
+}
+
+    #define MARTY_SVG_INSTR_SCOPE(point, oss)   ::marty::svg::SvgInstrScope<typename std::remove_reference<decltype(oss)>::type> martySvgInstrScope_(::marty::svg::SvgInstrPoint::point, oss)
+    #define MARTY_SVG_INSTR_ESCAPE_SCOPE(size)  ::marty::svg::SvgInstrEscapeScope martySvgInstrEscapeScope_(size)
+    #define MARTY_SVG_INSTR_ESCAPED()           martySvgInstrEscapeScope_.addEscaped()
+
+#else // !MARTY_SVG_INSTRUMENTATION
+
+inline
+SvgInstrReport instrumentationReport()
+{
+    return SvgInstrReport();
+}
+
+inline
+void resetInstrumentation()
+{
+}
+
+    #define MARTY_SVG_INSTR_SCOPE(point, oss)
+    #define MARTY_SVG_INSTR_ESCAPE_SCOPE(size)
+    #define MARTY_SVG_INSTR_ESCAPED()
+
+#endif // MARTY_SVG_INSTRUMENTATION
+
+//----------------------------------------------------------------------------
+//! Отчёт текстовой таблицей: point, calls, bytes, bytes/call, escaped, ns, ns/call
+template<typename StreamType>
+void writeInstrumentationReport(StreamType &oss, const SvgInstrReport &report)
+{
+    auto writeField = [&](std::string_view str, std::size_t width, bool bRight)
+    {
+        if (bRight)
+            for(std::size_t i=str.size(); i<width; ++i) oss << ' ';
+        oss << str;
+        if (!bRight)
+            for(std::size_t i=str.size(); i<width; ++i) oss << ' ';
+    };
+
+    auto writeNumber = [&](std::uint64_t v, std::size_t width)
+    {
+        char buf[24];
+        const auto res = std::to_chars(&buf[0], &buf[0]+sizeof(buf), v);
+        writeField(std::string_view(&buf[0], std::size_t(res.ptr-&buf[0])), width, true);
+    };
+
+    if (!report.enabled)
+    {
+        oss << "instrumentation disabled (build with MARTY_SVG_INSTRUMENTATION)\n";
+        return;
+    }
+
+    writeField("point"     , 12, false);
+    writeField("calls"     , 14, true );
+    writeField("bytes"     , 16, true );
+    writeField("bytes/call", 12, true );
+    writeField("escaped"   , 14, true );
+    writeField("ns"        , 16, true );
+    writeField("ns/call"   , 10, true );
+    oss << "\n";
+
+    for(std::size_t i=0; i!=svgInstrPointCount; ++i)
+    {
+        const SvgInstrStats &s = report.points[i];
+        writeField(svgInstrPointName(SvgInstrPoint(i)), 12, false);
+        writeNumber(s.calls                                  , 14);
+        writeNumber(s.bytes                                  , 16);
+        writeNumber(s.calls ? s.bytes/s.calls : 0u           , 12);
+        writeNumber(s.escapedChars                           , 14);
+        writeNumber(s.nanoseconds                            , 16);
+        writeNumber(s.calls ? s.nanoseconds/s.calls : 0u     , 10);
+        oss << "\n";
+    }
+}
+
+//----------------------------------------------------------------------------
+//! Отчёт одним JSON-объектом: {"enabled":true,"points":{"drawRectEx":{"calls":...,...},...}}
+template<typename StreamType>
+void writeInstrumentationReportJson(StreamType &oss, const SvgInstrReport &report)
+{
+    auto writeNumber = [&](std::uint64_t v)
+    {
+        char buf[24];
+        const auto res = std::to_chars(&buf[0], &buf[0]+sizeof(buf), v);
+        oss << std::string_view(&buf[0], std::size_t(res.ptr-&buf[0]));
+    };
+
+    oss << "{\"enabled\":" << (report.enabled ? "true" : "false") << ",\"points\":{";
+    for(std::size_t i=0; i!=svgInstrPointCount; ++i)
+    {
+        const SvgInstrStats &s = report.points[i];
+        if (i)
+            oss << ",";
+        oss << "\"" << svgInstrPointName(SvgInstrPoint(i)) << "\":{\"calls\":"; writeNumber(s.calls);
+        oss << ",\"bytes\":";                                                   writeNumber(s.bytes);
+        oss << ",\"escapedChars\":";                                            writeNumber(s.escapedChars);
+        oss << ",\"nanoseconds\":";                                             writeNumber(s.nanoseconds);
+        oss << "}";
+    }
+    oss << "}}\n";
+}
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/svg_instrumentation.h"
+
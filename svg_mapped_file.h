@@ -0,0 +1,209 @@
+/*! \file
+    \brief Файл, отображённый в память только для чтения (mmap / MapViewOfFile) - для разбора больших SVG без копирования
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(_WIN32)
+    #if !defined(NOMINMAX)
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/svg_mapped_file.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+//! Файл, целиком отображённый в память только для чтения
+/*! Страницы подгружаются системой по мере обращения, с подсказкой о последовательном чтении -
+    файл любого размера (в пределах адресного пространства) читается без копирования в кучу.
+    Пустой файл открывается успешно, его view() - пустая строка.
+
+    Ошибки открытия - std::runtime_error.
+ */
+class SvgMappedFile
+{
+
+public:
+
+    SvgMappedFile() = default;
+
+    explicit SvgMappedFile(const std::string &fileName)
+    {
+        open(fileName);
+    }
+
+    ~SvgMappedFile()
+    {
+        close();
+    }
+
+    SvgMappedFile(const SvgMappedFile&) = delete;
+    SvgMappedFile& operator=(const SvgMappedFile&) = delete;
+
+    SvgMappedFile(SvgMappedFile &&other) noexcept
+    : m_pData (std::exchange(other.m_pData , nullptr))
+    , m_size  (std::exchange(other.m_size  , 0))
+    , m_bOpen (std::exchange(other.m_bOpen , false))
+    {}
+
+    SvgMappedFile& operator=(SvgMappedFile &&other) noexcept
+    {
+        if (this!=&other)
+        {
+            close();
+            m_pData = std::exchange(other.m_pData, nullptr);
+            m_size  = std::exchange(other.m_size , 0);
+            m_bOpen = std::exchange(other.m_bOpen, false);
+        }
+        return *this;
+    }
+
+    //! Отображает файл; ранее открытый закрывается
+    void open(const std::string &fileName)
+    {
+        close();
+
+#if defined(_WIN32)
+
+        HANDLE hFile = CreateFileA( fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr
+                                  , OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr
+                                  );
+        if (hFile==INVALID_HANDLE_VALUE)
+            throw std::runtime_error("marty::svg::SvgMappedFile: failed to open file: " + fileName);
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(hFile, &fileSize))
+        {
+            CloseHandle(hFile);
+            throw std::runtime_error("marty::svg::SvgMappedFile: failed to get file size: " + fileName);
+        }
+
+        if (std::uint64_t(fileSize.QuadPart)>std::uint64_t((std::numeric_limits<std::size_t>::max)()))
+        {
+            CloseHandle(hFile);
+            throw std::runtime_error("marty::svg::SvgMappedFile: file is too large to map: " + fileName);
+        }
+
+        m_size = std::size_t(fileSize.QuadPart);
+        if (m_size)
+        {
+            // Отображение держит файл само, описатели можно закрыть сразу
+            HANDLE hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            CloseHandle(hFile);
+            if (!hMapping)
+                throw std::runtime_error("marty::svg::SvgMappedFile: CreateFileMapping failed: " + fileName);
+
+            m_pData = static_cast<const char*>(MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0));
+            CloseHandle(hMapping);
+            if (!m_pData)
+                throw std::runtime_error("marty::svg::SvgMappedFile: MapViewOfFile failed: " + fileName);
+        }
+        else
+        {
+            CloseHandle(hFile);
+        }
+
+#else
+
+        const int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd<0)
+            throw std::runtime_error("marty::svg::SvgMappedFile: failed to open file: " + fileName);
+
+        struct stat st;
+        if (::fstat(fd, &st)!=0)
+        {
+            ::close(fd);
+            throw std::runtime_error("marty::svg::SvgMappedFile: failed to get file size: " + fileName);
+        }
+
+        if (std::uint64_t(st.st_size)>std::uint64_t(std::numeric_limits<std::size_t>::max()))
+        {
+            ::close(fd);
+            throw std::runtime_error("marty::svg::SvgMappedFile: file is too large to map: " + fileName);
+        }
+
+        m_size = std::size_t(st.st_size);
+        if (m_size)
+        {
+            void *p = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd); // Отображение остаётся действительным
+            if (p==MAP_FAILED)
+            {
+                m_size = 0;
+                throw std::runtime_error("marty::svg::SvgMappedFile: mmap failed: " + fileName);
+            }
+
+            ::posix_madvise(p, m_size, POSIX_MADV_SEQUENTIAL);
+            m_pData = static_cast<const char*>(p);
+        }
+        else
+        {
+            ::close(fd);
+        }
+
+#endif
+
+        m_bOpen = true;
+    }
+
+    void close()
+    {
+        if (m_pData)
+        {
+#if defined(_WIN32)
+            UnmapViewOfFile(m_pData);
+#else
+            ::munmap(const_cast<char*>(m_pData), m_size);
+#endif
+        }
+
+        m_pData = nullptr;
+        m_size  = 0;
+        m_bOpen = false;
+    }
+
+    bool             isOpen() const { return m_bOpen; }
+    const char*      data()   const { return m_pData; }
+    std::size_t      size()   const { return m_size;  }
+    std::string_view view()   const { return m_pData ? std::string_view(m_pData, m_size) : std::string_view(); }
+
+
+protected:
+
+    const char      *m_pData = nullptr;
+    std::size_t     m_size   = 0;
+    bool            m_bOpen  = false;
+
+}; // class SvgMappedFile
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/svg_mapped_file.h"
+
@@ -0,0 +1,773 @@
+/*! \file
+    \brief Потоковый (pull) разбор SVG без копирования - для повторного чтения вывода библиотеки, и разбор данных пути (атрибут d)
+
+    Разбирается подмножество XML, которое выводят хелперы: элементы, атрибуты в кавычках, текст,
+    CDATA; комментарии, объявления (<!DOCTYPE ...>) и инструкции (<?xml ...?>) пропускаются.
+    Все строки - string_view во входные данные (например, SvgMappedFile::view()), сущности
+    не раскрываются - для этого есть unescapeXmlText.
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/svg_pull_parser.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+enum class SvgXmlEvent : std::uint8_t
+{
+    none        ,
+    startElement, //!< Открывающий тег; для <x/> следом приходит endElement
+    endElement  ,
+    text        , //!< Текст или содержимое CDATA
+    end         , //!< Данные разобраны
+    error
+};
+
+//----------------------------------------------------------------------------
+//! Атрибут элемента
+struct SvgXmlAttribute
+{
+    std::string_view    name;
+    std::string_view    value; //!< Как в исходных данных, без раскрытия сущностей
+};
+
+//----------------------------------------------------------------------------
+//! Дописывает в out текст XML с раскрытыми сущностями: пять стандартных и числовые (&#NN; &#xHH;)
+/*! Нераспознанные сущности переносятся как есть. */
+inline
+void unescapeXmlText(std::string_view str, std::string &out)
+{
+    std::size_t pos = 0;
+    while(pos<str.size())
+    {
+        const std::size_t amp = str.find('&', pos);
+        if (amp==str.npos)
+            break;
+
+        out.append(str.data()+pos, amp-pos);
+        pos = amp;
+
+        const std::size_t semi = str.find(';', amp+1);
+        if (semi==str.npos || semi-amp>12)
+        {
+            out.push_back('&');
+            ++pos;
+            continue;
+        }
+
+        const std::string_view entity = str.substr(amp+1, semi-amp-1);
+        std::uint32_t cp = 0;
+        bool bOk = true;
+
+        if      (entity=="amp" ) cp = '&';
+        else if (entity=="lt"  ) cp = '<';
+        else if (entity=="gt"  ) cp = '>';
+        else if (entity=="apos") cp = '\'';
+        else if (entity=="quot") cp = '\"';
+        else if (entity.size()>1 && entity[0]=='#')
+        {
+            const bool bHex = entity[1]=='x' || entity[1]=='X';
+            const std::string_view digits = entity.substr(bHex ? 2 : 1);
+            bOk = !digits.empty();
+            for(char ch : digits)
+            {
+                int d = -1;
+                if (ch>='0' && ch<='9')                 d = ch-'0';
+                else if (bHex && ch>='a' && ch<='f')    d = ch-'a'+10;
+                else if (bHex && ch>='A' && ch<='F')    d = ch-'A'+10;
+                if (d<0 || cp>0x10FFFFu)
+                {
+                    bOk = false;
+                    break;
+                }
+                cp = cp*(bHex ? 16u : 10u) + std::uint32_t(d);
+            }
+            bOk = bOk && cp<=0x10FFFFu;
+        }
+        else
+        {
+            bOk = false;
+        }
+
+        if (!bOk)
+        {
+            out.push_back('&');
+            ++pos;
+            continue;
+        }
+
+        // UTF-8
+        if (cp<0x80u)
+        {
+            out.push_back(char(cp));
+        }
+        else if (cp<0x800u)
+        {
+            out.push_back(char(0xC0u | (cp>>6)));
+            out.push_back(char(0x80u | (cp&0x3Fu)));
+        }
+        else if (cp<0x10000u)
+        {
+            out.push_back(char(0xE0u | (cp>>12)));
+            out.push_back(char(0x80u | ((cp>>6)&0x3Fu)));
+            out.push_back(char(0x80u | (cp&0x3Fu)));
+        }
+        else
+        {
+            out.push_back(char(0xF0u | (cp>>18)));
+            out.push_back(char(0x80u | ((cp>>12)&0x3Fu)));
+            out.push_back(char(0x80u | ((cp>>6)&0x3Fu)));
+            out.push_back(char(0x80u | (cp&0x3Fu)));
+        }
+
+        pos = semi+1;
+    }
+
+    out.append(str.data()+pos, str.size()-pos);
+}
+
+//----------------------------------------------------------------------------
+//! Потоковый разбор документа
+/*! \code
+    marty::svg::SvgMappedFile file("diagram.svg");
+    marty::svg::SvgPullParser parser(file.view());
+    for(auto ev=parser.next(); ev!=marty::svg::SvgXmlEvent::end; ev=parser.next())
+    {
+        if (ev==marty::svg::SvgXmlEvent::error)
+            throw std::runtime_error(parser.errorMessage());
+        if (ev==marty::svg::SvgXmlEvent::startElement && parser.name()=="path")
+            handlePath(parser.attribute("d"));
+    }
+    \endcode
+
+    Текст ищется через memchr, атрибуты разбираются за один проход по тегу и складываются в
+    вектор, который переиспользуется - после первых элементов разбор идёт без аллокаций.
+    Текст только из пробельных символов по умолчанию пропускается (setSkipWhitespace).
+ */
+class SvgPullParser
+{
+
+public:
+
+    explicit SvgPullParser(std::string_view data)
+    : m_data(data)
+    {}
+
+    //! Пропускать текст, состоящий только из пробельных символов (по умолчанию - да)
+    void setSkipWhitespace(bool bSkip) { m_skipWhitespace = bSkip; }
+
+    //! Следующее событие; после end и error возвращает их же
+    SvgXmlEvent next()
+    {
+        if (m_event==SvgXmlEvent::end || m_event==SvgXmlEvent::error)
+            return m_event;
+
+        if (m_pendingEnd)
+        {
+            m_pendingEnd = false;
+            m_event      = SvgXmlEvent::endElement;
+            m_name       = m_openElements.back();
+            m_openElements.pop_back();
+            m_attributes.clear();
+            return m_event;
+        }
+
+        for(;;)
+        {
+            if (m_pos>=m_data.size())
+            {
+                if (!m_openElements.empty())
+                    return setError("unexpected end of data: unclosed element", m_pos);
+                return m_event = SvgXmlEvent::end;
+            }
+
+            if (m_data[m_pos]!='<')
+            {
+                const char *pBegin = m_data.data()+m_pos;
+                const void *pLt    = std::memchr(pBegin, '<', m_data.size()-m_pos);
+                const std::size_t textEnd = pLt ? std::size_t(static_cast<const char*>(pLt)-m_data.data()) : m_data.size();
+
+                const std::string_view text = m_data.substr(m_pos, textEnd-m_pos);
+                m_pos = textEnd;
+                if (m_skipWhitespace && isWhitespaceOnly(text))
+                    continue;
+
+                m_text  = text;
+                m_cdata = false;
+                return m_event = SvgXmlEvent::text;
+            }
+
+            const char ch1 = m_pos+1<m_data.size() ? m_data[m_pos+1] : '\0';
+
+            if (ch1=='/')
+                return parseEndTag();
+
+            if (ch1=='!')
+            {
+                const std::string_view rest = m_data.substr(m_pos);
+
+                if (startsWith(rest, "<!--"))
+                {
+                    if (!skipPast("-->", m_pos+4))
+                        return setError("unterminated comment", m_pos);
+                    continue;
+                }
+
+                if (startsWith(rest, "<![CDATA["))
+                {
+                    const std::size_t begin  = m_pos+9;
+                    const std::size_t endPos = m_data.find("]]>", begin);
+                    if (endPos==m_data.npos)
+                        return setError("unterminated CDATA section", m_pos);
+
+                    m_text  = m_data.substr(begin, endPos-begin);
+                    m_cdata = true;
+                    m_pos   = endPos+3;
+                    return m_event = SvgXmlEvent::text;
+                }
+
+                if (!skipDeclaration())
+                    return setError("unterminated declaration", m_pos);
+                continue;
+            }
+
+            if (ch1=='?')
+            {
+                if (!skipPast("?>", m_pos+2))
+                    return setError("unterminated processing instruction", m_pos);
+                continue;
+            }
+
+            return parseStartTag();
+        }
+    }
+
+    SvgXmlEvent event() const { return m_event; }
+
+    //! Имя элемента для startElement/endElement
+    std::string_view name() const { return m_name; }
+
+    //! Текст для text - как в исходных данных; isCData() - из секции CDATA
+    std::string_view text()    const { return m_text;  }
+    bool             isCData() const { return m_cdata; }
+
+    //! Для startElement: элемент записан как <x/>, следующим событием будет его endElement
+    bool isEmptyElement() const { return m_pendingEnd; }
+
+    //! Число открытых элементов; для startElement включает его самого
+    std::size_t depth() const { return m_openElements.size(); }
+
+    //------------------------------
+    // Атрибуты текущего startElement
+
+    std::size_t                             attributeCount() const { return m_attributes.size(); }
+    const SvgXmlAttribute&                  attributeAt(std::size_t idx) const { return m_attributes[idx]; }
+    const std::vector<SvgXmlAttribute>&     attributes() const { return m_attributes; }
+
+    //! Значение атрибута; пустое, если атрибута нет (см. hasAttribute)
+    std::string_view attribute(std::string_view attrName) const
+    {
+        for(const auto &a : m_attributes)
+        {
+            if (a.name==attrName)
+                return a.value;
+        }
+        return std::string_view();
+    }
+
+    bool hasAttribute(std::string_view attrName) const
+    {
+        for(const auto &a : m_attributes)
+        {
+            if (a.name==attrName)
+                return true;
+        }
+        return false;
+    }
+
+    //------------------------------
+    //! Смещение во входных данных: после события - позиция за ним, после ошибки - место ошибки
+    std::size_t position() const { return m_pos; }
+
+    const char* errorMessage() const { return m_errorMessage; }
+
+
+protected:
+
+    enum CharClassFlags : std::uint8_t
+    {
+        ccSpace   = 0x01,
+        ccNameEnd = 0x02  // Пробельные, '/', '>', '=' - конец имени элемента или атрибута
+    };
+
+    struct CharClassTable
+    {
+        std::uint8_t flags[256] = {};
+
+        constexpr CharClassTable()
+        {
+            flags[std::uint8_t(' ' )] = ccSpace | ccNameEnd;
+            flags[std::uint8_t('\n')] = ccSpace | ccNameEnd;
+            flags[std::uint8_t('\r')] = ccSpace | ccNameEnd;
+            flags[std::uint8_t('\t')] = ccSpace | ccNameEnd;
+            flags[std::uint8_t('/' )] = ccNameEnd;
+            flags[std::uint8_t('>' )] = ccNameEnd;
+            flags[std::uint8_t('=' )] = ccNameEnd;
+        }
+    };
+
+    static std::uint8_t charClass(char ch)
+    {
+        static constexpr CharClassTable table;
+        return table.flags[std::uint8_t(ch)];
+    }
+
+    static bool isSpace(char ch)
+    {
+        return (charClass(ch) & ccSpace)!=0;
+    }
+
+    static bool isWhitespaceOnly(std::string_view str)
+    {
+        for(char ch : str)
+        {
+            if (!isSpace(ch))
+                return false;
+        }
+        return true;
+    }
+
+    static bool startsWith(std::string_view str, std::string_view prefix)
+    {
+        return str.size()>=prefix.size() && std::memcmp(str.data(), prefix.data(), prefix.size())==0;
+    }
+
+    SvgXmlEvent setError(const char *msg, std::size_t pos)
+    {
+        m_errorMessage = msg;
+        m_pos          = pos;
+        return m_event = SvgXmlEvent::error;
+    }
+
+    bool skipPast(std::string_view terminator, std::size_t from)
+    {
+        const std::size_t p = m_data.find(terminator, from);
+        if (p==m_data.npos)
+            return false;
+        m_pos = p+terminator.size();
+        return true;
+    }
+
+    //! <!DOCTYPE ...> - с возможным внутренним подмножеством [...]
+    bool skipDeclaration()
+    {
+        const std::size_t gt = m_data.find('>', m_pos+2);
+        if (gt==m_data.npos)
+            return false;
+
+        const std::size_t bracket = m_data.find('[', m_pos+2);
+        if (bracket!=m_data.npos && bracket<gt)
+            return skipPast("]>", bracket+1) || skipPast(">", bracket+1);
+
+        m_pos = gt+1;
+        return true;
+    }
+
+    void skipSpaces(std::size_t &pos) const
+    {
+        while(pos<m_data.size() && isSpace(m_data[pos]))
+            ++pos;
+    }
+
+    std::string_view scanName(std::size_t &pos) const
+    {
+        const std::size_t begin = pos;
+        while(pos<m_data.size() && !(charClass(m_data[pos]) & ccNameEnd))
+            ++pos;
+        return m_data.substr(begin, pos-begin);
+    }
+
+    SvgXmlEvent parseStartTag()
+    {
+        std::size_t pos = m_pos+1;
+        const std::string_view elementName = scanName(pos);
+        if (elementName.empty())
+            return setError("element name expected", pos);
+
+        m_attributes.clear();
+        bool bEmpty = false;
+
+        for(;;)
+        {
+            skipSpaces(pos);
+            if (pos>=m_data.size())
+                return setError("unterminated start tag", m_pos);
+
+            const char ch = m_data[pos];
+            if (ch=='>')
+            {
+                ++pos;
+                break;
+            }
+
+            if (ch=='/')
+            {
+                if (pos+1<m_data.size() && m_data[pos+1]=='>')
+                {
+                    pos += 2;
+                    bEmpty = true;
+                    break;
+                }
+                return setError("'>' expected after '/'", pos);
+            }
+
+            const std::string_view attrName = scanName(pos);
+            if (attrName.empty())
+                return setError("attribute name expected", pos);
+
+            skipSpaces(pos);
+            if (pos>=m_data.size() || m_data[pos]!='=')
+                return setError("'=' expected after attribute name", pos);
+            ++pos;
+            skipSpaces(pos);
+
+            if (pos>=m_data.size() || (m_data[pos]!='\"' && m_data[pos]!='\''))
+                return setError("quoted attribute value expected", pos);
+
+            const char  quote  = m_data[pos++];
+            const void *pQuote = std::memchr(m_data.data()+pos, quote, m_data.size()-pos);
+            if (!pQuote)
+                return setError("unterminated attribute value", pos);
+
+            const std::size_t valueEnd = std::size_t(static_cast<const char*>(pQuote)-m_data.data());
+            m_attributes.emplace_back(SvgXmlAttribute{ attrName, m_data.substr(pos, valueEnd-pos) });
+            pos = valueEnd+1;
+        }
+
+        m_name       = elementName;
+        m_pendingEnd = bEmpty;
+        m_pos        = pos;
+        m_openElements.emplace_back(elementName);
+        return m_event = SvgXmlEvent::startElement;
+    }
+
+    SvgXmlEvent parseEndTag()
+    {
+        std::size_t pos = m_pos+2;
+        const std::string_view elementName = scanName(pos);
+        skipSpaces(pos);
+        if (pos>=m_data.size() || m_data[pos]!='>')
+            return setError("'>' expected in end tag", pos);
+
+        if (m_openElements.empty() || m_openElements.back()!=elementName)
+            return setError("end tag does not match start tag", m_pos);
+
+        m_openElements.pop_back();
+        m_attributes.clear();
+        m_name  = elementName;
+        m_pos   = pos+1;
+        return m_event = SvgXmlEvent::endElement;
+    }
+
+
+    std::string_view                m_data;
+    std::size_t                     m_pos            = 0;
+    SvgXmlEvent                     m_event          = SvgXmlEvent::none;
+    std::string_view                m_name;
+    std::string_view                m_text;
+    bool                            m_cdata          = false;
+    bool                            m_pendingEnd     = false;
+    bool                            m_skipWhitespace = true;
+    std::vector<SvgXmlAttribute>    m_attributes;
+    std::vector<std::string_view>   m_openElements;
+    const char                      *m_errorMessage  = "";
+
+}; // class SvgPullParser
+
+//----------------------------------------------------------------------------
+//! Команда пути; набор - тот, что выводят pathStart/pathLineTo/.../pathEnd
+enum class SvgPathCommand : std::uint8_t
+{
+    moveTo         , //!< m/M: x y
+    lineTo         , //!< l/L: x y
+    horzLineTo     , //!< h/H: x
+    vertLineTo     , //!< v/V: y
+    quadraticBezier, //!< q/Q: cpX cpY endX endY
+    closePath        //!< z/Z
+};
+
+//----------------------------------------------------------------------------
+//! Сегмент пути, как записан в d: координаты относительные или абсолютные, по bAbs
+struct SvgPathDataSegment
+{
+    SvgPathCommand  command = SvgPathCommand::moveTo;
+    bool            bAbs    = false;
+    double          args[4] = {};
+
+    std::size_t argCount() const
+    {
+        switch(command)
+        {
+            case SvgPathCommand::moveTo         : return 2;
+            case SvgPathCommand::lineTo         : return 2;
+            case SvgPathCommand::horzLineTo     : return 1;
+            case SvgPathCommand::vertLineTo     : return 1;
+            case SvgPathCommand::quadraticBezier: return 4;
+            case SvgPathCommand::closePath      :
+            default                             : return 0;
+        }
+    }
+};
+
+//----------------------------------------------------------------------------
+//! Разбирает число SVG ([+-]цифры[.цифры][e[+-]цифры]) с позиции p; при успехе p - за числом
+/*! Целые (а их хелперы и выводят) разбираются без плавающей арифметики в цикле; дробные точны,
+    пока мантисса не длиннее 15 цифр и порядок не больше 22 по модулю.
+ */
+inline
+bool parseSvgNumber(const char *&p, const char *pEnd, double &v)
+{
+    static constexpr double pow10[] = { 1e0 , 1e1 , 1e2 , 1e3 , 1e4 , 1e5 , 1e6 , 1e7 , 1e8 , 1e9 , 1e10, 1e11
+                                      , 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+                                      };
+
+    const char *s = p;
+    bool bNeg = false;
+    if (s!=pEnd && (*s=='-' || *s=='+'))
+    {
+        bNeg = *s=='-';
+        ++s;
+    }
+
+    // Быстрый путь - целое до 9 цифр
+    {
+        const char    *d  = s;
+        std::uint32_t iv  = 0;
+        for(; d!=pEnd && unsigned(*d-'0')<10u && d-s<9; ++d)
+            iv = iv*10u + std::uint32_t(*d-'0');
+
+        if (d!=s && (d==pEnd || (*d!='.' && *d!='e' && *d!='E' && unsigned(*d-'0')>=10u)))
+        {
+            v = bNeg ? -double(iv) : double(iv);
+            p = d;
+            return true;
+        }
+    }
+
+    std::uint64_t mantissa  = 0;
+    int           exp10     = 0;
+    int           numDigits = 0;
+
+    for(; s!=pEnd && unsigned(*s-'0')<10u; ++s, ++numDigits)
+    {
+        if (mantissa<100000000000000000ull)
+            mantissa = mantissa*10u + std::uint64_t(*s-'0');
+        else
+            ++exp10; // Лишние цифры целой части только сдвигают порядок
+    }
+
+    if (s!=pEnd && *s=='.')
+    {
+        ++s;
+        for(; s!=pEnd && unsigned(*s-'0')<10u; ++s, ++numDigits)
+        {
+            if (mantissa<100000000000000000ull)
+            {
+                mantissa = mantissa*10u + std::uint64_t(*s-'0');
+                --exp10;
+            }
+        }
+    }
+
+    if (!numDigits)
+        return false;
+
+    if (s!=pEnd && (*s=='e' || *s=='E'))
+    {
+        const char *e = s+1;
+        bool bExpNeg = false;
+        if (e!=pEnd && (*e=='-' || *e=='+'))
+        {
+            bExpNeg = *e=='-';
+            ++e;
+        }
+
+        if (e!=pEnd && unsigned(*e-'0')<10u)
+        {
+            int expVal = 0;
+            for(; e!=pEnd && unsigned(*e-'0')<10u; ++e)
+            {
+                if (expVal<10000)
+                    expVal = expVal*10 + (*e-'0');
+            }
+            exp10 += bExpNeg ? -expVal : expVal;
+            s = e;
+        }
+        // Иначе 'e' - не часть числа
+    }
+
+    double d = double(mantissa);
+    if (exp10)
+    {
+        int e = exp10<0 ? -exp10 : exp10;
+        double scale = 1.0;
+        while(e>22)
+        {
+            scale *= 1e22;
+            e     -= 22;
+        }
+        scale *= pow10[e];
+        d = exp10<0 ? d/scale : d*scale;
+    }
+
+    v = bNeg ? -d : d;
+    p = s;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+//! Потоковый разбор атрибута d
+/*! Понимает то, что выводят хелперы и SvgPathEncoder: команды m/l/h/v/q/z в обоих регистрах,
+    повтор аргументов без повтора команды (после m/M повторы - l/L), числа без разделителей
+    там, где их разделяет знак или вторая точка. Другие команды (c, s, t, a) - ошибка.
+
+    \code
+    marty::svg::SvgPathDataParser pdp(parser.attribute("d"));
+    marty::svg::SvgPathDataSegment seg;
+    while(pdp.next(seg))
+        ...
+    if (pdp.hasError())
+        ...
+    \endcode
+ */
+class SvgPathDataParser
+{
+
+public:
+
+    explicit SvgPathDataParser(std::string_view d)
+    : m_p(d.data())
+    , m_pBegin(d.data())
+    , m_pEnd(d.data()+d.size())
+    {}
+
+    //! Следующий сегмент; false - данные кончились или ошибка (см. hasError)
+    bool next(SvgPathDataSegment &seg)
+    {
+        if (m_bError)
+            return false;
+
+        skipSeparators();
+        if (m_p==m_pEnd)
+            return false;
+
+        const char ch = *m_p;
+        if ((ch>='a' && ch<='z') || (ch>='A' && ch<='Z'))
+        {
+            if (!setCommand(ch))
+                return false;
+            ++m_p;
+
+            if (m_command==SvgPathCommand::closePath)
+            {
+                seg.command = SvgPathCommand::closePath;
+                seg.bAbs    = m_bAbs;
+                m_bHaveCommand = false; // После z нужна явная команда
+                return true;
+            }
+        }
+        else if (!m_bHaveCommand)
+        {
+            return setError();
+        }
+
+        seg.command = m_command;
+        seg.bAbs    = m_bAbs;
+
+        const std::size_t n = seg.argCount();
+        for(std::size_t i=0; i!=n; ++i)
+        {
+            skipSeparators();
+            if (!parseSvgNumber(m_p, m_pEnd, seg.args[i]))
+                return setError();
+        }
+
+        // Повтор аргументов после moveto - это lineto
+        if (m_command==SvgPathCommand::moveTo)
+            m_command = SvgPathCommand::lineTo;
+
+        return true;
+    }
+
+    bool        hasError() const { return m_bError; }
+
+    //! Смещение в d: после ошибки - место ошибки
+    std::size_t position() const { return std::size_t(m_p-m_pBegin); }
+
+
+protected:
+
+    void skipSeparators()
+    {
+        while(m_p!=m_pEnd && (*m_p==' ' || *m_p==',' || *m_p=='\n' || *m_p=='\r' || *m_p=='\t'))
+            ++m_p;
+    }
+
+    bool setCommand(char ch)
+    {
+        m_bAbs = ch>='A' && ch<='Z';
+        switch(ch)
+        {
+            case 'm': case 'M': m_command = SvgPathCommand::moveTo;          break;
+            case 'l': case 'L': m_command = SvgPathCommand::lineTo;          break;
+            case 'h': case 'H': m_command = SvgPathCommand::horzLineTo;      break;
+            case 'v': case 'V': m_command = SvgPathCommand::vertLineTo;      break;
+            case 'q': case 'Q': m_command = SvgPathCommand::quadraticBezier; break;
+            case 'z': case 'Z': m_command = SvgPathCommand::closePath;       break;
+            default: return setError();
+        }
+        m_bHaveCommand = true;
+        return true;
+    }
+
+    bool setError()
+    {
+        m_bError = true;
+        return false;
+    }
+
+
+    const char      *m_p;
+    const char      *m_pBegin;
+    const char      *m_pEnd;
+    SvgPathCommand  m_command      = SvgPathCommand::moveTo;
+    bool            m_bAbs         = false;
+    bool            m_bHaveCommand = false;
+    bool            m_bError       = false;
+
+}; // class SvgPathDataParser
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/svg_pull_parser.h"
+
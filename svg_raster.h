@@ -0,0 +1,1171 @@
+/*! \file
+    \brief Встроенный растеризатор для превью: сглаженная заливка и обводка примитивов библиотеки, вывод в PNG
+
+    Поддерживается ровно то, что выводят хелперы: прямоугольники (в т.ч. со скруглениями rx/ry),
+    линии и пути из сегментов m/l/h/v/q, заливка и обводка сплошным цветом. Текст не рисуется.
+
+    PNG пишется без сжатия (stored-блоки deflate); с MARTY_SVG_USE_ZLIB - сжимается zlib
+    с уровнем MARTY_SVG_PNG_DEFAULT_LEVEL (по умолчанию 1 - быстрое сжатие).
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include "marty_svg.h"
+#include "svg_checksum.h"
+#include "svg_document.h"
+#include "svg_simd.h"
+//
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(MARTY_SVG_USE_ZLIB)
+    #include <zlib.h>
+#endif
+
+//----------------------------------------------------------------------------
+//! Уровень сжатия PNG по умолчанию, 0-9; без MARTY_SVG_USE_ZLIB игнорируется
+#if !defined(MARTY_SVG_PNG_DEFAULT_LEVEL)
+    #define MARTY_SVG_PNG_DEFAULT_LEVEL 1
+#endif
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/svg_raster.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+//! Цвет RGBA, без предумножения на альфу; a==0 - нет цвета (none)
+struct SvgRasterColor
+{
+    std::uint8_t r = 0;
+    std::uint8_t g = 0;
+    std::uint8_t b = 0;
+    std::uint8_t a = 0;
+
+    bool isNone() const { return a==0; }
+};
+
+//----------------------------------------------------------------------------
+//! Цвет SVG: #rgb, #rrggbb, базовые именованные цвета, none; false - формат не распознан
+inline
+bool parseSvgColor(std::string_view str, SvgRasterColor &color)
+{
+    while(!str.empty() && (str.front()==' ' || str.front()=='\t'))
+        str.remove_prefix(1);
+    while(!str.empty() && (str.back()==' ' || str.back()=='\t'))
+        str.remove_suffix(1);
+
+    auto lowerEq = [](std::string_view s, std::string_view lowerName)
+    {
+        if (s.size()!=lowerName.size())
+            return false;
+        for(std::size_t i=0; i!=s.size(); ++i)
+        {
+            const char ch = (s[i]>='A' && s[i]<='Z') ? char(s[i]-'A'+'a') : s[i];
+            if (ch!=lowerName[i])
+                return false;
+        }
+        return true;
+    };
+
+    if (str.empty() || lowerEq(str, "none") || lowerEq(str, "transparent"))
+    {
+        color = SvgRasterColor();
+        return true;
+    }
+
+    if (str[0]=='#')
+    {
+        auto hexVal = [](char ch) -> int
+        {
+            if (ch>='0' && ch<='9') return ch-'0';
+            if (ch>='a' && ch<='f') return ch-'a'+10;
+            if (ch>='A' && ch<='F') return ch-'A'+10;
+            return -1;
+        };
+
+        str.remove_prefix(1);
+        int v[6] = {};
+        if (str.size()!=3 && str.size()!=6)
+            return false;
+        for(std::size_t i=0; i!=str.size(); ++i)
+        {
+            v[i] = hexVal(str[i]);
+            if (v[i]<0)
+                return false;
+        }
+
+        if (str.size()==3)
+            color = SvgRasterColor{ std::uint8_t(v[0]*17), std::uint8_t(v[1]*17), std::uint8_t(v[2]*17), 255 };
+        else
+            color = SvgRasterColor{ std::uint8_t(v[0]*16+v[1]), std::uint8_t(v[2]*16+v[3]), std::uint8_t(v[4]*16+v[5]), 255 };
+        return true;
+    }
+
+    struct NamedColor
+    {
+        std::string_view    name;
+        std::uint8_t        r, g, b;
+    };
+
+    static constexpr NamedColor namedColors[] =
+    { { "black"  ,   0,   0,   0 }, { "white"  , 255, 255, 255 }, { "red"    , 255,   0,   0 }
+    , { "green"  ,   0, 128,   0 }, { "blue"   ,   0,   0, 255 }, { "yellow" , 255, 255,   0 }
+    , { "cyan"   ,   0, 255, 255 }, { "aqua"   ,   0, 255, 255 }, { "magenta", 255,   0, 255 }
+    , { "fuchsia", 255,   0, 255 }, { "gray"   , 128, 128, 128 }, { "grey"   , 128, 128, 128 }
+    , { "silver" , 192, 192, 192 }, { "maroon" , 128,   0,   0 }, { "olive"  , 128, 128,   0 }
+    , { "lime"   ,   0, 255,   0 }, { "navy"   ,   0,   0, 128 }, { "purple" , 128,   0, 128 }
+    , { "teal"   ,   0, 128, 128 }, { "orange" , 255, 165,   0 }
+    };
+
+    for(const auto &nc : namedColors)
+    {
+        if (lowerEq(str, nc.name))
+        {
+            color = SvgRasterColor{ nc.r, nc.g, nc.b, 255 };
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//----------------------------------------------------------------------------
+//! Стиль отрисовки элемента
+struct SvgRasterPaint
+{
+    SvgRasterColor  fill;                                   // Нет заливки, если a==0
+    SvgRasterColor  stroke      = SvgRasterColor{ 0, 0, 0, 255 };
+    double          strokeWidth = 1.0;
+    LineJoin        linejoin    = LineJoin::miter;
+};
+
+//----------------------------------------------------------------------------
+//! Изображение RGBA8, цвета хранятся предумноженными на альфу
+class SvgRasterImage
+{
+
+public:
+
+    SvgRasterImage() = default;
+
+    SvgRasterImage(int width, int height, SvgRasterColor background=SvgRasterColor())
+    {
+        reset(width, height, background);
+    }
+
+    void reset(int width, int height, SvgRasterColor background=SvgRasterColor())
+    {
+        m_width  = std::max(width , 0);
+        m_height = std::max(height, 0);
+
+        const std::uint8_t px[4] = { premultiply(background.r, background.a), premultiply(background.g, background.a)
+                                   , premultiply(background.b, background.a), background.a
+                                   };
+        m_pixels.resize(std::size_t(m_width)*std::size_t(m_height)*4u);
+        for(std::size_t i=0; i<m_pixels.size(); i+=4)
+            std::memcpy(&m_pixels[i], px, 4);
+    }
+
+    int         width()  const { return m_width;  }
+    int         height() const { return m_height; }
+    bool        empty()  const { return m_pixels.empty(); }
+    std::size_t stride() const { return std::size_t(m_width)*4u; }
+
+    std::uint8_t*       row(int y)       { return m_pixels.data() + std::size_t(y)*stride(); }
+    const std::uint8_t* row(int y) const { return m_pixels.data() + std::size_t(y)*stride(); }
+
+    //! Цвет пикселя без предумножения
+    SvgRasterColor pixel(int x, int y) const
+    {
+        const std::uint8_t *p = row(y) + 4*x;
+        return SvgRasterColor{ unpremultiply(p[0], p[3]), unpremultiply(p[1], p[3]), unpremultiply(p[2], p[3]), p[3] };
+    }
+
+    //! x*y/255 с округлением, для x, y из 0..255
+    static std::uint8_t mulDiv255(unsigned x, unsigned y)
+    {
+        const unsigned t = x*y + 128u;
+        return std::uint8_t((t + (t>>8))>>8);
+    }
+
+    static std::uint8_t premultiply(std::uint8_t c, std::uint8_t a)
+    {
+        return mulDiv255(c, a);
+    }
+
+    static std::uint8_t unpremultiply(std::uint8_t c, std::uint8_t a)
+    {
+        if (a==255) return c;
+        if (a==0)   return 0;
+        return std::uint8_t(std::min(255u, (unsigned(c)*255u + a/2u)/a));
+    }
+
+
+protected:
+
+    int                         m_width  = 0;
+    int                         m_height = 0;
+    std::vector<std::uint8_t>   m_pixels;
+
+}; // class SvgRasterImage
+
+//----------------------------------------------------------------------------
+//! Сглаживающий растеризатор со сканированием строк
+/*! Контур строится вызовами, повторяющими хелперы путей (в координатах viewBox), кривые
+    разбиваются на отрезки. Отрезки накапливают в буфере ячеек знаковую площадь покрытия
+    (как в font-rs); префиксная сумма по строке даёт покрытие пикселя. Правило заливки - nonzero
+    для непересекающихся контуров, которые и выводят хелперы.
+
+    Обводка строится полигонами: прямоугольник на каждый отрезок и заплатка на каждый стык
+    (miter с пределом 4, как в SVG по умолчанию, bevel или круг для round); концы линий - butt.
+    Покрытия частей обводки складываются с ограничением единицей, поэтому края на стыках могут
+    быть чуть плотнее, чем у точного контура - для превью это незаметно.
+
+    Наложение пикселей строки идёт по 4 за шаг (SSE2), полностью покрытые и непокрытые
+    четвёрки пропускают смешивание.
+ */
+class SvgRasterizer
+{
+
+public:
+
+    explicit SvgRasterizer(SvgRasterImage &image)
+    : m_image(image)
+    {}
+
+    SvgRasterizer(const SvgRasterizer&) = delete;
+    SvgRasterizer& operator=(const SvgRasterizer&) = delete;
+
+    SvgRasterImage&       image()       { return m_image; }
+    const SvgRasterImage& image() const { return m_image; }
+
+    //------------------------------
+    //! Пиксель = координата*scale + offset
+    void setTransform(double scale, double offsetX, double offsetY)
+    {
+        m_scale   = scale;
+        m_offsetX = offsetX;
+        m_offsetY = offsetY;
+    }
+
+    //! Вписывает viewBox в изображение с сохранением пропорций, по центру (как preserveAspectRatio="xMidYMid meet")
+    void setViewBox(double posX, double posY, double sizeX, double sizeY)
+    {
+        if (sizeX<=0 || sizeY<=0)
+            return;
+
+        const double scale = std::min(double(m_image.width())/sizeX, double(m_image.height())/sizeY);
+        setTransform( scale
+                    , (double(m_image.width()) -sizeX*scale)/2 - posX*scale
+                    , (double(m_image.height())-sizeY*scale)/2 - posY*scale
+                    );
+    }
+
+    double scale() const { return m_scale; }
+
+    //------------------------------
+    //! Начало контура; первый moveto пути всегда абсолютный
+    void pathStart(double posX, double posY)
+    {
+        finishContour(false);
+        m_contours.emplace_back(Contour{ std::uint32_t(m_points.size()), 0, false });
+        m_curX = posX;
+        m_curY = posY;
+        addPoint(posX, posY);
+    }
+
+    void pathLineTo(double posX, double posY, bool bAbs)
+    {
+        if (!bAbs)
+        {
+            posX += m_curX;
+            posY += m_curY;
+        }
+        m_curX = posX;
+        m_curY = posY;
+        addPoint(posX, posY);
+    }
+
+    void pathHorzLineTo(double posX, bool bAbs)
+    {
+        pathLineTo(bAbs ? posX : m_curX+posX, m_curY, true);
+    }
+
+    void pathVertLineTo(double posY, bool bAbs)
+    {
+        pathLineTo(m_curX, bAbs ? posY : m_curY+posY, true);
+    }
+
+    void pathQuadraticBezier(double cpX, double cpY, double endX, double endY, bool bAbs)
+    {
+        if (!bAbs)
+        {
+            cpX  += m_curX; cpY  += m_curY;
+            endX += m_curX; endY += m_curY;
+        }
+
+        if (!m_contourOpen)
+        {
+            pathLineTo(endX, endY, true);
+            return;
+        }
+
+        const Point p0 = m_points.back();
+        const Point p1 = toPixel(cpX, cpY);
+        const Point p2 = toPixel(endX, endY);
+
+        // Погрешность отрезка не больше dd/(8*n*n) пикселя; берём не больше 0.2
+        const float ddX = p0.x - 2*p1.x + p2.x;
+        const float ddY = p0.y - 2*p1.y + p2.y;
+        const float dd  = std::sqrt(ddX*ddX + ddY*ddY);
+        const int   n   = std::max(1, std::min(64, int(std::ceil(std::sqrt(dd*0.625f)))));
+
+        for(int k=1; k<n; ++k)
+        {
+            const float t = float(k)/float(n);
+            const float u = 1.0f-t;
+            addPixelPoint(Point{ u*u*p0.x + 2*u*t*p1.x + t*t*p2.x, u*u*p0.y + 2*u*t*p1.y + t*t*p2.y });
+        }
+
+        m_curX = endX;
+        m_curY = endY;
+        addPixelPoint(p2);
+    }
+
+    void pathEnd(bool closePath)
+    {
+        finishContour(closePath);
+    }
+
+    //! Прямоугольник; r>0 - скруглённые дугами углы (как rx/ry у <rect>)
+    void addRect(double posX, double posY, double sizeX, double sizeY, double r=0)
+    {
+        r = std::max(0.0, std::min({ r, sizeX/2, sizeY/2 }));
+        if (r<=0)
+        {
+            pathStart(posX, posY);
+            pathLineTo(posX+sizeX, posY      , true);
+            pathLineTo(posX+sizeX, posY+sizeY, true);
+            pathLineTo(posX      , posY+sizeY, true);
+            pathEnd(true);
+            return;
+        }
+
+        constexpr double halfPi = 1.5707963267948966;
+        const int steps = std::max(2, std::min(32, int(std::ceil(std::sqrt(r*m_scale)*1.5))));
+
+        // Центры дуг и начальные углы, по часовой стрелке (ось Y вниз) от верхнего левого угла
+        const double cx[4] = { posX+r, posX+sizeX-r, posX+sizeX-r, posX+r       };
+        const double cy[4] = { posY+r, posY+r      , posY+sizeY-r, posY+sizeY-r };
+
+        pathStart(posX, posY+r);
+        for(int corner=0; corner!=4; ++corner)
+        {
+            const double a0 = halfPi*double(corner+2);
+            for(int k=0; k<=steps; ++k)
+            {
+                const double a = a0 + halfPi*double(k)/double(steps);
+                pathLineTo(cx[corner] + r*std::cos(a), cy[corner] + r*std::sin(a), true);
+            }
+        }
+        pathEnd(true);
+    }
+
+    //! Отрезок - открытый контур, только для обводки
+    void addLine(double startX, double startY, double endX, double endY)
+    {
+        pathStart(startX, startY);
+        pathLineTo(endX, endY, true);
+        pathEnd(false);
+    }
+
+    void clearPath()
+    {
+        m_points.clear();
+        m_contours.clear();
+        m_contourOpen = false;
+    }
+
+    bool pathEmpty() const { return m_contours.empty(); }
+
+    //------------------------------
+    void fillPath(SvgRasterColor color)
+    {
+        finishContour(false);
+        if (color.isNone())
+            return;
+        rasterize(m_points, m_contours, color);
+    }
+
+    void strokePath(SvgRasterColor color, double strokeWidth, LineJoin linejoin=LineJoin::miter)
+    {
+        finishContour(false);
+
+        const float halfWidth = float(strokeWidth*m_scale/2);
+        if (color.isNone() || !(halfWidth>0))
+            return;
+
+        buildStroke(halfWidth, linejoin);
+        rasterize(m_strokePoints, m_strokeContours, color);
+    }
+
+    //! Заливка, потом обводка текущего контура, как в SVG
+    void drawPath(const SvgRasterPaint &paint)
+    {
+        fillPath(paint.fill);
+        strokePath(paint.stroke, paint.strokeWidth, paint.linejoin);
+    }
+
+
+protected:
+
+    struct Point
+    {
+        float x, y;
+    };
+
+    struct Contour
+    {
+        std::uint32_t   first;
+        std::uint32_t   count;
+        bool            closed;
+    };
+
+    Point toPixel(double x, double y) const
+    {
+        return Point{ float(x*m_scale + m_offsetX), float(y*m_scale + m_offsetY) };
+    }
+
+    void addPoint(double x, double y)
+    {
+        addPixelPoint(toPixel(x, y));
+    }
+
+    void addPixelPoint(Point p)
+    {
+        if (m_contours.empty())
+            return;
+
+        Contour &c = m_contours.back();
+        if (c.count && m_points.back().x==p.x && m_points.back().y==p.y)
+            return;
+
+        m_points.emplace_back(p);
+        ++c.count;
+        m_contourOpen = true;
+    }
+
+    void finishContour(bool closePath)
+    {
+        if (!m_contourOpen)
+            return;
+
+        m_contourOpen = false;
+
+        Contour &c = m_contours.back();
+        c.closed = closePath;
+
+        // Замыкающая точка, совпавшая с начальной, не нужна
+        const Point &first = m_points[c.first];
+        if (c.count>1 && m_points.back().x==first.x && m_points.back().y==first.y)
+        {
+            m_points.pop_back();
+            --c.count;
+        }
+    }
+
+    //------------------------------
+    //! Полигон обводки; все полигоны обводки ориентируются одинаково, чтобы покрытия складывались
+    void addStrokePolygon(const Point *p, std::size_t n)
+    {
+        float area = 0;
+        for(std::size_t i=0, j=n-1; i!=n; j=i++)
+            area += p[j].x*p[i].y - p[i].x*p[j].y;
+
+        m_strokeContours.emplace_back(Contour{ std::uint32_t(m_strokePoints.size()), std::uint32_t(n), true });
+        if (area<=0)
+            m_strokePoints.insert(m_strokePoints.end(), p, p+n);
+        else
+            m_strokePoints.insert(m_strokePoints.end(), std::reverse_iterator<const Point*>(p+n), std::reverse_iterator<const Point*>(p));
+    }
+
+    void addStrokeJoin(Point prev, Point pt, Point next, float halfWidth, LineJoin linejoin)
+    {
+        float d0x = pt.x-prev.x, d0y = pt.y-prev.y;
+        float d1x = next.x-pt.x, d1y = next.y-pt.y;
+        const float len0 = std::sqrt(d0x*d0x + d0y*d0y);
+        const float len1 = std::sqrt(d1x*d1x + d1y*d1y);
+        if (len0<=0 || len1<=0)
+            return;
+        d0x /= len0; d0y /= len0;
+        d1x /= len1; d1y /= len1;
+
+        const float cross = d0x*d1y - d0y*d1x;
+        const float dot   = d0x*d1x + d0y*d1y;
+        if (std::fabs(cross)<1e-6f && dot>0)
+            return; // Отрезки на одной прямой
+
+        if (linejoin==LineJoin::round)
+        {
+            const int n = std::max(8, std::min(64, int(std::ceil(halfWidth*2))+6));
+            Point circle[64];
+            for(int k=0; k!=n; ++k)
+            {
+                const float a = 6.2831853f*float(k)/float(n);
+                circle[k] = Point{ pt.x + halfWidth*std::cos(a), pt.y + halfWidth*std::sin(a) };
+            }
+            addStrokePolygon(circle, std::size_t(n));
+            return;
+        }
+
+        // Внешняя сторона стыка - противоположная повороту
+        const float s   = cross>0 ? -halfWidth : halfWidth;
+        const Point o0  = { pt.x - d0y*s, pt.y + d0x*s };
+        const Point o1  = { pt.x - d1y*s, pt.y + d1x*s };
+
+        const bool  bMiter = linejoin!=LineJoin::bevel && 1+dot>1e-6f;
+        if (bMiter)
+        {
+            // Вектор до острия: (n0+n1)/(1+cos), его длина/halfWidth - отношение miter в SVG
+            const float mx = (-d0y-d1y)/(1+dot);
+            const float my = ( d0x+d1x)/(1+dot);
+            if (mx*mx + my*my <= 16.0f) // stroke-miterlimit=4
+            {
+                const Point poly[4] = { pt, o0, Point{ pt.x + mx*s, pt.y + my*s }, o1 };
+                addStrokePolygon(poly, 4);
+                return;
+            }
+        }
+
+        const Point poly[3] = { pt, o0, o1 };
+        addStrokePolygon(poly, 3);
+    }
+
+    void buildStroke(float halfWidth, LineJoin linejoin)
+    {
+        m_strokePoints.clear();
+        m_strokeContours.clear();
+
+        for(const Contour &c : m_contours)
+        {
+            if (c.count<2)
+                continue;
+
+            const Point      *p      = &m_points[c.first];
+            const std::size_t n      = c.count;
+            const bool        closed = c.closed && n>2;
+
+            const std::size_t segCount = closed ? n : n-1;
+            for(std::size_t i=0; i!=segCount; ++i)
+            {
+                const Point a = p[i];
+                const Point b = p[(i+1)%n];
+                const float dx = b.x-a.x, dy = b.y-a.y;
+                const float len = std::sqrt(dx*dx + dy*dy);
+                if (len<=0)
+                    continue;
+                const float nx = -dy/len*halfWidth, ny = dx/len*halfWidth;
+                const Point quad[4] = { Point{ a.x+nx, a.y+ny }, Point{ b.x+nx, b.y+ny }, Point{ b.x-nx, b.y-ny }, Point{ a.x-nx, a.y-ny } };
+                addStrokePolygon(quad, 4);
+            }
+
+            const std::size_t firstJoin = closed ? 0 : 1;
+            const std::size_t endJoin   = closed ? n : n-1;
+            for(std::size_t i=firstJoin; i<endJoin; ++i)
+                addStrokeJoin(p[(i+n-1)%n], p[i], p[(i+1)%n], halfWidth, linejoin);
+        }
+    }
+
+    //------------------------------
+    void rasterize(const std::vector<Point> &points, const std::vector<Contour> &contours, SvgRasterColor color)
+    {
+        if (points.empty() || m_image.empty())
+            return;
+
+        float minX = points[0].x, maxX = minX, minY = points[0].y, maxY = minY;
+        for(const Point &p : points)
+        {
+            minX = std::min(minX, p.x); maxX = std::max(maxX, p.x);
+            minY = std::min(minY, p.y); maxY = std::max(maxY, p.y);
+        }
+
+        // Пределы сравниваются во float - NaN и огромные координаты не дают переполнения int
+        const int ix0 = int(std::max(0.0f, std::min(std::floor(minX), float(m_image.width()))));
+        const int iy0 = int(std::max(0.0f, std::min(std::floor(minY), float(m_image.height()))));
+        const int ix1 = int(std::max(0.0f, std::min(std::ceil (maxX), float(m_image.width()))));
+        const int iy1 = int(std::max(0.0f, std::min(std::ceil (maxY), float(m_image.height()))));
+        if (ix0>=ix1 || iy0>=iy1)
+            return;
+
+        m_cellsW      = ix1-ix0;
+        m_cellsH      = iy1-iy0;
+        m_cellsStride = std::size_t(m_cellsW)+2u;
+        const std::size_t cellsSize = m_cellsStride*std::size_t(m_cellsH);
+        if (m_cells.size()<cellsSize)
+            m_cells.resize(cellsSize, 0.0f); // Между вызовами буфер всегда нулевой
+
+        for(const Contour &c : contours)
+        {
+            if (c.count<2)
+                continue;
+
+            const Point *p = &points[c.first];
+            for(std::size_t i=0, j=c.count-1; i!=c.count; j=i++)
+                accumulateLine(p[j].x-float(ix0), p[j].y-float(iy0), p[i].x-float(ix0), p[i].y-float(iy0));
+        }
+
+        for(int y=0; y!=m_cellsH; ++y)
+            blendRow(&m_cells[std::size_t(y)*m_cellsStride], m_image.row(iy0+y) + 4*std::size_t(ix0), color);
+    }
+
+    //! Отрезок в координатах буфера ячеек; по X прижимается к [0, ширина]
+    void accumulateLine(float x0, float y0, float x1, float y1)
+    {
+        if (!(y0!=y1))
+            return;
+
+        float dir = 1.0f;
+        if (y0>y1)
+        {
+            std::swap(x0, x1);
+            std::swap(y0, y1);
+            dir = -1.0f;
+        }
+
+        const float cellsH = float(m_cellsH);
+        if (y1<=0 || y0>=cellsH)
+            return;
+
+        const float dxdy = (x1-x0)/(y1-y0);
+        float x = x0;
+        if (y0<0)
+        {
+            x -= y0*dxdy;
+            y0 = 0;
+        }
+
+        const float maxX   = float(m_cellsW);
+        const int   yStart = int(y0);
+        const int   yEnd   = int(std::min(cellsH, std::ceil(y1)));
+
+        for(int y=yStart; y<yEnd; ++y)
+        {
+            float *row = &m_cells[std::size_t(y)*m_cellsStride];
+
+            const float dy    = std::min(float(y+1), y1) - std::max(float(y), y0);
+            const float xNext = x + dxdy*dy;
+            const float d     = dy*dir;
+
+            const float xa = std::max(0.0f, std::min(std::min(x, xNext), maxX));
+            const float xb = std::max(0.0f, std::min(std::max(x, xNext), maxX));
+
+            const float xaFloor = std::floor(xa);
+            const int   xai     = int(xaFloor);
+            const float xbCeil  = std::ceil(xb);
+            const int   xbi     = int(xbCeil);
+
+            if (xbi<=xai+1)
+            {
+                // Отрезок в пределах одной ячейки: площадь делится по средней точке
+                const float xmf = 0.5f*(xa+xb) - xaFloor;
+                row[xai  ] += d - d*xmf;
+                row[xai+1] += d*xmf;
+            }
+            else
+            {
+                const float s   = 1.0f/(xb-xa);
+                const float xaf = xa-xaFloor;
+                const float a0  = 0.5f*s*(1.0f-xaf)*(1.0f-xaf);
+                const float xbf = xb-xbCeil+1.0f;
+                const float am  = 0.5f*s*xbf*xbf;
+
+                row[xai] += d*a0;
+                if (xbi==xai+2)
+                {
+                    row[xai+1] += d*(1.0f-a0-am);
+                }
+                else
+                {
+                    const float a1 = s*(1.5f-xaf);
+                    row[xai+1] += d*(a1-a0);
+                    for(int xi=xai+2; xi<xbi-1; ++xi)
+                        row[xi] += d*s;
+                    const float a2 = a1 + float(xbi-xai-3)*s;
+                    row[xbi-1] += d*(1.0f-a2-am);
+                }
+                row[xbi] += d*am;
+            }
+
+            x = xNext;
+        }
+    }
+
+    //! Префиксная сумма ячеек строки - покрытие; наложение цвета на пиксели, обнуление ячеек
+    void blendRow(float *cells, std::uint8_t *pixels, SvgRasterColor color)
+    {
+        const int   w       = m_cellsW;
+        const float alphaF  = float(color.a);
+        int         x       = 0;
+        float       acc     = 0.0f;
+
+#if defined(MARTY_SVG_IMPL_USE_SSE2)
+        {
+            const __m128  absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+            const __m128  one     = _mm_set1_ps(1.0f);
+            const __m128  half    = _mm_set1_ps(0.5f);
+            const __m128  alpha   = _mm_set1_ps(alphaF);
+            const __m128i zero    = _mm_setzero_si128();
+            const __m128i full    = _mm_set1_epi32(255);
+            const __m128i v128    = _mm_set1_epi16(128);
+            const __m128i v255    = _mm_set1_epi16(255);
+            const __m128i src16   = _mm_set_epi16(255, color.b, color.g, color.r, 255, color.b, color.g, color.r);
+            const __m128i srcPx   = _mm_set1_epi32(int(std::uint32_t(color.r) | std::uint32_t(color.g)<<8 | std::uint32_t(color.b)<<16 | 0xFF000000u));
+
+            __m128 carry = _mm_setzero_ps();
+
+            for(; x+4<=w; x+=4)
+            {
+                __m128 v = _mm_loadu_ps(cells+x);
+                _mm_storeu_ps(cells+x, _mm_setzero_ps());
+
+                v = _mm_add_ps(v, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 4)));
+                v = _mm_add_ps(v, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 8)));
+                v = _mm_add_ps(v, carry);
+                carry = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+
+                const __m128 cov = _mm_min_ps(_mm_and_ps(v, absMask), one);
+                __m128i a = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(cov, alpha), half));
+
+                if (_mm_movemask_epi8(_mm_cmpeq_epi32(a, zero))==0xFFFF)
+                    continue;
+
+                __m128i *p = reinterpret_cast<__m128i*>(pixels + 4*x);
+                if (_mm_movemask_epi8(_mm_cmpeq_epi32(a, full))==0xFFFF)
+                {
+                    _mm_storeu_si128(p, srcPx);
+                    continue;
+                }
+
+                // Альфа каждого пикселя - во все четыре его байта
+                a = _mm_or_si128(a, _mm_slli_epi32(a, 8));
+                a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+
+                const __m128i dst = _mm_loadu_si128(p);
+                const __m128i aLo = _mm_unpacklo_epi8(a, zero);
+                const __m128i aHi = _mm_unpackhi_epi8(a, zero);
+
+                __m128i lo = _mm_add_epi16(_mm_mullo_epi16(src16, aLo), _mm_mullo_epi16(_mm_unpacklo_epi8(dst, zero), _mm_sub_epi16(v255, aLo)));
+                __m128i hi = _mm_add_epi16(_mm_mullo_epi16(src16, aHi), _mm_mullo_epi16(_mm_unpackhi_epi8(dst, zero), _mm_sub_epi16(v255, aHi)));
+
+                // Деление на 255 с округлением: (t + (t>>8))>>8, t = x+128
+                lo = _mm_add_epi16(lo, v128);
+                hi = _mm_add_epi16(hi, v128);
+                lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+                hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+                _mm_storeu_si128(p, _mm_packus_epi16(lo, hi));
+            }
+
+            acc = _mm_cvtss_f32(carry);
+        }
+#endif
+
+        for(; x<w; ++x)
+        {
+            acc += cells[x];
+            cells[x] = 0.0f;
+
+            const unsigned a = unsigned(std::min(std::fabs(acc), 1.0f)*alphaF + 0.5f);
+            if (!a)
+                continue;
+
+            auto blend = [a](unsigned src, unsigned dst)
+            {
+                const unsigned t = src*a + dst*(255u-a) + 128u;
+                return std::uint8_t((t + (t>>8))>>8);
+            };
+
+            std::uint8_t *p = pixels + 4*x;
+            p[0] = blend(color.r, p[0]);
+            p[1] = blend(color.g, p[1]);
+            p[2] = blend(color.b, p[2]);
+            p[3] = blend(255u   , p[3]);
+        }
+
+        cells[w]   = 0.0f;
+        cells[w+1] = 0.0f;
+    }
+
+
+    SvgRasterImage          &m_image;
+
+    double                  m_scale   = 1.0;
+    double                  m_offsetX = 0.0;
+    double                  m_offsetY = 0.0;
+
+    std::vector<Point>      m_points;           // В пикселях
+    std::vector<Contour>    m_contours;
+    bool                    m_contourOpen = false;
+    double                  m_curX = 0.0;       // Текущая точка, в координатах viewBox
+    double                  m_curY = 0.0;
+
+    std::vector<Point>      m_strokePoints;
+    std::vector<Contour>    m_strokeContours;
+
+    std::vector<float>      m_cells;
+    std::size_t             m_cellsStride = 0;
+    int                     m_cellsW      = 0;
+    int                     m_cellsH      = 0;
+
+}; // class SvgRasterizer
+
+//----------------------------------------------------------------------------
+//! Поток для хелперов, передающий в растеризатор только геометрию (через хуки габаритов); текст отбрасывается
+/*! \code
+    marty::svg::SvgRasterPathStream rs(rasterizer);
+    marty::svg::drawRectEx(rs, 10, 10, 120, 40, 8, 2, "black");
+    rasterizer.drawPath(paint);
+    rasterizer.clearPath();
+    \endcode
+ */
+class SvgRasterPathStream
+{
+
+public:
+
+    explicit SvgRasterPathStream(SvgRasterizer &rasterizer)
+    : m_rasterizer(rasterizer)
+    {}
+
+    template<typename T>
+    SvgRasterPathStream& operator<<(const T &)
+    {
+        return *this;
+    }
+
+    SvgRasterizer& rasterizer() { return m_rasterizer; }
+
+
+protected:
+
+    SvgRasterizer   &m_rasterizer;
+
+}; // class SvgRasterPathStream
+
+//----------------------------------------------------------------------------
+// Хуки габаритов для SvgRasterPathStream
+
+template<typename CoordType> inline
+void boundsPathStart(SvgRasterPathStream &oss, CoordType posX, CoordType posY, bool /* bAbs */, int /* strokeWidth */, std::string_view /* linejoin */)
+{
+    oss.rasterizer().pathStart(coordToDouble(posX), coordToDouble(posY));
+}
+
+template<typename CoordType> inline
+void boundsPathLineTo(SvgRasterPathStream &oss, CoordType posX, CoordType posY, bool bAbs)
+{
+    oss.rasterizer().pathLineTo(coordToDouble(posX), coordToDouble(posY), bAbs);
+}
+
+template<typename CoordType> inline
+void boundsPathHorzLineTo(SvgRasterPathStream &oss, CoordType posX, bool bAbs)
+{
+    oss.rasterizer().pathHorzLineTo(coordToDouble(posX), bAbs);
+}
+
+template<typename CoordType> inline
+void boundsPathVertLineTo(SvgRasterPathStream &oss, CoordType posY, bool bAbs)
+{
+    oss.rasterizer().pathVertLineTo(coordToDouble(posY), bAbs);
+}
+
+template<typename CoordType> inline
+void boundsPathQuadraticBezier(SvgRasterPathStream &oss, CoordType cpX, CoordType cpY, CoordType endX, CoordType endY, bool bAbs)
+{
+    oss.rasterizer().pathQuadraticBezier(coordToDouble(cpX), coordToDouble(cpY), coordToDouble(endX), coordToDouble(endY), bAbs);
+}
+
+inline
+void boundsPathEnd(SvgRasterPathStream &oss, bool closePath)
+{
+    oss.rasterizer().pathEnd(closePath);
+}
+
+template<typename CoordType> inline
+void boundsRect(SvgRasterPathStream &oss, CoordType posX, CoordType posY, CoordType sizeX, CoordType sizeY, CoordType r, int /* strokeWidth */)
+{
+    oss.rasterizer().addRect(coordToDouble(posX), coordToDouble(posY), coordToDouble(sizeX), coordToDouble(sizeY), coordToDouble(r));
+}
+
+template<typename CoordType> inline
+void boundsLine(SvgRasterPathStream &oss, CoordType startX, CoordType startY, CoordType endX, CoordType endY, int /* strokeWidth */)
+{
+    oss.rasterizer().addLine(coordToDouble(startX), coordToDouble(startY), coordToDouble(endX), coordToDouble(endY));
+}
+
+//----------------------------------------------------------------------------
+//! Параметры растеризации документа
+struct SvgRasterOptions
+{
+    SvgRasterColor  background = SvgRasterColor{ 255, 255, 255, 255 };
+
+    //! Стиль элементов, оформленных классом - CSS растеризатору недоступен
+    SvgRasterPaint  classPaint;
+
+    //! Если задан - стиль по имени класса, вместо classPaint
+    std::function<SvgRasterPaint(std::string_view /* itemClass */)> resolveClass;
+};
+
+//----------------------------------------------------------------------------
+//! Растеризует элементы документа в порядке добавления; преобразование координат задаётся в rasterizer заранее
+inline
+void rasterizeDocument(SvgRasterizer &rasterizer, const SvgDocument &doc, const SvgRasterOptions &opts=SvgRasterOptions())
+{
+    auto colorOf = [](std::string_view str)
+    {
+        SvgRasterColor color;
+        if (!parseSvgColor(str, color))
+            color = SvgRasterColor{ 0, 0, 0, 255 }; // Нераспознанный цвет - чёрный, элемент всё же виден
+        return color;
+    };
+
+    auto linejoinOf = [](std::string_view str)
+    {
+        if (str=="round") return LineJoin::round;
+        if (str=="bevel") return LineJoin::bevel;
+        return LineJoin::miter;
+    };
+
+    auto classPaint = [&](SvgStringId itemClass)
+    {
+        return opts.resolveClass ? opts.resolveClass(doc.getString(itemClass)) : opts.classPaint;
+    };
+
+    SvgRasterPathStream rs(rasterizer);
+
+    for(std::size_t idx=0; idx!=doc.size(); ++idx)
+    {
+        const std::size_t i = doc.elementIndex(idx);
+        SvgRasterPaint paint;
+
+        switch(doc.elementKind(idx))
+        {
+            case SvgElementKind::rectEx:
+            {
+                const auto &c = doc.rectExColumns();
+                paint.fill        = colorOf(doc.getString(c.fillColor[i]));
+                paint.stroke      = colorOf(doc.getString(c.strokeColor[i]));
+                paint.strokeWidth = c.strokeWidth[i];
+                doc.serializeElement(rs, idx);
+                break;
+            }
+
+            case SvgElementKind::rect:
+            {
+                const auto &c = doc.rectColumns();
+                paint = classPaint(c.itemClass[i]);
+                doc.serializeElement(rs, idx);
+                break;
+            }
+
+            case SvgElementKind::line:
+            {
+                paint = classPaint(doc.lineColumns().lineClass[i]);
+                paint.fill = SvgRasterColor();
+                doc.serializeElement(rs, idx);
+                break;
+            }
+
+            case SvgElementKind::lineStyled:
+            {
+                const auto &c = doc.lineStyledColumns();
+                paint.stroke      = colorOf(doc.getString(c.strokeColor[i]));
+                paint.strokeWidth = c.strokeWidth[i];
+                paint.linejoin    = linejoinOf(doc.getString(c.linejoin[i]));
+                doc.serializeElement(rs, idx);
+                break;
+            }
+
+            case SvgElementKind::path:
+            {
+                const auto &c = doc.pathColumns();
+                if (c.styled[i])
+                {
+                    paint.fill        = colorOf(doc.getString(c.fillColor[i]));
+                    paint.stroke      = colorOf(doc.getString(c.strokeColor[i]));
+                    paint.strokeWidth = c.strokeWidth[i];
+                    paint.linejoin    = linejoinOf(doc.getString(c.linejoin[i]));
+                }
+                else
+                {
+                    paint = classPaint(c.pathClass[i]);
+                }
+                doc.serializeElement(rs, idx);
+                break;
+            }
+
+            case SvgElementKind::text:
+            default:
+                continue;
+        }
+
+        rasterizer.drawPath(paint);
+        rasterizer.clearPath();
+    }
+}
+
+//! Превью документа: viewBox вписывается в изображение width x height
+inline
+SvgRasterImage rasterizeDocument( const SvgDocument &doc
+                                , int viewPosX , int viewPosY
+                                , int viewSizeX, int viewSizeY
+                                , int width    , int height
+                                , const SvgRasterOptions &opts=SvgRasterOptions()
+                                )
+{
+    SvgRasterImage img(width, height, opts.background);
+    SvgRasterizer  rasterizer(img);
+    rasterizer.setViewBox(viewPosX, viewPosY, viewSizeX, viewSizeY);
+    rasterizeDocument(rasterizer, doc, opts);
+    return img;
+}
+
+//----------------------------------------------------------------------------
+//! Чанк PNG: длина, тип, данные, CRC-32 типа и данных
+template<typename StreamType> inline
+void writePngChunk(StreamType &oss, const char *type, const std::uint8_t *pData, std::size_t size)
+{
+    const std::uint32_t len = std::uint32_t(size);
+    const char lenBytes[4] = { char(len>>24), char(len>>16), char(len>>8), char(len) };
+    oss << std::string_view(lenBytes, 4) << std::string_view(type, 4);
+    if (size)
+        oss << std::string_view(reinterpret_cast<const char*>(pData), size);
+
+    const std::uint32_t crc = crc32Update(crc32Update(0, type, 4), pData, size);
+    const char crcBytes[4] = { char(crc>>24), char(crc>>16), char(crc>>8), char(crc) };
+    oss << std::string_view(crcBytes, 4);
+}
+
+//----------------------------------------------------------------------------
+//! Изображение в PNG (RGBA8); level - уровень сжатия zlib, 0 - без сжатия
+/*! Без MARTY_SVG_USE_ZLIB данные всегда пишутся stored-блоками deflate. Строки фильтруются
+    фильтром Sub, только если данные сжимаются.
+ */
+template<typename StreamType> inline
+void writePng(StreamType &oss, const SvgRasterImage &img, int level=MARTY_SVG_PNG_DEFAULT_LEVEL)
+{
+    if (img.empty())
+        throw std::invalid_argument("marty::svg::writePng: empty image");
+
+#if defined(MARTY_SVG_USE_ZLIB)
+    const bool bCompress = level>0;
+#else
+    const bool bCompress = false;
+    (void)level;
+#endif
+
+    // Строки с байтом фильтра, цвета без предумножения
+    const std::size_t rowSize = img.stride()+1u;
+    std::vector<std::uint8_t> raw(rowSize*std::size_t(img.height()));
+    for(int y=0; y!=img.height(); ++y)
+    {
+        std::uint8_t       *pDst = &raw[std::size_t(y)*rowSize];
+        const std::uint8_t *pSrc = img.row(y);
+
+        *pDst++ = bCompress ? 1u : 0u; // Sub / None
+        for(std::size_t x=0; x!=img.stride(); x+=4)
+        {
+            const std::uint8_t a = pSrc[x+3];
+            pDst[x  ] = SvgRasterImage::unpremultiply(pSrc[x  ], a);
+            pDst[x+1] = SvgRasterImage::unpremultiply(pSrc[x+1], a);
+            pDst[x+2] = SvgRasterImage::unpremultiply(pSrc[x+2], a);
+            pDst[x+3] = a;
+        }
+
+        if (bCompress)
+        {
+            for(std::size_t x=img.stride()-1; x>=4; --x)
+                pDst[x] = std::uint8_t(pDst[x]-pDst[x-4]);
+        }
+    }
+
+    // Поток zlib
+    std::vector<std::uint8_t> z;
+
+#if defined(MARTY_SVG_USE_ZLIB)
+    if (bCompress)
+    {
+        uLongf zSize = compressBound(uLong(raw.size()));
+        z.resize(zSize);
+        if (compress2(z.data(), &zSize, raw.data(), uLong(raw.size()), std::min(level, 9))!=Z_OK)
+            throw std::runtime_error("marty::svg::writePng: compress2 failed");
+        z.resize(zSize);
+    }
+    else
+#endif
+    {
+        constexpr std::size_t maxStoredBlockSize = 65535u;
+
+        z.reserve(raw.size() + (raw.size()/maxStoredBlockSize+1u)*5u + 6u);
+        z.push_back(0x78); z.push_back(0x01); // CMF/FLG: deflate, окно 32K, без словаря
+
+        std::size_t pos = 0;
+        do
+        {
+            const std::size_t   blockSize = std::min(raw.size()-pos, maxStoredBlockSize);
+            const std::uint32_t len       = std::uint32_t(blockSize);
+            const bool          bFinal    = pos+blockSize==raw.size();
+
+            const std::uint8_t hdr[5] = { std::uint8_t(bFinal ? 1 : 0)
+                                        , std::uint8_t(len ), std::uint8_t(len >>8)
+                                        , std::uint8_t(~len), std::uint8_t(~len>>8)
+                                        };
+            z.insert(z.end(), hdr, hdr+5);
+            z.insert(z.end(), raw.begin()+std::ptrdiff_t(pos), raw.begin()+std::ptrdiff_t(pos+blockSize));
+            pos += blockSize;
+        }
+        while(pos!=raw.size());
+
+        const std::uint32_t adler = adler32Update(1, raw.data(), raw.size());
+        const std::uint8_t adlerBytes[4] = { std::uint8_t(adler>>24), std::uint8_t(adler>>16), std::uint8_t(adler>>8), std::uint8_t(adler) };
+        z.insert(z.end(), adlerBytes, adlerBytes+4);
+    }
+
+    static constexpr char signature[8] = { char(0x89), 'P', 'N', 'G', '\r', '\n', char(0x1A), '\n' };
+    oss << std::string_view(signature, 8);
+
+    const std::uint32_t w = std::uint32_t(img.width());
+    const std::uint32_t h = std::uint32_t(img.height());
+    const std::uint8_t ihdr[13] = { std::uint8_t(w>>24), std::uint8_t(w>>16), std::uint8_t(w>>8), std::uint8_t(w)
+                                  , std::uint8_t(h>>24), std::uint8_t(h>>16), std::uint8_t(h>>8), std::uint8_t(h)
+                                  , 8 /* бит на канал */, 6 /* RGBA */, 0, 0, 0
+                                  };
+    writePngChunk(oss, "IHDR", ihdr, sizeof(ihdr));
+
+    constexpr std::size_t idatChunkSize = 256u*1024u;
+    for(std::size_t pos=0; pos<z.size(); pos+=idatChunkSize)
+        writePngChunk(oss, "IDAT", z.data()+pos, std::min(idatChunkSize, z.size()-pos));
+
+    writePngChunk(oss, "IEND", nullptr, 0);
+}
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/svg_raster.h"
+
@@ -0,0 +1,37 @@
+/*! \file
+    \brief Внутренняя настройка SIMD-веток (экранирование текста, растеризатор)
+
+    Пользовательский переключатель один - MARTY_SVG_NO_SIMD: если он задан, везде используются
+    скалярные версии. Иначе набор инструкций определяется по флагам компилятора (__AVX2__, __SSE2__,
+    x64 в MSVC).
+
+    Макросы MARTY_SVG_IMPL_USE_AVX2/MARTY_SVG_IMPL_USE_SSE2 - внутренние, выводятся здесь и только здесь;
+    задавать их снаружи нельзя.
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#if defined(MARTY_SVG_IMPL_USE_AVX2) || defined(MARTY_SVG_IMPL_USE_SSE2)
+    #error "MARTY_SVG_IMPL_USE_* are internal macros, use MARTY_SVG_NO_SIMD to disable SIMD"
+#endif
+
+#if !defined(MARTY_SVG_NO_SIMD)
+
+    #if defined(__AVX2__)
+        #define MARTY_SVG_IMPL_USE_AVX2
+    #endif
+
+    #if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+        #define MARTY_SVG_IMPL_USE_SSE2
+    #endif
+
+#endif
+
+#if defined(MARTY_SVG_IMPL_USE_AVX2) || defined(MARTY_SVG_IMPL_USE_SSE2)
+    #include <immintrin.h>
+#endif
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/svg_simd.h"
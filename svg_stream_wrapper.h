@@ -0,0 +1,71 @@
+/*! \file
+    \brief Общая база обёрток над потоком вывода (SvgBoundsStream, SvgIdStream, CompactPathStream и др.)
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include <type_traits>
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/svg_stream_wrapper.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+//! Метка обёртки над потоком - по ней хуки по умолчанию передают вызов во вложенный поток
+struct SvgStreamWrapperTag {};
+
+//! true, если поток - обёртка (наследник SvgStreamWrapper)
+template<typename StreamType>
+struct IsSvgStreamWrapper : std::is_base_of<SvgStreamWrapperTag, StreamType> {};
+
+//----------------------------------------------------------------------------
+//! База обёртки над потоком: текст передаётся во вложенный поток как есть
+/*! Хуки marty_svg.h (elementTagOpened, bounds*, pathBeginData, path*Data), coordPrecision и
+    instrStreamBytes по умолчанию передаются обёрткой в stream(). Обёртка перегружает только те хуки,
+    которые ей нужны, и из перегрузки сама передаёт вызов дальше - поэтому обёртки вкладываются
+    друг в друга в любом порядке, а новый хук не требует перегрузок для каждой обёртки.
+ */
+template<typename WrapperType, typename StreamType>
+class SvgStreamWrapper : public SvgStreamWrapperTag
+{
+
+public:
+
+    using InnerStreamType = StreamType;
+
+    explicit SvgStreamWrapper(StreamType &oss)
+    : m_oss(oss)
+    {}
+
+    template<typename T>
+    WrapperType& operator<<(const T &v)
+    {
+        m_oss << v;
+        return static_cast<WrapperType&>(*this);
+    }
+
+    StreamType&       stream()       { return m_oss; }
+    const StreamType& stream() const { return m_oss; }
+
+
+protected:
+
+    StreamType          &m_oss;
+
+}; // class SvgStreamWrapper
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/svg_stream_wrapper.h"
+
@@ -0,0 +1,280 @@
+/*! \file
+    \brief SvgWriter - буферизованный приёмник вывода для SVG-хелперов
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include "svg_coord.h"
+//
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/svg_writer.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+//! Буферизованный приёмник вывода, замена std::ostringstream для всех хелперов marty_svg.h
+/*! Два режима работы:
+    - собственный непрерывный буфер, который растёт по мере надобности;
+    - внешний буфер фиксированного размера; при заполнении его содержимое отдаётся
+      в overflowHandler, и буфер начинается заново. Остаток отдаётся по flush(),
+      вызывать его нужно явно, деструктор этого не делает.
+
+    Целые числа форматируются через std::to_chars (без локали), строки копируются через memcpy.
+ */
+class SvgWriter
+{
+
+public:
+
+    using OverflowHandler = std::function<void(const char* /* data */, std::size_t /* size */)>;
+
+    //! Максимальная длина текстового представления целого (64 бита со знаком)
+    static constexpr std::size_t maxIntChars = 24;
+
+
+    SvgWriter() = default;
+
+    explicit SvgWriter(std::size_t reserveSize)
+    {
+        reserve(reserveSize);
+    }
+
+    //! Режим внешнего буфера фиксированного размера
+    SvgWriter(char *pBuf, std::size_t bufSize, OverflowHandler overflowHandler)
+    : m_pBuf(pBuf)
+    , m_capacity(bufSize)
+    , m_overflowHandler(std::move(overflowHandler))
+    {
+        if (!m_pBuf || !m_capacity)
+            throw std::invalid_argument("marty::svg::SvgWriter: empty external buffer");
+        if (!m_overflowHandler)
+            throw std::invalid_argument("marty::svg::SvgWriter: overflow handler is not set");
+    }
+
+    SvgWriter(const SvgWriter&) = delete;
+    SvgWriter& operator=(const SvgWriter&) = delete;
+
+    SvgWriter(SvgWriter &&other) noexcept
+    {
+        moveFrom(other);
+    }
+
+    SvgWriter& operator=(SvgWriter &&other) noexcept
+    {
+        if (this!=&other)
+            moveFrom(other);
+        return *this;
+    }
+
+
+    bool isFixedBuffer() const { return bool(m_overflowHandler); }
+
+    const char* data() const { return m_pBuf; }
+    std::size_t size() const { return m_size; }
+    bool        empty() const { return m_size==0; }
+    std::size_t capacity() const { return m_capacity; }
+
+    //! Всего байт с начала вывода, включая уже отданные в overflowHandler
+    std::uint64_t totalSize() const { return m_flushedSize+m_size; }
+
+    std::string_view view() const { return std::string_view(m_pBuf, m_size); }
+    std::string      str()  const { return std::string(m_pBuf, m_size); }
+
+    //! Сбрасывает содержимое, память собственного буфера остаётся за объектом
+    void clear() { m_size = 0; }
+
+    //! Максимум знаков после точки для нецелых координат
+    int  coordPrecision() const             { return m_coordPrecision; }
+    void setCoordPrecision(int precision)   { m_coordPrecision = precision; }
+
+    void reserve(std::size_t newCapacity)
+    {
+        if (isFixedBuffer() || newCapacity<=m_capacity)
+            return;
+
+        m_storage.resize(newCapacity);
+        m_pBuf     = m_storage.data();
+        m_capacity = m_storage.size();
+    }
+
+    //! Отдаёт накопленное в overflowHandler (только для внешнего буфера)
+    void flush()
+    {
+        if (!isFixedBuffer() || !m_size)
+            return;
+
+        m_overflowHandler(m_pBuf, m_size);
+        m_flushedSize += m_size;
+        m_size = 0;
+    }
+
+
+    void write(const char* p, std::size_t size)
+    {
+        if (size<=m_capacity-m_size)
+        {
+            if (size)
+                std::memcpy(m_pBuf+m_size, p, size);
+            m_size += size;
+            return;
+        }
+
+        writeSlow(p, size);
+    }
+
+    void put(char ch)
+    {
+        if (m_size==m_capacity)
+            makeRoom(1);
+        m_pBuf[m_size++] = ch;
+    }
+
+    template<typename IntType>
+    void writeInt(IntType v)
+    {
+        static_assert(std::is_integral<IntType>::value, "SvgWriter::writeInt: integral type required");
+
+        if (m_capacity-m_size>=maxIntChars)
+        {
+            auto res = std::to_chars(m_pBuf+m_size, m_pBuf+m_capacity, v);
+            m_size = std::size_t(res.ptr-m_pBuf);
+            return;
+        }
+
+        char buf[maxIntChars];
+        auto res = std::to_chars(&buf[0], &buf[0]+maxIntChars, v);
+        write(&buf[0], std::size_t(res.ptr-&buf[0]));
+    }
+
+
+    SvgWriter& operator<<(char ch)                  { put(ch); return *this; }
+    SvgWriter& operator<<(const char* str)          { write(str, std::strlen(str)); return *this; }
+    SvgWriter& operator<<(std::string_view str)     { write(str.data(), str.size()); return *this; }
+    SvgWriter& operator<<(const std::string &str)   { write(str.data(), str.size()); return *this; }
+
+    //! Целые, кроме bool и символьных типов
+    template< typename IntType
+            , typename std::enable_if< std::is_integral<IntType>::value
+                                    && !std::is_same<IntType, bool>::value
+                                    && !std::is_same<IntType, char>::value
+                                    && !std::is_same<IntType, signed char>::value
+                                    && !std::is_same<IntType, unsigned char>::value
+                                    && !std::is_same<IntType, wchar_t>::value
+                                    && !std::is_same<IntType, char16_t>::value
+                                    && !std::is_same<IntType, char32_t>::value
+                                     , int>::type = 0
+            >
+    SvgWriter& operator<<(IntType v)                { writeInt(v); return *this; }
+
+
+protected:
+
+    void moveFrom(SvgWriter &other)
+    {
+        const bool otherOwnsBuffer = !other.isFixedBuffer();
+
+        m_storage         = std::move(other.m_storage);
+        m_pBuf            = otherOwnsBuffer ? m_storage.data() : other.m_pBuf;
+        m_size            = other.m_size;
+        m_flushedSize     = other.m_flushedSize;
+        m_capacity        = otherOwnsBuffer ? m_storage.size() : other.m_capacity;
+        m_overflowHandler = std::move(other.m_overflowHandler);
+        m_coordPrecision  = other.m_coordPrecision;
+
+        other.m_storage.clear();
+        other.m_pBuf            = nullptr;
+        other.m_size            = 0;
+        other.m_flushedSize     = 0;
+        other.m_capacity        = 0;
+        other.m_overflowHandler = OverflowHandler();
+    }
+
+    //! Освобождает место хотя бы под size байт
+    void makeRoom(std::size_t size)
+    {
+        if (isFixedBuffer())
+        {
+            flush();
+            return;
+        }
+
+        std::size_t newCapacity = m_capacity ? m_capacity*2 : std::size_t(4096);
+        if (newCapacity<m_size+size)
+            newCapacity = m_size+size;
+
+        reserve(newCapacity);
+    }
+
+    void writeSlow(const char* p, std::size_t size)
+    {
+        if (!isFixedBuffer())
+        {
+            makeRoom(size);
+            std::memcpy(m_pBuf+m_size, p, size);
+            m_size += size;
+            return;
+        }
+
+        // Внешний буфер - заполняем кусками
+        while(size)
+        {
+            if (m_size==m_capacity)
+                flush();
+
+            const std::size_t chunkSize = std::min(size, m_capacity-m_size);
+            std::memcpy(m_pBuf+m_size, p, chunkSize);
+            m_size += chunkSize;
+            p      += chunkSize;
+            size   -= chunkSize;
+        }
+    }
+
+
+    std::vector<char>   m_storage;
+    char*               m_pBuf      = nullptr;
+    std::size_t         m_size      = 0;
+    std::size_t         m_capacity  = 0;
+    std::uint64_t       m_flushedSize = 0;
+    OverflowHandler     m_overflowHandler;
+    int                 m_coordPrecision = MARTY_SVG_DEFAULT_COORD_PRECISION;
+
+}; // class SvgWriter
+
+//----------------------------------------------------------------------------
+inline
+int coordPrecision(const SvgWriter &w)
+{
+    return w.coordPrecision();
+}
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/svg_writer.h"
+
@@ -0,0 +1,302 @@
+/*! \file
+    \brief Потоковый вывод сжатого SVG (.svgz, gzip): вывод сжимается кусками по мере генерации
+
+    Сжатие через zlib включается макросом MARTY_SVG_USE_ZLIB (нужна линковка с zlib);
+    без него используется встроенный вариант без сжатия (stored-блоки deflate) - файл
+    остаётся корректным .svgz, но не уменьшается.
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include "svg_checksum.h"
+#include "svg_writer.h"
+//
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(MARTY_SVG_USE_ZLIB)
+    #include <zlib.h>
+#endif
+
+//----------------------------------------------------------------------------
+//! Уровень сжатия по умолчанию, 0-9
+#if !defined(MARTY_SVG_SVGZ_DEFAULT_LEVEL)
+    #define MARTY_SVG_SVGZ_DEFAULT_LEVEL 6
+#endif
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/svgz_writer.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+//! Приёмник сжатых данных - тот же тип, что и у SvgWriter
+using SvgzOutputHandler = SvgWriter::OverflowHandler;
+
+//----------------------------------------------------------------------------
+//! Бэкенд gzip без сжатия: данные выводятся stored-блоками deflate, CRC-32 считается свой
+/*! Интерфейс бэкенда: конструктор (level, output), compress(p, size), sync(), finish().
+    Уровень сжатия игнорируется.
+ */
+class SvgzStoredBackend
+{
+
+public:
+
+    SvgzStoredBackend(int /* level */, SvgzOutputHandler output)
+    : m_output(std::move(output))
+    {
+        // Заголовок gzip: ID1 ID2 CM=deflate FLG=0 MTIME=0 XFL=0 OS=unknown
+        static constexpr unsigned char header[10] = { 0x1F, 0x8B, 0x08, 0x00, 0, 0, 0, 0, 0x00, 0xFF };
+        emit(header, sizeof(header));
+    }
+
+    void compress(const char* p, std::size_t size)
+    {
+        m_crc   = crc32Update(m_crc, p, size);
+        m_isize = std::uint32_t(m_isize+size); // ISIZE - размер по модулю 2^32
+
+        while(size)
+        {
+            const std::size_t blockSize = std::min<std::size_t>(size, maxStoredBlockSize);
+            writeBlockHeader(false, blockSize);
+            m_output(p, blockSize);
+            p    += blockSize;
+            size -= blockSize;
+        }
+    }
+
+    //! Выведенные блоки и так полные, досылать нечего
+    void sync() {}
+
+    void finish()
+    {
+        writeBlockHeader(true, 0); // Пустой завершающий блок
+
+        unsigned char trailer[8];
+        putLe32(&trailer[0], m_crc);
+        putLe32(&trailer[4], m_isize);
+        emit(trailer, sizeof(trailer));
+    }
+
+
+protected:
+
+    static constexpr std::size_t maxStoredBlockSize = 65535u;
+
+    void emit(const unsigned char *p, std::size_t size)
+    {
+        m_output(reinterpret_cast<const char*>(p), size);
+    }
+
+    static void putLe32(unsigned char *p, std::uint32_t v)
+    {
+        p[0] = (unsigned char)(v    ); p[1] = (unsigned char)(v>> 8);
+        p[2] = (unsigned char)(v>>16); p[3] = (unsigned char)(v>>24);
+    }
+
+    //! BFINAL, BTYPE=00, выравнивание до байта, LEN, NLEN
+    void writeBlockHeader(bool bFinal, std::size_t size)
+    {
+        const std::uint32_t len = std::uint32_t(size);
+        const unsigned char hdr[5] = { (unsigned char)(bFinal ? 1 : 0)
+                                     , (unsigned char)(len     ), (unsigned char)(len>>8)
+                                     , (unsigned char)(~len    ), (unsigned char)(~len>>8)
+                                     };
+        emit(hdr, sizeof(hdr));
+    }
+
+
+    SvgzOutputHandler   m_output;
+    std::uint32_t       m_crc   = 0;
+    std::uint32_t       m_isize = 0;
+
+}; // class SvgzStoredBackend
+
+//----------------------------------------------------------------------------
+#if defined(MARTY_SVG_USE_ZLIB)
+
+//! Бэкенд gzip через zlib; сжатый вывод отдаётся кусками по outChunkSize
+class SvgzZlibBackend
+{
+
+public:
+
+    static constexpr std::size_t outChunkSize = 64u*1024u;
+
+    SvgzZlibBackend(int level, SvgzOutputHandler output)
+    : m_output(std::move(output))
+    , m_outBuf(outChunkSize)
+    {
+        level = std::max(0, std::min(level, 9));
+        // windowBits 15+16 - zlib сам пишет заголовок и хвост gzip
+        if (deflateInit2(&m_zs, level, Z_DEFLATED, 15+16, 8, Z_DEFAULT_STRATEGY)!=Z_OK)
+            throw std::runtime_error("marty::svg::SvgzZlibBackend: deflateInit2 failed");
+    }
+
+    ~SvgzZlibBackend()
+    {
+        deflateEnd(&m_zs);
+    }
+
+    SvgzZlibBackend(const SvgzZlibBackend&) = delete;
+    SvgzZlibBackend& operator=(const SvgzZlibBackend&) = delete;
+
+    void compress(const char* p, std::size_t size)
+    {
+        // avail_in - uInt, большие куски подаются частями
+        while(size)
+        {
+            const std::size_t partSize = std::min<std::size_t>(size, 1u<<30);
+            m_zs.next_in  = reinterpret_cast<Bytef*>(const_cast<char*>(p));
+            m_zs.avail_in = uInt(partSize);
+            run(Z_NO_FLUSH);
+            p    += partSize;
+            size -= partSize;
+        }
+    }
+
+    //! Досылает всё принятое так, чтобы получатель мог распаковать вывод до текущего места
+    void sync()
+    {
+        run(Z_SYNC_FLUSH);
+    }
+
+    void finish()
+    {
+        run(Z_FINISH);
+    }
+
+
+protected:
+
+    void run(int flushMode)
+    {
+        for(;;)
+        {
+            m_zs.next_out  = reinterpret_cast<Bytef*>(m_outBuf.data());
+            m_zs.avail_out = uInt(m_outBuf.size());
+
+            const int res = deflate(&m_zs, flushMode);
+            if (res==Z_STREAM_ERROR)
+                throw std::runtime_error("marty::svg::SvgzZlibBackend: deflate failed");
+
+            const std::size_t produced = m_outBuf.size()-m_zs.avail_out;
+            if (produced)
+                m_output(m_outBuf.data(), produced);
+
+            if (flushMode==Z_FINISH ? res==Z_STREAM_END : (m_zs.avail_in==0 && m_zs.avail_out!=0))
+                break;
+        }
+    }
+
+
+    SvgzOutputHandler   m_output;
+    std::vector<char>   m_outBuf;
+    z_stream            m_zs = {};
+
+}; // class SvgzZlibBackend
+
+using SvgzDefaultBackend = SvgzZlibBackend;
+
+#else
+
+using SvgzDefaultBackend = SvgzStoredBackend;
+
+#endif
+
+//----------------------------------------------------------------------------
+//! Потоковый вывод .svgz
+/*! Хелперы пишут в writer() - обычный SvgWriter во внешнем буфере размера chunkSize; каждый
+    заполненный кусок сразу сжимается и отдаётся в output. Память ограничена входным куском и
+    буфером бэкенда, весь документ целиком нигде не собирается.
+
+    finish() обязателен - он дописывает остаток и хвост gzip; деструктор этого не делает.
+
+    \code
+    std::ofstream f("out.svgz", std::ios::binary);
+    marty::svg::SvgzWriter<> z(f);
+    marty::svg::writeSvgHeader(z.writer(), 0, 0, 1000, 700, style);
+    for(...)
+        marty::svg::drawRectEx(z.writer(), x, y, 120, 40, 8, 1, "black");
+    marty::svg::writeSvgFooter(z.writer());
+    z.finish();
+    \endcode
+ */
+template<typename BackendType=SvgzDefaultBackend>
+class SvgzWriter
+{
+
+public:
+
+    static constexpr std::size_t defaultChunkSize = 64u*1024u;
+
+    SvgzWriter(SvgzOutputHandler output, int level=MARTY_SVG_SVGZ_DEFAULT_LEVEL, std::size_t chunkSize=defaultChunkSize)
+    : m_backend(level, std::move(output))
+    , m_inBuf(chunkSize ? chunkSize : defaultChunkSize)
+    , m_writer(m_inBuf.data(), m_inBuf.size(), [this](const char* p, std::size_t size) { m_backend.compress(p, size); })
+    {}
+
+    explicit SvgzWriter(std::ostream &os, int level=MARTY_SVG_SVGZ_DEFAULT_LEVEL, std::size_t chunkSize=defaultChunkSize)
+    : SvgzWriter( [&os](const char* p, std::size_t size) { os.write(p, std::streamsize(size)); }
+                , level, chunkSize
+                )
+    {}
+
+    // Обработчик переполнения ссылается на this
+    SvgzWriter(const SvgzWriter&) = delete;
+    SvgzWriter& operator=(const SvgzWriter&) = delete;
+
+    SvgWriter& writer() { return m_writer; }
+
+    //! Сжимает накопленное и досылает его получателю, не завершая поток
+    void sync()
+    {
+        checkNotFinished();
+        m_writer.flush();
+        m_backend.sync();
+    }
+
+    //! Завершает поток gzip; после этого писать в writer() нельзя
+    void finish()
+    {
+        checkNotFinished();
+        m_writer.flush();
+        m_backend.finish();
+        m_finished = true;
+    }
+
+    bool finished() const { return m_finished; }
+
+
+protected:
+
+    void checkNotFinished() const
+    {
+        if (m_finished)
+            throw std::logic_error("marty::svg::SvgzWriter: stream already finished");
+    }
+
+
+    BackendType         m_backend;
+    std::vector<char>   m_inBuf;
+    SvgWriter           m_writer;
+    bool                m_finished = false;
+
+}; // class SvgzWriter
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/svgz_writer.h"
+
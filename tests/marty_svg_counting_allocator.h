@@ -0,0 +1,61 @@
+/*! \file
+    \brief Подсчёт аллокаций для бенчмарка и тестов: глобальные operator new/delete подменены счётчиком
+
+    Замены глобальных операторов - определения, а не объявления, поэтому заголовок включается
+    ровно в одну единицу трансляции исполняемого файла. Число аллокаций - g_allocationCounter.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+//----------------------------------------------------------------------------
+static std::atomic<std::uint64_t> g_allocationCounter{0};
+
+// Замены выделяют память через malloc и освобождают через free - пара согласована. GCC (с 11-й
+// версии), встроив operator delete в место вызова, видит free() для указателя из operator new и
+// выдаёт ложное -Wmismatched-new-delete; для этих определений предупреждение отключено.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__>=11
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size)
+{
+    ++g_allocationCounter;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    ++g_allocationCounter;
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void *p) noexcept                          { std::free(p); }
+void operator delete[](void *p) noexcept                        { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept             { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept           { std::free(p); }
+void operator delete(void *p, const std::nothrow_t&) noexcept   { std::free(p); }
+void operator delete[](void *p, const std::nothrow_t&) noexcept { std::free(p); }
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__>=11
+    #pragma GCC diagnostic pop
+#endif
+
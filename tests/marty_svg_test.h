@@ -0,0 +1,51 @@
+/*! \file
+    \brief Минимальная обвязка тестов marty_svg: проверки без внешних зависимостей
+
+    Тест - исполняемый файл; код возврата 0 - все проверки прошли, иначе печатается каждая
+    неудачная проверка и код возврата 1.
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <string_view>
+
+//----------------------------------------------------------------------------
+namespace marty_svg_test {
+
+inline int& failureCount()
+{
+    static int count = 0;
+    return count;
+}
+
+inline void reportFailure(const char *file, int line, const char *expr)
+{
+    ++failureCount();
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+}
+
+inline int result(const char *testName)
+{
+    if (failureCount())
+    {
+        std::fprintf(stderr, "%s: %d check(s) failed\n", testName, failureCount());
+        return 1;
+    }
+
+    std::printf("%s: ok\n", testName);
+    return 0;
+}
+
+} // namespace marty_svg_test
+
+//----------------------------------------------------------------------------
+#define MARTY_SVG_TEST_CHECK(expr)                                                      \
+            do                                                                          \
+            {                                                                           \
+                if (!(expr))                                                            \
+                    marty_svg_test::reportFailure(__FILE__, __LINE__, #expr);          \
+            } while(0)
+
+#define MARTY_SVG_TEST_CHECK_EQ(a, b)       MARTY_SVG_TEST_CHECK((a)==(b))
+
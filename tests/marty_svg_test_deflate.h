@@ -0,0 +1,88 @@
+/*! \file
+    \brief Проверка потоков deflate/zlib/gzip в тестах: эталонные CRC-32 и Adler-32, разбор stored-блоков
+
+    Эталонные суммы считаются побитно/побайтно, независимо от табличных реализаций svg_checksum.h.
+    Разбираются только stored-блоки (BTYPE=00) - так пишут PNG и svgz без zlib; сжатые блоки
+    проверяются через zlib (MARTY_SVG_USE_ZLIB).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+//----------------------------------------------------------------------------
+namespace marty_svg_test {
+
+inline std::uint32_t referenceCrc32(const void *pData, std::size_t size)
+{
+    const unsigned char *p = static_cast<const unsigned char*>(pData);
+    std::uint32_t crc = 0xFFFFFFFFu;
+    for(std::size_t i=0; i!=size; ++i)
+    {
+        crc ^= p[i];
+        for(int k=0; k!=8; ++k)
+            crc = (crc>>1) ^ (0xEDB88320u & (0u-(crc&1u)));
+    }
+    return ~crc;
+}
+
+inline std::uint32_t referenceAdler32(const void *pData, std::size_t size)
+{
+    const unsigned char *p = static_cast<const unsigned char*>(pData);
+    std::uint32_t a = 1, b = 0;
+    for(std::size_t i=0; i!=size; ++i)
+    {
+        a = (a+p[i])%65521u;
+        b = (b+a)%65521u;
+    }
+    return (b<<16) | a;
+}
+
+inline std::uint32_t readBigEndian32(const unsigned char *p)
+{
+    return std::uint32_t(p[0])<<24 | std::uint32_t(p[1])<<16 | std::uint32_t(p[2])<<8 | std::uint32_t(p[3]);
+}
+
+inline std::uint32_t readLittleEndian32(const unsigned char *p)
+{
+    return std::uint32_t(p[3])<<24 | std::uint32_t(p[2])<<16 | std::uint32_t(p[1])<<8 | std::uint32_t(p[0]);
+}
+
+//! Разбирает поток deflate из одних stored-блоков; false - другой тип блока или поток оборван
+/*! pos - на входе начало потока, на выходе - первый байт после последнего блока; *pBlockCount - число блоков. */
+inline bool inflateStored(std::string_view data, std::size_t &pos, std::vector<unsigned char> &out, std::size_t *pBlockCount=nullptr)
+{
+    const unsigned char *p = reinterpret_cast<const unsigned char*>(data.data());
+    std::size_t nBlocks = 0;
+
+    for(;;)
+    {
+        if (pos+5>data.size())
+            return false;
+
+        const unsigned hdr = p[pos];
+        if ((hdr&6u)!=0) // BTYPE
+            return false;
+
+        const unsigned len  = unsigned(p[pos+1]) | unsigned(p[pos+2])<<8;
+        const unsigned nlen = unsigned(p[pos+3]) | unsigned(p[pos+4])<<8;
+        if ((len^0xFFFFu)!=nlen || pos+5+len>data.size())
+            return false;
+
+        out.insert(out.end(), p+pos+5, p+pos+5+len);
+        pos += 5+len;
+        ++nBlocks;
+
+        if (hdr&1u) // BFINAL
+            break;
+    }
+
+    if (pBlockCount)
+        *pBlockCount = nBlocks;
+    return true;
+}
+
+} // namespace marty_svg_test
@@ -0,0 +1,108 @@
+/*! \file
+    \brief Пакетный вывод: отрезки не сливаются в ломаную, габариты совпадают с поэлементным выводом,
+           неверный индекс стиля - исключение
+ */
+
+#include "marty_svg/batch_draw.h"
+#include "marty_svg/bounds_tracker.h"
+
+#include "marty_svg_test.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+//----------------------------------------------------------------------------
+namespace {
+
+using marty::svg::SvgBoundsStream;
+using marty::svg::SvgBox;
+using marty::svg::SvgLine;
+using marty::svg::SvgPathStyle;
+using marty::svg::SvgRect;
+using marty::svg::SvgWriter;
+
+bool sameBox(const SvgBox &a, const SvgBox &b)
+{
+    return a.minX==b.minX && a.minY==b.minY && a.maxX==b.maxX && a.maxY==b.maxY;
+}
+
+//----------------------------------------------------------------------------
+//! Смежные отрезки - по отдельному moveto, как отдельные drawLine
+void testLinesAreSeparateSubpaths()
+{
+    const SvgLine lines[] = { {0,0,100,0}, {100,0,100,50}, {100,50,0,100}, {5,5,5,5} };
+
+    SvgWriter w;
+    marty::svg::drawLines(w, lines, std::size(lines), SvgPathStyle(8, "black"));
+    MARTY_SVG_TEST_CHECK_EQ(w.str(), std::string("<path stroke=\"black\" stroke-width=\"8\" stroke-linejoin=\"miter\" fill-opacity=\"0\" d=\"M0 0H100M100 0V50M100 50L0 100M5 5H5\" />\n"));
+
+    // Габариты пакета - те же, что у тех же отрезков, выведенных по одному
+    SvgWriter batchOut, singleOut;
+    SvgBoundsStream<SvgWriter> batch(batchOut), single(singleOut);
+    marty::svg::drawLines(batch, lines, std::size(lines), SvgPathStyle(8, "black"));
+    for(const auto &ln : lines)
+        marty::svg::drawLine(single, ln.startX, ln.startY, ln.endX, ln.endY, 8, "black");
+    MARTY_SVG_TEST_CHECK(sameBox(batch.box(), single.box()));
+
+    // С разными стилями - так же
+    const SvgPathStyle  styles[]  = { SvgPathStyle("a"), SvgPathStyle("b") };
+    const std::uint32_t indices[] = { 0, 0, 1, 0 };
+
+    SvgWriter grouped;
+    marty::svg::drawLines(grouped, lines, indices, std::size(lines), styles, std::size(styles));
+    MARTY_SVG_TEST_CHECK_EQ(grouped.str(), std::string("<path class=\"a\" d=\"M0 0H100M100 0V50M5 5H5\" />\n<path class=\"b\" d=\"M100 50L0 100\" />\n"));
+}
+
+//----------------------------------------------------------------------------
+//! Индекс стиля вне pStyles - std::out_of_range до какого-либо вывода
+void testStyleIndexOutOfRange()
+{
+    const SvgRect       rects[]   = { {0,0,10,10}, {20,0,10,10}, {40,0,10,10} };
+    const SvgLine       lines[]   = { {0,0,10,0}, {0,5,10,5}, {0,9,10,9} };
+    const SvgPathStyle  styles[]  = { SvgPathStyle("a"), SvgPathStyle("b") };
+    const std::uint32_t indices[] = { 1, 0, 2 };
+
+    SvgWriter w;
+
+    bool thrown = false;
+    try
+    {
+        marty::svg::drawRects(w, rects, indices, std::size(rects), styles, std::size(styles));
+    }
+    catch(const std::out_of_range &)
+    {
+        thrown = true;
+    }
+    MARTY_SVG_TEST_CHECK(thrown);
+
+    thrown = false;
+    try
+    {
+        marty::svg::drawLines(w, lines, indices, std::size(lines), styles, std::size(styles));
+    }
+    catch(const std::out_of_range &)
+    {
+        thrown = true;
+    }
+    MARTY_SVG_TEST_CHECK(thrown);
+    MARTY_SVG_TEST_CHECK(w.str().empty());
+
+    const std::uint32_t valid[] = { 1, 0, 1 };
+    marty::svg::drawRects(w, rects, valid, std::size(rects), styles, std::size(styles));
+    MARTY_SVG_TEST_CHECK_EQ(w.str(), std::string("<path class=\"a\" d=\"M20 0h10v10h-10z\" />\n<path class=\"b\" d=\"M0 0h10v10h-10zM40 0h10v10h-10z\" />\n"));
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int main()
+{
+    testLinesAreSeparateSubpaths();
+    testStyleIndexOutOfRange();
+
+    return marty_svg_test::result("batch_draw");
+}
+
@@ -0,0 +1,181 @@
+/*! \file
+    \brief Разбор AFM: символы по именам глифов, кодировки EncodingScheme; измерение текста
+ */
+
+#include "marty_svg/font_metrics.h"
+
+#include "marty_svg_test.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+//----------------------------------------------------------------------------
+namespace {
+
+using marty::svg::SvgFontMetrics;
+using marty::svg::parseAfmMetrics;
+using marty::svg::glyphNameToUnicode;
+
+//----------------------------------------------------------------------------
+void testGlyphNames()
+{
+    MARTY_SVG_TEST_CHECK_EQ(glyphNameToUnicode("A")            , U'A');
+    MARTY_SVG_TEST_CHECK_EQ(glyphNameToUnicode("quotesingle")  , U'\'');
+    MARTY_SVG_TEST_CHECK_EQ(glyphNameToUnicode("quoteright")   , char32_t(0x2019));
+    MARTY_SVG_TEST_CHECK_EQ(glyphNameToUnicode("grave")        , U'`');
+    MARTY_SVG_TEST_CHECK_EQ(glyphNameToUnicode("quoteleft")    , char32_t(0x2018));
+    MARTY_SVG_TEST_CHECK_EQ(glyphNameToUnicode("Adieresis")    , char32_t(0x00C4));
+    MARTY_SVG_TEST_CHECK_EQ(glyphNameToUnicode("ydieresis")    , char32_t(0x00FF));
+    MARTY_SVG_TEST_CHECK_EQ(glyphNameToUnicode("germandbls")   , char32_t(0x00DF));
+    MARTY_SVG_TEST_CHECK_EQ(glyphNameToUnicode("Euro")         , char32_t(0x20AC));
+    MARTY_SVG_TEST_CHECK_EQ(glyphNameToUnicode("uni041F")      , char32_t(0x041F));
+    MARTY_SVG_TEST_CHECK_EQ(glyphNameToUnicode("u1F600")       , char32_t(0x1F600));
+    MARTY_SVG_TEST_CHECK_EQ(glyphNameToUnicode("uni041f")      , char32_t(0));
+    MARTY_SVG_TEST_CHECK_EQ(glyphNameToUnicode("uniD800")      , char32_t(0));
+    MARTY_SVG_TEST_CHECK_EQ(glyphNameToUnicode("nosuchglyph")  , char32_t(0));
+    MARTY_SVG_TEST_CHECK_EQ(glyphNameToUnicode("")             , char32_t(0));
+
+    // Вся верхняя половина Latin-1 (кроме nbsp) имеет имена в таблице
+    static constexpr std::string_view names[] =
+    { "exclamdown", "cent", "sterling", "currency", "yen", "brokenbar", "section", "dieresis", "copyright"
+    , "ordfeminine", "guillemotleft", "logicalnot", "sfthyphen", "registered", "macron", "degree"
+    , "plusminus", "twosuperior", "threesuperior", "acute", "mu", "paragraph", "periodcentered"
+    , "cedilla", "onesuperior", "ordmasculine", "guillemotright", "onequarter", "onehalf"
+    , "threequarters", "questiondown", "Agrave", "Aacute", "Acircumflex", "Atilde", "Adieresis"
+    , "Aring", "AE", "Ccedilla", "Egrave", "Eacute", "Ecircumflex", "Edieresis", "Igrave", "Iacute"
+    , "Icircumflex", "Idieresis", "Eth", "Ntilde", "Ograve", "Oacute", "Ocircumflex", "Otilde"
+    , "Odieresis", "multiply", "Oslash", "Ugrave", "Uacute", "Ucircumflex", "Udieresis", "Yacute"
+    , "Thorn", "germandbls", "agrave", "aacute", "acircumflex", "atilde", "adieresis", "aring", "ae"
+    , "ccedilla", "egrave", "eacute", "ecircumflex", "edieresis", "igrave", "iacute", "icircumflex"
+    , "idieresis", "eth", "ntilde", "ograve", "oacute", "ocircumflex", "otilde", "odieresis", "divide"
+    , "oslash", "ugrave", "uacute", "ucircumflex", "udieresis", "yacute", "thorn", "ydieresis"
+    };
+
+    for(std::size_t i=0; i!=std::size(names); ++i)
+        MARTY_SVG_TEST_CHECK_EQ(glyphNameToUnicode(names[i]), char32_t(0xA1+i));
+}
+
+//----------------------------------------------------------------------------
+void testStandardEncoding()
+{
+    // Фрагмент Helvetica.afm: в AdobeStandardEncoding 39 - quoteright, 96 - quoteleft, 169 - quotesingle
+    const std::string_view afm =
+        "StartFontMetrics 4.1\n"
+        "FontName Helvetica\n"
+        "EncodingScheme AdobeStandardEncoding\n"
+        "Ascender 718\n"
+        "Descender -207\n"
+        "StartCharMetrics 7\n"
+        "C 39 ; WX 222 ; N quoteright ; B 65 463 186 718 ;\n"
+        "C 65 ; WX 667 ; N A ; B 14 0 654 718 ;\n"
+        "C 96 ; WX 222 ; N quoteleft ; B 65 470 169 725 ;\n"
+        "C 110 ; WX 556 ; N n ; B 65 0 491 538 ;\n"
+        "C 169 ; WX 191 ; N quotesingle ; B 59 463 132 718 ;\n"
+        "C 193 ; WX 333 ; N grave ; B 14 593 211 740 ;\n"
+        "C -1 ; WX 667 ; N Adieresis ; B 14 0 654 901 ;\n"
+        "EndCharMetrics\n"
+        "EndFontMetrics\n";
+
+    const SvgFontMetrics f = parseAfmMetrics(afm);
+
+    MARTY_SVG_TEST_CHECK_EQ(f.name(), std::string("Helvetica"));
+    MARTY_SVG_TEST_CHECK_EQ(f.advance(U'\''), 191);
+    MARTY_SVG_TEST_CHECK_EQ(f.advance(char32_t(0x2019)), 222);
+    MARTY_SVG_TEST_CHECK_EQ(f.advance(U'`'), 333);
+    MARTY_SVG_TEST_CHECK_EQ(f.advance(char32_t(0x2018)), 222);
+    MARTY_SVG_TEST_CHECK_EQ(f.advance(U'A'), 667);
+    MARTY_SVG_TEST_CHECK_EQ(f.advance(char32_t(0x00C4)), 667);
+    MARTY_SVG_TEST_CHECK(!f.hasAdvance(char32_t(169)));  // © - не quotesingle
+    MARTY_SVG_TEST_CHECK(!f.hasAdvance(char32_t(193)));  // Á - не grave
+    MARTY_SVG_TEST_CHECK_EQ(f.defaultWidth(), 556);
+}
+
+void testCodeEncodings()
+{
+    // ISOLatin1Encoding: код используется, если имени нет в таблице
+    const SvgFontMetrics latin1 = parseAfmMetrics(
+        "EncodingScheme ISOLatin1Encoding\n"
+        "C 65 ; WX 600 ; N A ;\n"
+        "C 233 ; WX 610 ; N someUnknownName ;\n"
+        "C 200 ; WX 620 ;\n");
+    MARTY_SVG_TEST_CHECK_EQ(latin1.advance(U'A'), 600);
+    MARTY_SVG_TEST_CHECK_EQ(latin1.advance(char32_t(233)), 610);
+    MARTY_SVG_TEST_CHECK_EQ(latin1.advance(char32_t(200)), 620);
+
+    // FontSpecific: только коды, имена (alpha и т.п.) не означают символы Unicode
+    const SvgFontMetrics symbol = parseAfmMetrics(
+        "EncodingScheme FontSpecific\n"
+        "C 97 ; WX 631 ; N alpha ;\n"
+        "C 65 ; WX 722 ; N Alpha ;\n");
+    MARTY_SVG_TEST_CHECK_EQ(symbol.advance(U'a'), 631);
+    MARTY_SVG_TEST_CHECK_EQ(symbol.advance(U'A'), 722);
+
+    // Прочие кодировки: без известного имени глиф пропускается; U - явный код Unicode
+    const SvgFontMetrics other = parseAfmMetrics(
+        "EncodingScheme AdobeStandardEncoding\n"
+        "C 200 ; WX 620 ;\n"
+        "U 41F ; WX 650 ; N afii10033 ;\n"
+        "CH <6E> ; WX 520 ; N n ;\n");
+    MARTY_SVG_TEST_CHECK(!other.hasAdvance(char32_t(200)));
+    MARTY_SVG_TEST_CHECK_EQ(other.advance(char32_t(0x41F)), 650);
+    MARTY_SVG_TEST_CHECK_EQ(other.advance(U'n'), 520);
+}
+
+//----------------------------------------------------------------------------
+//! Ширина - сумма ширин символов, умноженная на кегль/1000; результат из кэша тот же
+void testMeasureText()
+{
+    const marty::svg::SvgFontRegistry fonts;
+    marty::svg::SvgTextMeasurer measurer(fonts, 4, 8);
+
+    const std::size_t helvetica = fonts.findFont("Arial");
+    MARTY_SVG_TEST_CHECK(helvetica!=marty::svg::SvgFontRegistry::npos);
+    if (helvetica==marty::svg::SvgFontRegistry::npos)
+        return;
+
+    const SvgFontMetrics &font = fonts.font(helvetica);
+
+    const std::u32string texts[] = { U"Label", U"A long label for the cache", U"\u00C4rger \u00FCber \u00DF", U"" };
+    const char *const    utf8[]  = { "Label", "A long label for the cache", "\xC3\x84" "rger \xC3\xBC" "ber \xC3\x9F", "" };
+
+    for(std::size_t i=0; i!=std::size(texts); ++i)
+    {
+        long long advance = 0;
+        for(char32_t ch : texts[i])
+            advance += font.advance(ch);
+
+        const double expected = double(advance)*12.0/double(SvgFontMetrics::unitsPerEm);
+        for(int round=0; round!=3; ++round) // Первый раз - промах кэша, далее - попадания
+        {
+            const auto m = measurer.measureText(utf8[i], "Arial, sans-serif", 12.0);
+            MARTY_SVG_TEST_CHECK(m.width>expected-1e-9 && m.width<expected+1e-9);
+            MARTY_SVG_TEST_CHECK(m.height()>0.0);
+        }
+    }
+
+    // Кэшируются две строки не короче 8 байт: по промаху и по два попадания
+    MARTY_SVG_TEST_CHECK_EQ(measurer.cacheMisses(), std::uint64_t(2));
+    MARTY_SVG_TEST_CHECK_EQ(measurer.cacheHits()  , std::uint64_t(4));
+
+    // Неизвестное семейство - первый шрифт реестра
+    const auto unknown = measurer.measureText("Label", "NoSuchFont", 10.0);
+    const auto first   = measurer.measureText("Label", std::size_t(0), 10.0);
+    MARTY_SVG_TEST_CHECK(unknown.width==first.width);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int main()
+{
+    testGlyphNames();
+    testStandardEncoding();
+    testCodeEncodings();
+    testMeasureText();
+
+    return marty_svg_test::result("font_metrics");
+}
+
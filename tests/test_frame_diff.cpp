@@ -0,0 +1,215 @@
+/*! \file
+    \brief SvgFrameDiff: патч кадра содержит ровно добавления, замены и удаления, счётчики совпадают с ним
+ */
+
+#include "marty_svg/marty_svg.h"
+#include "marty_svg/frame_diff.h"
+
+#include "marty_svg_test.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+//----------------------------------------------------------------------------
+namespace {
+
+using marty::svg::SvgFrameDiff;
+using marty::svg::SvgFrameDiffStats;
+using marty::svg::SvgWriter;
+
+//! Элемент кадра: непустой id и цвет, от которого зависит его SVG
+using Item  = std::pair<std::string, std::string>;
+using Items = std::vector<Item>;
+
+//! Выводит кадр; возвращает строки патча
+std::vector<std::string> frame(SvgFrameDiff &diff, const Items &items, SvgFrameDiffStats *pStats=nullptr)
+{
+    SvgWriter patch;
+    diff.beginFrame();
+    for(const Item &item : items)
+    {
+        // Положение зависит только от id - вставка и удаление соседей элемент не меняют
+        diff.element(patch, item.first, [&](auto &oss)
+                     {
+                         marty::svg::drawRectEx(oss, int(item.first[0])*20, 0, 10, 10, 2, 1, item.second);
+                     });
+    }
+
+    const SvgFrameDiffStats &stats = diff.endFrame(patch);
+    if (pStats)
+        *pStats = stats;
+
+    std::vector<std::string> lines;
+    std::string_view rest = patch.view();
+    while(!rest.empty())
+    {
+        const std::size_t eol = rest.find('\n');
+        MARTY_SVG_TEST_CHECK(eol!=std::string_view::npos); // Каждая строка патча завершена
+        lines.emplace_back(rest.substr(0, eol));
+        rest.remove_prefix(eol==std::string_view::npos ? rest.size() : eol+1);
+    }
+    return lines;
+}
+
+bool startsWith(std::string_view str, std::string_view prefix)
+{
+    return str.substr(0, prefix.size())==prefix;
+}
+
+bool sameStats(const SvgFrameDiffStats &s, std::size_t added, std::size_t replaced, std::size_t removed, std::size_t unchanged)
+{
+    return s.added==added && s.replaced==replaced && s.removed==removed && s.unchanged==unchanged;
+}
+
+//----------------------------------------------------------------------------
+void testAddAfter()
+{
+    SvgFrameDiff diff;
+    SvgFrameDiffStats stats;
+
+    const auto lines = frame(diff, { {"a", "red"}, {"b", "green"}, {"c", "blue"} }, &stats);
+    MARTY_SVG_TEST_CHECK_EQ(lines.size(), std::size_t(3));
+    if (lines.size()!=3)
+        return;
+
+    // У первого элемента кадра нет after, у остальных - id предыдущего
+    MARTY_SVG_TEST_CHECK(startsWith(lines[0], "{\"op\":\"add\",\"id\":\"a\",\"svg\":\"<path id=\\\"a\\\" "));
+    MARTY_SVG_TEST_CHECK(startsWith(lines[1], "{\"op\":\"add\",\"id\":\"b\",\"after\":\"a\",\"svg\":\"<path id=\\\"b\\\" "));
+    MARTY_SVG_TEST_CHECK(startsWith(lines[2], "{\"op\":\"add\",\"id\":\"c\",\"after\":\"b\",\"svg\":\"<path id=\\\"c\\\" "));
+    MARTY_SVG_TEST_CHECK(lines[1].find("stroke=\\\"green\\\"")!=std::string::npos);
+
+    MARTY_SVG_TEST_CHECK(sameStats(stats, 3, 0, 0, 0));
+    MARTY_SVG_TEST_CHECK_EQ(stats.changes(), std::size_t(3));
+    MARTY_SVG_TEST_CHECK_EQ(diff.size(), std::size_t(3));
+
+    // Новый элемент в середине кадра вставляется после своего соседа
+    const auto inserted = frame(diff, { {"a", "red"}, {"x", "black"}, {"b", "green"}, {"c", "blue"} }, &stats);
+    MARTY_SVG_TEST_CHECK_EQ(inserted.size(), std::size_t(1));
+    if (!inserted.empty())
+        MARTY_SVG_TEST_CHECK(startsWith(inserted[0], "{\"op\":\"add\",\"id\":\"x\",\"after\":\"a\",\"svg\":"));
+    MARTY_SVG_TEST_CHECK(sameStats(stats, 1, 0, 0, 3));
+}
+
+void testUnchanged()
+{
+    SvgFrameDiff diff;
+    SvgFrameDiffStats stats;
+    const Items items = { {"a", "red"}, {"b", "green"}, {"c", "blue"} };
+
+    frame(diff, items);
+    for(int i=0; i!=3; ++i)
+    {
+        MARTY_SVG_TEST_CHECK(frame(diff, items, &stats).empty());
+        MARTY_SVG_TEST_CHECK(sameStats(stats, 0, 0, 0, 3));
+        MARTY_SVG_TEST_CHECK_EQ(stats.changes(), std::size_t(0));
+        MARTY_SVG_TEST_CHECK_EQ(diff.size(), std::size_t(3));
+    }
+
+    // element() сообщает, изменился ли элемент
+    SvgWriter patch;
+    diff.beginFrame();
+    MARTY_SVG_TEST_CHECK(!diff.element(patch, "a", [](auto &oss) { marty::svg::drawRectEx(oss, int('a')*20, 0, 10, 10, 2, 1, "red"); }));
+    MARTY_SVG_TEST_CHECK( diff.element(patch, "b", [](auto &oss) { marty::svg::drawRectEx(oss, int('b')*20, 0, 10, 10, 2, 1, "white"); }));
+}
+
+void testReplace()
+{
+    SvgFrameDiff diff;
+    SvgFrameDiffStats stats;
+
+    frame(diff, { {"a", "red"}, {"b", "green"}, {"c", "blue"} });
+    const auto lines = frame(diff, { {"a", "red"}, {"b", "yellow"}, {"c", "blue"} }, &stats);
+
+    MARTY_SVG_TEST_CHECK_EQ(lines.size(), std::size_t(1));
+    if (!lines.empty())
+    {
+        // У замены нет after - элемент остаётся на своём месте
+        MARTY_SVG_TEST_CHECK(startsWith(lines[0], "{\"op\":\"replace\",\"id\":\"b\",\"svg\":\"<path id=\\\"b\\\" "));
+        MARTY_SVG_TEST_CHECK(lines[0].find("stroke=\\\"yellow\\\"")!=std::string::npos);
+    }
+    MARTY_SVG_TEST_CHECK(sameStats(stats, 0, 1, 0, 2));
+    MARTY_SVG_TEST_CHECK_EQ(diff.size(), std::size_t(3));
+
+    // Возврат к прежнему значению - тоже замена
+    MARTY_SVG_TEST_CHECK_EQ(frame(diff, { {"a", "red"}, {"b", "green"}, {"c", "blue"} }, &stats).size(), std::size_t(1));
+    MARTY_SVG_TEST_CHECK(sameStats(stats, 0, 1, 0, 2));
+}
+
+void testRemove()
+{
+    SvgFrameDiff diff;
+    SvgFrameDiffStats stats;
+
+    frame(diff, { {"a", "red"}, {"b", "green"}, {"c", "blue"}, {"d", "black"} });
+    const auto lines = frame(diff, { {"b", "green"}, {"d", "white"} }, &stats);
+
+    // Замена выводится в ходе кадра, удаления - в endFrame()
+    MARTY_SVG_TEST_CHECK_EQ(lines.size(), std::size_t(3));
+    if (lines.size()==3)
+    {
+        MARTY_SVG_TEST_CHECK(startsWith(lines[0], "{\"op\":\"replace\",\"id\":\"d\","));
+        MARTY_SVG_TEST_CHECK_EQ(lines[1], std::string("{\"op\":\"remove\",\"id\":\"a\"}"));
+        MARTY_SVG_TEST_CHECK_EQ(lines[2], std::string("{\"op\":\"remove\",\"id\":\"c\"}"));
+    }
+    MARTY_SVG_TEST_CHECK(sameStats(stats, 0, 1, 2, 1));
+    MARTY_SVG_TEST_CHECK_EQ(stats.changes(), std::size_t(3));
+    MARTY_SVG_TEST_CHECK_EQ(diff.size(), std::size_t(2));
+
+    // Удалённый элемент при возвращении снова добавляется
+    const auto readded = frame(diff, { {"a", "red"}, {"b", "green"}, {"d", "white"} }, &stats);
+    MARTY_SVG_TEST_CHECK_EQ(readded.size(), std::size_t(1));
+    if (!readded.empty())
+        MARTY_SVG_TEST_CHECK(startsWith(readded[0], "{\"op\":\"add\",\"id\":\"a\",\"svg\":"));
+    MARTY_SVG_TEST_CHECK(sameStats(stats, 1, 0, 0, 2));
+
+    // Пустой кадр удаляет всё
+    MARTY_SVG_TEST_CHECK_EQ(frame(diff, Items(), &stats).size(), std::size_t(3));
+    MARTY_SVG_TEST_CHECK(sameStats(stats, 0, 0, 3, 0));
+    MARTY_SVG_TEST_CHECK_EQ(diff.size(), std::size_t(0));
+}
+
+void testGroupAndOutOfFrame()
+{
+    SvgFrameDiff diff;
+    SvgWriter patch;
+
+    // Несколько элементов под одним id оборачиваются в <g>
+    diff.beginFrame();
+    diff.element(patch, "pair", [](auto &oss)
+                 {
+                     marty::svg::drawLine(oss, 0, 0, 10, 10, 1, "red");
+                     marty::svg::drawLine(oss, 0, 10, 10, 0, 1, "red");
+                 });
+    diff.endFrame(patch);
+    MARTY_SVG_TEST_CHECK(startsWith(patch.view(), "{\"op\":\"add\",\"id\":\"pair\",\"svg\":\"<g id=\\\"pair\\\">\\n<line "));
+
+    // update()/remove() вне кадра
+    patch.clear();
+    MARTY_SVG_TEST_CHECK(diff.update(patch, "one", [](auto &oss) { marty::svg::drawLine(oss, 0, 0, 5, 5, 1, "blue"); }, "pair"));
+    MARTY_SVG_TEST_CHECK(startsWith(patch.view(), "{\"op\":\"add\",\"id\":\"one\",\"after\":\"pair\",\"svg\":"));
+    MARTY_SVG_TEST_CHECK_EQ(diff.size(), std::size_t(2));
+
+    patch.clear();
+    MARTY_SVG_TEST_CHECK(!diff.remove(patch, "missing"));
+    MARTY_SVG_TEST_CHECK(diff.remove(patch, "one"));
+    MARTY_SVG_TEST_CHECK(!diff.remove(patch, "one"));
+    MARTY_SVG_TEST_CHECK_EQ(std::string(patch.view()), std::string("{\"op\":\"remove\",\"id\":\"one\"}\n"));
+    MARTY_SVG_TEST_CHECK_EQ(diff.size(), std::size_t(1));
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int main()
+{
+    testAddAfter();
+    testUnchanged();
+    testReplace();
+    testRemove();
+    testGroupAndOutOfFrame();
+
+    return marty_svg_test::result("frame_diff");
+}
@@ -0,0 +1,139 @@
+/*! \file
+    \brief Инструментирование вывода: число вызовов и байт по примитивам совпадает с фактическим выводом
+
+    Собирается с MARTY_SVG_INSTRUMENTATION (см. CMakeLists.txt).
+ */
+
+#if !defined(MARTY_SVG_INSTRUMENTATION)
+    #error "test_instrumentation.cpp must be built with MARTY_SVG_INSTRUMENTATION"
+#endif
+
+#include "marty_svg/marty_svg.h"
+#include "marty_svg/shape_instancer.h"
+
+#include "marty_svg_test.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+//----------------------------------------------------------------------------
+namespace {
+
+using marty::svg::SvgInstrPoint;
+using marty::svg::SvgInstrReport;
+using marty::svg::SvgWriter;
+
+std::uint64_t calls(const SvgInstrReport &report, SvgInstrPoint point) { return report[point].calls; }
+std::uint64_t bytes(const SvgInstrReport &report, SvgInstrPoint point) { return report[point].bytes; }
+
+//----------------------------------------------------------------------------
+void testDrawRectEx()
+{
+    marty::svg::resetInstrumentation();
+
+    SvgWriter w;
+    for(int i=0; i!=3; ++i)
+        marty::svg::drawRectEx(w, 10*i, 10, 120, 40, 8, 2, "black", "#eee");
+
+    const SvgInstrReport report = marty::svg::instrumentationReport();
+    MARTY_SVG_TEST_CHECK(report.enabled);
+    MARTY_SVG_TEST_CHECK_EQ(calls(report, SvgInstrPoint::drawRectEx), std::uint64_t(3));
+    MARTY_SVG_TEST_CHECK_EQ(bytes(report, SvgInstrPoint::drawRectEx), std::uint64_t(w.size()));
+
+    // Вложенные pathStart/pathEnd учитываются и в своих строках
+    MARTY_SVG_TEST_CHECK_EQ(calls(report, SvgInstrPoint::pathStart), std::uint64_t(3));
+    MARTY_SVG_TEST_CHECK_EQ(calls(report, SvgInstrPoint::pathEnd), std::uint64_t(3));
+    MARTY_SVG_TEST_CHECK(bytes(report, SvgInstrPoint::pathStart)+bytes(report, SvgInstrPoint::pathEnd)<=std::uint64_t(w.size()));
+    MARTY_SVG_TEST_CHECK_EQ(calls(report, SvgInstrPoint::drawLine), std::uint64_t(0));
+}
+
+void testDrawLineAndRect()
+{
+    marty::svg::resetInstrumentation();
+
+    SvgWriter lines;
+    marty::svg::drawLine(lines, 0, 0, 100, 100, 1, "red");
+    marty::svg::drawLine(lines, 0, 5, 100, 5, "grid");
+
+    SvgWriter rects;
+    marty::svg::drawRect(rects, 1, 2, 30, 40, "cell", true, true, 4);
+    marty::svg::drawRect(rects, 1, 2, 30, 40, "cell", false, false, 0);
+
+    const SvgInstrReport report = marty::svg::instrumentationReport();
+    MARTY_SVG_TEST_CHECK_EQ(calls(report, SvgInstrPoint::drawLine), std::uint64_t(2));
+    MARTY_SVG_TEST_CHECK_EQ(bytes(report, SvgInstrPoint::drawLine), std::uint64_t(lines.size()));
+    MARTY_SVG_TEST_CHECK_EQ(calls(report, SvgInstrPoint::drawRect), std::uint64_t(2));
+    MARTY_SVG_TEST_CHECK_EQ(bytes(report, SvgInstrPoint::drawRect), std::uint64_t(rects.size()));
+}
+
+void testDrawTextEscaping()
+{
+    marty::svg::resetInstrumentation();
+
+    SvgWriter w;
+    const std::string_view text = "a<b & \"c\"";
+    marty::svg::drawText(w, 10, 20, text, "lbl", "middle", "middle");
+
+    const SvgInstrReport report = marty::svg::instrumentationReport();
+    MARTY_SVG_TEST_CHECK_EQ(calls(report, SvgInstrPoint::drawText), std::uint64_t(1));
+    MARTY_SVG_TEST_CHECK_EQ(bytes(report, SvgInstrPoint::drawText), std::uint64_t(w.size()));
+
+    // Экранирование: вход - сам текст, экранированы <, &, и две кавычки
+    MARTY_SVG_TEST_CHECK_EQ(calls(report, SvgInstrPoint::escapeText), std::uint64_t(1));
+    MARTY_SVG_TEST_CHECK_EQ(bytes(report, SvgInstrPoint::escapeText), std::uint64_t(text.size()));
+    MARTY_SVG_TEST_CHECK_EQ(report[SvgInstrPoint::escapeText].escapedChars, std::uint64_t(4));
+}
+
+void testInstancedDrawRectEx()
+{
+    marty::svg::resetInstrumentation();
+
+    SvgWriter w;
+    marty::svg::SvgShapeInstancer shapes;
+    for(int i=0; i!=4; ++i)
+        marty::svg::drawRectEx(w, 10*i, 10, 120, 40, 8, shapes, 2, "black");
+    marty::svg::drawRectEx(w, 0, 100, 60, 20, 4, shapes, "box");
+
+    // Вызов - каждый <use>; байты - только <use>, символы в <defs> вызовами drawRectEx не считаются
+    const SvgInstrReport report = marty::svg::instrumentationReport();
+    MARTY_SVG_TEST_CHECK_EQ(calls(report, SvgInstrPoint::drawRectEx), std::uint64_t(5));
+    MARTY_SVG_TEST_CHECK_EQ(bytes(report, SvgInstrPoint::drawRectEx), std::uint64_t(w.size()));
+    MARTY_SVG_TEST_CHECK_EQ(shapes.size(), std::size_t(2));
+    MARTY_SVG_TEST_CHECK_EQ(calls(report, SvgInstrPoint::pathStart), std::uint64_t(2));
+}
+
+void testWriteSvgAndReport()
+{
+    marty::svg::resetInstrumentation();
+
+    SvgWriter w;
+    marty::svg::writeSvg(w, 100, 100, ".r { fill: none; }", "<g/>\n");
+
+    const SvgInstrReport report = marty::svg::instrumentationReport();
+    MARTY_SVG_TEST_CHECK_EQ(calls(report, SvgInstrPoint::writeSvg), std::uint64_t(1));
+    MARTY_SVG_TEST_CHECK_EQ(bytes(report, SvgInstrPoint::writeSvg), std::uint64_t(w.size()));
+
+    SvgWriter json;
+    marty::svg::writeInstrumentationReportJson(json, report);
+    MARTY_SVG_TEST_CHECK(json.view().substr(0, 16)=="{\"enabled\":true,");
+    MARTY_SVG_TEST_CHECK(json.view().find("\"writeSvg\":{\"calls\":1,")!=std::string_view::npos);
+
+    // После сброса счётчики нулевые
+    marty::svg::resetInstrumentation();
+    MARTY_SVG_TEST_CHECK_EQ(calls(marty::svg::instrumentationReport(), SvgInstrPoint::writeSvg), std::uint64_t(0));
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int main()
+{
+    testDrawRectEx();
+    testDrawLineAndRect();
+    testDrawTextEscaping();
+    testInstancedDrawRectEx();
+    testWriteSvgAndReport();
+
+    return marty_svg_test::result("instrumentation");
+}
@@ -0,0 +1,91 @@
+/*! \file
+    \brief drawSeries: округление и ограничение координат, смещения в выводе не переполняются
+ */
+
+#include "marty_svg/polyline_simplify.h"
+#include "marty_svg/svg_pull_parser.h"
+
+#include "marty_svg_test.h"
+
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//----------------------------------------------------------------------------
+namespace {
+
+using marty::svg::SvgPathCommand;
+using marty::svg::SvgPathDataParser;
+using marty::svg::SvgPathDataSegment;
+using marty::svg::SvgSimplifyOptions;
+using marty::svg::SvgWriter;
+
+//! Абсолютные точки из атрибута d; суммирование в long long - переполнение в выводе было бы видно
+std::vector<long long> pathPoints(std::string_view svg)
+{
+    const std::size_t dPos = svg.find(" d=\"");
+    MARTY_SVG_TEST_CHECK(dPos!=svg.npos);
+    if (dPos==svg.npos)
+        return {};
+
+    const std::size_t dBegin = dPos+4;
+    SvgPathDataParser pdp(svg.substr(dBegin, svg.find('\"', dBegin)-dBegin));
+
+    std::vector<long long> points;
+    long long x = 0, y = 0;
+    SvgPathDataSegment seg;
+    while(pdp.next(seg))
+    {
+        const long long bx = seg.bAbs ? 0 : x;
+        const long long by = seg.bAbs ? 0 : y;
+        switch(seg.command)
+        {
+            case SvgPathCommand::moveTo         :
+            case SvgPathCommand::lineTo         : x = bx+(long long)seg.args[0]; y = by+(long long)seg.args[1]; break;
+            case SvgPathCommand::horzLineTo     : x = bx+(long long)seg.args[0]; break;
+            case SvgPathCommand::vertLineTo     : y = by+(long long)seg.args[0]; break;
+            default                             : continue;
+        }
+        points.push_back(x);
+        points.push_back(y);
+    }
+
+    MARTY_SVG_TEST_CHECK(!pdp.hasError());
+    return points;
+}
+
+void testSeriesClamp()
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    const double ys[] = { 1e300, -1e300, nan, 0.4, 2.6, -inf, 1e12 };
+
+    SvgSimplifyOptions opts;
+    opts.columnDecimation = false;
+    opts.removeCollinear  = false;
+
+    marty::svg::SvgSeriesTransform transform;
+    transform.scaleX = 10.0;
+
+    SvgWriter w;
+    marty::svg::drawSeries(w, (const double*)nullptr, ys, std::size(ys), transform, marty::svg::SvgPathStyle(1, "black"), opts);
+
+    const long long lim = marty::svg::seriesCoordLimit;
+    const std::vector<long long> expected = { 0,lim, 10,-lim, 30,0, 40,3, 50,-lim, 60,lim };
+    MARTY_SVG_TEST_CHECK(pathPoints(w.view())==expected);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int main()
+{
+    testSeriesClamp();
+
+    return marty_svg_test::result("polyline_simplify");
+}
+
@@ -0,0 +1,188 @@
+/*! \file
+    \brief SvgPullParser и SvgPathDataParser: разбор вывода хелперов возвращает записанные данные
+ */
+
+#include "marty_svg/marty_svg.h"
+#include "marty_svg/path_encoder.h"
+#include "marty_svg/svg_pull_parser.h"
+
+#include "marty_svg_test.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//----------------------------------------------------------------------------
+namespace {
+
+using marty::svg::SvgPathCommand;
+using marty::svg::SvgPathDataParser;
+using marty::svg::SvgPathDataSegment;
+using marty::svg::SvgPullParser;
+using marty::svg::SvgWriter;
+using marty::svg::SvgXmlEvent;
+
+const char *const sampleText = "a<b & \"c\" > 'd' \xD0\x96";
+
+template<typename StreamType>
+void drawPath(StreamType &oss)
+{
+    marty::svg::pathStart(oss, 10, 10, "p");
+    marty::svg::pathLineTo(oss, 5, -5);
+    marty::svg::pathHorzLineTo(oss, 7);
+    marty::svg::pathVertLineTo(oss, -3, true);
+    marty::svg::pathQuadraticBezier(oss, 1, 2, 3, 4);
+    marty::svg::pathLineTo(oss, 100, 200, true);
+    marty::svg::pathEnd(oss, true);
+}
+
+//! Абсолютные точки пути: после каждой команды - текущая позиция
+std::vector<double> pathPoints(std::string_view d, std::vector<SvgPathCommand> &commands)
+{
+    std::vector<double> points;
+    double x = 0, y = 0;
+
+    SvgPathDataParser pdp(d);
+    SvgPathDataSegment seg;
+    while(pdp.next(seg))
+    {
+        const double bx = seg.bAbs ? 0 : x;
+        const double by = seg.bAbs ? 0 : y;
+        switch(seg.command)
+        {
+            case SvgPathCommand::moveTo         :
+            case SvgPathCommand::lineTo         : x = bx+seg.args[0]; y = by+seg.args[1]; break;
+            case SvgPathCommand::horzLineTo     : x = bx+seg.args[0]; break;
+            case SvgPathCommand::vertLineTo     : y = by+seg.args[0]; break;
+            case SvgPathCommand::quadraticBezier: x = bx+seg.args[2]; y = by+seg.args[3]; break;
+            case SvgPathCommand::closePath      : break;
+        }
+        commands.push_back(seg.command);
+        points.push_back(x);
+        points.push_back(y);
+    }
+
+    MARTY_SVG_TEST_CHECK(!pdp.hasError());
+    return points;
+}
+
+void testRoundTrip()
+{
+    SvgWriter w;
+    marty::svg::writeSvgHeader(w, 0, 0, 400, 300, "");
+    marty::svg::drawRectEx(w, 10, 20, 30, 40, 0, 2, "red", "#fff");
+    marty::svg::drawLine(w, 1, 2, 3, 4, "cl");
+    marty::svg::drawText(w, 5, 6, sampleText, "t", "middle", "end");
+    drawPath(w);
+    marty::svg::CompactPathStream<SvgWriter> compact(w);
+    drawPath(compact);
+    marty::svg::writeSvgFooter(w);
+
+    const std::string doc = w.str();
+    SvgPullParser parser(doc);
+
+    std::vector<std::string> names;
+    std::vector<std::string> pathData;
+    std::string              text;
+    std::size_t              nEnds = 0;
+
+    for(auto ev=parser.next(); ev!=SvgXmlEvent::end; ev=parser.next())
+    {
+        MARTY_SVG_TEST_CHECK(ev!=SvgXmlEvent::error);
+        if (ev==SvgXmlEvent::error)
+            break;
+
+        if (ev==SvgXmlEvent::endElement)
+        {
+            ++nEnds;
+            continue;
+        }
+
+        if (ev==SvgXmlEvent::text)
+        {
+            if (!names.empty() && names.back()=="text")
+                marty::svg::unescapeXmlText(parser.text(), text);
+            continue;
+        }
+
+        if (ev!=SvgXmlEvent::startElement)
+            continue;
+
+        names.emplace_back(parser.name());
+
+        if (parser.name()=="path")
+        {
+            pathData.emplace_back(parser.attribute("d"));
+        }
+        else if (parser.name()=="line")
+        {
+            MARTY_SVG_TEST_CHECK(parser.attribute("x1")=="1" && parser.attribute("y1")=="2");
+            MARTY_SVG_TEST_CHECK(parser.attribute("x2")=="3" && parser.attribute("y2")=="4");
+            MARTY_SVG_TEST_CHECK(parser.attribute("class")=="cl");
+        }
+        else if (parser.name()=="text")
+        {
+            MARTY_SVG_TEST_CHECK(parser.attribute("x")=="5" && parser.attribute("y")=="6");
+            MARTY_SVG_TEST_CHECK(parser.attribute("dominant-baseline")=="middle");
+            MARTY_SVG_TEST_CHECK(parser.attribute("text-anchor")=="end");
+        }
+    }
+
+    const std::vector<std::string> expectedNames = { "svg", "path", "line", "text", "path", "path" };
+    MARTY_SVG_TEST_CHECK(names==expectedNames);
+    MARTY_SVG_TEST_CHECK_EQ(nEnds, expectedNames.size());
+    MARTY_SVG_TEST_CHECK_EQ(text, std::string(sampleText));
+
+    MARTY_SVG_TEST_CHECK_EQ(pathData.size(), std::size_t(3));
+    if (pathData.size()!=3)
+        return;
+
+    // Прямоугольник без скругления: moveto, четыре стороны, замыкание
+    std::vector<SvgPathCommand> rectCommands;
+    const std::vector<double> rectPoints = pathPoints(pathData[0], rectCommands);
+    MARTY_SVG_TEST_CHECK(rectPoints.size()>=2 && rectPoints[0]==10 && rectPoints[1]==20);
+    MARTY_SVG_TEST_CHECK(!rectCommands.empty() && rectCommands.back()==SvgPathCommand::closePath);
+
+    // Подробная и компактная запись пути дают одни и те же точки
+    std::vector<SvgPathCommand> verboseCommands, compactCommands;
+    const std::vector<double> verbose = pathPoints(pathData[1], verboseCommands);
+    const std::vector<double> compactPoints = pathPoints(pathData[2], compactCommands);
+
+    const std::vector<double> expected = { 10,10, 15,5, 22,5, 22,-3, 25,1, 100,200, 100,200 };
+    MARTY_SVG_TEST_CHECK(verbose==expected);
+    MARTY_SVG_TEST_CHECK(compactPoints==expected);
+    MARTY_SVG_TEST_CHECK(verboseCommands==compactCommands);
+}
+
+void testPathDataErrors()
+{
+    SvgPathDataSegment seg;
+
+    SvgPathDataParser bad("M 10 10 c 1 2 3 4 5 6");
+    while(bad.next(seg)) {}
+    MARTY_SVG_TEST_CHECK(bad.hasError());
+
+    SvgPathDataParser packed("m10-10.5.5-1l-1e1+2z");
+    std::vector<double> args;
+    while(packed.next(seg))
+    {
+        for(std::size_t i=0; i!=seg.argCount(); ++i)
+            args.push_back(seg.args[i]);
+    }
+    MARTY_SVG_TEST_CHECK(!packed.hasError());
+    const std::vector<double> expected = { 10, -10.5, 0.5, -1, -10, 2 };
+    MARTY_SVG_TEST_CHECK(args==expected);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int main()
+{
+    testRoundTrip();
+    testPathDataErrors();
+
+    return marty_svg_test::result("pull_parser");
+}
+
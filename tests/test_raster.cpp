@@ -0,0 +1,300 @@
+/*! \file
+    \brief Растеризатор: покрытие пикселей для основных примитивов и разбор записанного PNG
+ */
+
+#include "marty_svg/marty_svg.h"
+#include "marty_svg/svg_raster.h"
+
+#include "marty_svg_test.h"
+#include "marty_svg_test_deflate.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(MARTY_SVG_USE_ZLIB)
+    #include <zlib.h>
+#endif
+
+//----------------------------------------------------------------------------
+namespace {
+
+using marty::svg::SvgRasterColor;
+using marty::svg::SvgRasterImage;
+using marty::svg::SvgRasterizer;
+using marty::svg::SvgRasterPaint;
+using marty::svg::SvgRasterPathStream;
+using marty::svg::SvgWriter;
+
+const SvgRasterColor black = SvgRasterColor{ 0, 0, 0, 255 };
+
+//! Покрытие пикселя на прозрачном фоне - его альфа
+int coverage(const SvgRasterImage &img, int x, int y)
+{
+    return img.pixel(x, y).a;
+}
+
+double totalCoverage(const SvgRasterImage &img)
+{
+    double sum = 0;
+    for(int y=0; y!=img.height(); ++y)
+        for(int x=0; x!=img.width(); ++x)
+            sum += coverage(img, x, y);
+    return sum/255.0;
+}
+
+//! Рисует то, что выводит draw(rs), одним стилем; масштаб 1:1
+template<typename DrawHandler>
+SvgRasterImage rasterize(int width, int height, const SvgRasterPaint &paint, DrawHandler draw)
+{
+    SvgRasterImage      img(width, height);
+    SvgRasterizer       rasterizer(img);
+    SvgRasterPathStream rs(rasterizer);
+
+    draw(rs);
+    rasterizer.drawPath(paint);
+    rasterizer.clearPath();
+    return img;
+}
+
+SvgRasterPaint fillPaint()
+{
+    SvgRasterPaint paint;
+    paint.fill   = black;
+    paint.stroke = SvgRasterColor();
+    return paint;
+}
+
+//----------------------------------------------------------------------------
+void testFilledRect()
+{
+    const SvgRasterImage img = rasterize(40, 40, fillPaint(), [](SvgRasterPathStream &rs)
+                                         {
+                                             marty::svg::drawRect(rs, 10, 10, 20, 10, "r", false, false, 0);
+                                         });
+
+    int nWrong = 0;
+    for(int y=0; y!=img.height(); ++y)
+        for(int x=0; x!=img.width(); ++x)
+        {
+            const bool inside = x>=10 && x<30 && y>=10 && y<20;
+            if (coverage(img, x, y)!=(inside ? 255 : 0))
+                ++nWrong;
+        }
+
+    MARTY_SVG_TEST_CHECK_EQ(nWrong, 0);
+}
+
+void testStrokedLine()
+{
+    SvgRasterPaint paint;
+    paint.stroke      = black;
+    paint.strokeWidth = 2;
+
+    const SvgRasterImage img = rasterize(40, 40, paint, [](SvgRasterPathStream &rs)
+                                         {
+                                             marty::svg::drawLine(rs, 5, 20, 25, 20, 2, "black");
+                                         });
+
+    // Толщина 2 вокруг y=20 - ровно строки 19 и 20; концы butt - столбцы 5..24
+    int nWrong = 0;
+    for(int y=0; y!=img.height(); ++y)
+        for(int x=0; x!=img.width(); ++x)
+        {
+            const bool inside = x>=5 && x<25 && (y==19 || y==20);
+            if (coverage(img, x, y)!=(inside ? 255 : 0))
+                ++nWrong;
+        }
+
+    MARTY_SVG_TEST_CHECK_EQ(nWrong, 0);
+}
+
+void testRoundedRect()
+{
+    constexpr double r = 5;
+
+    // <rect rx ry> передаёт радиус через хук boundsRect
+    const SvgRasterImage img = rasterize(40, 40, fillPaint(), [](SvgRasterPathStream &rs)
+                                         {
+                                             marty::svg::drawRect(rs, 10, 10, 20, 20, "r", true, true, 5);
+                                         });
+
+    // Угловые пиксели целиком вне дуги, середины сторон и центр - внутри
+    MARTY_SVG_TEST_CHECK_EQ(coverage(img, 10, 10), 0);
+    MARTY_SVG_TEST_CHECK_EQ(coverage(img, 29, 10), 0);
+    MARTY_SVG_TEST_CHECK_EQ(coverage(img, 10, 29), 0);
+    MARTY_SVG_TEST_CHECK_EQ(coverage(img, 29, 29), 0);
+    MARTY_SVG_TEST_CHECK_EQ(coverage(img, 10, 20), 255);
+    MARTY_SVG_TEST_CHECK_EQ(coverage(img, 20, 10), 255);
+    MARTY_SVG_TEST_CHECK_EQ(coverage(img, 20, 20), 255);
+    MARTY_SVG_TEST_CHECK_EQ(coverage(img,  9, 20), 0);
+
+    // Площадь - квадрат без (4-pi)*r*r по углам; дуги приближаются вписанными ломаными, поэтому
+    // площадь чуть меньше - но далеко от 400 у прямоугольника без скруглений
+    const double expected = 20.0*20.0 - (4.0-3.14159265358979)*r*r;
+    const double area     = totalCoverage(img);
+    MARTY_SVG_TEST_CHECK(area<=expected+0.5 && area>expected-3.0);
+}
+
+//----------------------------------------------------------------------------
+//! Пиксели PNG (8 бит RGBA, без чересстрочности) из распакованных данных; понимает фильтры строк None и Sub
+bool decodePngPixels(const std::vector<unsigned char> &raw, int width, int height, std::vector<unsigned char> &pixels)
+{
+    const std::size_t stride = std::size_t(width)*4u;
+    if (raw.size()!=(stride+1u)*std::size_t(height))
+        return false;
+
+    pixels.clear();
+    for(int y=0; y!=height; ++y)
+    {
+        const unsigned char *pRow = &raw[std::size_t(y)*(stride+1u)];
+        const std::size_t    base = pixels.size();
+        const unsigned       filter = *pRow++;
+        if (filter>1u)
+            return false;
+
+        for(std::size_t x=0; x!=stride; ++x)
+            pixels.push_back(std::uint8_t(pRow[x] + (filter==1u && x>=4 ? pixels[base+x-4] : 0)));
+    }
+
+    return true;
+}
+
+//! Разбирает PNG, проверяя сигнатуру, CRC каждого чанка, IHDR и поток zlib, и сравнивает пиксели с img
+void checkPng(std::string_view png, const SvgRasterImage &img, bool bStoredOnly)
+{
+    const unsigned char *p = reinterpret_cast<const unsigned char*>(png.data());
+
+    MARTY_SVG_TEST_CHECK(png.size()>8 && png.substr(0, 8)==std::string_view("\x89PNG\r\n\x1A\n", 8));
+    if (png.size()<=8)
+        return;
+
+    std::vector<std::string> chunkTypes;
+    std::string              idat;
+    std::size_t              pos = 8;
+    bool                     bCrcOk = true;
+
+    while(pos+12<=png.size())
+    {
+        const std::uint32_t len = marty_svg_test::readBigEndian32(p+pos);
+        if (pos+12+len>png.size())
+            break;
+
+        chunkTypes.emplace_back(png.substr(pos+4, 4));
+        if (marty_svg_test::referenceCrc32(p+pos+4, 4+len)!=marty_svg_test::readBigEndian32(p+pos+8+len))
+            bCrcOk = false;
+
+        if (chunkTypes.back()=="IHDR")
+        {
+            MARTY_SVG_TEST_CHECK_EQ(len, 13u);
+            MARTY_SVG_TEST_CHECK_EQ(marty_svg_test::readBigEndian32(p+pos+8 ), std::uint32_t(img.width()));
+            MARTY_SVG_TEST_CHECK_EQ(marty_svg_test::readBigEndian32(p+pos+12), std::uint32_t(img.height()));
+            MARTY_SVG_TEST_CHECK_EQ(int(p[pos+16]), 8); // Бит на канал
+            MARTY_SVG_TEST_CHECK_EQ(int(p[pos+17]), 6); // RGBA
+            MARTY_SVG_TEST_CHECK(p[pos+18]==0 && p[pos+19]==0 && p[pos+20]==0);
+        }
+        else if (chunkTypes.back()=="IDAT")
+        {
+            idat.append(png.substr(pos+8, len));
+        }
+
+        pos += 12+len;
+    }
+
+    MARTY_SVG_TEST_CHECK_EQ(pos, png.size());
+    MARTY_SVG_TEST_CHECK(bCrcOk);
+    MARTY_SVG_TEST_CHECK(chunkTypes.size()>=3 && chunkTypes.front()=="IHDR" && chunkTypes.back()=="IEND");
+
+    // Поток zlib: заголовок, deflate, Adler-32 распакованных данных
+    MARTY_SVG_TEST_CHECK(idat.size()>6);
+    if (idat.size()<=6)
+        return;
+
+    const unsigned char *z = reinterpret_cast<const unsigned char*>(idat.data());
+    MARTY_SVG_TEST_CHECK_EQ(z[0]&0x0Fu, 8u); // deflate
+    MARTY_SVG_TEST_CHECK_EQ((unsigned(z[0])*256u + z[1])%31u, 0u);
+
+    std::vector<unsigned char> raw;
+    const std::size_t rawSize = (img.stride()+1u)*std::size_t(img.height());
+
+    if (bStoredOnly)
+    {
+        std::size_t zPos    = 2;
+        std::size_t nBlocks = 0;
+        MARTY_SVG_TEST_CHECK(marty_svg_test::inflateStored(idat, zPos, raw, &nBlocks));
+        MARTY_SVG_TEST_CHECK_EQ(nBlocks, (rawSize+65534u)/65535u);
+        MARTY_SVG_TEST_CHECK_EQ(zPos+4, idat.size());
+        if (zPos+4==idat.size())
+            MARTY_SVG_TEST_CHECK_EQ(marty_svg_test::readBigEndian32(z+zPos), marty_svg_test::referenceAdler32(raw.data(), raw.size()));
+    }
+    else
+    {
+#if defined(MARTY_SVG_USE_ZLIB)
+        raw.resize(rawSize);
+        uLongf size = uLongf(raw.size());
+        MARTY_SVG_TEST_CHECK_EQ(uncompress(raw.data(), &size, z, uLong(idat.size())), Z_OK);
+        MARTY_SVG_TEST_CHECK_EQ(std::size_t(size), rawSize);
+#endif
+    }
+
+    std::vector<unsigned char> pixels;
+    MARTY_SVG_TEST_CHECK(decodePngPixels(raw, img.width(), img.height(), pixels));
+    if (pixels.size()!=img.stride()*std::size_t(img.height()))
+        return;
+
+    int nWrong = 0;
+    for(int y=0; y!=img.height(); ++y)
+        for(int x=0; x!=img.width(); ++x)
+        {
+            const SvgRasterColor c = img.pixel(x, y);
+            const unsigned char *px = &pixels[std::size_t(y)*img.stride() + std::size_t(x)*4u];
+            if (px[0]!=c.r || px[1]!=c.g || px[2]!=c.b || px[3]!=c.a)
+                ++nWrong;
+        }
+    MARTY_SVG_TEST_CHECK_EQ(nWrong, 0);
+}
+
+void testPngRoundTrip()
+{
+    // Строк больше, чем влезает в один stored-блок (65535 байт)
+    SvgRasterImage img(300, 250, SvgRasterColor{ 255, 255, 255, 255 });
+    {
+        SvgRasterizer       rasterizer(img);
+        SvgRasterPathStream rs(rasterizer);
+
+        SvgRasterPaint paint;
+        paint.fill        = SvgRasterColor{ 31, 119, 180, 255 };
+        paint.stroke      = SvgRasterColor{ 214, 39, 40, 128 };
+        paint.strokeWidth = 3;
+
+        marty::svg::drawRectEx(rs, 20, 30, 200, 120, 16, 3, "red", "blue");
+        rasterizer.drawPath(paint);
+        rasterizer.clearPath();
+    }
+
+    SvgWriter stored;
+    marty::svg::writePng(stored, img, 0);
+    checkPng(stored.view(), img, true);
+
+#if defined(MARTY_SVG_USE_ZLIB)
+    SvgWriter compressed;
+    marty::svg::writePng(compressed, img, 6);
+    checkPng(compressed.view(), img, false);
+#endif
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int main()
+{
+    testFilledRect();
+    testStrokedLine();
+    testRoundedRect();
+    testPngRoundTrip();
+
+    return marty_svg_test::result("raster");
+}
@@ -0,0 +1,146 @@
+/*! \file
+    \brief SvgSpatialIndex: результат запроса совпадает с полным перебором элементов
+ */
+
+#include "marty_svg/spatial_index.h"
+
+#include "marty_svg_test.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------
+namespace {
+
+using marty::svg::SvgBox;
+using marty::svg::SvgDocument;
+using marty::svg::SvgSpatialIndex;
+using marty::svg::SvgWriter;
+
+//! Детерминированный генератор - тест воспроизводим
+struct Lcg
+{
+    std::uint32_t state = 12345u;
+
+    int next(int lo, int hi)
+    {
+        state = state*1664525u + 1013904223u;
+        return lo + int((state>>8) % std::uint32_t(hi-lo+1));
+    }
+};
+
+void buildDocument(SvgDocument &doc, Lcg &rnd, int nElements)
+{
+    for(int i=0; i!=nElements; ++i)
+    {
+        const int x = rnd.next(-500, 5000);
+        const int y = rnd.next(-500, 5000);
+
+        switch(rnd.next(0, 6))
+        {
+            case 0 : doc.drawRectEx(x, y, rnd.next(1, 200), rnd.next(1, 100), 6, rnd.next(1, 4), "black"); break;
+            case 1 : doc.drawRect(x, y, rnd.next(1, 200), rnd.next(1, 100), "r", true, false, 4); break;
+            case 2 : doc.drawLine(x, y, x+rnd.next(-300, 300), y+rnd.next(-300, 300), "l"); break;
+            case 3 : doc.drawLine(x, y, x+rnd.next(-300, 300), y, rnd.next(1, 5), "red", "round"); break;
+            case 4 : doc.drawText(x, y, "label", "t", "middle", "middle"); break;
+            case 5 :
+                doc.pathStart(x, y, 2, "blue");
+                doc.pathLineTo(rnd.next(-100, 100), rnd.next(-100, 100));
+                doc.pathQuadraticBezier(rnd.next(-100, 100), rnd.next(-100, 100), rnd.next(-100, 100), rnd.next(-100, 100));
+                doc.pathLineTo(rnd.next(-100, 100), rnd.next(-100, 100), true);
+                doc.pathEnd();
+                break;
+            default: // Крупные элементы - попадают в список слишком больших для сетки
+                doc.drawRectEx(x-3000, y-3000, 6000, 6000, 0, 1, "gray");
+                break;
+        }
+    }
+}
+
+std::vector<std::uint32_t> bruteForce(const SvgSpatialIndex &index, const SvgDocument &doc, const SvgBox &viewport)
+{
+    std::vector<std::uint32_t> res;
+    if (viewport.empty())
+        return res;
+
+    for(std::size_t idx=0; idx!=doc.size(); ++idx)
+    {
+        if (index.elementBox(idx).intersects(viewport))
+            res.push_back(std::uint32_t(idx));
+    }
+    return res;
+}
+
+void checkQueries(SvgSpatialIndex &index, const SvgDocument &doc, Lcg &rnd)
+{
+    for(std::size_t idx=0; idx!=doc.size(); ++idx)
+    {
+        const SvgBox a = index.elementBox(idx);
+        const SvgBox b = marty::svg::elementBounds(doc, idx);
+        MARTY_SVG_TEST_CHECK(a.minX==b.minX && a.minY==b.minY && a.maxX==b.maxX && a.maxY==b.maxY);
+    }
+
+    std::vector<std::uint32_t> res;
+    for(int q=0; q!=500; ++q)
+    {
+        SvgBox viewport;
+        switch(q%4)
+        {
+            case 0 : viewport = SvgBox::fromRect(rnd.next(-1000, 6000), rnd.next(-1000, 6000), rnd.next(1, 300), rnd.next(1, 300)); break;
+            case 1 : viewport = SvgBox::fromRect(rnd.next(-1000, 6000), rnd.next(-1000, 6000), rnd.next(300, 3000), rnd.next(300, 3000)); break;
+            case 2 : viewport = SvgBox::fromRect(rnd.next(-1000, 6000), rnd.next(-1000, 6000), 0, 0); break; // Точка
+            default: viewport = SvgBox::fromRect(rnd.next(20000, 30000), rnd.next(-1000, 6000), 100, 100); break; // Вне документа
+        }
+
+        res.clear();
+        index.query(viewport, res);
+        MARTY_SVG_TEST_CHECK(res==bruteForce(index, doc, viewport));
+    }
+
+    // Выборка выводится в порядке документа
+    const SvgBox viewport = SvgBox::fromRect(1000, 1000, 800, 600);
+    const std::vector<std::uint32_t> expected = bruteForce(index, doc, viewport);
+
+    SvgWriter byIndex, byBruteForce;
+    index.serialize(byIndex, doc, viewport);
+    doc.serialize(byBruteForce, expected.data(), expected.size());
+    MARTY_SVG_TEST_CHECK(!expected.empty());
+    MARTY_SVG_TEST_CHECK_EQ(byIndex.str(), byBruteForce.str());
+}
+
+void testQueries()
+{
+    Lcg rnd;
+    SvgDocument doc;
+    buildDocument(doc, rnd, 3000);
+
+    SvgSpatialIndex index;
+
+    index.build(doc);
+    checkQueries(index, doc, rnd);
+
+    index.build(doc, 16); // Мелкие ячейки - больше элементов уходит в список крупных
+    checkQueries(index, doc, rnd);
+
+    index.build(doc, 100000); // Одна ячейка
+    checkQueries(index, doc, rnd);
+
+    SvgDocument empty;
+    index.build(empty);
+    std::vector<std::uint32_t> res;
+    index.query(SvgBox::fromRect(0, 0, 100, 100), res);
+    MARTY_SVG_TEST_CHECK(res.empty());
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int main()
+{
+    testQueries();
+
+    return marty_svg_test::result("spatial_index");
+}
+
@@ -0,0 +1,171 @@
+/*! \file
+    \brief Установившийся режим без аллокаций: после прогрева примитивы, обёртки потока, измерение
+           текста и разбор не выделяют память
+
+    Аллокации считает marty_svg_counting_allocator.h; каждая проверка сначала выполняет работу
+    один раз (прогрев - буферы набирают ёмкость), затем повторяет её и требует ноль аллокаций.
+ */
+
+#include "marty_svg/marty_svg.h"
+#include "marty_svg/bounds_tracker.h"
+#include "marty_svg/font_metrics.h"
+#include "marty_svg/frame_diff.h"
+#include "marty_svg/path_encoder.h"
+#include "marty_svg/svg_pull_parser.h"
+
+#include "marty_svg_counting_allocator.h"
+#include "marty_svg_test.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+//----------------------------------------------------------------------------
+namespace {
+
+using marty::svg::SvgWriter;
+
+//! Аллокации при втором и последующих вызовах work()
+template<typename Work>
+std::uint64_t steadyStateAllocations(Work work, int nRounds=3)
+{
+    work(); // Прогрев
+
+    const std::uint64_t before = g_allocationCounter.load();
+    for(int i=0; i!=nRounds; ++i)
+        work();
+    return g_allocationCounter.load()-before;
+}
+
+template<typename StreamType>
+void drawPrimitives(StreamType &oss)
+{
+    for(int i=0; i!=100; ++i)
+    {
+        marty::svg::pathStart(oss, i, 2*i, 2, "black", "white", "round");
+        marty::svg::pathLineTo(oss, 10, 0);
+        marty::svg::pathHorzLineTo(oss, 5);
+        marty::svg::pathVertLineTo(oss, -5);
+        marty::svg::pathQuadraticBezier(oss, 3, 3, 6, 0);
+        marty::svg::pathEnd(oss);
+
+        marty::svg::pathStart(oss, 0.5, 1.25, "cls");
+        marty::svg::pathLineTo(oss, 10.5, 0.0);
+        marty::svg::pathEnd(oss, false);
+
+        marty::svg::drawLine(oss, 0, i, 100, i, "grid");
+        marty::svg::drawLine(oss, 0, i, 100, i, 1, "red", marty::svg::LineJoin::round);
+        marty::svg::drawText(oss, i, i, "Label <1> & \"2\"", "lbl", "middle", "middle");
+        marty::svg::drawRectEx(oss, i, i, 120, 40, 8, 2, "black", "#eee");
+        marty::svg::drawRectEx(oss, i, i, 120, 40, 8, "box");
+        marty::svg::drawRect(oss, i, i, 50, 20, "r", true, false, 4);
+    }
+}
+
+//----------------------------------------------------------------------------
+void testSvgWriter()
+{
+    SvgWriter w;
+    MARTY_SVG_TEST_CHECK_EQ(steadyStateAllocations([&] { w.clear(); drawPrimitives(w); }), std::uint64_t(0));
+    MARTY_SVG_TEST_CHECK(w.size()!=0);
+}
+
+void testWrappers()
+{
+    SvgWriter w;
+
+    marty::svg::SvgBoundsStream<SvgWriter> bs(w);
+    MARTY_SVG_TEST_CHECK_EQ(steadyStateAllocations([&] { w.clear(); bs.tracker().clear(); drawPrimitives(bs); }), std::uint64_t(0));
+
+    marty::svg::CompactPathStream<SvgWriter, double> cps(w);
+    MARTY_SVG_TEST_CHECK_EQ(steadyStateAllocations([&] { w.clear(); drawPrimitives(cps); }), std::uint64_t(0));
+
+    marty::svg::SvgIdStream<SvgWriter> ids(w);
+    MARTY_SVG_TEST_CHECK_EQ(steadyStateAllocations([&] { w.clear(); ids.setNextId("first"); drawPrimitives(ids); }), std::uint64_t(0));
+}
+
+void testEscape()
+{
+    SvgWriter w;
+    const std::string_view plain = "a plain label that needs no escaping at all, long enough to not fit SSO";
+
+    MARTY_SVG_TEST_CHECK_EQ(steadyStateAllocations([&] { w.clear(); marty::svg::writeEscapedText(w, "a<b & c>d \"q\" 'a'"); marty::svg::writeEscapedText(w, plain); }), std::uint64_t(0));
+
+    // Строка без экранирования возвращается как есть, с экранированием - в переиспользуемом буфере
+    std::string buf;
+    std::string_view escaped, passthrough;
+    MARTY_SVG_TEST_CHECK_EQ(steadyStateAllocations([&]
+                            {
+                                escaped     = marty::svg::escapeText(std::string_view("a<b & c>d"), buf);
+                                passthrough = marty::svg::escapeText(plain, buf);
+                            }), std::uint64_t(0));
+    MARTY_SVG_TEST_CHECK_EQ(escaped, std::string_view("a&lt;b &amp; c&gt;d"));
+    MARTY_SVG_TEST_CHECK(passthrough.data()==plain.data() && passthrough.size()==plain.size());
+}
+
+void testMeasureText()
+{
+    marty::svg::SvgFontRegistry fonts;
+    marty::svg::SvgTextMeasurer measurer(fonts);
+
+    double sum = 0;
+    MARTY_SVG_TEST_CHECK_EQ(steadyStateAllocations([&]
+                            {
+                                sum += measurer.measureText("Short", "Arial, sans-serif", 12.0).width;
+                                sum += measurer.measureText("A label long enough to go through the cache", "Times New Roman", 10.0).width;
+                                sum += measurer.measureText("Кириллица вне таблицы Latin-1", "monospace", 10.0).width;
+                            }), std::uint64_t(0));
+    MARTY_SVG_TEST_CHECK(sum>0);
+}
+
+void testPullParser()
+{
+    // Парсер выделяет память только под вектор атрибутов и стек открытых элементов, число аллокаций
+    // не зависит от размера документа
+    auto parseAllocations = [](int nRepeats, std::size_t &nSegments)
+    {
+        SvgWriter doc;
+        marty::svg::writeSvgHeader(doc, 0, 0, 200, 200, std::string_view());
+        for(int i=0; i!=nRepeats; ++i)
+            drawPrimitives(doc);
+        marty::svg::writeSvgFooter(doc);
+
+        const std::uint64_t before = g_allocationCounter.load();
+
+        marty::svg::SvgPullParser parser(doc.view());
+        for(auto ev=parser.next(); ev!=marty::svg::SvgXmlEvent::end && ev!=marty::svg::SvgXmlEvent::error; ev=parser.next())
+        {
+            if (ev!=marty::svg::SvgXmlEvent::startElement || parser.name()!="path")
+                continue;
+            marty::svg::SvgPathDataParser pdp(parser.attribute("d"));
+            marty::svg::SvgPathDataSegment seg;
+            while(pdp.next(seg))
+                ++nSegments;
+        }
+
+        return g_allocationCounter.load()-before;
+    };
+
+    std::size_t nSmall = 0, nLarge = 0;
+    const std::uint64_t smallAllocs = parseAllocations(1 , nSmall);
+    const std::uint64_t largeAllocs = parseAllocations(50, nLarge);
+
+    MARTY_SVG_TEST_CHECK_EQ(nLarge, 50*nSmall);
+    MARTY_SVG_TEST_CHECK_EQ(largeAllocs, smallAllocs);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int main()
+{
+    testSvgWriter();
+    testWrappers();
+    testEscape();
+    testMeasureText();
+    testPullParser();
+
+    return marty_svg_test::result("steady_state_allocs");
+}
+
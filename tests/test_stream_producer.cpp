@@ -0,0 +1,139 @@
+/*! \file
+    \brief SvgStreamProducer: документ, выбранный кусками любого размера, совпадает с writeSvg
+ */
+
+#include "marty_svg/marty_svg.h"
+#include "marty_svg/stream_producer.h"
+
+#include "marty_svg_test.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+//----------------------------------------------------------------------------
+namespace {
+
+using marty::svg::SvgStreamProducer;
+using marty::svg::SvgWriter;
+
+const char *const testStyle = ".r { fill: none; stroke: black; }\n.t { font: 10px sans-serif; }";
+
+//! Элементы разной длины, в том числе длиннее batchSize и буфера чтения
+void drawElement(SvgWriter &oss, std::size_t idx)
+{
+    const int i = int(idx);
+    switch(idx%4)
+    {
+        case 0 : marty::svg::drawRectEx(oss, i, 2*i, 120, 40, 8, 1, "black"); break;
+        case 1 : marty::svg::drawLine(oss, 0, i, 100, i, "r"); break;
+        case 2 : marty::svg::drawText(oss, i, i, std::string(idx%50, 'x'), "t", "middle", "middle"); break;
+        default: marty::svg::drawRect(oss, i, i, 50, 20, "r", true, false, 4);
+    }
+}
+
+std::string referenceDocument(std::string_view style, std::size_t count)
+{
+    SvgWriter text;
+    for(std::size_t i=0; i!=count; ++i)
+        drawElement(text, i);
+
+    SvgWriter w;
+    marty::svg::writeSvg(w, -10, -20, 1000, 800, style, text.view());
+    return std::string(w.view());
+}
+
+//! Выбирает весь документ кусками по bufSize байт
+std::string pullAll(SvgStreamProducer &producer, std::size_t bufSize)
+{
+    std::string res;
+    char buf[64];
+    while(std::size_t n = producer.read(buf, bufSize))
+    {
+        MARTY_SVG_TEST_CHECK(n<=bufSize);
+        res.append(buf, n);
+    }
+    return res;
+}
+
+//----------------------------------------------------------------------------
+void testOddBufferSize()
+{
+    constexpr std::size_t count = 200;
+
+    SvgStreamProducer producer(-10, -20, 1000, 800, testStyle, count, drawElement, 64);
+
+    // Первые байты - без генерации всех элементов
+    char buf[37];
+    const std::size_t first = producer.read(buf, sizeof(buf));
+    MARTY_SVG_TEST_CHECK_EQ(first, sizeof(buf));
+    MARTY_SVG_TEST_CHECK(producer.elementsProduced()<count);
+    MARTY_SVG_TEST_CHECK(!producer.done());
+
+    const std::string doc = std::string(buf, first) + pullAll(producer, 37);
+    MARTY_SVG_TEST_CHECK_EQ(doc, referenceDocument(testStyle, count));
+    MARTY_SVG_TEST_CHECK(producer.done());
+    MARTY_SVG_TEST_CHECK_EQ(producer.elementsProduced(), count);
+
+    // После конца документа read() возвращает 0
+    MARTY_SVG_TEST_CHECK_EQ(producer.read(buf, sizeof(buf)), std::size_t(0));
+}
+
+void testBufferSizes()
+{
+    constexpr std::size_t count = 57;
+    const std::string     ref   = referenceDocument(testStyle, count);
+
+    for(std::size_t bufSize : { std::size_t(1), std::size_t(2), std::size_t(7), std::size_t(64) })
+        for(std::size_t batchSize : { std::size_t(0), std::size_t(1), std::size_t(64), SvgStreamProducer::defaultBatchSize })
+        {
+            SvgStreamProducer producer(-10, -20, 1000, 800, testStyle, count, drawElement, batchSize);
+            MARTY_SVG_TEST_CHECK_EQ(pullAll(producer, bufSize), ref);
+        }
+}
+
+void testNoElements()
+{
+    SvgStreamProducer producer(-10, -20, 1000, 800, testStyle, 0, drawElement, 64);
+    MARTY_SVG_TEST_CHECK_EQ(pullAll(producer, 37), referenceDocument(testStyle, 0));
+    MARTY_SVG_TEST_CHECK(producer.done());
+
+    SvgStreamProducer noStyle(-10, -20, 1000, 800, std::string_view(), 0, drawElement, 64);
+    MARTY_SVG_TEST_CHECK_EQ(pullAll(noStyle, 37), referenceDocument(std::string_view(), 0));
+}
+
+void testEmptyBuffer()
+{
+    constexpr std::size_t count = 20;
+
+    SvgStreamProducer producer(-10, -20, 1000, 800, testStyle, count, drawElement, 64);
+
+    // bufSize==0 ничего не выдаёт и не сдвигает позицию - ни в начале, ни в середине документа
+    char buf[37];
+    MARTY_SVG_TEST_CHECK_EQ(producer.read(buf, 0), std::size_t(0));
+    MARTY_SVG_TEST_CHECK_EQ(producer.elementsProduced(), std::size_t(0));
+    MARTY_SVG_TEST_CHECK(!producer.done());
+
+    std::string doc;
+    for(int i=0; i!=5; ++i)
+    {
+        doc.append(buf, producer.read(buf, sizeof(buf)));
+        MARTY_SVG_TEST_CHECK_EQ(producer.read(buf, 0), std::size_t(0));
+    }
+
+    doc += pullAll(producer, 37);
+    MARTY_SVG_TEST_CHECK_EQ(doc, referenceDocument(testStyle, count));
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int main()
+{
+    testOddBufferSize();
+    testBufferSizes();
+    testNoElements();
+    testEmptyBuffer();
+
+    return marty_svg_test::result("stream_producer");
+}
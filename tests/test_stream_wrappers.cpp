@@ -0,0 +1,279 @@
+/*! \file
+    \brief Вложение обёрток потока: хуки и запись путей проходят через любую цепочку обёрток
+ */
+
+#include "marty_svg/marty_svg.h"
+#include "marty_svg/bounds_tracker.h"
+#include "marty_svg/frame_diff.h"
+#include "marty_svg/path_encoder.h"
+#include "marty_svg/tile_writer.h"
+
+#include "marty_svg_test.h"
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+//----------------------------------------------------------------------------
+namespace {
+
+using marty::svg::SvgWriter;
+using marty::svg::SvgBox;
+using marty::svg::SvgBoundsStream;
+using marty::svg::SvgIdStream;
+using marty::svg::CompactPathStream;
+
+template<typename StreamType>
+void drawSample(StreamType &oss)
+{
+    marty::svg::drawRectEx(oss, 10, 10, 120, 40, 8, 2, "black");
+    marty::svg::pathStart(oss, 200, 20, 1, "blue");
+    marty::svg::pathLineTo(oss, 10, 0);
+    marty::svg::pathLineTo(oss, 10, 0);
+    marty::svg::pathVertLineTo(oss, 30);
+    marty::svg::pathQuadraticBezier(oss, -10, 10, -20, 0);
+    marty::svg::pathEnd(oss);
+    marty::svg::drawLine(oss, 0, 100, 50, 120, 3, "red");
+}
+
+std::string verboseOutput()
+{
+    SvgWriter w;
+    drawSample(w);
+    return std::string(w.view());
+}
+
+std::string compactOutput()
+{
+    SvgWriter w;
+    CompactPathStream<SvgWriter> cps(w);
+    drawSample(cps);
+    return std::string(w.view());
+}
+
+SvgBox plainBox()
+{
+    SvgWriter w;
+    SvgBoundsStream<SvgWriter> bs(w);
+    drawSample(bs);
+    return bs.box();
+}
+
+SvgBox rectBox()
+{
+    SvgWriter w;
+    SvgBoundsStream<SvgWriter> bs(w);
+    marty::svg::drawRectEx(bs, 10, 10, 120, 40, 8, 2, "black");
+    return bs.box();
+}
+
+bool sameBox(const SvgBox &a, const SvgBox &b)
+{
+    return a.minX==b.minX && a.minY==b.minY && a.maxX==b.maxX && a.maxY==b.maxY;
+}
+
+//----------------------------------------------------------------------------
+void testBoundsOverCompact()
+{
+    SvgWriter w;
+    CompactPathStream<SvgWriter> cps(w);
+    SvgBoundsStream<CompactPathStream<SvgWriter>> bs(cps);
+    drawSample(bs);
+
+    MARTY_SVG_TEST_CHECK(compactOutput()!=verboseOutput());
+    MARTY_SVG_TEST_CHECK_EQ(std::string(w.view()), compactOutput());
+    MARTY_SVG_TEST_CHECK(!bs.box().empty());
+    MARTY_SVG_TEST_CHECK(sameBox(bs.box(), plainBox()));
+}
+
+void testCompactOverBounds()
+{
+    SvgWriter w;
+    SvgBoundsStream<SvgWriter> bs(w);
+    CompactPathStream<SvgBoundsStream<SvgWriter>> cps(bs);
+    drawSample(cps);
+
+    MARTY_SVG_TEST_CHECK_EQ(std::string(w.view()), compactOutput());
+    MARTY_SVG_TEST_CHECK(sameBox(bs.box(), plainBox()));
+}
+
+void testBoundsOverIds()
+{
+    SvgWriter w;
+    SvgIdStream<SvgWriter> ids(w);
+    SvgBoundsStream<SvgIdStream<SvgWriter>> bs(ids);
+
+    ids.setNextId("frame");
+    marty::svg::drawRectEx(bs, 10, 10, 120, 40, 8, 2, "black");
+
+    MARTY_SVG_TEST_CHECK(w.view().find("id=\"frame\"")!=std::string_view::npos);
+    MARTY_SVG_TEST_CHECK(sameBox(bs.box(), rectBox()));
+}
+
+void testBoundsOverBounds()
+{
+    SvgWriter w;
+    SvgBoundsStream<SvgWriter> inner(w);
+    SvgBoundsStream<SvgBoundsStream<SvgWriter>> outer(inner);
+    drawSample(outer);
+
+    MARTY_SVG_TEST_CHECK_EQ(std::string(w.view()), verboseOutput());
+    MARTY_SVG_TEST_CHECK(sameBox(outer.box(), plainBox()));
+    MARTY_SVG_TEST_CHECK(sameBox(inner.box(), plainBox()));
+}
+
+void testCoordPrecision()
+{
+    SvgWriter w;
+    w.setCoordPrecision(1);
+    CompactPathStream<SvgWriter> cps(w);
+    SvgBoundsStream<CompactPathStream<SvgWriter>> bs(cps);
+
+    MARTY_SVG_TEST_CHECK_EQ(marty::svg::coordPrecision(bs), 1);
+
+    marty::svg::drawLine(bs, 0.25, 0.0, 10.0, 10.0, 1, "red");
+    MARTY_SVG_TEST_CHECK(w.view().find("x1=\"0.2\"")!=std::string_view::npos);
+}
+
+void testCompactFloatPath()
+{
+    SvgWriter w;
+    CompactPathStream<SvgWriter, double> cps(w);
+
+    marty::svg::pathStart(cps, 0.5, 0.5);
+    marty::svg::pathLineTo(cps, 10.5, 0.0);
+    marty::svg::pathLineTo(cps, 0.0, 0.0);
+    marty::svg::pathHorzLineTo(cps, 3.25);
+    marty::svg::pathEnd(cps);
+    MARTY_SVG_TEST_CHECK_EQ(std::string(w.view()), std::string("<path d=\"m0.5 0.5h13.75z\" />\n"));
+
+    // Смещения считаются в единицах сетки: после десяти шагов по 0.1 точка ровно (1,3), без накопленной ошибки
+    w.clear();
+    marty::svg::pathStart(cps, 0, 0);
+    for(int i=0; i!=10; ++i)
+        marty::svg::pathLineTo(cps, 0.1, 0.3);
+    marty::svg::pathVertLineTo(cps, 2);
+    marty::svg::pathLineTo(cps, 1.0, 5.0, true);
+    marty::svg::pathEnd(cps, false);
+    MARTY_SVG_TEST_CHECK_EQ(std::string(w.view()), std::string("<path d=\"m0 0 0.1 0.3 0.1 0.3 0.1 0.3 0.1 0.3 0.1 0.3 0.1 0.3 0.1 0.3 0.1 0.3 0.1 0.3L1 3v2\" />\n"));
+
+    // Округление до точности потока - как у несжатого вывода
+    w.clear();
+    w.setCoordPrecision(1);
+    marty::svg::pathStart(cps, 0.25, 0.0, std::string_view(), true);
+    marty::svg::pathLineTo(cps, 10.0, 10.0, true);
+    marty::svg::pathEnd(cps, false);
+    MARTY_SVG_TEST_CHECK_EQ(std::string(w.view()), std::string("<path d=\"m0.2 0L10 10\" />\n"));
+
+    SvgWriter wf;
+    CompactPathStream<SvgWriter, marty::svg::SvgFixed16> fps(wf);
+    marty::svg::pathStart(fps, marty::svg::SvgFixed16(1.5), marty::svg::SvgFixed16(0.25));
+    marty::svg::pathLineTo(fps, marty::svg::SvgFixed16(2), marty::svg::SvgFixed16(0));
+    marty::svg::pathEnd(fps);
+    MARTY_SVG_TEST_CHECK_EQ(std::string(wf.view()), std::string("<path d=\"m1.5 0.25h2z\" />\n"));
+}
+
+void testIdsOverBounds()
+{
+    SvgWriter w;
+    SvgBoundsStream<SvgWriter> bs(w);
+    SvgIdStream<SvgBoundsStream<SvgWriter>> ids(bs);
+
+    ids.setNextId("frame");
+    marty::svg::drawRectEx(ids, 10, 10, 120, 40, 8, 2, "black");
+
+    MARTY_SVG_TEST_CHECK(w.view().find("id=\"frame\"")!=std::string_view::npos);
+    MARTY_SVG_TEST_CHECK(sameBox(bs.box(), rectBox()));
+}
+
+void testIdsOverCompact()
+{
+    SvgWriter w;
+    CompactPathStream<SvgWriter> cps(w);
+    SvgIdStream<CompactPathStream<SvgWriter>> ids(cps);
+    drawSample(ids);
+
+    MARTY_SVG_TEST_CHECK_EQ(std::string(w.view()), compactOutput());
+}
+
+void testFrameDiffWrappedElement()
+{
+    marty::svg::SvgFrameDiff diff;
+    SvgWriter patch;
+
+    SvgBox box;
+    diff.beginFrame();
+    diff.element(patch, "box", [&](auto &oss)
+                 {
+                     SvgBoundsStream<std::remove_reference_t<decltype(oss)>> bs(oss);
+                     marty::svg::drawRectEx(bs, 10, 10, 120, 40, 8, 2, "black");
+                     box = bs.box();
+                 });
+    diff.endFrame(patch);
+
+    // Один элемент - id ставится на сам <path>, а не на обёртку <g>
+    MARTY_SVG_TEST_CHECK(patch.view().find("<path id=\\\"box\\\"")!=std::string_view::npos);
+    MARTY_SVG_TEST_CHECK(sameBox(box, rectBox()));
+}
+
+void testFrameDiffRemoveUnknown()
+{
+    marty::svg::SvgFrameDiff diff;
+    SvgWriter patch;
+
+    diff.beginFrame();
+    diff.element(patch, "a", [&](auto &oss) { marty::svg::drawLine(oss, 0, 0, 10, 10, 1, "red"); });
+    diff.endFrame(patch);
+    patch.clear();
+
+    for(int i=0; i!=1000; ++i)
+        MARTY_SVG_TEST_CHECK(!diff.remove(patch, "unknown-" + std::to_string(i)));
+
+    MARTY_SVG_TEST_CHECK(patch.view().empty());
+    MARTY_SVG_TEST_CHECK_EQ(diff.size(), std::size_t(1));
+    MARTY_SVG_TEST_CHECK(diff.remove(patch, "a"));
+    MARTY_SVG_TEST_CHECK_EQ(diff.size(), std::size_t(0));
+
+    // Поиск в пуле строк не добавляет строку
+    marty::svg::SvgStringPool pool;
+    const auto id = pool.intern("a");
+    MARTY_SVG_TEST_CHECK_EQ(pool.find("a"), id);
+    MARTY_SVG_TEST_CHECK_EQ(pool.find("b"), marty::svg::SvgStringId(0));
+    MARTY_SVG_TEST_CHECK_EQ(pool.size(), std::size_t(2));
+}
+
+void testTileWriterCompact()
+{
+    // Тайлы пишутся через SvgBoundsStream<SvgWriter>; элемент может сам обернуть поток в CompactPathStream
+    std::string tile;
+    marty::svg::SvgTileWriter tiles(1000, 1000, std::string_view(), [&](const marty::svg::SvgTileInfo&, std::string_view data) { tile.append(data); });
+    tiles.element([&](auto &oss)
+                  {
+                      CompactPathStream<std::remove_reference_t<decltype(oss)>> cps(oss);
+                      drawSample(cps);
+                  });
+    tiles.finish();
+
+    MARTY_SVG_TEST_CHECK(tile.find(compactOutput())!=std::string::npos);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int main()
+{
+    testBoundsOverCompact();
+    testCompactOverBounds();
+    testBoundsOverIds();
+    testBoundsOverBounds();
+    testCoordPrecision();
+    testCompactFloatPath();
+    testIdsOverBounds();
+    testIdsOverCompact();
+    testFrameDiffWrappedElement();
+    testFrameDiffRemoveUnknown();
+    testTileWriterCompact();
+
+    return marty_svg_test::result("stream_wrappers");
+}
+
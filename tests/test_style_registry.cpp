@@ -0,0 +1,60 @@
+/*! \file
+    \brief Реестр стилей: имена классов остаются действительными при добавлении новых стилей
+ */
+
+#include "marty_svg/style_registry.h"
+
+#include "marty_svg_test.h"
+
+#include <string>
+#include <string_view>
+
+//----------------------------------------------------------------------------
+namespace {
+
+using marty::svg::SvgStyleRegistry;
+
+void testClassNamesStable()
+{
+    SvgStyleRegistry styles("st");
+
+    const std::string_view first = styles.getClass(1, "black");
+    MARTY_SVG_TEST_CHECK_EQ(first, std::string_view("st0"));
+
+    // Много новых стилей - хранилище имён растёт, ранее выданные строки не должны меняться
+    for(int i=0; i!=10000; ++i)
+        styles.getClass(i+2, "red", "blue");
+
+    MARTY_SVG_TEST_CHECK_EQ(first, std::string_view("st0"));
+    MARTY_SVG_TEST_CHECK_EQ(styles.getClass(1, "black").data(), first.data());
+    MARTY_SVG_TEST_CHECK_EQ(styles.getClass(1, "black", std::string_view(), "miter"), std::string_view("st0"));
+    MARTY_SVG_TEST_CHECK_EQ(styles.getClass(2, "red", "blue"), std::string_view("st1"));
+    MARTY_SVG_TEST_CHECK_EQ(styles.size(), std::size_t(10001));
+}
+
+void testRules()
+{
+    SvgStyleRegistry styles;
+    marty::svg::SvgWriter w;
+
+    marty::svg::drawLine(w, 0, 0, 10, 10, styles, 2, "red", "round");
+    marty::svg::drawLine(w, 0, 0, 20, 20, styles, 2, "red", "round");
+    marty::svg::drawRectEx(w, 0, 0, 10, 10, 2, styles, 1, "black", "white");
+
+    MARTY_SVG_TEST_CHECK_EQ(styles.size(), std::size_t(2));
+    MARTY_SVG_TEST_CHECK_EQ(styles.styleText(), std::string("<style>\n.s0{stroke:red;stroke-width:2;stroke-linejoin:round;fill-opacity:0}\n.s1{stroke:black;stroke-width:1;stroke-linejoin:miter;fill:white}\n</style>"));
+    MARTY_SVG_TEST_CHECK(w.view().find("class=\"s0\"")!=std::string_view::npos);
+    MARTY_SVG_TEST_CHECK(w.view().find("class=\"s1\"")!=std::string_view::npos);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int main()
+{
+    testClassNamesStable();
+    testRules();
+
+    return marty_svg_test::result("style_registry");
+}
+
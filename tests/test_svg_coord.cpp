@@ -0,0 +1,203 @@
+/*! \file
+    \brief Координаты: вызовы со смешанными типами координат, диапазон SvgFixed16, запись нецелых координат
+ */
+
+#include "marty_svg/marty_svg.h"
+
+#include "marty_svg_test.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+//----------------------------------------------------------------------------
+namespace {
+
+using marty::svg::SvgFixed16;
+using marty::svg::formatFixed16Coord;
+using marty::svg::formatFloatCoord;
+using marty::svg::SvgMixedCoordType;
+using marty::svg::SvgMixedCoords;
+using marty::svg::SvgWriter;
+
+//----------------------------------------------------------------------------
+void testMixedCoordTypes()
+{
+    static_assert(!SvgMixedCoords<int, int>::value, "same types are not mixed");
+    static_assert(!SvgMixedCoords<double, double, double>::value, "same types are not mixed");
+    static_assert( SvgMixedCoords<double, int>::value, "double and int are mixed");
+    static_assert(!SvgMixedCoords<marty::svg::SvgFixed16, int>::value, "SvgFixed16 does not mix");
+
+    static_assert(std::is_same<SvgMixedCoordType<short, unsigned, long>, int>::value, "integers give int");
+    static_assert(std::is_same<SvgMixedCoordType<double, int>, double>::value, "floating point is kept");
+    static_assert(std::is_same<SvgMixedCoordType<int, float>, float>::value, "floating point is kept");
+    static_assert(std::is_same<SvgMixedCoordType<float, double, int>, double>::value, "common type");
+}
+
+//! Смешанные int и double не округляются до int
+void testMixedCoordCalls()
+{
+    SvgWriter mixed, same;
+
+    marty::svg::pathStart(mixed, 0.5, 1, "c");
+    marty::svg::pathLineTo(mixed, 1.5, 2);
+    marty::svg::pathQuadraticBezier(mixed, 1, 2.25, 3, 4);
+    marty::svg::pathEnd(mixed);
+    marty::svg::drawRectEx(mixed, 0.5, 0, 10, 5, 1, 1, "k");
+    marty::svg::drawRect(mixed, 1, 2.5, 3, 4, "r", true, false, 1);
+    marty::svg::drawLine(mixed, 0, 0.5, 1, 1, "l");
+    marty::svg::drawLine(mixed, 0, 0.5, 1, 1, 2, "k", marty::svg::LineJoin::round);
+    marty::svg::drawText(mixed, 1.5, 2, "t", "c");
+
+    marty::svg::pathStart(same, 0.5, 1.0, "c");
+    marty::svg::pathLineTo(same, 1.5, 2.0);
+    marty::svg::pathQuadraticBezier(same, 1.0, 2.25, 3.0, 4.0);
+    marty::svg::pathEnd(same);
+    marty::svg::drawRectEx(same, 0.5, 0.0, 10.0, 5.0, 1.0, 1, "k");
+    marty::svg::drawRect(same, 1.0, 2.5, 3.0, 4.0, "r", true, false, 1.0);
+    marty::svg::drawLine(same, 0.0, 0.5, 1.0, 1.0, "l");
+    marty::svg::drawLine(same, 0.0, 0.5, 1.0, 1.0, 2, "k", marty::svg::LineJoin::round);
+    marty::svg::drawText(same, 1.5, 2.0, "t", "c");
+
+    MARTY_SVG_TEST_CHECK_EQ(mixed.str(), same.str());
+    MARTY_SVG_TEST_CHECK(mixed.str().find("l 1.5 2")!=std::string::npos);
+
+    // Разные целые типы - как int
+    SvgWriter ints, intsRef;
+    marty::svg::pathStart(ints, 1u, short(2), "c");
+    marty::svg::pathLineTo(ints, 3L, 4);
+    marty::svg::pathEnd(ints);
+    marty::svg::pathStart(intsRef, 1, 2, "c");
+    marty::svg::pathLineTo(intsRef, 3, 4);
+    marty::svg::pathEnd(intsRef);
+    MARTY_SVG_TEST_CHECK_EQ(ints.str(), intsRef.str());
+}
+
+//----------------------------------------------------------------------------
+//! Значения вне диапазона 16.16 прижимаются к границам, а не заворачиваются
+void testFixed16Range()
+{
+    MARTY_SVG_TEST_CHECK_EQ(SvgFixed16(100).raw, 100*SvgFixed16::one);
+    MARTY_SVG_TEST_CHECK_EQ(SvgFixed16(-32768).raw, INT32_MIN);
+    MARTY_SVG_TEST_CHECK_EQ(SvgFixed16(40000).raw, SvgFixed16::maxInt*SvgFixed16::one);
+    MARTY_SVG_TEST_CHECK_EQ(SvgFixed16(-40000).raw, INT32_MIN);
+
+    MARTY_SVG_TEST_CHECK_EQ(SvgFixed16(1.5).raw, SvgFixed16::one+SvgFixed16::one/2);
+    MARTY_SVG_TEST_CHECK_EQ(SvgFixed16(-1.5).raw, -(SvgFixed16::one+SvgFixed16::one/2));
+    MARTY_SVG_TEST_CHECK_EQ(SvgFixed16(40000.0).raw, INT32_MAX);
+    MARTY_SVG_TEST_CHECK_EQ(SvgFixed16(-40000.0).raw, INT32_MIN);
+    MARTY_SVG_TEST_CHECK_EQ(SvgFixed16(1e300).raw, INT32_MAX);
+    MARTY_SVG_TEST_CHECK_EQ(SvgFixed16(std::numeric_limits<double>::quiet_NaN()).raw, 0);
+
+    const SvgFixed16 big(30000);
+    MARTY_SVG_TEST_CHECK_EQ((big*2).raw, INT32_MAX);
+    MARTY_SVG_TEST_CHECK_EQ((-2*big).raw, INT32_MIN);
+    MARTY_SVG_TEST_CHECK_EQ((big+big).raw, INT32_MAX);
+    MARTY_SVG_TEST_CHECK_EQ((-big-big).raw, INT32_MIN);
+    MARTY_SVG_TEST_CHECK_EQ((-SvgFixed16::fromRaw(INT32_MIN)).raw, INT32_MAX);
+    MARTY_SVG_TEST_CHECK_EQ((SvgFixed16::fromRaw(INT32_MIN)/-1).raw, INT32_MAX);
+    MARTY_SVG_TEST_CHECK((SvgFixed16(10000)*3/4)==SvgFixed16(7500));
+
+    SvgFixed16 acc(32000);
+    acc += SvgFixed16(1000);
+    MARTY_SVG_TEST_CHECK_EQ(acc.raw, INT32_MAX);
+    acc -= SvgFixed16(-32768);
+    MARTY_SVG_TEST_CHECK_EQ(acc.raw, INT32_MAX);
+}
+
+//----------------------------------------------------------------------------
+//! Самая короткая запись, не больше precision знаков после точки, без хвостовых нулей и "-0"
+void testFormatFloat()
+{
+    MARTY_SVG_TEST_CHECK_EQ(formatFloatCoord(0.1, 3).view(), std::string_view("0.1"));
+    MARTY_SVG_TEST_CHECK_EQ(formatFloatCoord(0.1f, 3).view(), std::string_view("0.1"));
+    MARTY_SVG_TEST_CHECK_EQ(formatFloatCoord(-0.5, 3).view(), std::string_view("-0.5"));
+    MARTY_SVG_TEST_CHECK_EQ(formatFloatCoord(2.5, 3).view(), std::string_view("2.5"));
+    MARTY_SVG_TEST_CHECK_EQ(formatFloatCoord(123.0, 3).view(), std::string_view("123"));
+    MARTY_SVG_TEST_CHECK_EQ(formatFloatCoord(-0.0, 3).view(), std::string_view("0"));
+    MARTY_SVG_TEST_CHECK_EQ(formatFloatCoord(std::numeric_limits<double>::quiet_NaN(), 3).view(), std::string_view("0"));
+    MARTY_SVG_TEST_CHECK_EQ(formatFloatCoord(std::numeric_limits<double>::infinity(), 3).view(), std::string_view("0"));
+
+    // Меньше точности - ноль без знака
+    MARTY_SVG_TEST_CHECK_EQ(formatFloatCoord(1e-7, 3).view(), std::string_view("0"));
+    MARTY_SVG_TEST_CHECK_EQ(formatFloatCoord(-1e-7, 3).view(), std::string_view("0"));
+    MARTY_SVG_TEST_CHECK_EQ(formatFloatCoord(1e-7, 7).view(), std::string_view("0.0000001"));
+    MARTY_SVG_TEST_CHECK_EQ(formatFloatCoord(-1e-7, 17).view(), std::string_view("-0.0000001"));
+
+    // Округление до precision знаков, хвостовые нули убираются
+    MARTY_SVG_TEST_CHECK_EQ(formatFloatCoord(1.0/3.0, 3).view(), std::string_view("0.333"));
+    MARTY_SVG_TEST_CHECK_EQ(formatFloatCoord(1.0/3.0, 6).view(), std::string_view("0.333333"));
+    MARTY_SVG_TEST_CHECK_EQ(formatFloatCoord(2.0004, 3).view(), std::string_view("2"));
+    MARTY_SVG_TEST_CHECK_EQ(formatFloatCoord(123.456, 0).view(), std::string_view("123"));
+
+    // Точность ограничивается диапазоном [0, 17]
+    MARTY_SVG_TEST_CHECK_EQ(formatFloatCoord(0.1, -5).view(), formatFloatCoord(0.1, 0).view());
+    MARTY_SVG_TEST_CHECK_EQ(formatFloatCoord(1.0/3.0, 100).view(), formatFloatCoord(1.0/3.0, 17).view());
+    MARTY_SVG_TEST_CHECK_EQ(formatFloatCoord(0.1+0.2, 17).view(), std::string_view("0.30000000000000004"));
+
+    // При полной точности запись читается обратно в то же значение
+    const double values[] = { 0.1, -0.5, 1e-7, 1.0/3.0, -2.0/3.0, 1234.5678, 0.1+0.2, 98765.4321, -1e-3 };
+    for(double v : values)
+    {
+        const std::string text(formatFloatCoord(v, 17).view());
+        MARTY_SVG_TEST_CHECK(std::strtod(text.c_str(), nullptr)==v);
+    }
+
+    // Точность берётся из потока
+    SvgWriter w;
+    w.setCoordPrecision(1);
+    marty::svg::pathStart(w, 1.25, 1.0/3.0, "c");
+    marty::svg::pathEnd(w);
+    MARTY_SVG_TEST_CHECK(w.str().find("m 1.2 0.3 z")!=std::string::npos);
+}
+
+//! Точная запись 16.16 - не больше 5 знаков после точки
+void testFormatFixed16()
+{
+    MARTY_SVG_TEST_CHECK_EQ(formatFixed16Coord(SvgFixed16(1.5), 3).view(), std::string_view("1.5"));
+    MARTY_SVG_TEST_CHECK_EQ(formatFixed16Coord(SvgFixed16(-1.5), 3).view(), std::string_view("-1.5"));
+    MARTY_SVG_TEST_CHECK_EQ(formatFixed16Coord(SvgFixed16(-0.25), 3).view(), std::string_view("-0.25"));
+    MARTY_SVG_TEST_CHECK_EQ(formatFixed16Coord(SvgFixed16(-7), 3).view(), std::string_view("-7"));
+    MARTY_SVG_TEST_CHECK_EQ(formatFixed16Coord(SvgFixed16(-32768), 3).view(), std::string_view("-32768"));
+    MARTY_SVG_TEST_CHECK_EQ(formatFixed16Coord(SvgFixed16(), 3).view(), std::string_view("0"));
+    MARTY_SVG_TEST_CHECK_EQ(formatFixed16Coord(-SvgFixed16(0), 3).view(), std::string_view("0"));
+
+    // Отрицательное значение, округляемое до нуля, - без знака
+    MARTY_SVG_TEST_CHECK_EQ(formatFixed16Coord(SvgFixed16::fromRaw(-1), 3).view(), std::string_view("0"));
+    MARTY_SVG_TEST_CHECK_EQ(formatFixed16Coord(SvgFixed16::fromRaw(-1), 5).view(), std::string_view("-0.00002"));
+
+    MARTY_SVG_TEST_CHECK_EQ(formatFixed16Coord(SvgFixed16(-1.0/3.0), 2).view(), std::string_view("-0.33"));
+    MARTY_SVG_TEST_CHECK_EQ(formatFixed16Coord(SvgFixed16(-1.0/3.0), 5).view(), std::string_view("-0.33333"));
+
+    // Точность ограничивается диапазоном [0, 5]: пяти знаков хватает для точной записи
+    MARTY_SVG_TEST_CHECK_EQ(formatFixed16Coord(SvgFixed16(-1.0/3.0), 9).view(), std::string_view("-0.33333"));
+    MARTY_SVG_TEST_CHECK_EQ(formatFixed16Coord(SvgFixed16(-1.5), -1).view(), std::string_view("-2"));
+
+    // Перенос в целую часть при округлении
+    MARTY_SVG_TEST_CHECK_EQ(formatFixed16Coord(SvgFixed16(-2.9999), 2).view(), std::string_view("-3"));
+
+    // При точности 5 запись читается обратно в то же сырое значение
+    for(std::int32_t raw : { -1, -2, -3, -32767, -65535, -65537, -100000, 12345, 654321, INT32_MIN, INT32_MAX })
+    {
+        const std::string text(formatFixed16Coord(SvgFixed16::fromRaw(raw), 5).view());
+        MARTY_SVG_TEST_CHECK_EQ(SvgFixed16(std::strtod(text.c_str(), nullptr)).raw, raw);
+    }
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int main()
+{
+    testMixedCoordTypes();
+    testMixedCoordCalls();
+    testFixed16Range();
+    testFormatFloat();
+    testFormatFixed16();
+
+    return marty_svg_test::result("svg_coord");
+}
+
@@ -0,0 +1,103 @@
+/*! \file
+    \brief SvgDocument: вывод совпадает с прямым выводом в поток, порядок вызовов пути проверяется
+ */
+
+#include "marty_svg/svg_document.h"
+
+#include "marty_svg_test.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+//----------------------------------------------------------------------------
+namespace {
+
+using marty::svg::SvgDocument;
+using marty::svg::SvgWriter;
+
+template<typename Fn>
+bool throwsLogicError(Fn fn)
+{
+    try
+    {
+        fn();
+    }
+    catch(const std::logic_error &)
+    {
+        return true;
+    }
+    return false;
+}
+
+void testSameAsDirect()
+{
+    SvgWriter direct;
+    marty::svg::drawRectEx(direct, 10, 10, 100, 40, 8, 1, "black");
+    marty::svg::pathStart(direct, 0, 0, 2, "red", std::string_view(), "round");
+    marty::svg::pathLineTo(direct, 10, 0);
+    marty::svg::pathVertLineTo(direct, 10);
+    marty::svg::pathEnd(direct, false);
+    marty::svg::drawText(direct, 5, 5, "a<b", "lbl");
+
+    SvgDocument doc;
+    doc.drawRectEx(10, 10, 100, 40, 8, 1, "black");
+    doc.pathStart(0, 0, 2, "red", std::string_view(), "round");
+    doc.pathLineTo(10, 0);
+    doc.pathVertLineTo(10);
+    doc.pathEnd(false);
+    doc.drawText(5, 5, "a<b", "lbl");
+
+    SvgWriter serialized;
+    doc.serialize(serialized);
+    MARTY_SVG_TEST_CHECK_EQ(serialized.str(), direct.str());
+}
+
+void testPathOrder()
+{
+    SvgDocument doc;
+
+    // Сегменты и pathEnd без pathStart
+    MARTY_SVG_TEST_CHECK(throwsLogicError([&] { doc.pathLineTo(1, 1); }));
+    MARTY_SVG_TEST_CHECK(throwsLogicError([&] { doc.pathHorzLineTo(1); }));
+    MARTY_SVG_TEST_CHECK(throwsLogicError([&] { doc.pathVertLineTo(1); }));
+    MARTY_SVG_TEST_CHECK(throwsLogicError([&] { doc.pathQuadraticBezier(1, 1, 2, 2); }));
+    MARTY_SVG_TEST_CHECK(throwsLogicError([&] { doc.pathEnd(); }));
+    MARTY_SVG_TEST_CHECK(doc.empty());
+
+    // Элемент внутри незавершённого пути
+    doc.pathStart(0, 0, "p");
+    MARTY_SVG_TEST_CHECK(doc.pathOpen());
+    MARTY_SVG_TEST_CHECK(throwsLogicError([&] { doc.drawLine(0, 0, 1, 1, "l"); }));
+    MARTY_SVG_TEST_CHECK(throwsLogicError([&] { doc.pathStart(5, 5, "q"); }));
+    doc.pathLineTo(1, 1);
+    doc.pathEnd();
+    MARTY_SVG_TEST_CHECK(!doc.pathOpen());
+
+    // После завершения пути сегменты к нему уже не добавляются
+    doc.drawLine(0, 0, 1, 1, "l");
+    MARTY_SVG_TEST_CHECK(throwsLogicError([&] { doc.pathLineTo(2, 2); }));
+    MARTY_SVG_TEST_CHECK_EQ(doc.pathColumns().segmentCount[0], std::uint32_t(1));
+    MARTY_SVG_TEST_CHECK_EQ(doc.size(), std::size_t(2));
+
+    // clear() сбрасывает незавершённый путь
+    doc.pathStart(0, 0, "p");
+    doc.clear();
+    MARTY_SVG_TEST_CHECK(!doc.pathOpen());
+    doc.drawLine(0, 0, 1, 1, "l");
+    MARTY_SVG_TEST_CHECK_EQ(doc.size(), std::size_t(1));
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int main()
+{
+    testSameAsDirect();
+    testPathOrder();
+
+    return marty_svg_test::result("svg_document");
+}
+
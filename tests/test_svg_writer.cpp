@@ -0,0 +1,222 @@
+/*! \file
+    \brief SvgWriter: форматирование целых (в том числе граничных) и режим внешнего буфера с overflowHandler
+ */
+
+#include "marty_svg/svg_writer.h"
+
+#include "marty_svg_test.h"
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+//----------------------------------------------------------------------------
+namespace {
+
+using marty::svg::SvgWriter;
+
+//! Фрагменты, отданные в overflowHandler
+struct Chunks
+{
+    std::vector<std::string> parts;
+
+    SvgWriter::OverflowHandler handler()
+    {
+        return [this](const char *p, std::size_t size) { parts.emplace_back(p, size); };
+    }
+
+    std::string joined() const
+    {
+        std::string res;
+        for(const std::string &part : parts)
+            res += part;
+        return res;
+    }
+};
+
+//! Вывод, одинаковый для обоих режимов: строки длиннее буфера, символы и целые
+void writeSample(SvgWriter &w)
+{
+    w << "<svg viewBox=\"" << 0 << ' ' << -20 << ' ' << 1000 << ' ' << 800 << "\">\n";
+    for(int i=0; i!=50; ++i)
+    {
+        w << "<line x1=\"" << INT_MAX/50*i << "\" y1=\"" << -i << "\" data-id=\"" << std::uint64_t(i)*1000000007u << "\"/>\n";
+        w.writeInt(INT_MIN);
+        w.put('\n');
+    }
+    w << std::string(100, 'x') << std::string_view("</svg>\n");
+}
+
+//----------------------------------------------------------------------------
+template<typename IntType>
+std::string formatInt(IntType v)
+{
+    SvgWriter w;
+    w.writeInt(v);
+    return w.str();
+}
+
+void testWriteIntEdgeCases()
+{
+    MARTY_SVG_TEST_CHECK_EQ(formatInt(0), std::string("0"));
+    MARTY_SVG_TEST_CHECK_EQ(formatInt(7), std::string("7"));
+    MARTY_SVG_TEST_CHECK_EQ(formatInt(-1), std::string("-1"));
+    MARTY_SVG_TEST_CHECK_EQ(formatInt(-305), std::string("-305"));
+    MARTY_SVG_TEST_CHECK_EQ(formatInt(INT_MAX), std::string("2147483647"));
+    MARTY_SVG_TEST_CHECK_EQ(formatInt(INT_MIN), std::string("-2147483648"));
+    MARTY_SVG_TEST_CHECK_EQ(formatInt(std::numeric_limits<long long>::min()), std::string("-9223372036854775808"));
+    MARTY_SVG_TEST_CHECK_EQ(formatInt(std::numeric_limits<std::uint64_t>::max()), std::string("18446744073709551615"));
+    MARTY_SVG_TEST_CHECK_EQ(formatInt(std::int16_t(-32768)), std::string("-32768"));
+    MARTY_SVG_TEST_CHECK_EQ(formatInt(0u), std::string("0"));
+
+    // operator<< для целых идёт через writeInt; char выводится символом
+    SvgWriter w;
+    w << 0 << ' ' << -1 << ' ' << INT_MIN << ' ' << 12345678901LL << ' ' << 'c';
+    MARTY_SVG_TEST_CHECK_EQ(w.str(), std::string("0 -1 -2147483648 12345678901 c"));
+}
+
+void testWriteIntNearBufferEnd()
+{
+    // Свободного места меньше maxIntChars - число пишется через временный буфер,
+    // в собственном буфере с ростом, во внешнем - с переносом через flush()
+    for(std::size_t prefix=0; prefix!=SvgWriter::maxIntChars+2; ++prefix)
+    {
+        SvgWriter grow(SvgWriter::maxIntChars);
+        grow << std::string(prefix, 'a');
+        grow.writeInt(INT_MIN);
+        MARTY_SVG_TEST_CHECK_EQ(grow.str(), std::string(prefix, 'a') + "-2147483648");
+
+        Chunks chunks;
+        char   buf[SvgWriter::maxIntChars];
+        SvgWriter fixed(buf, sizeof(buf), chunks.handler());
+        fixed << std::string(prefix, 'a');
+        fixed.writeInt(std::numeric_limits<long long>::min());
+        fixed.flush();
+        MARTY_SVG_TEST_CHECK_EQ(chunks.joined(), std::string(prefix, 'a') + "-9223372036854775808");
+    }
+
+    // Буфер короче самого числа
+    Chunks chunks;
+    char   buf[5];
+    SvgWriter fixed(buf, sizeof(buf), chunks.handler());
+    fixed.writeInt(INT_MIN);
+    fixed.writeInt(0);
+    fixed.flush();
+    MARTY_SVG_TEST_CHECK_EQ(chunks.joined(), std::string("-21474836480"));
+}
+
+//----------------------------------------------------------------------------
+void testFixedBufferOverflow()
+{
+    SvgWriter expected;
+    writeSample(expected);
+
+    for(std::size_t bufSize : { std::size_t(1), std::size_t(7), std::size_t(64), std::size_t(4096) })
+    {
+        Chunks            chunks;
+        std::vector<char> buf(bufSize);
+        SvgWriter         w(buf.data(), buf.size(), chunks.handler());
+
+        MARTY_SVG_TEST_CHECK(w.isFixedBuffer());
+        writeSample(w);
+
+        // Буфер не растёт; до flush() отдано только то, что не влезло
+        MARTY_SVG_TEST_CHECK_EQ(w.capacity(), bufSize);
+        MARTY_SVG_TEST_CHECK(w.size()<=bufSize);
+        MARTY_SVG_TEST_CHECK_EQ(w.totalSize(), std::uint64_t(expected.size()));
+        MARTY_SVG_TEST_CHECK_EQ(chunks.joined().size()+w.size(), expected.size());
+
+        // При переполнении отдаётся целиком заполненный буфер
+        bool bFullChunks = true;
+        for(const std::string &part : chunks.parts)
+            bFullChunks = bFullChunks && part.size()==bufSize;
+        MARTY_SVG_TEST_CHECK(bFullChunks);
+
+        w.flush();
+        MARTY_SVG_TEST_CHECK(w.empty());
+        MARTY_SVG_TEST_CHECK_EQ(chunks.joined(), expected.str());
+
+        // Пустой буфер flush() не отдаёт
+        const std::size_t nParts = chunks.parts.size();
+        w.flush();
+        MARTY_SVG_TEST_CHECK_EQ(chunks.parts.size(), nParts);
+        MARTY_SVG_TEST_CHECK_EQ(w.totalSize(), std::uint64_t(expected.size()));
+    }
+}
+
+void testFixedBufferMove()
+{
+    Chunks chunks;
+    char   buf[16];
+    SvgWriter w(buf, sizeof(buf), chunks.handler());
+    w << "0123456789";
+
+    // Перемещённый writer пишет в тот же внешний буфер и в тот же обработчик
+    SvgWriter moved = std::move(w);
+    MARTY_SVG_TEST_CHECK(moved.isFixedBuffer());
+    MARTY_SVG_TEST_CHECK(moved.data()==&buf[0]);
+    MARTY_SVG_TEST_CHECK(!w.isFixedBuffer());
+    MARTY_SVG_TEST_CHECK(w.empty());
+
+    moved << "abcdefghij";
+    moved.flush();
+    MARTY_SVG_TEST_CHECK_EQ(chunks.joined(), std::string("0123456789abcdefghij"));
+    MARTY_SVG_TEST_CHECK_EQ(chunks.parts.size(), std::size_t(2));
+}
+
+void testFixedBufferInvalidArgs()
+{
+    char buf[16];
+
+    bool bThrown = false;
+    try { SvgWriter w(nullptr, sizeof(buf), [](const char*, std::size_t) {}); } catch(const std::invalid_argument &) { bThrown = true; }
+    MARTY_SVG_TEST_CHECK(bThrown);
+
+    bThrown = false;
+    try { SvgWriter w(buf, 0, [](const char*, std::size_t) {}); } catch(const std::invalid_argument &) { bThrown = true; }
+    MARTY_SVG_TEST_CHECK(bThrown);
+
+    bThrown = false;
+    try { SvgWriter w(buf, sizeof(buf), SvgWriter::OverflowHandler()); } catch(const std::invalid_argument &) { bThrown = true; }
+    MARTY_SVG_TEST_CHECK(bThrown);
+}
+
+void testGrowingBuffer()
+{
+    SvgWriter w;
+    MARTY_SVG_TEST_CHECK(!w.isFixedBuffer());
+    writeSample(w);
+
+    // Собственный буфер растёт и ничего не отдаёт; flush() его не трогает
+    const std::string text = w.str();
+    MARTY_SVG_TEST_CHECK(w.capacity()>=w.size());
+    w.flush();
+    MARTY_SVG_TEST_CHECK_EQ(w.str(), text);
+    MARTY_SVG_TEST_CHECK_EQ(w.totalSize(), std::uint64_t(text.size()));
+
+    // Запись длиннее удвоенного буфера
+    const std::string big(3u*w.capacity() + 1u, 'z');
+    w << big;
+    MARTY_SVG_TEST_CHECK_EQ(w.str(), text + big);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int main()
+{
+    testWriteIntEdgeCases();
+    testWriteIntNearBufferEnd();
+    testFixedBufferOverflow();
+    testFixedBufferMove();
+    testFixedBufferInvalidArgs();
+    testGrowingBuffer();
+
+    return marty_svg_test::result("svg_writer");
+}
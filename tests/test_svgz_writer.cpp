@@ -0,0 +1,203 @@
+/*! \file
+    \brief SvgzWriter: поток gzip распаковывается в исходный документ, в том числе до места sync()
+
+    Stored-бэкенд проверяется своим разбором (заголовок, stored-блоки, CRC-32 и ISIZE); с
+    MARTY_SVG_USE_ZLIB тот же тест проходит и SvgzZlibBackend, распаковка - через zlib.
+ */
+
+#include "marty_svg/marty_svg.h"
+#include "marty_svg/svgz_writer.h"
+
+#include "marty_svg_test.h"
+#include "marty_svg_test_deflate.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(MARTY_SVG_USE_ZLIB)
+    #include <zlib.h>
+#endif
+
+//----------------------------------------------------------------------------
+namespace {
+
+using marty::svg::SvgWriter;
+
+constexpr int nElements = 2500;
+
+template<typename StreamType>
+void drawElements(StreamType &oss, int first, int last)
+{
+    for(int i=first; i!=last; ++i)
+        marty::svg::drawRectEx(oss, (i*37)%1000, (i*53)%700, 120, 40, 8, 1, "black", (i&1) ? "#eee" : "");
+}
+
+//! Разбор gzip из stored-блоков; bComplete - поток завершён finish(), иначе - оборван на границе блока после sync()
+std::string inflateStoredGzip(std::string_view gz, bool bComplete, std::size_t *pBlockCount=nullptr)
+{
+    const unsigned char *p = reinterpret_cast<const unsigned char*>(gz.data());
+
+    MARTY_SVG_TEST_CHECK(gz.size()>=10 && p[0]==0x1F && p[1]==0x8B && p[2]==0x08 && p[3]==0);
+    if (gz.size()<10)
+        return std::string();
+
+    std::vector<unsigned char> out;
+    std::size_t pos = 10;
+    const bool bFinal = marty_svg_test::inflateStored(gz, pos, out, pBlockCount);
+
+    if (bComplete)
+    {
+        MARTY_SVG_TEST_CHECK(bFinal);
+        MARTY_SVG_TEST_CHECK_EQ(pos+8, gz.size());
+        if (pos+8==gz.size())
+        {
+            MARTY_SVG_TEST_CHECK_EQ(marty_svg_test::readLittleEndian32(p+pos), marty_svg_test::referenceCrc32(out.data(), out.size()));
+            MARTY_SVG_TEST_CHECK_EQ(marty_svg_test::readLittleEndian32(p+pos+4), std::uint32_t(out.size()));
+        }
+    }
+    else
+    {
+        // После sync() выведены только целые блоки
+        MARTY_SVG_TEST_CHECK(!bFinal);
+        MARTY_SVG_TEST_CHECK_EQ(pos, gz.size());
+    }
+
+    return std::string(out.begin(), out.end());
+}
+
+#if defined(MARTY_SVG_USE_ZLIB)
+
+//! Распаковка gzip через zlib; поток может быть оборван (после sync())
+std::string inflateZlibGzip(std::string_view gz, bool bComplete)
+{
+    z_stream zs = {};
+    MARTY_SVG_TEST_CHECK_EQ(inflateInit2(&zs, 15+16), Z_OK);
+
+    std::string out;
+    std::vector<char> buf(64u*1024u);
+
+    zs.next_in  = reinterpret_cast<Bytef*>(const_cast<char*>(gz.data()));
+    zs.avail_in = uInt(gz.size());
+
+    int res = Z_OK;
+    do
+    {
+        zs.next_out  = reinterpret_cast<Bytef*>(buf.data());
+        zs.avail_out = uInt(buf.size());
+        res = inflate(&zs, Z_NO_FLUSH);
+        out.append(buf.data(), buf.size()-zs.avail_out);
+    }
+    while(res==Z_OK && (zs.avail_in!=0 || zs.avail_out==0));
+
+    // Завершённый поток проверяет CRC-32 и ISIZE сама zlib
+    MARTY_SVG_TEST_CHECK(bComplete ? res==Z_STREAM_END : (res==Z_OK || res==Z_BUF_ERROR));
+    MARTY_SVG_TEST_CHECK_EQ(zs.avail_in, uInt(0));
+
+    inflateEnd(&zs);
+    return out;
+}
+
+#endif
+
+//----------------------------------------------------------------------------
+//! Документ через SvgzWriter, с sync() посередине; decode(gz, bComplete) распаковывает вывод
+template<typename BackendType, typename DecodeFn>
+void checkRoundTrip(std::size_t chunkSize, DecodeFn decode)
+{
+    SvgWriter plain;
+    marty::svg::writeSvgHeader(plain, 0, 0, 1000, 700, ".r { fill: none; }");
+    drawElements(plain, 0, nElements);
+    marty::svg::writeSvgFooter(plain);
+    MARTY_SVG_TEST_CHECK(plain.size()>3u*65535u);
+
+    std::string gz;
+    marty::svg::SvgzWriter<BackendType> z([&](const char *p, std::size_t size) { gz.append(p, size); }, 6, chunkSize);
+
+    marty::svg::writeSvgHeader(z.writer(), 0, 0, 1000, 700, ".r { fill: none; }");
+    drawElements(z.writer(), 0, nElements/2);
+
+    // До sync() часть вывода может быть в буферах; после - распаковывается ровно написанное
+    z.sync();
+    const std::string head = decode(std::string_view(gz), false);
+    MARTY_SVG_TEST_CHECK(!head.empty());
+    MARTY_SVG_TEST_CHECK(plain.view().substr(0, head.size())==head);
+
+    SvgWriter expectedHead;
+    marty::svg::writeSvgHeader(expectedHead, 0, 0, 1000, 700, ".r { fill: none; }");
+    drawElements(expectedHead, 0, nElements/2);
+    MARTY_SVG_TEST_CHECK_EQ(head.size(), expectedHead.size());
+
+    drawElements(z.writer(), nElements/2, nElements);
+    marty::svg::writeSvgFooter(z.writer());
+    z.finish();
+    MARTY_SVG_TEST_CHECK(z.finished());
+
+    MARTY_SVG_TEST_CHECK(decode(std::string_view(gz), true)==plain.view());
+
+    // После finish() поток закрыт
+    bool bThrown = false;
+    try { z.sync(); } catch(const std::logic_error &) { bThrown = true; }
+    MARTY_SVG_TEST_CHECK(bThrown);
+}
+
+void testStoredBackend()
+{
+    auto decode = [](std::string_view gz, bool bComplete) { return inflateStoredGzip(gz, bComplete); };
+
+    // Кусок больше 65535 - каждый делится на несколько stored-блоков; меньше - блок на кусок
+    checkRoundTrip<marty::svg::SvgzStoredBackend>(200000, decode);
+    checkRoundTrip<marty::svg::SvgzStoredBackend>(marty::svg::SvgzWriter<marty::svg::SvgzStoredBackend>::defaultChunkSize, decode);
+    checkRoundTrip<marty::svg::SvgzStoredBackend>(1000, decode);
+
+    // Один большой вызов compress() - блоки по 65535 байт
+    std::string gz;
+    {
+        marty::svg::SvgzStoredBackend backend(0, [&](const char *p, std::size_t size) { gz.append(p, size); });
+        const std::string data(3u*65535u + 100u, 'x');
+        backend.compress(data.data(), data.size());
+        backend.finish();
+
+        std::size_t nBlocks = 0;
+        MARTY_SVG_TEST_CHECK(inflateStoredGzip(gz, true, &nBlocks)==data);
+        MARTY_SVG_TEST_CHECK_EQ(nBlocks, std::size_t(5)); // 4 блока данных и пустой завершающий
+    }
+
+    // Пустой документ - корректный gzip
+    gz.clear();
+    {
+        marty::svg::SvgzWriter<marty::svg::SvgzStoredBackend> z([&](const char *p, std::size_t size) { gz.append(p, size); });
+        z.finish();
+    }
+    MARTY_SVG_TEST_CHECK(inflateStoredGzip(gz, true).empty());
+}
+
+#if defined(MARTY_SVG_USE_ZLIB)
+
+void testZlibBackend()
+{
+    auto decode = [](std::string_view gz, bool bComplete) { return inflateZlibGzip(gz, bComplete); };
+
+    checkRoundTrip<marty::svg::SvgzZlibBackend>(200000, decode);
+    checkRoundTrip<marty::svg::SvgzZlibBackend>(marty::svg::SvgzWriter<marty::svg::SvgzZlibBackend>::defaultChunkSize, decode);
+    checkRoundTrip<marty::svg::SvgzZlibBackend>(1000, decode);
+}
+
+#endif
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int main()
+{
+    testStoredBackend();
+
+#if defined(MARTY_SVG_USE_ZLIB)
+    testZlibBackend();
+#endif
+
+    return marty_svg_test::result("svgz_writer");
+}
@@ -0,0 +1,171 @@
+/*! \file
+    \brief SvgTileWriter: документы тайлов не зависят от размера буфера и совпадают с раздельным выводом
+ */
+
+#include "marty_svg/tile_writer.h"
+
+#include "marty_svg_test.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+//----------------------------------------------------------------------------
+namespace {
+
+using marty::svg::SvgBox;
+using marty::svg::SvgBoundsStream;
+using marty::svg::SvgTileInfo;
+using marty::svg::SvgTileWriter;
+using marty::svg::SvgWriter;
+
+using TileDocs = std::map<std::pair<int,int>, std::string>;
+
+constexpr int tileSize = 256;
+constexpr int nElements = 1500;
+
+const char *const tileStyle = ".r { fill: none; }";
+
+//! Элемент номер idx; координаты выбираются так, чтобы часть элементов попадала точно на края тайлов
+template<typename StreamType>
+void drawElement(StreamType &oss, int idx)
+{
+    const int x = (idx*97)%2000 - 300;
+    const int y = (idx*61)%1800 - 200;
+
+    switch(idx%5)
+    {
+        case 0 : marty::svg::drawRectEx(oss, x, y, 40+idx%300, 30, 4, 1, "black"); break;
+        case 1 : marty::svg::drawLine(oss, (x/tileSize)*tileSize, y, (x/tileSize+1)*tileSize, y, "l"); break; // Вдоль тайла, до края
+        case 2 : marty::svg::drawLine(oss, x, (y/tileSize)*tileSize, x, (y/tileSize)*tileSize, "l"); break; // Точка на краю
+        case 3 :
+            marty::svg::pathStart(oss, x, y, 2, "blue");
+            marty::svg::pathLineTo(oss, 300, 0);
+            marty::svg::pathVertLineTo(oss, 300);
+            marty::svg::pathEnd(oss, true);
+            break;
+        default: marty::svg::drawRect(oss, x, y, 10, 600, "r", true, true, 3); break;
+    }
+}
+
+TileDocs writeTiles(std::size_t maxBufferedBytes)
+{
+    TileDocs docs;
+    SvgTileWriter tiles(tileSize, tileSize, tileStyle, [&](const SvgTileInfo &tile, std::string_view data)
+    {
+        std::string &doc = docs[std::make_pair(tile.tileX, tile.tileY)];
+        MARTY_SVG_TEST_CHECK(tile.first==doc.empty());
+        doc.append(data.data(), data.size());
+    }, maxBufferedBytes);
+
+    for(int idx=0; idx!=nElements; ++idx)
+        tiles.element([&](auto &oss) { drawElement(oss, idx); });
+
+    MARTY_SVG_TEST_CHECK_EQ(tiles.elementCount(), std::size_t(nElements));
+    tiles.finish();
+    return docs;
+}
+
+//! Попадание в тайл по одной оси: полуоткрытый интервал, вырожденный элемент - точка
+bool axisHits(int minV, int maxV, int t0, int t1)
+{
+    if (maxV>minV)
+        return minV<t1 && maxV>t0;
+    return t0<=minV && minV<t1;
+}
+
+//! Ожидаемые документы тайлов - каждый элемент выводится отдельно и проверяется против каждого тайла
+TileDocs bruteForceTiles()
+{
+    std::vector<std::string> elements;
+    std::vector<SvgBox>      boxes;
+    for(int idx=0; idx!=nElements; ++idx)
+    {
+        SvgWriter w;
+        SvgBoundsStream<SvgWriter> oss(w);
+        drawElement(oss, idx);
+        elements.emplace_back(w.str());
+        boxes.emplace_back(oss.box());
+    }
+
+    TileDocs docs;
+    for(int ty=-4; ty!=12; ++ty)
+    {
+        for(int tx=-4; tx!=12; ++tx)
+        {
+            const int x0 = tx*tileSize, y0 = ty*tileSize;
+
+            SvgWriter doc;
+            bool bAny = false;
+            for(std::size_t i=0; i!=elements.size(); ++i)
+            {
+                const SvgBox &b = boxes[i];
+                if (b.empty() || !axisHits(b.minX, b.maxX, x0, x0+tileSize) || !axisHits(b.minY, b.maxY, y0, y0+tileSize))
+                    continue;
+
+                if (!bAny)
+                    marty::svg::writeSvgHeader(doc, x0, y0, tileSize, tileSize, tileStyle);
+                bAny = true;
+                doc << elements[i];
+            }
+
+            if (!bAny)
+                continue;
+
+            marty::svg::writeSvgFooter(doc);
+            docs[std::make_pair(tx, ty)] = doc.str();
+        }
+    }
+
+    return docs;
+}
+
+void testBufferSizeIndependence()
+{
+    const TileDocs big   = writeTiles(SvgTileWriter::defaultMaxBufferedBytes);
+    const TileDocs small = writeTiles(1); // Сброс после каждого элемента
+
+    MARTY_SVG_TEST_CHECK(big.size()>4);
+    MARTY_SVG_TEST_CHECK(big==small);
+    MARTY_SVG_TEST_CHECK(big==bruteForceTiles());
+}
+
+void testSingleTile()
+{
+    // Один тайл на всю диаграмму - обычный документ
+    SvgWriter expected;
+    marty::svg::writeSvgHeader(expected, -1000, -1000, 8000, 8000, tileStyle);
+    for(int idx=0; idx!=nElements; ++idx)
+        drawElement(expected, idx);
+    marty::svg::writeSvgFooter(expected);
+
+    TileDocs docs;
+    SvgTileWriter tiles(8000, 8000, tileStyle, [&](const SvgTileInfo &tile, std::string_view data)
+    {
+        docs[std::make_pair(tile.tileX, tile.tileY)].append(data.data(), data.size());
+    }, 4096);
+    tiles.setOrigin(-1000, -1000);
+
+    for(int idx=0; idx!=nElements; ++idx)
+        tiles.element([&](auto &oss) { drawElement(oss, idx); });
+    tiles.finish();
+
+    MARTY_SVG_TEST_CHECK_EQ(docs.size(), std::size_t(1));
+    if (docs.size()==1)
+        MARTY_SVG_TEST_CHECK_EQ(docs.begin()->second, expected.str());
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int main()
+{
+    testBufferSizeIndependence();
+    testSingleTile();
+
+    return marty_svg_test::result("tile_writer");
+}
+
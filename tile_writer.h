@@ -0,0 +1,350 @@
+/*! \file
+    \brief Вывод одной диаграммы набором тайлов (отдельных SVG-документов) за один проход по примитивам
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------
+#include "marty_svg.h"
+#include "bounds_tracker.h"
+#include "svg_box.h"
+//
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------
+
+// #include "marty_svg/tile_writer.h"
+// marty::svg::
+namespace marty {
+namespace svg {
+
+//----------------------------------------------------------------------------
+//! Тайл, которому принадлежит очередной кусок вывода
+struct SvgTileInfo
+{
+    int     tileX = 0;      //!< Индекс тайла по X (может быть отрицательным)
+    int     tileY = 0;
+    SvgBox  viewBox;        //!< Область тайла, в координатах диаграммы
+    bool    first = false;  //!< Первый кусок документа тайла (начинается с <svg>)
+    bool    last  = false;  //!< Последний кусок (заканчивается </svg>)
+};
+
+//----------------------------------------------------------------------------
+//! Разбиение диаграммы на тайлы при выводе
+/*! Каждый элемент выводится через element(drawFn) один раз, в общий буфер; его габариты считаются
+    хуками bounds* (см. SvgBoundsStream), и элемент попадает во все тайлы, которые он задевает.
+    Документ каждого тайла - то же, что writeSvg(viewBox тайла, style, элементы тайла): координаты
+    элементов не меняются, сдвигается только viewBox.
+
+    Когда буфер превышает maxBufferedBytes, все тайлы со своими новыми элементами отдаются в
+    chunkHandler(const SvgTileInfo&, std::string_view data) - документ тайла приходит кусками, в порядке
+    вывода, первый кусок - с заголовком, последний (по finish()) - с концом документа. Память
+    ограничена буфером плюс по 16 байт на попадание элемента в тайл.
+
+    Тайлы без элементов не выводятся. Элементы без геометрии (например, просто текст, выведенный
+    в поток) ни в один тайл не попадают; их можно направить явно - element(box, drawFn).
+
+    \code
+    marty::svg::SvgTileWriter tiles(2048, 2048, style, marty::svg::SvgTileFileSink("diagram"));
+    for(const auto &b : boxes)
+        tiles.element([&](auto &oss) { marty::svg::drawRectEx(oss, b.x, b.y, 120, 40, 8, 1, "black"); });
+    tiles.finish();
+    \endcode
+ */
+class SvgTileWriter
+{
+
+public:
+
+    using ChunkHandler = std::function<void(const SvgTileInfo& /* tile */, std::string_view /* data */)>;
+
+    //! Поток, в который выводится элемент
+    using ElementStream = SvgBoundsStream<SvgWriter>;
+
+    static constexpr std::size_t defaultMaxBufferedBytes = 16u*1024u*1024u;
+
+    SvgTileWriter( int tileSizeX, int tileSizeY
+                 , std::string_view style
+                 , ChunkHandler chunkHandler
+                 , std::size_t maxBufferedBytes=defaultMaxBufferedBytes
+                 , const SvgBoundsOptions &boundsOpts=SvgBoundsOptions()
+                 )
+    : m_tileSizeX(tileSizeX)
+    , m_tileSizeY(tileSizeY)
+    , m_style(style)
+    , m_chunkHandler(std::move(chunkHandler))
+    , m_maxBufferedBytes(maxBufferedBytes)
+    , m_elementStream(m_buffer, boundsOpts)
+    {
+        if (m_tileSizeX<=0 || m_tileSizeY<=0)
+            throw std::invalid_argument("marty::svg::SvgTileWriter: tile size must be positive");
+        if (!m_chunkHandler)
+            throw std::invalid_argument("marty::svg::SvgTileWriter: chunk handler is not set");
+    }
+
+    SvgTileWriter(const SvgTileWriter&) = delete;
+    SvgTileWriter& operator=(const SvgTileWriter&) = delete;
+
+    //! Начало сетки тайлов; тайл (0,0) - [originX, originX+tileSizeX) x [originY, originY+tileSizeY)
+    void setOrigin(int originX, int originY)
+    {
+        m_originX = originX;
+        m_originY = originY;
+    }
+
+    //! Ограничение области диаграммы: тайлы вне её не создаются, даже если элемент выходит за край
+    void setClipBox(const SvgBox &clipBox) { m_clipBox = clipBox; m_bClip = !clipBox.empty(); }
+
+    //! Точность нецелых координат в выводе элементов
+    void setCoordPrecision(int precision)
+    {
+        m_buffer.setCoordPrecision(precision);
+    }
+
+    //------------------------------
+    //! Элемент; drawFn(ElementStream&) может вывести несколько примитивов - они идут в тайлы вместе
+    template<typename DrawFn>
+    void element(DrawFn drawFn)
+    {
+        const std::size_t start = m_buffer.size();
+        m_elementStream.tracker().clear();
+
+        drawFn(m_elementStream);
+
+        routeElement(m_elementStream.box(), start);
+    }
+
+    //! Элемент с заданными габаритами - геометрия из хуков не используется
+    template<typename DrawFn>
+    void element(const SvgBox &box, DrawFn drawFn)
+    {
+        const std::size_t start = m_buffer.size();
+
+        drawFn(m_elementStream);
+
+        routeElement(box, start);
+    }
+
+    //! Отдаёт накопленное всех тайлов; вызывается сам при переполнении буфера
+    void flush()
+    {
+        for(auto &tile : m_tiles)
+        {
+            if (!tile.spans.empty())
+                flushTile(tile, false);
+        }
+
+        m_buffer.clear();
+    }
+
+    //! Завершает документы всех тайлов
+    void finish()
+    {
+        for(auto &tile : m_tiles)
+            flushTile(tile, true);
+
+        m_buffer.clear();
+        m_tiles.clear();
+        m_tileIndex.clear();
+    }
+
+    std::size_t tileCount()    const { return m_tiles.size(); }
+    std::size_t elementCount() const { return m_elementCount; }
+
+    //! Область тайла с индексами (tileX, tileY)
+    SvgBox tileBox(int tileX, int tileY) const
+    {
+        const long long x0 = (long long)m_originX + (long long)tileX*m_tileSizeX;
+        const long long y0 = (long long)m_originY + (long long)tileY*m_tileSizeY;
+        return SvgBox::fromRect(int(x0), int(y0), m_tileSizeX, m_tileSizeY);
+    }
+
+
+protected:
+
+    struct Span
+    {
+        std::size_t offset = 0;
+        std::size_t size   = 0;
+    };
+
+    struct Tile
+    {
+        int                 tileX   = 0;
+        int                 tileY   = 0;
+        bool                started = false;
+        std::vector<Span>   spans;
+    };
+
+    static int floorDiv(long long v, int d)
+    {
+        return int(v>=0 ? v/d : -((-v+d-1)/d));
+    }
+
+    //! Диапазон тайлов по одной оси; правая граница, попавшая точно на край тайла, следующий тайл не задевает
+    static void tileRange(int minV, int maxV, int origin, int size, int &first, int &last)
+    {
+        first = floorDiv((long long)minV-origin, size);
+        last  = floorDiv((long long)maxV-origin-(maxV>minV ? 1 : 0), size);
+    }
+
+    Tile& getTile(int tileX, int tileY)
+    {
+        const std::uint64_t key = (std::uint64_t(std::uint32_t(tileX))<<32) | std::uint32_t(tileY);
+
+        const auto it = m_tileIndex.find(key);
+        if (it!=m_tileIndex.end())
+            return m_tiles[it->second];
+
+        m_tileIndex.emplace(key, m_tiles.size());
+        m_tiles.emplace_back();
+        m_tiles.back().tileX = tileX;
+        m_tiles.back().tileY = tileY;
+        return m_tiles.back();
+    }
+
+    void routeElement(SvgBox box, std::size_t start)
+    {
+        const std::size_t size = m_buffer.size()-start;
+        ++m_elementCount;
+
+        if (m_bClip)
+        {
+            box.minX = std::max(box.minX, m_clipBox.minX);
+            box.minY = std::max(box.minY, m_clipBox.minY);
+            box.maxX = std::min(box.maxX, m_clipBox.maxX);
+            box.maxY = std::min(box.maxY, m_clipBox.maxY);
+        }
+
+        if (size && !box.empty())
+        {
+            int tx0, tx1, ty0, ty1;
+            tileRange(box.minX, box.maxX, m_originX, m_tileSizeX, tx0, tx1);
+            tileRange(box.minY, box.maxY, m_originY, m_tileSizeY, ty0, ty1);
+
+            for(int ty=ty0; ty<=ty1; ++ty)
+            {
+                for(int tx=tx0; tx<=tx1; ++tx)
+                {
+                    Tile &tile = getTile(tx, ty);
+                    // Соседние элементы одного тайла склеиваются в один кусок
+                    if (!tile.spans.empty() && tile.spans.back().offset+tile.spans.back().size==start)
+                        tile.spans.back().size += size;
+                    else
+                        tile.spans.emplace_back(Span{start, size});
+                }
+            }
+        }
+
+        if (m_buffer.size()>m_maxBufferedBytes)
+            flush();
+    }
+
+    void flushTile(Tile &tile, bool bLast)
+    {
+        SvgTileInfo info;
+        info.tileX   = tile.tileX;
+        info.tileY   = tile.tileY;
+        info.viewBox = tileBox(tile.tileX, tile.tileY);
+        info.first   = !tile.started;
+        info.last    = bLast;
+
+        m_scratch.clear();
+        if (!tile.started)
+            writeSvgHeader(m_scratch, info.viewBox.minX, info.viewBox.minY, m_tileSizeX, m_tileSizeY, m_style);
+
+        const std::string_view buf = m_buffer.view();
+        for(const auto &span : tile.spans)
+            m_scratch << buf.substr(span.offset, span.size);
+
+        if (bLast)
+            writeSvgFooter(m_scratch);
+
+        tile.started = true;
+        tile.spans.clear();
+
+        m_chunkHandler(info, m_scratch.view());
+    }
+
+
+    int                                         m_tileSizeX;
+    int                                         m_tileSizeY;
+    int                                         m_originX = 0;
+    int                                         m_originY = 0;
+    SvgBox                                      m_clipBox;
+    bool                                        m_bClip   = false;
+
+    std::string                                 m_style;
+    ChunkHandler                                m_chunkHandler;
+    std::size_t                                 m_maxBufferedBytes;
+
+    SvgWriter                                   m_buffer;
+    ElementStream                               m_elementStream;
+    SvgWriter                                   m_scratch;
+
+    std::vector<Tile>                           m_tiles;
+    std::unordered_map<std::uint64_t, std::size_t> m_tileIndex;
+    std::size_t                                 m_elementCount = 0;
+
+}; // class SvgTileWriter
+
+//----------------------------------------------------------------------------
+//! Обработчик кусков SvgTileWriter, пишущий тайлы в файлы prefix_X_Y.svg
+/*! Файл открывается только на время записи куска, поэтому число одновременно открытых тайлов
+    не ограничено числом дескрипторов. Ошибки записи - std::runtime_error.
+ */
+class SvgTileFileSink
+{
+
+public:
+
+    explicit SvgTileFileSink(std::string prefix)
+    : m_prefix(std::move(prefix))
+    {}
+
+    std::string fileName(int tileX, int tileY) const
+    {
+        return m_prefix + "_" + std::to_string(tileX) + "_" + std::to_string(tileY) + ".svg";
+    }
+
+    void operator()(const SvgTileInfo &tile, std::string_view data) const
+    {
+        const std::string name = fileName(tile.tileX, tile.tileY);
+
+        std::FILE *f = std::fopen(name.c_str(), tile.first ? "wb" : "ab");
+        if (!f)
+            throw std::runtime_error("marty::svg::SvgTileFileSink: failed to open file: " + name);
+
+        const bool ok = std::fwrite(data.data(), 1, data.size(), f)==data.size();
+        if (std::fclose(f)!=0 || !ok)
+            throw std::runtime_error("marty::svg::SvgTileFileSink: failed to write file: " + name);
+    }
+
+
+protected:
+
+    std::string     m_prefix;
+
+}; // class SvgTileFileSink
+
+//----------------------------------------------------------------------------
+
+} // namespace svg
+} // namespace marty
+// marty::svg::
+// #include "marty_svg/tile_writer.h"
+